@@ -0,0 +1,160 @@
+// gemc headers
+#include "fieldFactory.h"
+#include "options.h"
+
+// G4 headers
+#include "G4FieldTrack.hh"
+#include "G4ChargeState.hh"
+#include "G4EquationOfMotion.hh"
+#include "Randomize.hh"
+
+// CLHEP units
+#include "CLHEP/Units/PhysicalConstants.h"
+using namespace CLHEP;
+
+// C++ headers
+#include <iostream>
+#include <cstdlib>
+#include <ctime>
+#include <cmath>
+using namespace std;
+
+
+// counts the calls to the field
+class countingField : public G4MagneticField
+{
+public:
+	countingField(const G4Field *f) : field(f), ncalls(0) {;}
+
+	void GetFieldValue(const double x[4], double *B) const
+	{
+		ncalls++;
+		field->GetFieldValue(x, B);
+	}
+
+	const G4Field *field;
+	mutable long ncalls;
+};
+
+
+// electrons from the target, momentum and angles drawn before timing
+class benchTrack
+{
+public:
+	double p, theta, phi;
+	G4ThreeVector end;
+};
+
+
+// integrates the tracks along pathLength with the chord finder of the field
+// returns the cpu time in seconds, fills the number of steps
+double propagate(G4ChordFinder *cf, double epsilon, vector<benchTrack> &tracks, double pathLength, long &nsteps)
+{
+	double mass = electron_mass_c2;
+	G4EquationOfMotion *equation = cf->GetIntegrationDriver()->GetEquationOfMotion();
+
+	nsteps = 0;
+	clock_t start = clock();
+	for(auto &t: tracks) {
+		G4ThreeVector dir(sin(t.theta)*cos(t.phi), sin(t.theta)*sin(t.phi), cos(t.theta));
+		double ekin = sqrt(t.p*t.p + mass*mass) - mass;
+
+		equation->SetChargeMomentumMass(G4ChargeState(-1, 0, 0, 0, 0), t.p, mass);
+		G4FieldTrack ft(G4ThreeVector(0, 0, 0), 0, dir, ekin, mass, -1, G4ThreeVector(0, 0, 0));
+
+		// steps of at most 1 m, as the geant4 propagator outside of volume boundaries
+		while(ft.GetCurveLength() < pathLength) {
+			double step = min(1*m, pathLength - ft.GetCurveLength());
+			double done = cf->AdvanceChordLimited(ft, step, epsilon, ft.GetPosition(), 0);
+			nsteps++;
+			if(done <= 0) break;
+		}
+		t.end = ft.GetPosition();
+	}
+	return double(clock() - start)/CLOCKS_PER_SEC;
+}
+
+
+// Usage:
+//  fieldBenchmark fieldname ntracks [gemc options]
+//  The field integration is set with the gemc options, for example:
+//  fieldBenchmark clas12-torus-big 1000 -FIELD_DIR=/path/to/maps -FIELD_PROPERTIES="clas12-torus-big, 1*mm, G4DormandPrince745"
+//  -FIELD_INTEGRATION="clas12-torus-big, G4InterpolationDriver, 0.25*mm, 0.01*mm, 0.01*mm, 1e-5, 1e-3"
+//
+//  The end positions are compared with a reference integration using
+//  G4ClassicalRK4 with tight accuracy.
+int main(int argn, char** argv)
+{
+	if(argn < 3) {
+		cout << endl << " Wrong number of arguments. Usage: fieldBenchmark fieldname ntracks [gemc options]" << endl << endl;
+		exit(0);
+	}
+
+	string fieldName = argv[1];
+	int    ntracks   = atoi(argv[2]);
+
+	// the remaining arguments are gemc options
+	vector<char*> gargv;
+	gargv.push_back(argv[0]);
+	for(int a=3; a<argn; a++) gargv.push_back(argv[a]);
+
+	goptions gemcOpt;
+	gemcOpt.setGoptions();
+	gemcOpt.setOptMap(gargv.size(), gargv.data());
+
+	map<string, gfield> fieldsMap = loadAllFields(registerFieldFactories(), gemcOpt);
+	if(fieldsMap.find(fieldName) == fieldsMap.end()) {
+		cout << " Field " << fieldName << " not found. Check FIELD_DIR." << endl;
+		exit(0);
+	}
+
+	gfield &gf = fieldsMap[fieldName];
+	G4FieldManager *mfm = gf.get_MFM(&fieldsMap);
+	countingField counter(mfm->GetDetectorField());
+
+	// the same accuracy as the field manager used by gemc
+	G4ChordFinder *cf = gf.create_chordFinder(&counter);
+	cf->SetDeltaChord(mfm->GetChordFinder()->GetDeltaChord());
+	double epsilon = mfm->GetMaximumEpsilonStep();
+
+	// reference: tight accuracy
+	gfield reference = gf;
+	reference.integration = "G4ClassicalRK4";
+	reference.driver      = "default";
+	reference.minStep     = 0.01*mm;
+	countingField refCounter(mfm->GetDetectorField());
+	G4ChordFinder *refCf = reference.create_chordFinder(&refCounter);
+	refCf->SetDeltaChord(0.001*mm);
+
+	// electrons from 1 to 10 GeV, 5 to 40 degrees in theta
+	G4Random::setTheSeed(1);
+	vector<benchTrack> tracks(ntracks), refTracks;
+	for(auto &t: tracks) {
+		t.p     = (1 + 9*G4UniformRand())*GeV;
+		t.theta = (5 + 35*G4UniformRand())*deg;
+		t.phi   = 360*G4UniformRand()*deg;
+	}
+	refTracks = tracks;
+
+	double pathLength = 8*m;
+	long nsteps = 0, refSteps = 0;
+
+	double elapsed = propagate(cf, epsilon, tracks, pathLength, nsteps);
+	propagate(refCf, 1e-8, refTracks, pathLength, refSteps);
+
+	double maxDiff = 0, sumDiff = 0;
+	for(int t=0; t<ntracks; t++) {
+		double diff = (tracks[t].end - refTracks[t].end).mag();
+		sumDiff += diff;
+		if(diff > maxDiff) maxDiff = diff;
+	}
+
+	cout << " Field: " << fieldName << ", stepper: " << gf.integration << ", driver: " << gf.driver
+	     << ", delta chord: " << cf->GetDeltaChord()/mm << " mm, epsilon: " << epsilon << endl;
+	cout << " " << ntracks << " tracks of " << pathLength/m << " m in " << elapsed << " s: " << ntracks/elapsed << " tracks/s" << endl;
+	cout << " steps: " << nsteps << " (" << double(nsteps)/ntracks << " per track), field calls: " << counter.ncalls
+	     << " (" << double(counter.ncalls)/ntracks << " per track)" << endl;
+	cout << " end position difference with the reference: mean " << sumDiff/ntracks/mm << " mm, max " << maxDiff/mm << " mm" << endl;
+
+	return 0;
+}
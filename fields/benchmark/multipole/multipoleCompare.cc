@@ -0,0 +1,132 @@
+// Compares multipoleField::GetFieldValue with the previous formulation
+// (pow, atan2, sin, cos and G4ThreeVector rotations at each call)
+// at random points, for each number of poles and rotation axis.
+// Exits with 1 if the two disagree.
+//
+// Usage: multipoleCompare (number of points per configuration, default 100000)
+
+// gemc headers
+#include "multipoleField.h"
+
+// G4 headers
+#include "Randomize.hh"
+
+// CLHEP units
+#include "CLHEP/Units/PhysicalConstants.h"
+using namespace CLHEP;
+
+// C++ headers
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+using namespace std;
+
+
+// the previous multipoleField::GetFieldValue
+void previousMultipole(int polenumber, double strength, const double origin[3], double rotation, string rotaxis,
+					   const double pos[4], double *B)
+{
+	G4ThreeVector x0(pos[0], pos[1], pos[2]);
+	G4ThreeVector x1(origin[0], origin[1], origin[2]);
+	G4ThreeVector x2;
+	G4ThreeVector x0_local;
+	if (rotaxis=="X")
+	{
+		x2 = G4ThreeVector(0*cm,0*cm,1*cm).rotateX(rotation)+x1;
+		x0_local = (x0 - x1).rotateX(-rotation);
+	}
+	else if (rotaxis=="Y")
+	{
+		x2 = G4ThreeVector(0*cm,0*cm,1*cm).rotateY(rotation)+x1;
+		x0_local = (x0 - x1).rotateY(-rotation);
+	}
+	else
+	{
+		x2 = G4ThreeVector(0*cm,0*cm,1*cm).rotateZ(rotation)+x1;
+		x0_local = (x0 - x1).rotateZ(-rotation);
+	}
+
+	G4double r = (x2 - x1).cross(x1 - x0).mag() / (x2 - x1).mag(); //distance from x0 to line x1-x2
+	G4double phi = atan2(x0_local.y(), x0_local.x());
+
+	G4ThreeVector B_local;
+	if (polenumber == 2)
+	{
+		B_local.setX(0);
+		B_local.setY(strength);
+		B_local.setZ(0);
+	}
+	else
+	{
+		int a = polenumber / 2 - 1;
+		B_local.setX(strength * pow(r/m, a) * sin(a * phi));
+		B_local.setY(strength * pow(r/m, a) * cos(a * phi));
+		B_local.setZ(0);
+	}
+
+	G4ThreeVector B_lab=B_local;
+	if (rotaxis=="X")		{B_lab.rotateX(rotation);}
+	else if (rotaxis=="Y")	{B_lab.rotateY(rotation);}
+	else                    {B_lab.rotateZ(rotation);}
+
+	B[0]=B_lab.x();
+	B[1]=B_lab.y();
+	B[2]=B_lab.z();
+}
+
+
+int main(int argc, char **argv)
+{
+	long npoints = argc > 1 ? atol(argv[1]) : 100000;
+
+	// relative tolerance on the field magnitude
+	double tolerance = 1e-10;
+
+	string axes[3]     = {"X", "Y", "Z"};
+	double rotations[] = {0, 12*deg, 90*deg, -135*deg};
+
+	int nfailed = 0;
+
+	for(int npole = 2; npole <= 12; npole++) {
+		for(auto &axis: axes) {
+			for(auto rotation: rotations) {
+
+				double origin[3] = {10*cm, -5*cm, 20*cm};
+				double strength  = 1.5*tesla;
+
+				multipoleField field(npole, strength, origin[0], origin[1], origin[2], rotation, axis);
+
+				double maxDiff = 0;
+				for(long i=0; i<npoints; i++) {
+					double pos[4] = {origin[0] + (2*G4UniformRand() - 1)*m,
+						             origin[1] + (2*G4UniformRand() - 1)*m,
+						             origin[2] + (2*G4UniformRand() - 1)*m, 0};
+
+					double Bprev[3], Bnew[3];
+					previousMultipole(npole, strength, origin, rotation, axis, pos, Bprev);
+					field.GetFieldValue(pos, Bnew);
+
+					double scale = sqrt(Bprev[0]*Bprev[0] + Bprev[1]*Bprev[1] + Bprev[2]*Bprev[2]);
+					if(scale < 1e-6*strength) scale = 1e-6*strength;
+
+					double diff = sqrt(pow(Bnew[0] - Bprev[0], 2) + pow(Bnew[1] - Bprev[1], 2) + pow(Bnew[2] - Bprev[2], 2))/scale;
+					if(diff > maxDiff) maxDiff = diff;
+				}
+
+				bool failed = maxDiff > tolerance;
+				if(failed) nfailed++;
+
+				cout << " poles: " << npole << ", axis " << axis << ", rotation " << rotation/deg << " deg: "
+				     << " maximum relative difference " << maxDiff << (failed ? "  FAILED" : "") << endl;
+			}
+		}
+	}
+
+	if(nfailed) {
+		cout << " !!! " << nfailed << " configurations disagree with the previous formulation." << endl;
+		return 1;
+	}
+
+	cout << " The multipole field agrees with the previous formulation." << endl;
+	return 0;
+}
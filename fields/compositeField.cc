@@ -0,0 +1,163 @@
+// gemc headers
+#include "compositeField.h"
+#include "string_utilities.h"
+
+// mlibrary
+#include "gstring.h"
+using namespace gstring;
+
+// C++ headers
+#include <iostream>
+#include <cfloat>
+#include <algorithm>
+
+// CLHEP units
+#include "CLHEP/Units/PhysicalConstants.h"
+using namespace CLHEP;
+
+
+void compositeFieldComponent::shrinkBox(int n)
+{
+	if(!hasBox || threshold <= 0 || field == nullptr) return;
+
+	double width[3], lo[3], hi[3];
+	for(int a=0; a<3; a++) {
+		width[a] = (box[2*a+1] - box[2*a])/n;
+		lo[a] =  DBL_MAX;
+		hi[a] = -DBL_MAX;
+	}
+
+	// cell centers
+	double x[4] = {0, 0, 0, 0};
+	double b[6];
+	for(int i=0; i<n; i++) {
+		x[0] = box[0] + (i + 0.5)*width[0];
+		for(int j=0; j<n; j++) {
+			x[1] = box[2] + (j + 0.5)*width[1];
+			for(int k=0; k<n; k++) {
+				x[2] = box[4] + (k + 0.5)*width[2];
+
+				b[0] = b[1] = b[2] = 0;
+				field->GetFieldValue(x, b);
+				if(b[0]*b[0] + b[1]*b[1] + b[2]*b[2] < threshold*threshold) continue;
+
+				for(int a=0; a<3; a++) {
+					if(x[a] < lo[a]) lo[a] = x[a];
+					if(x[a] > hi[a]) hi[a] = x[a];
+				}
+			}
+		}
+	}
+
+	// nothing above threshold: empty box, the component is never queried
+	if(lo[0] > hi[0]) {
+		box[0] = box[2] = box[4] =  1;
+		box[1] = box[3] = box[5] = -1;
+		return;
+	}
+
+	// the cells of the points found, plus one cell
+	for(int a=0; a<3; a++) {
+		box[2*a]   = max(box[2*a],   lo[a] - 1.5*width[a]);
+		box[2*a+1] = min(box[2*a+1], hi[a] + 1.5*width[a]);
+	}
+}
+
+
+compositeField::compositeField(string n, double scale) : name(n), scaleFactor(scale)
+{
+	messenger = new compositeFieldMessenger(this);
+}
+
+compositeField::~compositeField()
+{
+	delete messenger;
+}
+
+bool compositeField::setScale(string component, double factor)
+{
+	for(auto &c: components) {
+		if(c.name == component) {
+			c.scale = factor;
+			return true;
+		}
+	}
+	return false;
+}
+
+void compositeField::GetFieldValue(const double x[4], double *Bfield) const
+{
+	Bfield[0] = Bfield[1] = Bfield[2] = 0;
+
+	double b[6];
+	for(auto &c: components) {
+
+		// most points are outside of most boxes: nothing else is done for them
+		if(!c.contains(x) || c.scale == 0) continue;
+
+		b[0] = b[1] = b[2] = 0;
+		c.field->GetFieldValue(x, b);
+
+		Bfield[0] += c.scale*b[0];
+		Bfield[1] += c.scale*b[1];
+		Bfield[2] += c.scale*b[2];
+	}
+
+	Bfield[0] *= scaleFactor;
+	Bfield[1] *= scaleFactor;
+	Bfield[2] *= scaleFactor;
+}
+
+ostream &operator<<(ostream &stream, const compositeField &cf)
+{
+	stream << "  > Composite field " << cf.name << ", scale factor: " << cf.scaleFactor << endl;
+	for(auto &c: cf.components) {
+		stream << "    - component " << c.name << ", scale factor: " << c.scale;
+		if(c.hasBox)
+			stream << ", box: x=[" << c.box[0]/cm << ", " << c.box[1]/cm << "] cm"
+			       << ", y=[" << c.box[2]/cm << ", " << c.box[3]/cm << "] cm"
+			       << ", z=[" << c.box[4]/cm << ", " << c.box[5]/cm << "] cm";
+		if(c.hasBox && c.box[0] > c.box[1])
+			stream << ", below threshold everywhere: not queried";
+		if(c.threshold > 0)
+			stream << ", threshold: " << c.threshold/gauss << " gauss";
+		stream << endl;
+	}
+	return stream;
+}
+
+
+
+compositeFieldMessenger::compositeFieldMessenger(compositeField *cf) : field(cf)
+{
+	string dir = "/gemc/field/" + cf->name + "/";
+
+	fieldDir = new G4UIdirectory(dir.c_str());
+	fieldDir->SetGuidance(("Composite field " + cf->name).c_str());
+
+	scaleCmd = new G4UIcmdWithAString((dir + "scale").c_str(), this);
+	scaleCmd->SetGuidance("Sets the scale factor of a component. Usage: scale \"component factor\"");
+	scaleCmd->SetParameterName("componentAndFactor", false);
+	scaleCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+compositeFieldMessenger::~compositeFieldMessenger()
+{
+	delete scaleCmd;
+	delete fieldDir;
+}
+
+void compositeFieldMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+	if(command == scaleCmd) {
+		vector<string> values = getStringVectorFromString(newValue);
+		if(values.size() != 2) {
+			cout << "  !!! Error: " << scaleCmd->GetCommandPath() << " needs a component name and a scale factor." << endl;
+			return;
+		}
+		if(field->setScale(values[0], get_number(values[1])))
+			cout << "  > Composite field " << field->name << ": component " << values[0] << " scaled by " << get_number(values[1]) << endl;
+		else
+			cout << "  !!! Error: composite field " << field->name << " has no component " << values[0] << endl;
+	}
+}
@@ -0,0 +1,107 @@
+/// \file compositeField.h
+/// Defines the gemc composite magnetic field.\n
+/// A composite field is the sum of several gemc fields (maps, multipoles, uniform).
+/// Each component can have an axis aligned bounding box: points outside the box
+/// do not query the component. With a threshold, the box is shrunk when the composite
+/// is built to the region where the component magnitude is above the threshold,
+/// so the queries of the negligible field region are skipped.\n
+/// The components scale factors can be changed at run time with
+/// /gemc/field/<composite name>/scale "component factor"\n
+/// \author \n Maurizio Ungaro
+/// \author mail: ungaro@jlab.org\n\n\n
+#ifndef COMPOSITE_FIELD_H
+#define COMPOSITE_FIELD_H 1
+
+// G4 headers
+#include "G4MagneticField.hh"
+#include "G4UImessenger.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+
+// C++ headers
+#include <string>
+#include <vector>
+using namespace std;
+
+class compositeFieldMessenger;
+
+
+/// \class compositeFieldComponent
+/// <b>compositeFieldComponent </b>\n\n
+/// One field of the composite, with its scale factor, bounding box and threshold
+class compositeFieldComponent
+{
+public:
+	compositeFieldComponent(string n, const G4Field *f) : name(n), field(f), scale(1), hasBox(false), threshold(0)
+	{
+		box[0] = box[2] = box[4] = 0;
+		box[1] = box[3] = box[5] = 0;
+	}
+
+	string         name;
+	const G4Field *field;
+	double         scale;
+	bool           hasBox;
+	double         box[6];      ///< xmin, xmax, ymin, ymax, zmin, zmax
+	double         threshold;   ///< field magnitude below which the component is negligible, used to shrink the box
+
+	// shrinks the box to the cells of an n^3 grid where the field magnitude is above the threshold,
+	// plus one cell on each side. The box is empty if the field is below the threshold everywhere
+	void shrinkBox(int n = 50);
+
+	inline bool contains(const double x[3]) const
+	{
+		if(!hasBox) return true;
+		return x[0] >= box[0] && x[0] <= box[1] &&
+		       x[1] >= box[2] && x[1] <= box[3] &&
+		       x[2] >= box[4] && x[2] <= box[5];
+	}
+};
+
+
+/// \class compositeField
+/// <b>compositeField </b>\n\n
+/// The function GetFieldValue returns the sum of the components
+/// whose box contains the point
+class compositeField : public G4MagneticField
+{
+public:
+	compositeField(string name, double scale);
+	~compositeField();
+
+	string name;
+	double scaleFactor;   ///< overall scale factor (SCALE_FIELD of the composite field)
+
+	void addComponent(compositeFieldComponent c) { components.push_back(c); }
+
+	// returns false if the component does not exist
+	bool setScale(string component, double factor);
+
+	void GetFieldValue(const double x[4], double *Bfield) const;
+
+	friend ostream &operator<<(ostream &stream, const compositeField &cf);
+
+private:
+	vector<compositeFieldComponent> components;
+	compositeFieldMessenger *messenger;
+};
+
+
+/// \class compositeFieldMessenger
+/// <b>compositeFieldMessenger </b>\n\n
+/// /gemc/field/<composite name>/scale "component factor"
+class compositeFieldMessenger: public G4UImessenger
+{
+public:
+	compositeFieldMessenger(compositeField *cf);
+	virtual ~compositeFieldMessenger();
+
+	void SetNewValue(G4UIcommand*, G4String);
+
+private:
+	compositeField     *field;
+	G4UIdirectory      *fieldDir;
+	G4UIcmdWithAString *scaleCmd;
+};
+
+#endif
@@ -22,6 +22,13 @@ using namespace gstring;
 #include "G4SimpleRunge.hh"
 #include "G4NystromRK4.hh"
 #include "G4CachedMagneticField.hh"
+#include "G4DormandPrince745.hh"
+#include "G4BogackiShampine45.hh"
+#include "G4Version.hh"
+#if G4VERSION_NUMBER >= 1070
+#include "G4FSALIntegrationDriver.hh"
+#include "G4InterpolationDriver.hh"
+#endif
 
 // this class serves as a dispatcher for the
 // various format of magnetic fields
@@ -42,10 +49,10 @@ void gfield::create_MFM()
 	if(format == "map")
 	{
 		fFactory->loadFieldMap(map, verbosity);
+		if(zeroThreshold > 0)
+			map->buildZeroMask(zeroThreshold, zeroBlockSize);
 
-		G4Mag_UsualEqRhs*       iEquation    = new G4Mag_UsualEqRhs(map);
-		G4MagIntegratorStepper* iStepper     = createStepper(integration, 	iEquation);
-		G4ChordFinder*          iChordFinder = new G4ChordFinder(map, minStep, iStepper);
+		G4ChordFinder*          iChordFinder = create_chordFinder(map);
 
 		// caching does not seem to help for dipole-y
 		// will it help for other field maps?
@@ -61,6 +68,7 @@ void gfield::create_MFM()
 		MFM->SetDeltaIntersection(0.01 * mm);
 	}
 
+	set_accuracy();
 }
 
 void gfield::create_simple_MFM()
@@ -73,10 +81,7 @@ void gfield::create_simple_MFM()
 
 	const G4ThreeVector constField(get_number(dim[0]), get_number(dim[1]), get_number(dim[2]));
 	G4UniformMagField*      magField     = new G4UniformMagField(constField);
-
-	G4Mag_UsualEqRhs*       iEquation    = new G4Mag_UsualEqRhs(magField);
-	G4MagIntegratorStepper* iStepper     = createStepper(integration, iEquation);
-	G4ChordFinder*          iChordFinder = new G4ChordFinder(magField, minStep,	iStepper);
+	G4ChordFinder*          iChordFinder = create_chordFinder(magField);
 
 	MFM = new G4FieldManager(magField, iChordFinder);
 
@@ -98,9 +103,7 @@ void gfield::create_simple_multipole_MFM()
 			                                     get_number(dim[4]), get_number(dim[5]), dim[6]);
 	
 	
-	G4Mag_UsualEqRhs* iEquation      = new G4Mag_UsualEqRhs(magField);
-	G4MagIntegratorStepper* iStepper = createStepper(integration, iEquation);
-	G4ChordFinder* iChordFinder      = new G4ChordFinder(magField, minStep, iStepper);
+	G4ChordFinder* iChordFinder      = create_chordFinder(magField);
 
 	MFM = new G4FieldManager(magField, iChordFinder);
 
@@ -111,6 +114,89 @@ void gfield::create_simple_multipole_MFM()
 	}
 }
 
+// the embedded error drivers use their own templated G4DormandPrince745,
+// the other steppers use the G4ChordFinder default driver
+G4ChordFinder* gfield::create_chordFinder(G4MagneticField *magField)
+{
+	G4Mag_UsualEqRhs* iEquation = new G4Mag_UsualEqRhs(magField);
+
+#if G4VERSION_NUMBER >= 1070
+	if(driver == "G4FSALIntegrationDriver") {
+		auto iStepper = new G4DormandPrince745(iEquation);
+		return new G4ChordFinder(new G4FSALIntegrationDriver<G4DormandPrince745>(minStep, iStepper, iStepper->GetNumberOfVariables()));
+	}
+	if(driver == "G4InterpolationDriver") {
+		auto iStepper = new G4DormandPrince745(iEquation);
+		return new G4ChordFinder(new G4InterpolationDriver<G4DormandPrince745>(minStep, iStepper, iStepper->GetNumberOfVariables()));
+	}
+#else
+	if(driver != "default")
+		cout << "   !!! Warning: driver " << driver << " of field " << name << " needs geant4 10.7 or later. Using the default driver." << endl;
+#endif
+
+	G4MagIntegratorStepper* iStepper = createStepper(integration, iEquation);
+	return new G4ChordFinder(magField, minStep, iStepper);
+}
+
+// FIELD_INTEGRATION values override the defaults of each format
+void gfield::set_accuracy()
+{
+	if(MFM == nullptr) return;
+
+	if(deltaChord > 0)        MFM->GetChordFinder()->SetDeltaChord(deltaChord);
+	if(deltaOneStep > 0)      MFM->SetDeltaOneStep(deltaOneStep);
+	if(deltaIntersection > 0) MFM->SetDeltaIntersection(deltaIntersection);
+
+	// geant4 requires min <= max: the maximum is set first if it is decreased
+	if(maxEpsilon > 0 && maxEpsilon < MFM->GetMinimumEpsilonStep()) {
+		if(minEpsilon > 0) MFM->SetMinimumEpsilonStep(minEpsilon);
+		MFM->SetMaximumEpsilonStep(maxEpsilon);
+	} else {
+		if(maxEpsilon > 0) MFM->SetMaximumEpsilonStep(maxEpsilon);
+		if(minEpsilon > 0) MFM->SetMinimumEpsilonStep(minEpsilon);
+	}
+
+	if(verbosity > 1)
+		cout << "  >  <" << name << ">: stepper " << integration << ", driver " << driver
+		     << ", delta chord " << MFM->GetChordFinder()->GetDeltaChord()/mm << " mm"
+		     << ", delta one step " << MFM->GetDeltaOneStep()/mm << " mm"
+		     << ", delta intersection " << MFM->GetDeltaIntersection()/mm << " mm"
+		     << ", epsilon [" << MFM->GetMinimumEpsilonStep() << ", " << MFM->GetMaximumEpsilonStep() << "]" << endl;
+}
+
+// the components fields are taken from their own field managers,
+// so maps are loaded only once even if used alone by other volumes
+void gfield::create_composite_MFM(std::map<string, gfield> *allFields)
+{
+	if(allFields == nullptr) {
+		cout << "   !!! Error: composite field " << name << " needs the fields map to build its components." << endl;
+		return;
+	}
+
+	compositeField *magField = new compositeField(name, scaleFactor);
+
+	for(auto &c: components) {
+		auto component = allFields->find(c.name);
+		if(component == allFields->end() || component->second.format == "composite") {
+			cout << "   !!! Error: component " << c.name << " of composite field " << name << " is not a defined field. Exiting." << endl;
+			exit(0);
+		}
+		compositeFieldComponent thisComponent = c;
+		thisComponent.field = component->second.get_MFM()->GetDetectorField();
+		thisComponent.shrinkBox();
+		magField->addComponent(thisComponent);
+	}
+
+	G4ChordFinder*          iChordFinder = create_chordFinder(magField);
+
+	MFM = new G4FieldManager(magField, iChordFinder);
+
+	set_accuracy();
+
+	if (verbosity > 1)
+		cout << *magField;
+}
+
 G4MagIntegratorStepper *createStepper(string sname, G4Mag_UsualEqRhs* ie)
 {
 	if (sname == "G4CashKarpRKF45")	      return new G4CashKarpRKF45(ie);
@@ -123,6 +209,8 @@ G4MagIntegratorStepper *createStepper(string sname, G4Mag_UsualEqRhs* ie)
 	if (sname == "G4HelixExplicitEuler")  return new G4HelixExplicitEuler(ie);
 	if (sname == "G4HelixSimpleRunge")	  return new G4HelixSimpleRunge(ie);
 	if (sname == "G4NystromRK4")	      return new G4NystromRK4(ie);
+	if (sname == "G4DormandPrince745")    return new G4DormandPrince745(ie);
+	if (sname == "G4BogackiShampine45")   return new G4BogackiShampine45(ie);
 
 	// if requested is not found return NULL
 	cout << "  !!! Error: stepper " << sname << " is not defined " << endl;
@@ -198,6 +286,30 @@ void gfield::initialize(goptions Opt)
 		}
 	}
 	
+	// driver and accuracy parameters
+	vector<aopt> FIELD_INTEGRATION = Opt.getArgs("FIELD_INTEGRATION");
+	for (unsigned int f = 0; f < FIELD_INTEGRATION.size(); f++) {
+		vector < string > pars = getStringVectorFromStringWithDelimiter(FIELD_INTEGRATION[f].args, ",");
+		if(pars.size() == 7 && trimSpacesFromString(pars[0]) == name) {
+			driver            = trimSpacesFromString(pars[1]);
+			deltaChord        = get_number(pars[2]);
+			deltaOneStep      = get_number(pars[3]);
+			deltaIntersection = get_number(pars[4]);
+			minEpsilon        = get_number(pars[5]);
+			maxEpsilon        = get_number(pars[6]);
+		}
+	}
+
+	// zero field mask
+	vector<aopt> FIELD_ZERO_MASK = Opt.getArgs("FIELD_ZERO_MASK");
+	for (unsigned int f = 0; f < FIELD_ZERO_MASK.size(); f++) {
+		vector < string > pars = getStringVectorFromStringWithDelimiter(FIELD_ZERO_MASK[f].args, ",");
+		if(pars.size() > 1 && trimSpacesFromString(pars[0]) == name) {
+			zeroThreshold = get_number(pars[1]);
+			if(pars.size() > 2) zeroBlockSize = (unsigned) get_number(pars[2]);
+		}
+	}
+
 	if(map) {
 		map->scaleFactor = scaleFactor;
 		map->initializeMap();
@@ -215,7 +327,10 @@ ostream &operator<<(ostream &stream, gfield gf)
 	cout << "    - symmetry:           "   << gf.symmetry << endl;
 	cout << "    - scale factor:       "   << gf.scaleFactor << endl;
 	cout << "    - integration method: "   << gf.integration << endl;
+	cout << "    - integration driver: "   << gf.driver << endl;
 	cout << "    - minimum Step:       "   << gf.minStep << " mm" << endl;
+	for (auto &c: gf.components)
+		cout << "    - component:          " << c.name << (c.hasBox ? " (bounding box)" : "") << endl;
 	if (gf.dimensions != "na" && gf.format == "simple")
 		cout << "    - dimensions:         " << gf.dimensions << endl;
 
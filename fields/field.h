@@ -28,17 +28,20 @@
 // gemc headers
 #include "options.h"
 #include "mappedField.h"
+#include "compositeField.h"
 // forward declaration of fieldFactory
 class fieldFactory;
 
 // C++ headers
 #include <string>
+#include <map>
 using namespace std;
 
 // G4 headers
 #include "G4FieldManager.hh"
 #include "G4MagIntegratorStepper.hh"
 #include "G4Mag_UsualEqRhs.hh"
+#include "G4ChordFinder.hh"
 
 // CLHEP units
 #include "CLHEP/Units/PhysicalConstants.h"
@@ -59,6 +62,14 @@ public:
 		scaleFactor	     = 1;
 		minStep          = 1*mm;
 		integration      = "G4ClassicalRK4";
+		driver           = "default";
+		deltaChord       = 0;
+		deltaOneStep     = 0;
+		deltaIntersection = 0;
+		minEpsilon       = 0;
+		maxEpsilon       = 0;
+		zeroThreshold    = 0;
+		zeroBlockSize    = 4;
 		verbosity        = opts.optMap["FIELD_VERBOSITY"].arg;
 		g4fieldCacheSize = opts.optMap["G4FIELDCACHESIZE"].arg*mm;
 	}
@@ -72,10 +83,22 @@ public:
 	string description;     ///< Field Description
 	string dimensions;      ///< Field dimensions (with units), for non-mapped fields
 	string integration;     ///< Integration Method
+	string driver;          ///< Integration driver: default, G4FSALIntegrationDriver, G4InterpolationDriver
 	double verbosity;       ///< Log verbosity
 	double minStep;         ///< Minimum Step for the G4ChordFinder
 	string unit;            ///< Field Unit
 	double g4fieldCacheSize;
+
+	// accuracy parameters. Zero means the default of the field format
+	double deltaChord;        ///< Maximum miss distance between the chord and the trajectory
+	double deltaOneStep;      ///< Position accuracy of each step
+	double deltaIntersection; ///< Position accuracy of the boundary intersections
+	double minEpsilon;        ///< Minimum relative accuracy of each step
+	double maxEpsilon;        ///< Maximum relative accuracy of each step
+
+	// zero field mask of mapped fields (FIELD_ZERO_MASK)
+	double   zeroThreshold;   ///< field magnitude below which a block of the map is zero. 0: no mask
+	unsigned zeroBlockSize;   ///< number of map cells of each block, in each coordinate
 	
 	// Scale factor, integration methods and map interpolations are set from options
 	double scaleFactor;
@@ -88,18 +111,31 @@ public:
 	// mapped Field. We need to factory to load the map
 	gMappedField *map;       ///< Mapped Field
 	fieldFactory *fFactory;  ///< fieldFactory that created the field
-	
+
+	// chord finder with the field stepper and driver. Also used by the field benchmark
+	G4ChordFinder *create_chordFinder(G4MagneticField *magField);
+
+	// composite field: sum of other fields of the map
+	vector<compositeFieldComponent> components;  ///< components names, boxes and thresholds. The fields are set in create_composite_MFM
+	void create_composite_MFM(std::map<string, gfield> *allFields);
+
 private:
 	G4FieldManager *MFM;             	///< G4 Magnetic Field Manager
 	void create_MFM();                ///< Creates the G4 Magnetic Field Manager
+	void set_accuracy();              ///< Sets the accuracy parameters of the MFM
 	
 public:
 	// Returns Magnetic Field Manager Pointer
 	// creates one if it doesn't exist
-	G4FieldManager* get_MFM()
+	// a composite field needs the other fields to build its components
+	G4FieldManager* get_MFM(std::map<string, gfield> *allFields = nullptr)
 	{
-		if(MFM == NULL)
-			create_MFM();
+		if(MFM == NULL) {
+			if(format == "composite")
+				create_composite_MFM(allFields);
+			else
+				create_MFM();
+		}
 		
 		return MFM;
 	}
@@ -3,6 +3,10 @@
 #include "asciiField.h"
 #include "utils.h"
 
+// mlibrary
+#include "gstring.h"
+using namespace gstring;
+
 
 fieldFactory *getFieldFactory(map<string, fieldFactoryInMap> *fieldsFactoryMap, string fieldsMethod)
 {
@@ -71,6 +75,46 @@ map<string, gfield> loadAllFields(map<string, fieldFactoryInMap> fieldFactoryMap
 		// not done with the factory, cannot delete factory pointer
 		// it's needed later for loading field maps
 	}
+
+	// composite fields: sums of the fields above
+	vector<aopt> COMPOSITE_FIELDS = opts.getArgs("COMPOSITE_FIELD");
+	for(auto &cf: COMPOSITE_FIELDS) {
+		vector<string> names = getStringVectorFromStringWithDelimiter(cf.args, ",");
+		if(names.size() < 2) continue;
+
+		gfield gf(opts);
+		gf.name        = trimSpacesFromString(names[0]);
+		gf.format      = "composite";
+		gf.symmetry    = "composite";
+		gf.description = "sum of";
+		gf.fFactory    = nullptr;
+		for(unsigned c=1; c<names.size(); c++) {
+			string component = trimSpacesFromString(names[c]);
+			if(gfields.find(component) == gfields.end()) {
+				cout << "   !!! Error: component " << component << " of composite field " << gf.name << " is not a defined field." << endl;
+				continue;
+			}
+			gf.components.push_back(compositeFieldComponent(component, nullptr));
+			gf.description += " " + component;
+		}
+
+		// bounding boxes and thresholds
+		vector<aopt> BOXES = opts.getArgs("COMPOSITE_FIELD_BOX");
+		for(auto &b: BOXES) {
+			vector<string> pars = getStringVectorFromStringWithDelimiter(b.args, ",");
+			if(pars.size() < 8 || trimSpacesFromString(pars[0]) != gf.name) continue;
+			for(auto &c: gf.components) {
+				if(c.name != trimSpacesFromString(pars[1])) continue;
+				c.hasBox = true;
+				for(int i=0; i<6; i++) c.box[i] = get_number(pars[2+i]);
+				if(pars.size() > 8) c.threshold = get_number(pars[8]);
+			}
+		}
+
+		gf.initialize(opts);
+		gfields[gf.name] = gf;
+		if(verbosity > 0) cout << gfields[gf.name] << endl;
+	}
 	
 	return gfields;
 }
@@ -1,6 +1,9 @@
 // gemc include
 #include "mappedField.h"
 
+// c++ headers
+#include <algorithm>
+
 
 
 void gMappedField::GetFieldValue(const double point[3], double *bField) const
@@ -184,6 +187,55 @@ void gMappedField::initializeMap()
 
 
 
+void gMappedField::buildZeroMask(double threshold, unsigned blockSize)
+{
+	// 2D maps: dipoles have one component, cylindrical two
+	int dimension = (symmetry == "phi-segmented" || symmetry == "cartesian_3D" || symmetry == "cartesian_3D_quadrant") ? 3 : 2;
+	bool dipole   = symmetry.find("dipole") == 0;
+
+	if(blockSize < 1) blockSize = 1;
+	zeroBlockSize = blockSize;
+
+	unsigned n[3] = {np[0], np[1], dimension == 3 ? np[2] : 1};
+	for(int d=0; d<3; d++)
+		nBlocks[d] = (n[d] + blockSize - 1)/blockSize;
+
+	zeroBlocks.assign(nBlocks[0]*nBlocks[1]*nBlocks[2], 0);
+
+	double threshold2 = threshold*threshold;
+	unsigned nzero = 0;
+
+	for(unsigned b0=0; b0<nBlocks[0]; b0++) {
+		for(unsigned b1=0; b1<nBlocks[1]; b1++) {
+			for(unsigned b2=0; b2<nBlocks[2]; b2++) {
+
+				bool isZero = true;
+
+				// the interpolation uses index and index+1: one more cell at the upper edge
+				for(unsigned i=b0*blockSize; i<=min((b0+1)*blockSize, n[0]-1) && isZero; i++) {
+					for(unsigned j=b1*blockSize; j<=min((b1+1)*blockSize, n[1]-1) && isZero; j++) {
+						for(unsigned k=b2*blockSize; k<=min((b2+1)*blockSize, n[2]-1) && isZero; k++) {
+							double b2sum = 0;
+							if(dimension == 3) {
+								b2sum = B1_3D[i][j][k]*B1_3D[i][j][k] + B2_3D[i][j][k]*B2_3D[i][j][k] + B3_3D[i][j][k]*B3_3D[i][j][k];
+							} else {
+								b2sum = B1_2D[i][j]*B1_2D[i][j];
+								if(!dipole) b2sum += B2_2D[i][j]*B2_2D[i][j];
+							}
+							if(b2sum >= threshold2) isZero = false;
+						}
+					}
+				}
+
+				if(isZero) {
+					zeroBlocks[(b0*nBlocks[1] + b1)*nBlocks[2] + b2] = 1;
+					nzero++;
+				}
+			}
+		}
+	}
 
-
-
+	if(verbosity > 0)
+		cout << "  > Zero field mask for " << identifier << ": " << nzero << " of " << zeroBlocks.size() << " blocks of "
+		     << blockSize << " cells are below " << threshold/gauss << " gauss." << endl;
+}
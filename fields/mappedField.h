@@ -85,6 +85,8 @@ public:
 		unit          = "gauss";
 		interpolation = "linear";
 		verbosity     = 0;
+		zeroBlockSize = 1;
+		nBlocks[0] = nBlocks[1] = nBlocks[2] = 1;
 	}
 	~gMappedField(){;}
 	
@@ -123,6 +125,20 @@ public:
 	double *cellSize;
 	unsigned int *np;
 	void initializeMap();
+
+	// zero field mask: blocks of blockSize cells (in each index) where all components
+	// stay below threshold, including the cells used by the interpolation at the block edge.
+	// GetFieldValue returns zero for those blocks without interpolating
+	void buildZeroMask(double threshold, unsigned blockSize);
+	vector<char> zeroBlocks;    ///< 1 if the block field is below threshold. Empty if there's no mask
+	unsigned zeroBlockSize;
+	unsigned nBlocks[3];
+
+	inline bool isZeroBlock(unsigned i, unsigned j, unsigned k = 0) const
+	{
+		if(zeroBlocks.empty()) return false;
+		return zeroBlocks[((i/zeroBlockSize)*nBlocks[1] + j/zeroBlockSize)*nBlocks[2] + k/zeroBlockSize];
+	}
 	
 	gcoord getCoordinateWithSpeed(int speed);   ///< return coordinate based on speed
 	gcoord getCoordinateWithName(string name);  ///< return coordinate based on type
@@ -1,6 +1,9 @@
 // gemc headers
 #include "multipoleField.h"
 
+// G4 headers
+#include "G4RotationMatrix.hh"
+
 // CLHEP units
 #include "CLHEP/Units/PhysicalConstants.h"
 using namespace CLHEP;
@@ -22,69 +25,65 @@ multipoleField::multipoleField(int Npole, G4double scale, G4double x,
 				<< rotaxis << endl; exit(-1);
 	}
 
+	// the rotation is computed once: the local frame has the multipole axis along z
+	G4RotationMatrix rm;
+	if (rotaxis == "X")      rm.rotateX(rotation);
+	else if (rotaxis == "Y") rm.rotateY(rotation);
+	else                     rm.rotateZ(rotation);
+
+	R[0][0] = rm.xx(); R[0][1] = rm.xy(); R[0][2] = rm.xz();
+	R[1][0] = rm.yx(); R[1][1] = rm.yy(); R[1][2] = rm.yz();
+	R[2][0] = rm.zx(); R[2][1] = rm.zy(); R[2][2] = rm.zz();
+
+	// radial power of the pole: 0 for the dipole
+	order = polenumber / 2 - 1;
 }
 
 multipoleField::~multipoleField() {}
 
 // ------------------------------------------------------------------------
 
+// With w = (x + i y)/m in the local frame, r^a (cos(a phi) + i sin(a phi)) = w^a:
+// the local field is Bx = strength * Im(w^a), By = strength * Re(w^a).
+// The power is expanded by squaring, the field is rotated back with the columns of R.
 void multipoleField::GetFieldValue(const G4double pos[4], G4double *B) const
 {
+	G4double dx = pos[0] - origin[0];
+	G4double dy = pos[1] - origin[1];
+	G4double dz = pos[2] - origin[2];
 
-	G4ThreeVector x0(pos[0], pos[1], pos[2]);
-	G4ThreeVector x1(origin[0], origin[1], origin[2]);
-	G4ThreeVector x2;
-	G4ThreeVector x0_local;
-	if (rotaxis=="X")
-	{
-		x2 = G4ThreeVector(0*cm,0*cm,1*cm).rotateX(rotation)+x1;
-		x0_local = (x0 - x1).rotateX(-rotation);
-	}
-	else if (rotaxis=="Y")
-	{
-		x2 = G4ThreeVector(0*cm,0*cm,1*cm).rotateY(rotation)+x1;
-		x0_local = (x0 - x1).rotateY(-rotation);
-	}
-	else if (rotaxis=="Z")
-	{
-		x2 = G4ThreeVector(0*cm,0*cm,1*cm).rotateZ(rotation)+x1;
-		x0_local = (x0 - x1).rotateZ(-rotation);
-	}
-	else
-	{
-		cout	<< "!!! Error: multipole field has rot axis along X or Y or Z, while you have axis: "
-				<< rotaxis << endl;
-		exit(-1);
-	}
-
-	G4double r = (x2 - x1).cross(x1 - x0).mag() / (x2 - x1).mag(); //distance from x0 to line x1-x2
-	G4double phi = atan2(x0_local.y(), x0_local.x());
+	// local coordinates: R transposed times the displacement
+	G4double lx = (R[0][0]*dx + R[1][0]*dy + R[2][0]*dz) / m;
+	G4double ly = (R[0][1]*dx + R[1][1]*dy + R[2][1]*dz) / m;
 
-	G4ThreeVector B_local;
-	if (polenumber == 2)
+	// w^|a| by squaring
+	G4double re = 1, im = 0;
+	G4double bre = lx, bim = ly;
+	for (int a = order < 0 ? -order : order; a > 0; a >>= 1)
 	{
-		B_local.setX(0);
-		B_local.setY(strength);
-		B_local.setZ(0);
-	}
-	else
-	{
-		int a = polenumber / 2 - 1;
-		B_local.setX(strength * pow(r/m, a) * sin(a * phi));
-		B_local.setY(strength * pow(r/m, a) * cos(a * phi));
-		B_local.setZ(0);
+		if (a & 1)
+		{
+			G4double t = re*bre - im*bim;
+			im = re*bim + im*bre;
+			re = t;
+		}
+		G4double t = bre*bre - bim*bim;
+		bim = 2*bre*bim;
+		bre = t;
 	}
 
-	G4ThreeVector B_lab=B_local;
-	if (rotaxis=="X")		{B_lab.rotateX(rotation);}
-	else if (rotaxis=="Y")	{B_lab.rotateY(rotation);}
-	else if (rotaxis=="Z")	{B_lab.rotateZ(rotation);}
-	else {cout	<< "!!! Error: multipole field has rot axis along X or Y or Z, while you have axis "
-				<< rotaxis << endl; exit(-1);
+	// negative orders: 1/w^|a|
+	if (order < 0)
+	{
+		G4double n2 = re*re + im*im;
+		re =  re/n2;
+		im = -im/n2;
 	}
 
-	B[0]=B_lab.x();
-	B[1]=B_lab.y();
-	B[2]=B_lab.z();
+	G4double Bx = strength * im;
+	G4double By = strength * re;
 
+	B[0] = R[0][0]*Bx + R[0][1]*By;
+	B[1] = R[1][0]*Bx + R[1][1]*By;
+	B[2] = R[2][0]*Bx + R[2][1]*By;
 }
@@ -27,6 +27,10 @@ class multipoleField: public G4MagneticField
 		G4double rotation;
 		string rotaxis;
 
+	private:
+		G4double R[3][3];   ///< rotation from the multipole frame to the lab, computed at construction
+		int order;          ///< radial power of the field: polenumber/2 - 1
+
 };
 
 #endif
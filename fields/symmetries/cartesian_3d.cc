@@ -230,6 +230,9 @@ void gMappedField::GetFieldValue_cartesian3d( const double x[3], double *Bfield,
 	// outside map, returning no field
 	if (XX < startMap[0] || YY < startMap[1] || ZZ < startMap[2]) return;
 	if (XX >= endMap[0] || YY >= endMap[1] || ZZ >= endMap[2]) return;
+
+	// negligible field in this region
+	if(isZeroBlock(IXX, IYY, IZZ)) return;
 	
 	double B1,B2,B3;
 	// no interpolation
@@ -157,6 +157,9 @@ void gMappedField::GetFieldValue_Cylindrical( const double x[3], double *Bfield,
 	// outside map, returning no field
 	if(IT>=np[0]-1 || IL>=np[1]-1) return;
 
+	// negligible field in this region
+	if(isZeroBlock(IT, IL)) return;
+
 
 	// no interpolation
 	if(interpolation == "none")
@@ -149,6 +149,9 @@ void gMappedField::GetFieldValue_Dipole( const double x[3], double *Bfield, int
 		// cout << "  Field is outside limits IL: "  << IL << "  IT:" << IT << "  np[0] - 1: " << np[0] - 1 << " np[1] - 1: " << np[1] - 1 << endl;
 		return;
 	}
+
+	// negligible field in this region
+	if(isZeroBlock(IL, IT)) return;
 	
 	// no interpolation
 	if(interpolation == "none")
@@ -254,6 +254,9 @@ void gMappedField::GetFieldValue_phiSegmented( const double x[3], double *Bfield
 	// outside map, returning no field
 	if(aI >= np[0]-1 || tI >= np[1]-1 || lI >= np[2]-1) return;
 
+	// negligible field in this region
+	if(isZeroBlock(aI, tI, lI)) return;
+
 	// positive on the right side of the segment
 	int sign = (aLC >= 0 ? 1 : -1);
 
@@ -65,6 +65,7 @@ const char *GEMC_VERSION = "gemc 2.8";
 #include "string_utilities.h"
 #include "utils.h"
 #include "ActionInitialization.h"
+#include "digitizeOnly.h"
 
 // c++ headers
 #include <unistd.h>  // needed for get_pid
@@ -151,7 +152,41 @@ int main( int argc, char **argv )
 	
 	CLHEP::HepRandom::setTheSeed(seed);
 	gemc_splash.message(" Seed initialized to: " + stringify(seed));
-	
+
+	// DIGITIZE_ONLY: the hits come from a step record.
+	// Detectors, parameters and banks are loaded so that the hit process routines
+	// find their volumes and constants, but no geometry is built and nothing is tracked.
+	if(gemcOpt.optMap["DIGITIZE_ONLY"].args != "no") {
+		gemc_splash.message(" Digitization only mode: reading hits from " + gemcOpt.optMap["DIGITIZE_ONLY"].args);
+
+		runConditions runConds(gemcOpt);
+		map<string, detectorFactoryInMap> detectorFactoryMap = registerDetectorFactory();
+		map<string, detector> hallMap = buildDetector(detectorFactoryMap, gemcOpt, runConds);
+
+		map<string, parameterFactoryInMap> parameterFactoriesMap = registerParameterFactories();
+		map<string, double> gParameters = loadAllParameters(parameterFactoriesMap, gemcOpt, runConds);
+
+		map<string, HitProcess_Factory> hitProcessMap = HitProcess_Map(gemcOpt.optMap["HIT_PROCESS_LIST"].args);
+		map<string, gBank> banksMap = read_banks(gemcOpt, runConds.get_systems());
+
+		outputContainer outContainer(gemcOpt);
+		map<string, outputFactoryInMap> outputFactoryMap = registerOutputFactories();
+
+		if(outContainer.outType != "no" && outputFactoryMap.find(outContainer.outType) != outputFactoryMap.end()) {
+			map<string, string> sim_condition = gemcOpt.getOptMap();
+			mergeMaps(sim_condition, runConds.getDetectorConditionsMap());
+			mergeMaps(sim_condition, getParametersMap(gParameters));
+			sim_condition["JSON"] = gemcOpt.jSonOptions();
+
+			outContainer.recordSimConditions(sim_condition, outputFactoryMap[outContainer.outType]);
+		}
+
+		digitizeOnly(gemcOpt, &hallMap, &hitProcessMap, gParameters, &banksMap, &outContainer, &outputFactoryMap);
+
+		cout << " > Total gemc time: " <<  (clock() - startTime) / (double) CLOCKS_PER_SEC << " seconds. " << endl;
+		return 1;
+	}
+
 	// Construct the default G4 run manager
 	gemc_splash.message(" Instantiating Run Manager...");
 	G4RunManager *runManager = new G4RunManager;
@@ -298,10 +333,9 @@ int main( int argc, char **argv )
 
 		sim_condition["JSON"] = gemcOpt.jSonOptions();
 
-		outputFactory *processOutputFactory  = getOutputFactory(&outputFactoryMap, outContainer.outType);
-		processOutputFactory->recordSimConditions(&outContainer, sim_condition);
-		// then deleting process output pointer, not needed anymore
-		delete processOutputFactory;
+		// written again at the beginning of each file if the output is split
+		if(outputFactoryMap.find(outContainer.outType) != outputFactoryMap.end())
+			outContainer.recordSimConditions(sim_condition, outputFactoryMap[outContainer.outType]);
 	}
 	
 
@@ -311,6 +345,23 @@ int main( int argc, char **argv )
 	gActions->evtAction->SeDe_Map         = ExpHall->SeDe_Map;
 	gActions->evtAction->banksMap         = &banksMap;
 	gActions->evtAction->gen_action       = gActions->genAction;
+	gActions->evtAction->bunchRecorder    = gActions->stpAction->bunchRecorder;
+	gActions->evtAction->phaseSpaceOutput = gActions->stpAction->phaseSpaceOutput;
+	gActions->evtAction->scoring          = gActions->stpAction->scoring;
+
+	if(gemcOpt.optMap["MIX_STEP_RECORD"].args != "no") {
+		eventMixer *mixer = new eventMixer(gemcOpt, &hallMap);
+		if(mixer->isGood()) {
+			gActions->evtAction->mixer = mixer;
+		} else {
+			cout << " !!! Error: no background event found in MIX_STEP_RECORD. Exiting." << endl;
+			exit(1);
+		}
+	}
+
+	// cosmic rays biased to volumes: their bounding spheres need the physical volumes
+	if(gemcOpt.optMap["COSMIC_TARGETS"].args != "no" && gemcOpt.optMap["COSMICRAYS"].args != "no")
+		gActions->genAction->setCosmicTargets(&hallMap);
  	
 	///< passing output process factory to sensitive detectors
 	map<string, sensitiveDetector*>::iterator it;
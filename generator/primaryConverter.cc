@@ -0,0 +1,145 @@
+// Converts LUND, BEAGLE or StdHep generator files to the gemc binary primary events format.
+// The converted file is read with -INPUT_GEN_FILE="gprimary, filename"
+//
+// Usage: primaryConverter <LUND | BEAGLE | StdHep> <input file> <output file> [events per index block]
+//
+// StdHep events are written with the LUND columns:
+// index, charge (0), type (1 for particles without daughters), pid, parent, daughter, px, py, pz, E, mass, vx, vy, vz
+
+// gemc headers
+#include "primaryEventFile.h"
+#include "lStdHep.hh"
+using namespace UTIL;
+
+// C++ headers
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+
+
+// numbers of a text line
+static void lineNumbers(const string &line, vector<double> &numbers)
+{
+	numbers.clear();
+	const char *p = line.c_str();
+	char *end;
+	while(true) {
+		double value = strtod(p, &end);
+		if(end == p) break;
+		numbers.push_back(value);
+		p = end;
+	}
+}
+
+static long convertText(ifstream &input, primaryEventFile &output, bool beagle)
+{
+	string line;
+	primaryEvent event;
+	long nevents = 0;
+
+	// first 6 lines are the beagle file header
+	if(beagle)
+		for(int i=0; i<6; i++) getline(input, line);
+
+	while(getline(input, line)) {
+
+		lineNumbers(line, event.header);
+		if(event.header.empty()) continue;
+
+		int nparticles = beagle ? event.header.back() : event.header[0];
+
+		// header / particles separator
+		if(beagle) getline(input, line);
+
+		event.particles.resize(nparticles);
+		for(int p=0; p<nparticles; p++) {
+			if(!getline(input, line)) {
+				cout << " Input file appears to be truncated at event " << nevents + 1 << endl;
+				return nevents;
+			}
+			lineNumbers(line, event.particles[p]);
+		}
+
+		// end of event separator
+		if(beagle) getline(input, line);
+
+		output.writeEvent(event);
+		nevents++;
+	}
+
+	return nevents;
+}
+
+static long convertStdHep(string filename, primaryEventFile &output)
+{
+	lStdHep reader(filename.c_str());
+	primaryEvent event;
+	long nevents = 0;
+
+	while(reader.readEvent() == LSH_SUCCESS) {
+
+		int nparticles = reader.nTracks();
+
+		event.header.assign(10, 0);
+		event.header[0] = nparticles;
+
+		event.particles.resize(nparticles);
+		for(int p=0; p<nparticles; p++) {
+			double values[] = {(double) p + 1, 0, reader.daughter1(p) > 0 ? 0. : 1., (double) reader.pid(p),
+			                   (double) reader.mother1(p), (double) reader.daughter1(p),
+			                   reader.Px(p), reader.Py(p), reader.Pz(p), reader.E(p), reader.M(p),
+			                   reader.X(p), reader.Y(p), reader.Z(p)};
+			event.particles[p].assign(values, values + 14);
+		}
+
+		output.writeEvent(event);
+		nevents++;
+	}
+
+	return nevents;
+}
+
+
+int main(int argc, char **argv)
+{
+	if(argc < 4) {
+		cout << " Usage: primaryConverter <LUND | BEAGLE | StdHep> <input file> <output file> [events per index block]" << endl;
+		return 1;
+	}
+
+	string format = argv[1];
+	for(auto &c: format) c = toupper(c);
+
+	string inputFile  = argv[2];
+	string outputFile = argv[3];
+	unsigned blockSize = argc > 4 ? atoi(argv[4]) : 1000;
+
+	if(format != "LUND" && format != "BEAGLE" && format != "STDHEP") {
+		cout << " Format " << argv[1] << " not supported. Use LUND, BEAGLE or StdHep." << endl;
+		return 1;
+	}
+
+	primaryEventFile output(outputFile, "w", format == "BEAGLE" ? PRIMARY_FORMAT_BEAGLE : PRIMARY_FORMAT_LUND, blockSize);
+	if(!output.isGood()) {
+		cout << " Can't open output file " << outputFile << endl;
+		return 1;
+	}
+
+	long nevents = 0;
+	if(format == "STDHEP") {
+		nevents = convertStdHep(inputFile, output);
+	} else {
+		ifstream input(inputFile.c_str());
+		if(!input) {
+			cout << " Can't open input file " << inputFile << endl;
+			return 1;
+		}
+		nevents = convertText(input, output, format == "BEAGLE");
+	}
+
+	output.close();
+
+	cout << " " << nevents << " events converted from " << inputFile << " to " << outputFile << endl;
+
+	return 0;
+}
@@ -247,7 +247,7 @@ map<string, double> crs_HitProcess :: integrateDgt(MHit* aHit, int hitn)
         
         // Crystal readout
         //double test=WaveForm(peR_crs,TDCR_crs);
-        double* test;
+        vector<double> test;
         double tim;
         double peR_int_crs;
         double peR_crs;
@@ -387,120 +387,10 @@ map< string, vector <int> >  crs_HitProcess :: multiDgt(MHit* aHit, int hitn)
 
 
 
-//double crs_HitProcess::WaveForm(double npe, double time)
-double* crs_HitProcess::WaveForm(double npe, double* time)
+// Waveform of npe photoelectrons, see crs_waveform.h
+vector<double> crs_HitProcess::WaveForm(double npe, double* time)
 {
-    double c=exp(-2.);
-//    double Time;
-    double t; // time in usec
-    double WF;
-    double y;
-    double rr;
-    int it;
-    int Nch_digi=800; //Number of cjannel for the digitizer
-    static double WFsample[1000]; //Needs to be >  Nch_digi+size of the response to the single pe
-    double smp_t=4./1000. ;// Assuming fADC sampling at 250 MHz 1sample every 4ns
-
-    // double p[6] = {0.14,-3.5,2.5,-2.,0.5,-1.2};
-    double p[6] = {0.,0.680,0.64,3.34,0.36,0.};// Babar CsI paprameters: fast component(in us), % fast, slow comp(in us), % slow
-    // double p1[6] = {0.33,-0.04,3.45,-0.05,2.5,-0.045};
-
-    double tau=15.; // ampli response time constant (in ns)
-    double t0=0.01; // t0 starting time (in ns)
-    double area=(tau/c/2.);
-    double A=1./area; // amplitude at mnax (55.41 to have it normalized to integral=1, otherwise the max is at 1)
-//    double threshold=10.*1./area/smp_t/1000.; //time threshold in pe - 1/55.41/smp_t*1000. is the funct max -
-
-    
-    double t_spread= 1.*0.000;// pream time spread in us
-    double A_spread= 1.*0.05*A;// pream amp spread (in fraction of 1pe amplitude = A)
-    double func=0.;
-    // Building the waveform
-    for(unsigned int s=0; s<1000; s++)
-    {
-       WFsample[s]=0;
-    }
-    // Building the response to a single pe (preamps response)
-    double AmpWF[80];
-    for(unsigned int s=0; s<80; s++)
-    {t=1000.*s*smp_t;
-        // parametrization of preamp out time is in ns (rise ~10ns decay~80ns) sampled in 160ns or 40 samples
-        //func=1./411.5*((1-exp(p1[0]+p1[1]*t))*exp(p1[2]+p1[3]*t)+exp(p1[4]+p1[5]*t)));
-        func=(t-t0)*(t-t0)*exp(-(t-t0)/tau)*A/(4*tau*tau*c)*0.5*(abs(t-t0)/(t-t0)+1);
-        // spreading amplitude by apli noise
-         AmpWF[s]=smp_t*1000.*func;
-    }
-    
-    // fraction of pe in Nch_digi
-    double frac=1-((p[2]*exp(-smp_t*Nch_digi/p[1])+p[4]*exp(-smp_t*Nch_digi/p[3])));
-    int Npe = frac*npe;
-//    cout << "Npe  " << Npe<<"  "<<npe << endl;
-    
-    //Npe=1.;
-    //Npe=Npe/100.;
-    for(int s=1; s<=Npe; s++){
-     y=1.;
-     WF=0.;
-     while (y > WF) {
-       rr=(rand() % 1000000+1)/1000000.; // rnd number between 0-1
-       t= Nch_digi*smp_t*rr; // extracting over 5000 samples range (5000x4ns=20us)
-       //WF= 1./5.15*((1-exp(p[0]+p[1]*t))*exp(p[2]+p[3]*t)+exp(p[4]+p[5]*t));
-       WF= (p[2]/p[1]*exp(-t/p[1])+p[4]/p[3]*exp(-t/p[3]))/(p[2]/p[1]+p[4]/p[3]);
-       rr=(rand() % 10000000+1)/10000000.; // rnd number between 0-1
-       y=rr;
-       //  cout << "WF " << WF   << " rnd " << y  << endl;
-     }
-     // spreading time and amplitude of the ampli signal
-//        it=t/smp_t;
-//        cout << "t " << t << "it " << it        << endl;
-
-     t=G4RandGauss::shoot(t,t_spread);
-     if (t<0.) t=0.;
-     it=t/smp_t;
-//      cout << "t " << t << "it " << it        << endl;
-     for(int s=0; s<80; s++)
-      { t=1000.*s*smp_t;
-          func=AmpWF[s];
-          func=G4RandGauss::shoot(func,A_spread);
-          if((s+it)<Nch_digi) WFsample[s+it]=WFsample[s+it]+ func;
-      }
-     }
-    
-    //for(unsigned int s=0; s<200; s++) cout << s  << " " <<  WFsample[s] << endl ;
-
-        // mimicking a CF discriminatorm at 1/3 of the max signal
-    *time=0.;
-    double time_max=-100;
-    int s=0;
-    int s_time_max=0;
-    while (time_max<WFsample[s]){
-        time_max=1/2.*(WFsample[s+1]+WFsample[s]);
-        s_time_max=s;
-        *time=1000.*smp_t*s_time_max/3.;
-        s++;
-    }
-   // cout<<s_time_max<<"  "<< time_max<< "  "<<*time <<endl;
-    
-/* // mimicking a FixedT discriminatorm
-     for(unsigned int s=0; s<1000; s++)
-     {
-      //cout << s  << " " <<  WFsample[s] << endl ;
-         //look for the max
-         
-         if(WFsample[s]>threshold)
-         {*time=1000.*s*smp_t; //time in ns
-             break;
-         }
-    }
- */
-    
-    // get timing from digitized WF
-    
-    // cout <<  "routine " <<  WFsample[50] << endl ;
-    //cout << "Time  " << threshold<< "sample  "<<s<< "time  "<< *time << endl;
-
-    return WFsample;
-
+	return crsWaveForm(npe, time);
 }
 
 
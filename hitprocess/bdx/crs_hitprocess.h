@@ -4,6 +4,8 @@
 // gemc headers
 #include "HitProcess.h"
 
+#include "crs_waveform.h"
+
 // Class definition
 class crs_HitProcess : public HitProcess
 {
@@ -32,7 +34,9 @@ public:
 
 	double BirksAttenuation(double,double,int,double);
 	double BirksAttenuation2(double,double,int,double);
-	double* WaveForm(double,double*);
+
+	// waveform of the given number of pe; the second argument is filled with the discriminator time
+	vector<double> WaveForm(double,double*);
 
 	// - electronicNoise: returns a vector of hits generated / by electronics.
 	vector<MHit*> electronicNoise();
@@ -0,0 +1,115 @@
+// G4 headers
+#include "Randomize.hh"
+
+// gemc headers
+#include "crs_waveform.h"
+
+// C++ headers
+#include <cmath>
+#include <algorithm>
+using namespace std;
+
+
+// single photoelectron preamp response, sampled once at the fADC sampling
+// parametrization of preamp out time is in ns (rise ~10ns decay~80ns) sampled in 320ns or 80 samples
+vector<double> crsSinglePETemplate()
+{
+	double c     = exp(-2.);
+	double smp_t = 4./1000.;      // Assuming fADC sampling at 250 MHz 1sample every 4ns
+	double tau   = 15.;           // ampli response time constant (in ns)
+	double t0    = 0.01;          // t0 starting time (in ns)
+	double area  = (tau/c/2.);
+	double A     = 1./area;       // amplitude at max (55.41 to have it normalized to integral=1, otherwise the max is at 1)
+
+	vector<double> AmpWF(CRS_NSAMP_PE, 0.);
+	for(int s=0; s<CRS_NSAMP_PE; s++) {
+		double t = 1000.*s*smp_t;
+		if(t > t0) AmpWF[s] = smp_t*1000.*(t-t0)*(t-t0)*exp(-(t-t0)/tau)*A/(4*tau*tau*c);
+	}
+	return AmpWF;
+}
+
+// Waveform of npe photoelectrons, sampled at 250 MHz.
+// The photoelectrons arrival time follow the BaBar CsI two-component decay, truncated at the digitizer window:
+// each arrival time is sampled exactly by inverse CDF of the chosen component.
+// The single pe response is accumulated per arrival sample and convoluted once with the preamp template.
+// The amplitude spread of each pe (gaussian, A_spread) is added per sample as a single gaussian
+// with variance A_spread^2 times the number of pe contributing to that sample.
+// Uses the geant4 random engine.
+vector<double> crsWaveForm(double npe, double* time)
+{
+	static const vector<double> AmpWF = crsSinglePETemplate();
+
+	double c=exp(-2.);
+	int Nch_digi=CRS_NCH_DIGI;     // Number of channel for the digitizer
+	double smp_t=4./1000. ;        // Assuming fADC sampling at 250 MHz 1sample every 4ns
+
+	double p[6] = {0.,0.680,0.64,3.34,0.36,0.};// Babar CsI paprameters: fast component(in us), % fast, slow comp(in us), % slow
+
+	double tau=15.; // ampli response time constant (in ns)
+	double area=(tau/c/2.);
+	double A=1./area;
+
+	double t_spread= 1.*0.000;     // pream time spread in us
+	double A_spread= 1.*0.05*A;    // pream amp spread (in fraction of 1pe amplitude = A)
+
+	// Needs to be >  Nch_digi+size of the response to the single pe
+	vector<double> WFsample(CRS_NCH_WF, 0.);
+
+	// fraction of pe in Nch_digi
+	double window = smp_t*Nch_digi;
+	double frac=1-((p[2]*exp(-window/p[1])+p[4]*exp(-window/p[3])));
+	int Npe = frac*npe;
+
+	// truncated exponentials: probability of the fast component inside the window
+	double cdfFast  = 1 - exp(-window/p[1]);
+	double cdfSlow  = 1 - exp(-window/p[3]);
+	double probFast = p[2]*cdfFast / (p[2]*cdfFast + p[4]*cdfSlow);
+
+	// number of pe starting in each sample
+	vector<int> nInSample(Nch_digi, 0);
+	for(int s=0; s<Npe; s++) {
+		double t;
+		if(G4UniformRand() < probFast) t = -p[1]*log(1 - G4UniformRand()*cdfFast);
+		else                           t = -p[3]*log(1 - G4UniformRand()*cdfSlow);
+
+		// spreading time of the ampli signal
+		if(t_spread > 0) t = G4RandGauss::shoot(t, t_spread);
+		if(t < 0.) t = 0.;
+		int it = t/smp_t;
+		if(it < Nch_digi) nInSample[it]++;
+	}
+
+	// convolution with the single pe response
+	vector<int> nContributing(Nch_digi, 0);
+	for(int it=0; it<Nch_digi; it++) {
+		int n = nInSample[it];
+		if(n == 0) continue;
+		int last = min(CRS_NSAMP_PE, Nch_digi - it);
+		for(int s=0; s<last; s++) {
+			WFsample[s+it]     += n*AmpWF[s];
+			nContributing[s+it] += n;
+		}
+	}
+
+	// spreading amplitude by ampli noise
+	if(A_spread > 0) {
+		for(int s=0; s<Nch_digi; s++) {
+			if(nContributing[s]) WFsample[s] += G4RandGauss::shoot(0., A_spread*sqrt((double) nContributing[s]));
+		}
+	}
+
+	// mimicking a CF discriminatorm at 1/3 of the max signal
+	*time=0.;
+	double time_max=-100;
+	int s=0;
+	int s_time_max=0;
+	while (s < CRS_NCH_WF - 1 && time_max<WFsample[s]){
+		time_max=1/2.*(WFsample[s+1]+WFsample[s]);
+		s_time_max=s;
+		*time=1000.*smp_t*s_time_max/3.;
+		s++;
+	}
+
+	return WFsample;
+}
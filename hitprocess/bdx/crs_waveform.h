@@ -0,0 +1,22 @@
+#ifndef crs_WAVEFORM_H
+#define crs_WAVEFORM_H 1
+
+// Waveform synthesis of the BDX CsI crystals readout.
+// Kept outside of the hit process so that it can be checked by itself (see example.cc).
+
+// C++ headers
+#include <vector>
+using namespace std;
+
+// digitizer: number of fADC samples, size of the waveform buffer, samples of the single pe response
+#define CRS_NCH_DIGI 800
+#define CRS_NCH_WF   1000
+#define CRS_NSAMP_PE 80
+
+// single photoelectron preamp response, CRS_NSAMP_PE samples at 250 MHz
+vector<double> crsSinglePETemplate();
+
+// waveform of npe photoelectrons (CRS_NCH_WF samples at 250 MHz); time is filled with the discriminator time (ns)
+vector<double> crsWaveForm(double npe, double* time);
+
+#endif
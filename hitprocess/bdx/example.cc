@@ -0,0 +1,156 @@
+#include "crs_waveform.h"
+
+// G4 headers
+#include "Randomize.hh"
+
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+using namespace std;
+
+// Regression check of the crs waveform synthesis.
+// The waveform statistics (integral, peak, discriminator time and average shape) of crsWaveForm
+// are compared with the rejection sampling, per photoelectron implementation it replaced.
+//
+// Usage:
+//  example [nwaveforms]  : nwaveforms per number of pe (default 1000). Exits with 1 if the statistics disagree.
+
+// former crs_HitProcess::WaveForm, unchanged except for the returned buffer
+static vector<double> referenceWaveForm(double npe, double* time)
+{
+	double c=exp(-2.);
+	double t; // time in usec
+	double WF;
+	double y;
+	double rr;
+	int it;
+	int Nch_digi=800; //Number of cjannel for the digitizer
+	vector<double> WFsample(1000, 0.); //Needs to be >  Nch_digi+size of the response to the single pe
+	double smp_t=4./1000. ;// Assuming fADC sampling at 250 MHz 1sample every 4ns
+
+	double p[6] = {0.,0.680,0.64,3.34,0.36,0.};// Babar CsI paprameters: fast component(in us), % fast, slow comp(in us), % slow
+
+	double tau=15.; // ampli response time constant (in ns)
+	double t0=0.01; // t0 starting time (in ns)
+	double area=(tau/c/2.);
+	double A=1./area;
+
+	double t_spread= 1.*0.000;// pream time spread in us
+	double A_spread= 1.*0.05*A;// pream amp spread (in fraction of 1pe amplitude = A)
+	double func=0.;
+
+	// Building the response to a single pe (preamps response)
+	double AmpWF[80];
+	for(unsigned int s=0; s<80; s++)
+	{t=1000.*s*smp_t;
+		func=(t-t0)*(t-t0)*exp(-(t-t0)/tau)*A/(4*tau*tau*c)*0.5*(abs(t-t0)/(t-t0)+1);
+		AmpWF[s]=smp_t*1000.*func;
+	}
+
+	// fraction of pe in Nch_digi
+	double frac=1-((p[2]*exp(-smp_t*Nch_digi/p[1])+p[4]*exp(-smp_t*Nch_digi/p[3])));
+	int Npe = frac*npe;
+
+	for(int s=1; s<=Npe; s++){
+		y=1.;
+		WF=0.;
+		while (y > WF) {
+			rr=(rand() % 1000000+1)/1000000.; // rnd number between 0-1
+			t= Nch_digi*smp_t*rr;
+			WF= (p[2]/p[1]*exp(-t/p[1])+p[4]/p[3]*exp(-t/p[3]))/(p[2]/p[1]+p[4]/p[3]);
+			rr=(rand() % 10000000+1)/10000000.; // rnd number between 0-1
+			y=rr;
+		}
+		t=G4RandGauss::shoot(t,t_spread);
+		if (t<0.) t=0.;
+		it=t/smp_t;
+		for(int s=0; s<80; s++)
+		{
+			func=AmpWF[s];
+			func=G4RandGauss::shoot(func,A_spread);
+			if((s+it)<Nch_digi) WFsample[s+it]=WFsample[s+it]+ func;
+		}
+	}
+
+	// mimicking a CF discriminatorm at 1/3 of the max signal
+	*time=0.;
+	double time_max=-100;
+	int s=0;
+	int s_time_max=0;
+	while (s < 999 && time_max<WFsample[s]){
+		time_max=1/2.*(WFsample[s+1]+WFsample[s]);
+		s_time_max=s;
+		*time=1000.*smp_t*s_time_max/3.;
+		s++;
+	}
+
+	return WFsample;
+}
+
+// mean and variance accumulator
+class stat
+{
+public:
+	stat() : n(0), sum(0), sum2(0) {;}
+	void fill(double x) {n++; sum += x; sum2 += x*x;}
+	double mean()  const {return sum/n;}
+	double error() const {return n > 1 ? sqrt(max(sum2/n - mean()*mean(), 0.)/(n - 1)) : 0;}
+	long n;
+	double sum, sum2;
+};
+
+// integral, peak, discriminator time and average shape in 8 slices of 100 samples
+#define NSTATS 11
+static void fillStats(const vector<double> &wf, double time, stat *stats)
+{
+	double integral = 0, peak = 0;
+	double slice[8] = {0};
+	for(int s=0; s<CRS_NCH_DIGI; s++) {
+		integral += wf[s];
+		peak = max(peak, wf[s]);
+		slice[s/100] += wf[s];
+	}
+	stats[0].fill(integral);
+	stats[1].fill(peak);
+	stats[2].fill(time);
+	for(int i=0; i<8; i++) stats[3+i].fill(slice[i]);
+}
+
+int main(int argn, char** argv)
+{
+	int nwaveforms = argn > 1 ? atoi(argv[1]) : 1000;
+	const char *names[NSTATS] = {"integral", "peak", "time", "slice 0", "slice 1", "slice 2", "slice 3",
+	                             "slice 4", "slice 5", "slice 6", "slice 7"};
+
+	srand(1);
+	double npes[] = {5, 50, 500, 5000};
+	int bad = 0;
+
+	for(auto npe: npes) {
+		stat ref[NSTATS], now[NSTATS];
+		for(int w=0; w<nwaveforms; w++) {
+			double time;
+			vector<double> wf = referenceWaveForm(npe, &time);
+			fillStats(wf, time, ref);
+			wf = crsWaveForm(npe, &time);
+			fillStats(wf, time, now);
+		}
+
+		cout << " npe: " << npe << endl;
+		for(int i=0; i<NSTATS; i++) {
+			double sigma = sqrt(ref[i].error()*ref[i].error() + now[i].error()*now[i].error());
+			double pull  = sigma > 0 ? (now[i].mean() - ref[i].mean())/sigma : 0;
+			bool ok = fabs(pull) < 5 || (sigma == 0 && now[i].mean() == ref[i].mean());
+			if(!ok) bad++;
+			cout << "   " << names[i] << ": reference " << ref[i].mean() << " +- " << ref[i].error()
+			     << ", now " << now[i].mean() << " +- " << now[i].error() << ", pull " << pull << (ok ? "" : "  <<< DISAGREE") << endl;
+		}
+	}
+
+	if(bad) {
+		cout << " " << bad << " waveform statistics disagree with the reference implementation." << endl;
+		return 1;
+	}
+	cout << " Waveform statistics agree with the reference implementation." << endl;
+	return 0;
+}
@@ -0,0 +1,41 @@
+// gemc headers
+#include "erf_table.h"
+
+// c++
+#include <cmath>
+
+const vector<double>& erfTable::table()
+{
+	// function static: built once, thread safe initialization
+	static const vector<double> values = [] {
+		vector<double> v(2*ERFT_NBINS + 2);
+		double step = ERFT_XMAX/ERFT_NBINS;
+		for(unsigned i=0; i<v.size(); i++)
+			v[i] = std::erf(-ERFT_XMAX + i*step);
+		return v;
+	}();
+
+	return values;
+}
+
+double erfTable::erf(double x)
+{
+	if(x >=  ERFT_XMAX) return  1;
+	if(x <= -ERFT_XMAX) return -1;
+	if(x != x)          return  x;  // nan
+
+	static const double invStep = ERFT_NBINS/ERFT_XMAX;
+	const vector<double>& v = table();
+
+	double u = (x + ERFT_XMAX)*invStep;
+	int    i = (int) u;
+	double f = u - i;
+
+	return v[i] + f*(v[i+1] - v[i]);
+}
+
+double erfTable::gaussFraction(double xmin, double xmax, double x0, double sigma)
+{
+	double norm = 1/(sigma*M_SQRT2);
+	return (erf((xmax - x0)*norm) - erf((xmin - x0)*norm))/2.;
+}
@@ -0,0 +1,32 @@
+#ifndef erf_table_H
+#define erf_table_H 1
+
+// c++
+#include <vector>
+using namespace std;
+
+#define ERFT_XMAX  6.0
+#define ERFT_NBINS 6000
+
+/// \class erfTable
+/// <b> erfTable </b>\n\n
+/// Tabulated error function with linear interpolation.\n
+/// Used by the strip charge sharing kernels of the silicon and micromegas digitization,
+/// where the gaussian fraction collected by each strip is evaluated for every step and candidate strip.\n
+/// The table is built once, on first use. Beyond |x| = ERFT_XMAX the function returns +/-1.\n
+/// The maximum deviation from std::erf is below 1e-6.
+class erfTable
+{
+public:
+
+	// tabulated erf(x)
+	static double erf(double x);
+
+	// fraction of a gaussian of width sigma centered at x0 falling in [xmin, xmax]
+	static double gaussFraction(double xmin, double xmax, double x0, double sigma);
+
+private:
+	static const vector<double>& table();
+};
+
+#endif
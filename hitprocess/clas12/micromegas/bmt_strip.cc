@@ -1,5 +1,6 @@
 // gemc headers
 #include "bmt_strip.h"
+#include "erf_table.h"
 #include "Randomize.hh"
 
 // c++ headers
@@ -17,9 +18,10 @@
 // Removed the loop over the number of electrons
 // M. Ungaro (Jun 14 2019)
 // Added target position 
+// Constants passed by reference, strip weights from the tabulated erf (erf_table.h)
 
 // the routine to find the strip
-vector<double> bmt_strip::FindStrip(int layer, int sector, G4ThreeVector xyz, double Edep, bmtConstants bmtc)
+vector<double> bmt_strip::FindStrip(int layer, int sector, G4ThreeVector xyz, double Edep, const bmtConstants &bmtc)
 {
 	double x = xyz.x()/mm;
 	double y = xyz.y()/mm;
@@ -112,7 +114,7 @@ vector<double> bmt_strip::FindStrip(int layer, int sector, G4ThreeVector xyz, do
 // param y y-coordinate of the hit in the lab frame
 // return the sigma in the azimuth direction taking the Lorentz angle into account
 //
-double bmt_strip::getSigma(int layer, double x, double y,  bmtConstants bmtc)
+double bmt_strip::getSigma(int layer, double x, double y,  const bmtConstants &bmtc)
 { // sigma for Z-detectors
 
 	double sigma = bmtc.SigmaDrift*(sqrt(x*x+y*y) - bmtc.RADIUS[layer-1])/cos(bmtc.ThetaL);
@@ -121,7 +123,7 @@ double bmt_strip::getSigma(int layer, double x, double y,  bmtConstants bmtc)
 
 }
 
-int bmt_strip::getClosestStrip(int layer, int sector, double angle, double z, bmtConstants bmtc){
+int bmt_strip::getClosestStrip(int layer, int sector, double angle, double z, const bmtConstants &bmtc){
 	double var=0;
 	double var_min=0;
 	double var_max=0; //var=z if it is a C detector, var=angle if Z detector
@@ -163,7 +165,7 @@ int bmt_strip::getClosestStrip(int layer, int sector, double angle, double z, bm
 }
 
 // Return the group of equally separated strips in which the strip is
-int bmt_strip::getStripGroup(int layer, int strip, bmtConstants bmtc){
+int bmt_strip::getStripGroup(int layer, int strip, const bmtConstants &bmtc){
 	int group=0; //Z is always one group
 	int total_strip=bmtc.GROUP[layer-1][group];
 	while (strip>total_strip){
@@ -179,7 +181,7 @@ int bmt_strip::getStripGroup(int layer, int strip, bmtConstants bmtc){
 //
 // WARNING: This routine is not used?
 //
-double bmt_strip::GetStripInfo(int layer, int sector, int strip, bmtConstants bmtc)
+double bmt_strip::GetStripInfo(int layer, int sector, int strip, const bmtConstants &bmtc)
 {
 	int num_strip = strip - 1;     			// index of the strip (starts at 0)
 	double var=0.;
@@ -207,7 +209,7 @@ double bmt_strip::GetStripInfo(int layer, int sector, int strip, bmtConstants bm
 
 
 // not used yet (implemented for alternate algorithm not yet fully developed)
-int bmt_strip::isInSector(int layer, double angle, bmtConstants bmtc)
+int bmt_strip::isInSector(int layer, double angle, const bmtConstants &bmtc)
 {
 	if(angle<0)
 	angle+=2*pi; // from 0 to 2Pi
@@ -228,7 +230,7 @@ int bmt_strip::isInSector(int layer, double angle, bmtConstants bmtc)
 	return num_detector;
 }
 
-double bmt_strip::Weight_td(int layer, int sector, int strip, double angle, double z, bmtConstants bmtc){
+double bmt_strip::Weight_td(int layer, int sector, int strip, double angle, double z, const bmtConstants &bmtc){
 	double wght=0;
 	int group=getStripGroup(layer, strip, bmtc);
 	if(angle<0) angle+=2*pi; // from 0 to 2Pi
@@ -245,7 +247,7 @@ double bmt_strip::Weight_td(int layer, int sector, int strip, double angle, doub
 		double strip_phi=angle_i+(strip-0.5)*bmtc.PITCH[layer-1][0];
 		double strip_z=(bmtc.ZMIN[layer-1]+bmtc.ZMAX[layer-1])/2.;
 		double strip_length=bmtc.ZMAX[layer-1]-bmtc.ZMIN[layer-1];
-		wght=(erf((strip_phi+bmtc.PITCH[layer-1][0]/2.-angle)/sigma_phi/sqrt(2))-erf((strip_phi-bmtc.PITCH[layer-1][0]/2.-angle)/sigma_phi/sqrt(2)))*(erf((strip_z+strip_length/2.-z)/sigma/sqrt(2))-erf((strip_z-strip_length/2.-z)/sigma/sqrt(2)))/2./2.;
+		wght=erfTable::gaussFraction(strip_phi-bmtc.PITCH[layer-1][0]/2., strip_phi+bmtc.PITCH[layer-1][0]/2., angle, sigma_phi)*erfTable::gaussFraction(strip_z-strip_length/2., strip_z+strip_length/2., z, sigma);
 	}
 	if(bmtc.AXIS[layer-1]==0){ // if it is a C-detector
 		double strip_phi=(angle_i+angle_f)/2.;
@@ -257,7 +259,7 @@ double bmt_strip::Weight_td(int layer, int sector, int strip, double angle, doub
 		}
 		strip_z+=(strip-strip_offset-0.5)*bmtc.PITCH[layer-1][group];
 		double strip_length=bmtc.EDGE2[layer-1]-bmtc.EDGE1[layer-1];
-		wght=(erf((strip_z+bmtc.PITCH[layer-1][group]/2.-z)/sigma/sqrt(2))-erf((strip_z-bmtc.PITCH[layer-1][group]/2.-z)/sigma/sqrt(2)))*(erf((strip_phi+strip_length/2.-angle)/sigma_phi/sqrt(2))-erf((strip_phi-strip_length/2.-angle)/sigma_phi/sqrt(2)))/2./2.;
+		wght=erfTable::gaussFraction(strip_z-bmtc.PITCH[layer-1][group]/2., strip_z+bmtc.PITCH[layer-1][group]/2., z, sigma)*erfTable::gaussFraction(strip_phi-strip_length/2., strip_phi+strip_length/2., angle, sigma_phi);
 	}
 	if (wght<0) wght=-wght;
 	return wght;
@@ -85,14 +85,14 @@ public:
   double sigma; // Transverse diffusion value computed from SigmaDrift
   double sigma_phi; // sigma/radius of the tile... for Z-detector 
   
-  vector<double> FindStrip( int layer, int sector, G4ThreeVector xyz, double Edep, bmtConstants bmtc);   // Strip Finding Routine
+  vector<double> FindStrip( int layer, int sector, G4ThreeVector xyz, double Edep, const bmtConstants &bmtc);   // Strip Finding Routine
     
-  double getSigma( int layer, double x, double y, bmtConstants bmtc);     // sigma for C-detector
-  int getClosestStrip( int layer, int sector, double angle, double z,bmtConstants bmtc);
-  int getStripGroup(int layer, int strip, bmtConstants bmtc);
-  double GetStripInfo(int layer, int sector, int strip, bmtConstants bmtc); 				   // the z position of a given C strip. Not used?
-  int isInSector(int layer, double angle, bmtConstants bmtc);
-  double Weight_td(int layer, int sector, int strip, double angle, double z, bmtConstants bmtc); //Compute the likelihood to get an electron
+  double getSigma( int layer, double x, double y, const bmtConstants &bmtc);     // sigma for C-detector
+  int getClosestStrip( int layer, int sector, double angle, double z,const bmtConstants &bmtc);
+  int getStripGroup(int layer, int strip, const bmtConstants &bmtc);
+  double GetStripInfo(int layer, int sector, int strip, const bmtConstants &bmtc); 				   // the z position of a given C strip. Not used?
+  int isInSector(int layer, double angle, const bmtConstants &bmtc);
+  double Weight_td(int layer, int sector, int strip, double angle, double z, const bmtConstants &bmtc); //Compute the likelihood to get an electron
   double GetBinomial(double n, double p); //Compute the number of electrons collected following the likelihood from Weight_td
 };
 
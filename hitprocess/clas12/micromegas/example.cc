@@ -2,53 +2,173 @@
 #include "bmt_strip.h"
 
 #include <iostream>
+#include <cstdlib>
+#include <ctime>
 using namespace std;
 
-int main(int argn, char** argv) {
- if(argn != 7)
- {
-	 cout << endl << " Wrong mumber of arguments. Usage: example layer sector x y z BMT" << endl << endl;
-	 exit(0);
- }
-
- int layer  = atoi(argv[1]);
- int sector = atoi(argv[2]);
- double x   = atof(argv[3]);
- double y   = atof(argv[4]);
- double z   = atof(argv[5]);
- string D = argv[6];
-
- double X,Y,Z;
-
- int Strip;
-
- if(D == "FMT")
- {
-	 class fmt_strip fmts;
-	 fmts.fill_infos();
-	 X = x;
-	 Y = y;
-	 Z = z;
-	 Strip = fmts.FindStrip(layer, sector, X, Y, Z);
- }
-
- if(D == "BMT")
- {
-	 class bmt_strip bmts;
-	 bmts.fill_infos();
-	 X = x;
-	 Y = y;
-	 Z = z;
-	 Strip = bmts.FindStrip(layer, sector, X, Y, Z);
- }
-
-
- cout << D << ": ";
- cout << " x = " << X << " " ;
- cout << " y = " << Y << " " ;
- cout << " z = " << Z << " " ;
- cout << " Strip = " << Strip << endl;
-
- return 1;
-	
+// Micromegas strip finding and charge sharing benchmark.
+// The constants are nominal values (normally read from CCDB in the hit process routines).
+//
+// Usage: example FMT|BMT nhits
+
+static fmtConstants nominalFMTConstants()
+{
+	fmtConstants fmtc;
+
+	fmtc.hDrift     = 5.0;
+	fmtc.pitch      = 0.525;
+	fmtc.R_min      = 25.0;
+	fmtc.N_str      = 1024;
+	fmtc.N_halfstr  = 320;
+	fmtc.SigmaDrift = 0.01;
+	fmtc.w_i        = 25.0;
+	fmtc.N_sidestr  = (fmtc.N_str-2*fmtc.N_halfstr)/2;
+	fmtc.y_central  = fmtc.N_halfstr*fmtc.pitch/2.;
+	fmtc.nb_sigma   = 4;
+	fmtc.R_max      = fmtc.pitch*(fmtc.N_halfstr+2*fmtc.N_sidestr)/2.;
+	fmtc.ThetaL     = 0;
+	fmtc.Theta_Ls   = 0;
+
+	for(int i=0; i<fmtc.NLAYERS; i++)
+	{
+		fmtc.Z0.push_back(300 + 11.9*i);
+		fmtc.alpha.push_back(i*60*degree);
+		fmtc.HV_DRIFT[i]      = 600;
+		fmtc.HV_STRIPS_IN[i]  = 520;
+		fmtc.HV_STRIPS_OUT[i] = 520;
+	}
+
+	return fmtc;
+}
+
+static bmtConstants nominalBMTConstants()
+{
+	bmtConstants bmtc;
+
+	double radius[6] = {146.4, 161.4, 176.4, 191.4, 206.4, 221.4};
+	int    axis[6]   = {0, 1, 1, 0, 1, 0};
+	double pitch     = 0.5;
+
+	bmtc.GROUP.resize(bmtc.NLAYERS);
+	bmtc.PITCH.resize(bmtc.NLAYERS);
+	for(int l=0; l<bmtc.NLAYERS; l++)
+	{
+		bmtc.RADIUS[l] = radius[l];
+		bmtc.AXIS[l]   = axis[l];
+		bmtc.ZMIN[l]   = -127.;
+		bmtc.ZMAX[l]   = 297.;
+
+		for(int s=0; s<bmtc.NSECTORS; s++)
+		{
+			bmtc.EDGE1[l][s] = (-50 + 120*s)*degree;
+			bmtc.EDGE2[l][s] = ( 50 + 120*s)*degree;
+			bmtc.HV_DRIFT[l][s]  = axis[l] ? 1800 : 1500;
+			bmtc.HV_STRIPS[l][s] = 520;
+		}
+
+		// Z detectors: angular pitch, C detectors: one group of strips of constant pitch
+		if(axis[l] == 1)
+		{
+			bmtc.PITCH[l].push_back(pitch/radius[l]);
+			bmtc.NSTRIPS[l] = 100*degree/bmtc.PITCH[l][0];
+		}
+		else
+		{
+			bmtc.PITCH[l].push_back(pitch);
+			bmtc.NSTRIPS[l] = (bmtc.ZMAX[l] - bmtc.ZMIN[l])/pitch;
+		}
+		bmtc.GROUP[l].push_back(bmtc.NSTRIPS[l]);
+
+		// getClosestStrip / Weight_td for C detectors refer to the smallest pitch group
+		while(bmtc.PITCH[l].size() < 6)
+		{
+			bmtc.PITCH[l].push_back(bmtc.PITCH[l][0]);
+			bmtc.GROUP[l].push_back(0);
+		}
+	}
+
+	bmtc.hDrift     = 3.0;
+	bmtc.SigmaDrift = 0.036;
+	bmtc.hStrip2Det = bmtc.hDrift/2.;
+	bmtc.nb_sigma   = 4;
+	bmtc.ThetaL     = 0;
+	bmtc.Theta_Ls_Z = 0;
+	bmtc.Theta_Ls_C = 0;
+	bmtc.targetZPos = 0;
+
+	return bmtc;
+}
+
+int main(int argn, char** argv)
+{
+	if(argn != 3)
+	{
+		cout << endl << " Wrong mumber of arguments. Usage: example FMT|BMT nhits" << endl << endl;
+		exit(0);
+	}
+
+	string D  = argv[1];
+	int nhits = atoi(argv[2]);
+
+	double checksum = 0;
+	double elapsed  = 0;
+	srand(1);
+
+	if(D == "FMT")
+	{
+		fmtConstants fmtc = nominalFMTConstants();
+		class fmt_strip fmts;
+
+		vector<double> x(nhits), y(nhits), z(nhits);
+		vector<int> layer(nhits);
+		for(int h=0; h<nhits; h++)
+		{
+			double r   = fmtc.R_min + (fmtc.R_max - fmtc.R_min)*rand()/RAND_MAX;
+			double phi = 2*pi*rand()/RAND_MAX;
+			layer[h]   = rand()%fmtc.NLAYERS;
+			x[h] = r*cos(phi);
+			y[h] = r*sin(phi);
+			z[h] = fmtc.Z0[layer[h]] + fmtc.hDrift*rand()/RAND_MAX;
+		}
+
+		clock_t start = clock();
+		for(int h=0; h<nhits; h++)
+		{
+			vector<double> strips = fmts.FindStrip(layer[h], 0, x[h], y[h], z[h], 50e-6, fmtc);
+			checksum += strips[0];
+		}
+		elapsed = double(clock() - start)/CLOCKS_PER_SEC;
+	}
+
+	if(D == "BMT")
+	{
+		bmtConstants bmtc = nominalBMTConstants();
+		class bmt_strip bmts;
+
+		vector<G4ThreeVector> xyz(nhits);
+		vector<int> layer(nhits);
+		for(int h=0; h<nhits; h++)
+		{
+			layer[h]   = rand()%bmtc.NLAYERS + 1;
+			double r   = bmtc.RADIUS[layer[h]-1] + bmtc.hDrift*rand()/RAND_MAX;
+			double phi = 2*pi*rand()/RAND_MAX;
+			double z   = bmtc.ZMIN[0] + (bmtc.ZMAX[0] - bmtc.ZMIN[0])*rand()/RAND_MAX;
+			xyz[h] = G4ThreeVector(r*cos(phi), r*sin(phi), z);
+		}
+
+		clock_t start = clock();
+		for(int h=0; h<nhits; h++)
+		{
+			int sector = bmts.isInSector(layer[h], xyz[h].phi(), bmtc) + 1;
+			if(sector == 0) continue;
+			vector<double> strips = bmts.FindStrip(layer[h], sector, xyz[h], 50e-6, bmtc);
+			checksum += strips[0];
+		}
+		elapsed = double(clock() - start)/CLOCKS_PER_SEC;
+	}
+
+	cout << " " << D << ": " << nhits << " hits in " << elapsed << " s: " << nhits/elapsed << " hits/s" ;
+	cout << "  (strip checksum: " << checksum << ")" << endl;
+
+	return 0;
 }
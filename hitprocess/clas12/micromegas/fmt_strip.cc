@@ -1,10 +1,11 @@
 // gemc headers
 #include "fmt_strip.h"
+#include "erf_table.h"
 #include "Randomize.hh"
 #include <iostream>
 #include <cmath>
 
-vector<double> fmt_strip::FindStrip(int layer, int sector, double x, double y, double z, double Edep, fmtConstants fmtc)
+vector<double> fmt_strip::FindStrip(int layer, int sector, double x, double y, double z, double Edep, const fmtConstants &fmtc)
 {
 	
 	// the return vector is always in pairs.
@@ -114,7 +115,7 @@ vector<double> fmt_strip::FindStrip(int layer, int sector, double x, double y, d
 	return strip_id;
 }
 
-void fmt_strip::Carac_strip(int strip, fmtConstants fmtc){
+void fmt_strip::Carac_strip(int strip, const fmtConstants &fmtc){
 	if (strip<=fmtc.N_str/2){
 		strip_y=fmtc.y_central-(strip-0.5)*fmtc.pitch;
 	}
@@ -148,9 +149,9 @@ void fmt_strip::Carac_strip(int strip, fmtConstants fmtc){
 }
 
 
-double fmt_strip::Weight_td(int strip, double x, double y, double z, fmtConstants fmtc){
+double fmt_strip::Weight_td(int strip, double x, double y, double z, const fmtConstants &fmtc){
 	Carac_strip(strip,fmtc);
-	double wght=(erf((strip_y+fmtc.pitch/2.-y)/sigma_td/sqrt(2))-erf((strip_y-fmtc.pitch/2.-y)/sigma_td/sqrt(2)))*(erf((strip_x+strip_length/2.-x)/sigma_td/sqrt(2))-erf((strip_x-strip_length/2.-x)/sigma_td/sqrt(2)))/2./2.;
+	double wght=erfTable::gaussFraction(strip_y-fmtc.pitch/2., strip_y+fmtc.pitch/2., y, sigma_td)*erfTable::gaussFraction(strip_x-strip_length/2., strip_x+strip_length/2., x, sigma_td);
 	if (wght<0) wght=-wght;
 	return wght;
 }
@@ -1,5 +1,5 @@
 #include "rtpc_hitprocess.h"
-#include <math.h>
+#include <cmath>
 #include <random>
 
 // G4 Headers
@@ -10,123 +10,198 @@
 using namespace CLHEP;
 
 
+static const double PI=3.1415926535;
+
+// diffusions at r: the variances are quadratic in (7-r), sigma = sqrt(variance)
+// is evaluated directly since its slope is infinite at r = 7 cm
+// r in cm. Output order: t_diff, phi_diff, z_diff in drift[1], drift[3], drift[4]
+static void rtpcDiffusion(const rtpcConstants &rc, double r, double *drift)
+{
+	double d = 7.0 - r;
+
+	drift[1] = sqrt(rc.c_t*d   + rc.d_t*d*d);
+	drift[3] = sqrt(rc.c_phi*d + rc.d_phi*d*d);
+	drift[4] = sqrt(rc.a_z*d   + rc.b_z*d*d);
+}
+
+// drift time, drift angle and their diffusions at (z, r) from the parametrization
+// z, r in cm. Output order: t_drift, t_diff, phi_drift, phi_diff, z_diff
+static void rtpcDriftParametrization(const rtpcConstants &rc, double z, double r, double *drift)
+{
+	double a_t   = (((rc.a_t[0]*z   + rc.a_t[1])*z   + rc.a_t[2])*z   + rc.a_t[3])*z   + rc.a_t[4];
+	double b_t   = (((rc.b_t[0]*z   + rc.b_t[1])*z   + rc.b_t[2])*z   + rc.b_t[3])*z   + rc.b_t[4];
+	double a_phi = (((rc.a_phi[0]*z + rc.a_phi[1])*z + rc.a_phi[2])*z + rc.a_phi[3])*z + rc.a_phi[4];
+	double b_phi = (((rc.b_phi[0]*z + rc.b_phi[1])*z + rc.b_phi[2])*z + rc.b_phi[3])*z + rc.b_phi[4];
+
+	double d = 7.0 - r;
+
+	drift[0] = a_t*d + b_t*d*d;
+	drift[2] = a_phi*d + b_phi*d*d;
+	rtpcDiffusion(rc, r, drift);
+}
+
+// drift time and drift angle at (z, r): bilinear interpolation of the lookup table
+// (largest errors: 0.04 ns and 4e-6 rad), diffusions from rtpcDiffusion
+static void rtpcDrift(const rtpcConstants &rc, double z, double r, double *drift)
+{
+	if(z < rc.zmin || z > rc.zmax || r < rc.rmin || r > rc.rmax) {
+		rtpcDriftParametrization(rc, z, r, drift);
+		return;
+	}
+
+	double u = (z - rc.zmin)/rc.dz;
+	double v = (r - rc.rmin)/rc.dr;
+	int iz = min((int) u, rc.nz - 2);
+	int ir = min((int) v, rc.nr - 2);
+	double fz = u - iz;
+	double fr = v - ir;
+
+	int i00 = iz*rc.nr + ir;
+	int i10 = i00 + rc.nr;
+
+	drift[0] = (1-fz)*((1-fr)*rc.t_drift[i00]   + fr*rc.t_drift[i00+1])   + fz*((1-fr)*rc.t_drift[i10]   + fr*rc.t_drift[i10+1]);
+	drift[2] = (1-fz)*((1-fr)*rc.phi_drift[i00] + fr*rc.phi_drift[i00+1]) + fz*((1-fr)*rc.phi_drift[i10] + fr*rc.phi_drift[i10+1]);
+	rtpcDiffusion(rc, r, drift);
+}
+
+static rtpcConstants initializeRTPCConstants(int runno)
+{
+	rtpcConstants rtpcc;
+
+	// the constants do not depend on the run number: they are set before the first event.
+	// runNo stays -1 until initWithRunNumber is called with the run number
+	rtpcc.runNo = runno;
+
+	// Establish constants
+	rtpcc.PAD_W  = 2.79;
+	rtpcc.PAD_L  = 4.0;
+	rtpcc.PAD_S  = 80.0;
+	rtpcc.RTPC_L = 384.0;
+	rtpcc.phi_per_pad = (2.0*PI)/180;
+
+	// Drift time from first GEM to readout pad
+	double t_2GEM2 = 296.082;
+	double sigma_t_2GEM2 = 8.72728;
+	double t_2GEM3 = 296.131;
+	double sigma_t_2GEM3 = 6.77807;
+	double t_2PAD = 399.09;
+	double sigma_t_2PAD = 7.58056;
+
+	double phi_2GEM2 = 0.0492538;
+	double sigma_phi_2GEM2 = 0.00384579;
+	double phi_2GEM3 = 0.0470817;
+	double sigma_phi_2GEM3 = 0.00234478;
+	double phi_2PAD = 0.0612122;
+	double sigma_phi_2PAD = 0.00238653;
+
+	// parameters to change for gas mixture and potential
+	// gas mixture = He:CO2 at 80:20
+	// potential = 3500V
+
+	// --------- May 2019 B-field parameters ----------- //
+	double a_t[5]   = {-2.34637e-04,  1.12685e-03, -8.73537e-03, -3.73064e-01,  1.83874e+03};
+	double b_t[5]   = { 1.71487e-05, -3.92849e-04, -2.87046e-03,  1.26281e-01, -1.32689e+02};
+	double a_phi[5] = {-1.75851e-08,  2.98814e-07, -8.84479e-07, -7.87568e-05,  1.75647e-01};
+	double b_phi[5] = {-5.99407e-09, -8.21323e-08,  2.61592e-07,  2.81728e-05,  2.24182e-02};
+
+	// Diffusion parameters
+	rtpcc.c_t = 388.7449859;
+	rtpcc.d_t = -4.33E+01;
+
+	rtpcc.c_phi = 6.00E-06;
+	rtpcc.d_phi = 2.00E-06;
+
+	rtpcc.a_z = 0.035972097;
+	rtpcc.b_z = -0.000739386;
+
+	rtpcc.t_2END = t_2GEM2 + t_2GEM3 + t_2PAD;
+	rtpcc.sigma_t_gap = sqrt(pow(sigma_t_2GEM2,2)+pow(sigma_t_2GEM3,2)+pow(sigma_t_2PAD,2));
+	rtpcc.phi_2END = phi_2GEM2 + phi_2GEM3 + phi_2PAD;
+	rtpcc.sigma_phi_gap = sqrt(pow(sigma_phi_2GEM2,2)+pow(sigma_phi_2GEM3,2)+pow(sigma_phi_2PAD,2));
+	// ----------------------------------------- //
+
+	// ------------ B=0 T Parameters ------------//
+	// a_t   = {0, 0, 0, 0,  6.96387e+02}
+	// b_t   = {0, 0, 0, 0, -4.73759e+01}
+	// a_phi = b_phi = 0
+	// c_t = d_t = c_phi = d_phi = a_z = b_z = 0
+	// t_2END = 500.0, sigma_t_gap = phi_2END = sigma_phi_gap = 0
+	// ------------------------------------------//
+
+	for(int i=0; i<5; i++) {
+		rtpcc.a_t[i]   = a_t[i];
+		rtpcc.b_t[i]   = b_t[i];
+		rtpcc.a_phi[i] = a_phi[i];
+		rtpcc.b_phi[i] = b_phi[i];
+	}
+
+	rtpcc.TPC_TZERO = 0.0;
+
+	// lookup tables, in cm: full drift length and drift region between 3 and 7 cm
+	rtpcc.zmin = -rtpcc.RTPC_L/20.0;
+	rtpcc.zmax =  rtpcc.RTPC_L/20.0;
+	rtpcc.dz   = 0.2;
+	rtpcc.rmin = 3.0;
+	rtpcc.rmax = 7.0;
+	rtpcc.dr   = 0.025;
+	rtpcc.nz   = (int) round((rtpcc.zmax - rtpcc.zmin)/rtpcc.dz) + 1;
+	rtpcc.nr   = (int) round((rtpcc.rmax - rtpcc.rmin)/rtpcc.dr) + 1;
+
+	rtpcc.t_drift.resize(rtpcc.nz*rtpcc.nr);
+	rtpcc.phi_drift.resize(rtpcc.nz*rtpcc.nr);
+
+	double drift[5];
+	for(int iz=0; iz<rtpcc.nz; iz++) {
+		for(int ir=0; ir<rtpcc.nr; ir++) {
+			rtpcDriftParametrization(rtpcc, rtpcc.zmin + iz*rtpcc.dz, rtpcc.rmin + ir*rtpcc.dr, drift);
+			rtpcc.t_drift[iz*rtpcc.nr + ir]   = drift[0];
+			rtpcc.phi_drift[iz*rtpcc.nr + ir] = drift[2];
+		}
+	}
+
+	return rtpcc;
+}
+
+static rtpcIDConstants initializeRTPCIDConstants()
+{
+	rtpcIDConstants rtpcidc;
+
+	// Establish constants
+	rtpcidc.PAD_W  = 2.79;
+	rtpcidc.PAD_L  = 4.0;
+	rtpcidc.PAD_S  = 80.0;
+	rtpcidc.RTPC_L = 384.0;
+	rtpcidc.phi_per_pad = rtpcidc.PAD_W/rtpcidc.PAD_S;
+
+	// parameters to change for gas mixture and potential
+	// gas mixture = He:CO2 at 80:20
+	// potential = 3500V
+	rtpcidc.a_phi = 0.161689123;
+	rtpcidc.b_phi = 0.023505021;
+	rtpcidc.c_phi = 6.00E-06;
+	rtpcidc.d_phi = 2.00E-06;
+
+	rtpcidc.a_z = 0.035972097;
+	rtpcidc.b_z = -0.000739386;
+
+	rtpcidc.phi_2GEM2 = 0.0492538;
+	rtpcidc.sigma_phi_2GEM2 = 0.00384579;
+	rtpcidc.phi_2GEM3 = 0.0470817;
+	rtpcidc.sigma_phi_2GEM3 = 0.00234478;
+	rtpcidc.phi_2PAD = 0.0612122;
+	rtpcidc.sigma_phi_2PAD = 0.00238653;
+	rtpcidc.phi_2END = rtpcidc.phi_2GEM2 + rtpcidc.phi_2GEM3 + rtpcidc.phi_2PAD;
+	rtpcidc.sigma_phi_gap = sqrt(pow(rtpcidc.sigma_phi_2GEM2,2)+pow(rtpcidc.sigma_phi_2GEM3,2)+pow(rtpcidc.sigma_phi_2PAD,2));
+
+	return rtpcidc;
+}
+
+
 map<string, double> rtpc_HitProcess :: integrateDgt(MHit* aHit, int hitn)
 {
-    static const double PI=3.1415926535;
-    
-    // Establish constants
-    PAD_W =2.79;
-    PAD_L = 4.0;
-    PAD_S = 80.0;
-    RTPC_L = 384.0;
-    phi_per_pad=(2.0*PI)/180;
-    
-    // Drift time from first GEM to readout pad
-    t_2GEM2 = 296.082;
-    sigma_t_2GEM2 = 8.72728;
-    t_2GEM3 = 296.131;
-    sigma_t_2GEM3 = 6.77807;
-    t_2PAD = 399.09;
-    sigma_t_2PAD = 7.58056;
-    
-    phi_2GEM2 = 0.0492538;
-    sigma_phi_2GEM2 = 0.00384579;
-    phi_2GEM3 = 0.0470817;
-    sigma_phi_2GEM3 = 0.00234478;
-    phi_2PAD = 0.0612122;
-    sigma_phi_2PAD = 0.00238653;
-    
-    // parameters to change for gas mixture and potential
-    // gas mixture = He:CO2 at 80:20
-    // potential = 3500V
-    
-    // --------- May 2019 B-field parameters ----------- //
-    double a_t1 = -2.34637e-04;
-    double a_t2 = 1.12685e-03;
-    double a_t3 = -8.73537e-03;
-    double a_t4 = -3.73064e-01;
-    double a_t5 = 1.83874e+03;
-    
-    double b_t1 = 1.71487e-05;
-    double b_t2 = -3.92849e-04;
-    double b_t3 = -2.87046e-03;
-    double b_t4 = 1.26281e-01;
-    double b_t5 = -1.32689e+02;
-    
-    double a_phi1 = -1.75851e-08;
-    double a_phi2 = 2.98814e-07;
-    double a_phi3 = -8.84479e-07;
-    double a_phi4 = -7.87568e-05;
-    double a_phi5 = 1.75647e-01;
-    
-    double b_phi1 = -5.99407e-09;
-    double b_phi2 = -8.21323e-08;
-    double b_phi3 = 2.61592e-07;
-    double b_phi4 = 2.81728e-05;
-    double b_phi5 = 2.24182e-02;
-     
-     // Diffusion parameters
-     c_t=388.7449859;
-     d_t=-4.33E+01;
-     
-     c_phi=6.00E-06;
-     d_phi=2.00E-06;
-     
-     a_z=0.035972097;
-     b_z =-0.000739386;
-     
-     t_2END = t_2GEM2 + t_2GEM3 + t_2PAD;
-     sigma_t_gap = sqrt(pow(sigma_t_2GEM2,2)+pow(sigma_t_2GEM3,2)+pow(sigma_t_2PAD,2));
-     phi_2END = phi_2GEM2 + phi_2GEM3 + phi_2PAD;
-     sigma_phi_gap = sqrt(pow(sigma_phi_2GEM2,2)+pow(sigma_phi_2GEM3,2)+pow(sigma_phi_2PAD,2));
-    // ----------------------------------------- //
-    
-    // ------------ B=0 T Parameters ------------//
-    /*double a_t1 = 0;
-     double a_t2 = 0;
-     double a_t3 = 0;
-     double a_t4 = 0;
-    double a_t5 = 6.96387e+02;
-     
-    
-     double b_t1 = 0;
-     double b_t2 = 0;
-     double b_t3 = 0;
-     double b_t4 = 0;
-    double b_t5 = -4.73759e+01;
-    
-     double a_phi1 = 0;
-     double a_phi2 = 0;
-     double a_phi3 = 0;
-     double a_phi4 = 0;
-     double a_phi5 = 0;
-    
-     double b_phi1 = 0;
-     double b_phi2 = 0;
-     double b_phi3 = 0;
-     double b_phi4 = 0;
-     double b_phi5 = 0;
-    
-    // Diffusion parameters
-    c_t=0.0;
-    d_t=0.0;
-    
-    c_phi=0.0;
-    d_phi=0.0;
-    
-    a_z=0.0;
-    b_z =0.0;
-    
-    t_2END = 500.0;
-    sigma_t_gap = 0;
-    phi_2END = 0.0;
-    sigma_phi_gap = 0.0;*/
-    // ------------------------------------------//
-    
-    
-    TPC_TZERO = 0.0;
-    
-     int chan=0;
+	const rtpcConstants &rc = rtpcc;
+
+	int chan=0;
     
 	map<string, double> dgtz;
 	vector<identifier> identity = aHit->GetId();
@@ -138,9 +213,6 @@ map<string, double> rtpc_HitProcess :: integrateDgt(MHit* aHit, int hitn)
 	// local variable for each step
 	vector<G4ThreeVector> Lpos = aHit->GetLPos();
 
-	// take momentum for each step
-	vector<G4ThreeVector> Lmom = aHit->GetMoms();
-
 	// energy at each step
 	// so tInfos.eTot is the sum of all steps s of Edep[s] 
 	vector<double>      Edep = aHit->GetEdep();
@@ -149,131 +221,104 @@ map<string, double> rtpc_HitProcess :: integrateDgt(MHit* aHit, int hitn)
 	// Get the information x,y,z and Edep at each ionization point
 	// 
 
-    // -------------------------- TIME SHIFT for non-primary tracks ---------------------------
-    if(aHit->GetTId() != timeShift_map.cend()->first){
-        if(aHit->GetTId()< 3) timeShift_map[aHit->GetTId()] = 0.0;
-        else timeShift_map[aHit->GetTId()] = G4RandFlat::shoot(-8000.,8000.);
-    }
-    
-    
+	// -------------------------- TIME SHIFT for non-primary tracks ---------------------------
+	// one shift per track, shared by all hits of the same track in the event
+	int tid = aHit->GetTId();
+	if(tid >= (int) timeShift.size()) timeShift.resize(tid + 1, NAN);
+	if(std::isnan(timeShift[tid])) {
+		if(tid < 3) timeShift[tid] = 0.0;
+		else        timeShift[tid] = G4RandFlat::shoot(-8000.,8000.);
+	}
+	shift_t = timeShift[tid];
+
 	double LposX=0.;
 	double LposY=0.;
 	double LposZ=0.;
 	double DiffEdep=0.;
     
 	if(tInfos.eTot > 0)
+	{
+		int adc =0;
+		double tdc =0;
 
-	  {
-	    
-	    int adc =0;
-	    double tdc =0;
-          
-          
-	    for(unsigned int s=0; s<tInfos.nsteps; s++)
-	    {
-	      LposX = Lpos[s].x();
-	      LposY = Lpos[s].y();
-	      LposZ = Lpos[s].z();
-
-    //          if(sqrt(LposX*LposX+LposY*LposY)<30. || sqrt(LposX*LposX+LposY*LposY)>70.) continue;
-    //          if(LposZ<-(RTPC_L/2.0) || LposZ>(RTPC_L/2.0)) continue;
-            
-	      DiffEdep = Edep[s];
-
-            z_cm = LposZ/10.0;
-            
-            // all in cm
-            a_t=a_t1*(pow(z_cm,4)) + a_t2*(pow(z_cm,3)) + a_t3*(pow(z_cm,2)) + a_t4*z_cm + a_t5;
-            b_t=b_t1*(pow(z_cm,4)) + b_t2*(pow(z_cm,3)) + b_t3*(pow(z_cm,2)) + b_t4*z_cm + b_t5;
-            
-            a_phi=a_phi1*(pow(z_cm,4)) + a_phi2*(pow(z_cm,3)) + a_phi3*(pow(z_cm,2)) + a_phi4*z_cm + a_phi5;
-            b_phi=b_phi1*(pow(z_cm,4)) + b_phi2*(pow(z_cm,3)) + b_phi3*(pow(z_cm,2)) + b_phi4*z_cm + b_phi5;
-            
-	      double r0,phi0_rad;
-	      //convert (x0,y0,z0) into (r0,phi0,z0)
-          r0=(sqrt(LposX*LposX+LposY*LposY))/10.0;  //in cm
-          
-            phi0_rad=atan2(LposY,LposX); //return (-Pi, + Pi)
-	      if( phi0_rad<0.)  phi0_rad+=2.0*PI;
-          if( phi0_rad>=2.0*PI )  phi0_rad-=2.0*PI;
-
-          
-          // -------------------------------- Addition of Diffusion -----------------------------
-          
-          // calculate drift time [ns] to first GEM
-            double t_drift = a_t*(7.0-r0)+b_t*(7.0-r0)*(7.0-r0);
-            
-          // determine sigma of drift time [ns]
-           double t_diff = sqrt(c_t*(7.0-r0)+d_t*(7.0-r0)*(7.0-r0));
-
-          // calculate drift angle to first GEM at 7 cm [rad]
-          double phi_drift = a_phi*(7.0-r0)+b_phi*(7.0-r0)*(7.0-r0);
-            
-          // determine sigma of drift angle [rad]
-          double phi_diff = sqrt(c_phi*(7.0-r0)+d_phi*(7.0-r0)*(7.0-r0));
-
-            // calculate drift in z [mm]
-            double z_drift = 0.0;
-            
-          // determine sigma in z [mm]
-          double z_diff = sqrt(a_z*(7.0-r0)+b_z*(7.0-r0)*(7.0-r0));
-            
-            // find t_s2pad and delta_phi by gaussians
-            double t_s2pad = G4RandGauss::shoot(t_drift, t_diff);
-            double delta_phi = G4RandGauss::shoot(phi_drift, phi_diff);
-            double delta_z = G4RandGauss::shoot(z_drift, z_diff);
-            double t_gap = G4RandGauss::shoot(t_2END, sigma_t_gap);
-            double phi_gap = G4RandGauss::shoot(phi_2END, sigma_phi_gap);
-            
-          // ------------------------------------------------------------------------------------
-	      
-            double phi_rad= phi0_rad+delta_phi+phi_gap;   //phi at pad pcb board
-            if( phi_rad<0.0 )  phi_rad+=2.0*PI;
-            if( phi_rad>=2.0*PI )  phi_rad-=2.0*PI;
-            
-            // time shift
-            shift_t = timeShift_map.find(aHit->GetTId())->second;
-            
-            // NO time shift
-            //shift_t = 0.0;
-            
-            tdc=t_s2pad+t_gap+shift_t;
-            adc=DiffEdep;
-
-            double z_pos = LposZ+delta_z;
-            int col = -999;
-            int row = -999;
- 
-            row = ceil(phi_rad/phi_per_pad);
-            float z_shift = row%4;
-            
-            float col_min = -RTPC_L/2.0+z_shift;
-            float col_max = RTPC_L/2.0+z_shift;
-            
-	        if( z_pos < col_min || z_pos > col_max ) {row = -999; col = -999;}
-            else {
-                
-                row = ceil(phi_rad/phi_per_pad);
-                col = ceil((z_pos+RTPC_L/2.0-z_shift)/PAD_L);
-            }
-            
-            int Num_of_Col = (int) (RTPC_L/PAD_L);
-            chan = row*Num_of_Col+col;
-
-
-            dgtz["Sector"] = 1;
-            dgtz["Layer"] = col;
-            dgtz["Component"] = row;
-            dgtz["Order"] = 0;
-            dgtz["Time"]   = tdc;
-            dgtz["ADC"]    = (int) adc;
-            dgtz["Ped"] = 0;
-            dgtz["TimeShift"] = shift_t;
-            dgtz["hitn"]   = (int) hitn;
-    
-	    } // end step
+		// gaussian draws for all steps at once: t_s2pad, delta_phi, delta_z, t_gap, phi_gap
+		vector<double> gauss(5*tInfos.nsteps);
+		G4RandGauss::shootArray(5*tInfos.nsteps, &gauss[0]);
+
+		int Num_of_Col = (int) (rc.RTPC_L/rc.PAD_L);
+
+		for(unsigned int s=0; s<tInfos.nsteps; s++)
+		{
+			LposX = Lpos[s].x();
+			LposY = Lpos[s].y();
+			LposZ = Lpos[s].z();
+
+			DiffEdep = Edep[s];
+
+			double r0,phi0_rad;
+			//convert (x0,y0,z0) into (r0,phi0,z0)
+			r0=(sqrt(LposX*LposX+LposY*LposY))/10.0;  //in cm
+
+			phi0_rad=atan2(LposY,LposX); //return (-Pi, + Pi)
+			if( phi0_rad<0.)  phi0_rad+=2.0*PI;
+			if( phi0_rad>=2.0*PI )  phi0_rad-=2.0*PI;
 
-	  }	      
+			// -------------------------------- Addition of Diffusion -----------------------------
+
+			// drift time [ns] to first GEM and its sigma,
+			// drift angle to first GEM at 7 cm [rad] and its sigma, sigma in z [mm]
+			double drift[5];
+			rtpcDrift(rc, LposZ/10.0, r0, drift);
+
+			// calculate drift in z [mm]
+			double z_drift = 0.0;
+
+			// find t_s2pad and delta_phi by gaussians
+			const double *g = &gauss[5*s];
+			double t_s2pad   = drift[0]       + drift[1]*g[0];
+			double delta_phi = drift[2]       + drift[3]*g[1];
+			double delta_z   = z_drift        + drift[4]*g[2];
+			double t_gap     = rc.t_2END      + rc.sigma_t_gap*g[3];
+			double phi_gap   = rc.phi_2END    + rc.sigma_phi_gap*g[4];
+
+			// ------------------------------------------------------------------------------------
+
+			double phi_rad= phi0_rad+delta_phi+phi_gap;   //phi at pad pcb board
+			if( phi_rad<0.0 )  phi_rad+=2.0*PI;
+			if( phi_rad>=2.0*PI )  phi_rad-=2.0*PI;
+
+			tdc=t_s2pad+t_gap+shift_t;
+			adc=DiffEdep;
+
+			double z_pos = LposZ+delta_z;
+			int col = -999;
+			int row = -999;
+
+			row = ceil(phi_rad/rc.phi_per_pad);
+			float z_shift = row%4;
+
+			float col_min = -rc.RTPC_L/2.0+z_shift;
+			float col_max = rc.RTPC_L/2.0+z_shift;
+
+			if( z_pos < col_min || z_pos > col_max ) {row = -999; col = -999;}
+			else {
+				col = ceil((z_pos+rc.RTPC_L/2.0-z_shift)/rc.PAD_L);
+			}
+
+			chan = row*Num_of_Col+col;
+
+			dgtz["Sector"] = 1;
+			dgtz["Layer"] = col;
+			dgtz["Component"] = row;
+			dgtz["Order"] = 0;
+			dgtz["Time"]   = tdc;
+			dgtz["ADC"]    = (int) adc;
+			dgtz["Ped"] = 0;
+			dgtz["TimeShift"] = shift_t;
+			dgtz["hitn"]   = (int) hitn;
+
+		} // end step
+	}
 
 	return dgtz;
 }
@@ -282,98 +327,59 @@ map<string, double> rtpc_HitProcess :: integrateDgt(MHit* aHit, int hitn)
 
 vector<identifier>  rtpc_HitProcess :: processID(vector<identifier> id, G4Step* aStep, detector Detector)
 {
-    static const double PI=3.1415926535;
-    double r0 = 0.;
-    double phi0_rad=0.;
-    
-    // Establish constants
-    PAD_W =2.79;
-    PAD_L = 4.0;
-    PAD_S = 80.0;
-    RTPC_L = 384.0;
-    phi_per_pad=PAD_W/PAD_S;
-    
-    // parameters to change for gas mixture and potential
-    // gas mixture = He:CO2 at 80:20
-    // potential = 3500V
-    a_t=1741.179712;
-    b_t=-1.25E+02;
-    c_t=388.7449859;
-    d_t=-4.33E+01;
-    
-    a_phi=0.161689123;
-    b_phi=0.023505021;
-    c_phi=6.00E-06;
-    d_phi=2.00E-06;
-    
-    a_z=0.035972097;
-    b_z =-0.000739386;
-    
-    phi_2GEM2 = 0.0492538;
-    sigma_phi_2GEM2 = 0.00384579;
-    phi_2GEM3 = 0.0470817;
-    sigma_phi_2GEM3 = 0.00234478;
-    phi_2PAD = 0.0612122;
-    sigma_phi_2PAD = 0.00238653;
-    phi_2END = phi_2GEM2 + phi_2GEM3 + phi_2PAD;
-    sigma_phi_gap = sqrt(pow(sigma_phi_2GEM2,2)+pow(sigma_phi_2GEM3,2)+pow(sigma_phi_2PAD,2));
-
-  vector<identifier> yid = id;
-
-  G4ThreeVector xyz = aStep->GetPostStepPoint()->GetPosition();
-  G4ThreeVector Lxyz = aStep->GetPreStepPoint()->GetTouchableHandle()->GetHistory()
-    ->GetTopTransform().TransformPoint(xyz);///< Local Coordinates of interaction
-
-    int chan;
-  double LposX = 0;
-  double LposY = 0;
-  double LposZ = 0;
-  LposX = Lxyz.x();
-  LposY = Lxyz.y();
-  LposZ = Lxyz.z();
-    
-  r0=(sqrt(LposX*LposX+LposY*LposY))/10.0;  //in mm
-  
-  phi0_rad=atan2(LposY,LposX); //return (-Pi, + Pi)
-  if( phi0_rad<0.)  phi0_rad+=2.0*PI;
-  if( phi0_rad>=2.0*PI)  phi0_rad-=2.0*PI;
-  
-    // -------------------------------- Addition of Diffusion -----------------------------
-    
-    // calculate drift angle to first GEM at 7 cm [rad]
-    double phi_drift = a_phi*(7.0-r0)+b_phi*(7.0-r0)*(7.0-r0);
-    
-    // determine sigma of drift angle [rad]
-    double phi_diff = sqrt(c_phi*(7.0-r0)+d_phi*(7.0-r0)*(7.0-r0));
-    
-    // calculate drift in z [mm]
-    double z_drift = 0.0;
-    
-    // determine sigma in z [mm]
-    double z_diff = sqrt(a_z*(7.0-r0)+b_z*(7.0-r0)*(7.0-r0));
-    
-    // find t_s2pad and delta_phi by gaussians
-    double delta_phi = G4RandGauss::shoot(phi_drift, phi_diff);
-    double delta_z = G4RandGauss::shoot(z_drift, z_diff);
-    double phi_gap = G4RandGauss::shoot(phi_2END, sigma_phi_gap);
+	const rtpcIDConstants &rc = rtpcidc;
 
-    
-    // ------------------------------------------------------------------------------------
-    
-    double phi_rad= phi0_rad+delta_phi+phi_gap;   //phi at pad pcb board
-	      if( phi_rad<0. )  phi_rad+=2.0*PI;
-	      if( phi_rad>2.0*PI )  phi_rad-=2.0*PI;
+	vector<identifier> yid = id;
+
+	G4ThreeVector xyz = aStep->GetPostStepPoint()->GetPosition();
+	G4ThreeVector Lxyz = aStep->GetPreStepPoint()->GetTouchableHandle()->GetHistory()
+	->GetTopTransform().TransformPoint(xyz);///< Local Coordinates of interaction
+
+	double LposX = Lxyz.x();
+	double LposY = Lxyz.y();
+	double LposZ = Lxyz.z();
+
+	double r0 = (sqrt(LposX*LposX+LposY*LposY))/10.0;  //in cm
+
+	double phi0_rad = atan2(LposY,LposX); //return (-Pi, + Pi)
+	if( phi0_rad<0.)  phi0_rad+=2.0*PI;
+	if( phi0_rad>=2.0*PI)  phi0_rad-=2.0*PI;
+
+	// -------------------------------- Addition of Diffusion -----------------------------
+
+	// calculate drift angle to first GEM at 7 cm [rad]
+	double phi_drift = rc.a_phi*(7.0-r0)+rc.b_phi*(7.0-r0)*(7.0-r0);
+
+	// determine sigma of drift angle [rad]
+	double phi_diff = sqrt(rc.c_phi*(7.0-r0)+rc.d_phi*(7.0-r0)*(7.0-r0));
+
+	// calculate drift in z [mm]
+	double z_drift = 0.0;
+
+	// determine sigma in z [mm]
+	double z_diff = sqrt(rc.a_z*(7.0-r0)+rc.b_z*(7.0-r0)*(7.0-r0));
+
+	// find delta_phi and delta_z by gaussians
+	double delta_phi = G4RandGauss::shoot(phi_drift, phi_diff);
+	double delta_z   = G4RandGauss::shoot(z_drift, z_diff);
+	double phi_gap   = G4RandGauss::shoot(rc.phi_2END, rc.sigma_phi_gap);
+
+	// ------------------------------------------------------------------------------------
+
+	double phi_rad= phi0_rad+delta_phi+phi_gap;   //phi at pad pcb board
+	if( phi_rad<0. )  phi_rad+=2.0*PI;
+	if( phi_rad>2.0*PI )  phi_rad-=2.0*PI;
 
 	double z_pos = LposZ+delta_z;
-    
-    int row = int(phi_rad/phi_per_pad);
-    float z_shift = row%4;
-    int col = (int) ((z_pos-z_shift+RTPC_L/2.0)/PAD_L);
-    int Num_of_Col = (int) (ceil(RTPC_L/PAD_L));
-    chan = row*Num_of_Col+col;
-
-    yid[0].id=chan;
-  return yid;
+
+	int row = int(phi_rad/rc.phi_per_pad);
+	float z_shift = row%4;
+	int col = (int) ((z_pos-z_shift+rc.RTPC_L/2.0)/rc.PAD_L);
+	int Num_of_Col = (int) (ceil(rc.RTPC_L/rc.PAD_L));
+	int chan = row*Num_of_Col+col;
+
+	yid[0].id=chan;
+	return yid;
 }
 
 
@@ -417,12 +423,16 @@ double rtpc_HitProcess :: voltage(double charge, double time, double forTime)
 	return 0.0;
 }
 
+void rtpc_HitProcess::initWithRunNumber(int runno)
+{
+	if(rtpcc.runNo != runno) {
+		cout << " > Initializing " << HCname << " digitization for run number " << runno << endl;
+		rtpcc = initializeRTPCConstants(runno);
+		rtpcc.runNo = runno;
+	}
+}
 
-
-
-
-
-
-
-
+// this static function will be loaded first thing by the executable
+rtpcConstants rtpc_HitProcess::rtpcc = initializeRTPCConstants(-1);
+rtpcIDConstants rtpc_HitProcess::rtpcidc = initializeRTPCIDConstants();
 
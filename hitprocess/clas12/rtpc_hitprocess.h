@@ -4,6 +4,64 @@
 // gemc headers
 #include "HitProcess.h"
 
+// constants to be used in the digitization routine
+// the drift parametrization is tabulated once per run in a (z, r) lookup table
+class rtpcConstants
+{
+public:
+
+	int runNo;
+
+	// RTPC geometry parameters
+	double PAD_W, PAD_L, PAD_S, RTPC_L;
+	double phi_per_pad;
+
+	// drift time and drift angle parametrization:
+	// t   = a_t(z)*(7-r)   + b_t(z)*(7-r)^2
+	// phi = a_phi(z)*(7-r) + b_phi(z)*(7-r)^2
+	// a, b are 4th order polynomials in z, coefficients from z^4 to z^0. z, r in cm
+	double a_t[5], b_t[5];
+	double a_phi[5], b_phi[5];
+
+	// diffusion parameters: sigma^2 = c*(7-r) + d*(7-r)^2
+	double c_t, d_t;
+	double c_phi, d_phi;
+	double a_z, b_z;
+
+	// drift time and angle from the first GEM to the readout pad
+	double t_2END, sigma_t_gap;
+	double phi_2END, sigma_phi_gap;
+
+	double TPC_TZERO;
+
+	// lookup tables: drift time and angle on a (z, r) grid
+	// outside the grid the parametrization is evaluated directly
+	double zmin, zmax, dz;
+	double rmin, rmax, dr;
+	int nz, nr;
+	vector<double> t_drift, phi_drift;        // index iz*nr + ir
+};
+
+// constants used by processID to assign the pad identifier
+// they differ from the digitization ones (pad width, drift angle parametrization)
+// and are kept in float, as in the original processID, so the channel assignment is unchanged
+class rtpcIDConstants
+{
+public:
+
+	// RTPC geometry parameters
+	float PAD_W, PAD_L, PAD_S, RTPC_L;
+	float phi_per_pad;
+
+	// drift angle and diffusion parameters
+	float a_phi, b_phi, c_phi, d_phi;
+	float a_z, b_z;
+
+	// drift angle from the first GEM to the readout pad
+	float phi_2GEM2, phi_2GEM3, phi_2PAD, phi_2END;
+	float sigma_phi_2GEM2, sigma_phi_2GEM3, sigma_phi_2PAD, sigma_phi_gap;
+};
+
 // Class definition
 /// \class rtpc_HitProcess
 
@@ -32,32 +90,20 @@ public:
 	// creates the HitProcess
 	static HitProcess *createHitClass() {return new rtpc_HitProcess;}
 
+	// constants initialized with initWithRunNumber
+	static rtpcConstants rtpcc;
+
+	void initWithRunNumber(int runno);
+
+	// processID constants, set once
+	static rtpcIDConstants rtpcidc;
+
 	// - electronicNoise: returns a vector of hits generated / by electronics.
 	vector<MHit*> electronicNoise();
 	
 public:
-    	// RTPC geometry parameters
-    	float PAD_W, PAD_L, PAD_S, RTPC_L;
-    	float phi_per_pad;
-    
-   	 // parameters for drift and diffustion equations for drift time, 
-	 // drift angle, and diffusion in z
-   	 float a_t, b_t, c_t, d_t;
-   	 float a_phi, b_phi, c_phi, d_phi;
-  	 float a_z, b_z;
-    
-    	 // variables for storing drift times and diffusion in time
-  	 float t_2GEM2, t_2GEM3, t_2PAD, t_2END;
-  	 float sigma_t_2GEM2, sigma_t_2GEM3, sigma_t_2PAD, sigma_t_gap;
-    
-    	 // variables for storing drift angle and diffusion in phi
-  	 float phi_2GEM2, phi_2GEM3, phi_2PAD, phi_2END;
-   	 float sigma_phi_2GEM2, sigma_phi_2GEM3, sigma_phi_2PAD, sigma_phi_gap;
-    
-    float z_cm;
-   	 float TPC_TZERO;
-    
-    map<int, double> timeShift_map;
+    // time shift for each track, indexed by track id. NaN if not assigned yet
+    vector<double> timeShift;
     double shift_t;
 
 };
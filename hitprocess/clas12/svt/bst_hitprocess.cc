@@ -1,6 +1,5 @@
 // gemc headers
 #include "bst_hitprocess.h"
-#include "bst_strip.h"
 
 // CLHEP units
 #include "CLHEP/Units/PhysicalConstants.h"
@@ -70,9 +69,6 @@ map<string, double> bst_HitProcess :: integrateDgt(MHit* aHit, int hitn)
 		return dgtz;
 	}
 	
-	class bst_strip bsts;
-	bsts.fill_infos();
-	
 	if(!aHit->isElectronicNoise) {
 		// double checking dimensions
 		double SensorLength = 2.0*aHit->GetDetector().dimensions[2]/mm;  // length of 1 card
@@ -166,9 +162,6 @@ vector<identifier> bst_HitProcess :: processID(vector<identifier> id, G4Step* aS
 	G4ThreeVector  Lxyz    = aStep->GetPreStepPoint()->GetTouchableHandle()->GetHistory()  ///< Local Coordinates of interaction
 	->GetTopTransform().TransformPoint(xyz);
 	
-	class bst_strip bsts;
-	bsts.fill_infos();
-	
 	int layer   = 2*yid[0].id + yid[1].id - 2 ;
 	int sector  = yid[2].id;
 	int isensor = yid[3].id;
@@ -334,6 +327,15 @@ void bst_HitProcess::initWithRunNumber(int runno)
 // this static function will be loaded first thing by the executable
 bstConstants bst_HitProcess::bstc = initializeBSTConstants(-1);
 
+// strip geometry does not depend on the run number: filled once
+static bst_strip initializeBSTStrip()
+{
+	bst_strip strip;
+	strip.fill_infos();
+	return strip;
+}
+bst_strip bst_HitProcess::bsts = initializeBSTStrip();
+
 
 
 
@@ -3,6 +3,7 @@
 
 // gemc headers
 #include "HitProcess.h"
+#include "bst_strip.h"
 
 // Class definition
 
@@ -65,6 +66,9 @@ private:
 	
 	// constants initialized with initWithRunNumber
 	static bstConstants bstc;
+
+	// strip geometry, with the strips angles precomputed
+	static bst_strip bsts;
 	
 	void initWithRunNumber(int runno);
 	
@@ -4,6 +4,7 @@
 #include <iostream>
 #include <cmath>
 #include <cstdlib>
+#include <algorithm>
 
 // CLHEP units
 #include "CLHEP/Units/PhysicalConstants.h"
@@ -43,7 +44,12 @@ void bst_strip::fill_infos()
 	
 	// Number of strips -1
 	Nstrips  = (int) floor((SensorWidth-2.0*DZ_inWidth)/pitch) - 1;
-	
+
+	// strips angles: the k-strip has angle k*alpha/Nstrips
+	double dalpha = alpha/((float)Nstrips);
+	stripTan.resize(Nstrips);
+	for(int k=0; k<Nstrips; k++)
+		stripTan[k] = tan(k*dalpha/rad);
 }
 
 
@@ -71,13 +77,26 @@ vector<double> bst_strip::FindStrip(int layer, int sector, int isens, G4ThreeVec
 	if( fabs(Lxyz.z()) < (SensorLength/2.0 - DZ_inLength) && fabs(Lxyz.x()) < SensitiveSensorWidth/2.0 )
 	{
 		
-		// looping over all strips to find the closest
-		// to the point
-		for(int k=0; k<Nstrips; k++)
+		// the strip x position at lz is monotonic in the strip number:
+		// x_k = intcp_0 -/+ k*pitch -/+ tan(k*dalpha)*lz for layer A/B.
+		// Using tan(k*dalpha) ~ k*dalpha the closest strip is estimated directly,
+		// then the exact distance is checked on the neighbouring strips only.
+		// The approximation error (< 0.02 mm at the maximum angle) is well within the window.
+		double kEstimate;
+		if(layer%2 == 0)
+			kEstimate = (SensitiveSensorWidth - StripStart - 0.5*pitch - lx)/(pitch + lz*dalpha/rad);
+		else
+			kEstimate = (lx - StripStart - 0.5*pitch)/(pitch + lz*dalpha/rad);
+
+		int kClosest = (int) floor(kEstimate);
+		if(kClosest < 0)         kClosest = 0;
+		if(kClosest > Nstrips-1) kClosest = Nstrips-1;
+
+		int kFirst = max(kClosest - 2, 0);
+		int kLast  = min(kClosest + 3, Nstrips);
+
+		for(int k=kFirst; k<kLast; k++)
 		{
-			// angle of the k-strip
-			double alpha_k = k*dalpha;
-			
 			// strip equation is z = mz + intcp
 			double intcp = 0;
 			double     m = 0;
@@ -88,7 +107,7 @@ vector<double> bst_strip::FindStrip(int layer, int sector, int isens, G4ThreeVec
 				// which is at positive local x
 				// the first strip starts at StripStart+1/2Pitch; hence in this frame the first strip intercept is SensitiveSensorWidth-(StripStart+1/2Pitch)
 				intcp = SensitiveSensorWidth - StripStart - (k+0.5)*pitch ;
-				m     = -tan(alpha_k/rad);
+				m     = -stripTan[k];
 			}
 			
 			if(layer%2 == 1)
@@ -97,7 +116,7 @@ vector<double> bst_strip::FindStrip(int layer, int sector, int isens, G4ThreeVec
 				// which is at negative local x
 				// the first strip starts at StripStart+1/2Pitch
 				intcp = StripStart + (k+0.5)*pitch ;
-				m     = tan(alpha_k/rad);
+				m     = stripTan[k];
 			}
 			
 			// x position of the strip according to the active local z position
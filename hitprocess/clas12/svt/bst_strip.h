@@ -1,3 +1,6 @@
+#ifndef bst_strip_H
+#define bst_strip_H 1
+
 #include <vector>
 using namespace std;
 
@@ -19,9 +22,12 @@ public:
 	double SensorWidth ;  // width 1 Sensor (including dead area)
 	double StripStart;    // the first sensitive strip starts at stripStart + 1/2 of the pitch
 	int Nstrips;          // Number of strips for 1 card (New Design)
+	vector<double> stripTan; // tangent of the k-strip angle, filled by fill_infos
 
 	void fill_infos();
 
 	vector<double> FindStrip( int layer, int sector, int isens, G4ThreeVector Lxyz);   // Strip Finding Routine
 
 };
+
+#endif
@@ -1,55 +1,74 @@
 #include "bst_strip.h"
-#include "fst_strip.h"
+
+// CLHEP units
+#include "CLHEP/Units/PhysicalConstants.h"
+using namespace CLHEP;
 
 #include <iostream>
+#include <cstdlib>
+#include <ctime>
 using namespace std;
 
+// Usage:
+//  example layer sector sensor x y z   :  strips and sharing for a local position (mm) in the sensor
+//  example bench nhits                  :  strip finding rate (hits/s) for random positions
 int main(int argn, char** argv)
 {
- if(argn != 7)
- {
-    cout << endl << " Wrong mumber of arguments. Usage: example layer sector x y z BST" << endl << endl;
-    exit(0);
- }
-
- int layer  = atoi(argv[1]);
- int sector = atoi(argv[2]);
- double x   = atof(argv[3]);
- double y   = atof(argv[4]);
- double z   = atof(argv[5]);
- string D = argv[6];
-
- double X,Y,Z;
-
- int Strip;
-
- if(D == "BST")
- {
-    class bst_strip bsts;
-    bsts.fill_infos();
-    bsts.FindCard(layer, z);
-    X = bsts.x;
-    Y = bsts.y;
-    Z = bsts.z;
-    Strip = bsts.FindStrip(layer, sector, X, Y, Z);
- }
- if(D == "FST")
- {
-    class fst_strip fsts;
-    fsts.fill_infos();
-    X = x;
-    Y = y;
-    Z = z;
-    Strip = fsts.FindStrip(layer, sector, X, Y, Z);
- }
-
-
- cout << D << ": "; 
- cout << " x = " << X << " " ;
- cout << " y = " << Y << " " ;
- cout << " z = " << Z << " " ;
- cout << " Strip = " << Strip << endl;
- 
- return 1;
+	class bst_strip bsts;
+	bsts.fill_infos();
+
+	if(argn == 3 && string(argv[1]) == "bench")
+	{
+		int nhits = atoi(argv[2]);
+
+		double halfL = bsts.SensorLength/2.0 - bsts.DZ_inLength;
+		double halfW = (bsts.SensorWidth - 2.0*bsts.DZ_inWidth)/2.0;
+
+		// positions generated before timing
+		vector<G4ThreeVector> pos(nhits);
+		vector<int> layers(nhits), sensors(nhits);
+		srand(1);
+		for(int h=0; h<nhits; h++)
+		{
+			double x = (2.0*rand()/RAND_MAX - 1)*halfW;
+			double z = (2.0*rand()/RAND_MAX - 1)*halfL;
+			pos[h]     = G4ThreeVector(x, 0, z);
+			layers[h]  = rand()%8;
+			sensors[h] = rand()%3 + 1;
+		}
+
+		double checksum = 0;
+		clock_t start = clock();
+		for(int h=0; h<nhits; h++)
+		{
+			vector<double> strips = bsts.FindStrip(layers[h], 0, sensors[h], pos[h]);
+			checksum += strips[0];
+		}
+		double elapsed = double(clock() - start)/CLOCKS_PER_SEC;
+
+		cout << " BST: " << nhits << " hits in " << elapsed << " s: " << nhits/elapsed << " hits/s" ;
+		cout << "  (strip checksum: " << checksum << ")" << endl;
+		return 0;
+	}
+
+	if(argn != 7)
+	{
+		cout << endl << " Wrong mumber of arguments. Usage: example layer sector sensor x y z  or  example bench nhits" << endl << endl;
+		exit(0);
+	}
+
+	int layer  = atoi(argv[1]);
+	int sector = atoi(argv[2]);
+	int sensor = atoi(argv[3]);
+	double x   = atof(argv[4])*mm;
+	double y   = atof(argv[5])*mm;
+	double z   = atof(argv[6])*mm;
+
+	vector<double> strips = bsts.FindStrip(layer-1, sector-1, sensor, G4ThreeVector(x, y, z));
+
+	cout << " BST: x = " << x << "  y = " << y << "  z = " << z << endl;
+	for(unsigned s=0; s<strips.size()/2; s++)
+		cout << "  strip " << strips[2*s] << "  sharing " << strips[2*s+1] << endl;
 
+	return 0;
 }
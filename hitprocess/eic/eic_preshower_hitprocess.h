@@ -33,6 +33,9 @@ public:
 
 	// - electronicNoise: returns a vector of hits generated / by electronics.
 	vector<MHit*> electronicNoise();
+
+	// - stepsNeeded: only trueInfos and the first step are used, steps can be summed
+	bool stepsNeeded() { return false; }
 };
 
 #endif
@@ -0,0 +1,122 @@
+// gemc headers
+#include "evioEventBuffer.h"
+
+// C++ headers
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+using namespace std;
+
+
+// heavy event: header, ndet detector banks with 3 sub-banks of nvar variables of nhits values
+// the variables alternate between int and double, as in the gemc banks
+class heavyEvent
+{
+public:
+	heavyEvent(int nd, int nv, int nh) : ndet(nd), nvar(nv), nhits(nh)
+	{
+		for(int h=0; h<nhits; h++) {
+			ivalues.push_back(h);
+			dvalues.push_back(0.5*h);
+		}
+	}
+
+	int ndet, nvar, nhits;
+	vector<int>    ivalues;
+	vector<double> dvalues;
+};
+
+void fillDOM(evioDOMTree *event, heavyEvent &he)
+{
+	evioDOMNodeP header = evioDOMNode::createEvioDOMNode(5, 0);
+	vector<string> time(1, "Mon Oct 19 12:00:00 2026");
+	*header << evioDOMNode::createEvioDOMNode(5, 1, time);
+	*event << header;
+
+	for(int d=0; d<he.ndet; d++) {
+		evioDOMNodeP detector = evioDOMNode::createEvioDOMNode(100*(d+1), 0);
+		for(int s=1; s<4; s++) {
+			evioDOMNodeP sub = evioDOMNode::createEvioDOMNode(100*(d+1) + s, 0);
+			for(int v=1; v<=he.nvar; v++) {
+				if(v%2) *sub << evioDOMNode::createEvioDOMNode(100*(d+1) + s, v, he.ivalues);
+				else    *sub << evioDOMNode::createEvioDOMNode(100*(d+1) + s, v, he.dvalues);
+			}
+			*detector << sub;
+		}
+		*event << detector;
+	}
+}
+
+void fillBuffer(evioEventBuffer *event, heavyEvent &he)
+{
+	event->openBank(5, 0);
+	event->addStrings(5, 1, vector<string>(1, "Mon Oct 19 12:00:00 2026"));
+	event->closeBank();
+
+	for(int d=0; d<he.ndet; d++) {
+		event->openBank(100*(d+1), 0);
+		for(int s=1; s<4; s++) {
+			event->openBank(100*(d+1) + s, 0);
+			for(int v=1; v<=he.nvar; v++) {
+				if(v%2) event->addBank(100*(d+1) + s, v, he.ivalues);
+				else    event->addBank(100*(d+1) + s, v, he.dvalues);
+			}
+			event->closeBank();
+		}
+		event->closeBank();
+	}
+}
+
+
+// Usage:
+//  evioBenchmark nevents [ndetectors nvariables nhits]
+//  Serializes the same events with an evioDOMTree and with the evioEventBuffer,
+//  prints the events/s of both and checks that the buffers are identical.
+int main(int argn, char** argv)
+{
+	if(argn < 2) {
+		cout << endl << " Wrong number of arguments. Usage: evioBenchmark nevents [ndetectors nvariables nhits]" << endl << endl;
+		exit(0);
+	}
+
+	int nevents = atoi(argv[1]);
+	int ndet    = argn > 2 ? atoi(argv[2]) : 20;
+	int nvar    = argn > 3 ? atoi(argv[3]) : 20;
+	int nhits   = argn > 4 ? atoi(argv[4]) : 500;
+
+	heavyEvent he(ndet, nvar, nhits);
+
+	int bufSize = 30000000;
+	uint32_t *domBuffer = new uint32_t[bufSize];
+
+	clock_t start = clock();
+	for(int e=0; e<nevents; e++) {
+		evioDOMTree *event = new evioDOMTree(1, 0);
+		fillDOM(event, he);
+		event->toEVIOBuffer(domBuffer, bufSize);
+		delete event;
+	}
+	double domTime = double(clock() - start)/CLOCKS_PER_SEC;
+
+	evioEventBuffer event;
+	const uint32_t *directBuffer = nullptr;
+	start = clock();
+	for(int e=0; e<nevents; e++) {
+		event.startEvent(1, 0);
+		fillBuffer(&event, he);
+		directBuffer = event.event();
+	}
+	double directTime = double(clock() - start)/CLOCKS_PER_SEC;
+
+	bool identical = directBuffer != nullptr && event.size() == domBuffer[0] + 1 &&
+	                 memcmp(directBuffer, domBuffer, event.size()*sizeof(uint32_t)) == 0;
+
+	cout << " " << nevents << " events of " << event.size() << " words (" << ndet << " detectors, " << nvar << " variables, " << nhits << " hits)" << endl;
+	cout << " evioDOMTree:     " << domTime    << " s, " << nevents/domTime    << " events/s" << endl;
+	cout << " evioEventBuffer: " << directTime << " s, " << nevents/directTime << " events/s" << endl;
+	cout << " buffers are " << (identical ? "identical" : "DIFFERENT") << endl;
+
+	delete [] domBuffer;
+	return identical ? 0 : 1;
+}
@@ -0,0 +1,212 @@
+// gemc headers
+#include "compressedStream.h"
+
+// C++ headers
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+
+// zlib
+#include "zlib.h"
+
+
+compressedStream::compressedStream(string filename, int l, unsigned long bs, int nthreads) : ostream(nullptr)
+{
+	rdbuf(&buffer);
+
+	level      = l;
+	blockSize  = bs;
+	firstEvent = -1;
+	nevents    = 0;
+	uncompressedOffset = 0;
+	compressedOffset   = 0;
+	nextSequence = 0;
+	nextToWrite  = 0;
+	closing      = false;
+	nstored      = 0;
+
+	file.open(filename.c_str(), ios::out | ios::binary);
+	index.open((filename + ".idx").c_str());
+	good = file.good() && index.good();
+
+	index << "# block  compressed_offset  compressed_size  uncompressed_offset  uncompressed_size  first_event  nevents" << endl;
+
+	buffer.block.reserve(blockSize + blockSize/4);
+
+	// at most two blocks per worker are waiting, to bound the memory
+	maxQueue = nthreads > 0 ? 2*nthreads : 1;
+	for(int t=0; t<nthreads; t++)
+		workers.push_back(thread(&compressedStream::work, this));
+}
+
+compressedStream::~compressedStream()
+{
+	close();
+}
+
+void compressedStream::endEvent(int evn)
+{
+	if(nevents == 0) firstEvent = evn;
+	nevents++;
+
+	if(buffer.block.size() >= blockSize)
+		submitBlock();
+}
+
+void compressedStream::submitBlock()
+{
+	if(buffer.block.empty()) return;
+
+	compressedBlock *b = new compressedBlock;
+	b->sequence           = nextSequence++;
+	b->uncompressedOffset = uncompressedOffset;
+	b->firstEvent         = firstEvent;
+	b->nevents            = nevents;
+	b->dataSize           = buffer.block.size();
+	b->data.swap(buffer.block);
+
+	buffer.block.reserve(blockSize + blockSize/4);
+	uncompressedOffset += b->dataSize;
+	firstEvent = -1;
+	nevents    = 0;
+
+	// no workers: compressing here
+	if(workers.empty()) {
+		if(!compress(b)) store(b);
+		writeCompleted(b);
+		return;
+	}
+
+	unique_lock<mutex> lock(queueMutex);
+	queueChanged.wait(lock, [this]{return queue.size() < maxQueue;});
+	queue.push_back(b);
+	queueChanged.notify_all();
+}
+
+void compressedStream::work()
+{
+	while(true) {
+		compressedBlock *b;
+		{
+			unique_lock<mutex> lock(queueMutex);
+			queueChanged.wait(lock, [this]{return !queue.empty() || closing;});
+			if(queue.empty()) return;
+			b = queue.front();
+			queue.pop_front();
+			queueChanged.notify_all();
+		}
+		if(!compress(b)) store(b);
+		writeCompleted(b);
+	}
+}
+
+// each block is an independent gzip member
+bool compressedStream::compress(compressedBlock *b)
+{
+	z_stream zs;
+	memset(&zs, 0, sizeof(zs));
+
+	// 15 + 16: gzip header and trailer
+	if(deflateInit2(&zs, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+		cout << " !!! Error: compressed output: zlib initialization failed for block " << b->sequence << endl;
+		return false;
+	}
+
+	vector<char> out(deflateBound(&zs, b->data.size()));
+
+	zs.next_in   = (Bytef*) b->data.data();
+	zs.avail_in  = b->data.size();
+	zs.next_out  = (Bytef*) out.data();
+	zs.avail_out = out.size();
+
+	int status = deflate(&zs, Z_FINISH);
+	out.resize(zs.total_out);
+	deflateEnd(&zs);
+
+	if(status != Z_STREAM_END) {
+		cout << " !!! Error: compressed output: zlib compression failed for block " << b->sequence << endl;
+		return false;
+	}
+
+	b->data.swap(out);
+	return true;
+}
+
+// gzip member made of stored deflate blocks (at most 65535 bytes each):
+// the block is kept, uncompressed, and the file can still be read with gunzip
+void compressedStream::store(compressedBlock *b)
+{
+	const vector<char> &in = b->data;
+
+	// gzip header: magic, deflate, no flags, no time, unknown OS
+	vector<char> out = {(char) 0x1f, (char) 0x8b, 8, 0, 0, 0, 0, 0, 0, (char) 0xff};
+	out.reserve(in.size() + in.size()/65535*5 + 32);
+
+	uLong crc = crc32(0L, Z_NULL, 0);
+	size_t pos = 0;
+	do {
+		size_t n  = min(in.size() - pos, (size_t) 65535);
+		bool last = pos + n == in.size();
+		out.push_back(last ? 1 : 0);
+		out.push_back(n & 0xff);
+		out.push_back((n >> 8) & 0xff);
+		out.push_back(~n & 0xff);
+		out.push_back((~n >> 8) & 0xff);
+		out.insert(out.end(), in.begin() + pos, in.begin() + pos + n);
+		crc = crc32(crc, (const Bytef*) in.data() + pos, n);
+		pos += n;
+	} while(pos < in.size());
+
+	// trailer: crc32 and size modulo 2^32, little endian
+	unsigned long isize = in.size() & 0xffffffffUL;
+	for(int i=0; i<4; i++) out.push_back((crc   >> (8*i)) & 0xff);
+	for(int i=0; i<4; i++) out.push_back((isize >> (8*i)) & 0xff);
+
+	b->data.swap(out);
+
+	good = false;
+	nstored++;
+	cout << " !!! Error: compressed output: block " << b->sequence << " is written uncompressed." << endl;
+}
+
+// the blocks are written in order: a block waits until the previous ones are written
+void compressedStream::writeCompleted(compressedBlock *b)
+{
+	lock_guard<mutex> lock(fileMutex);
+
+	compressed[b->sequence] = b;
+
+	while(compressed.find(nextToWrite) != compressed.end()) {
+		compressedBlock *w = compressed[nextToWrite];
+
+		file.write(w->data.data(), w->data.size());
+
+		index << w->sequence << " " << compressedOffset << " " << w->data.size() << " "
+		      << w->uncompressedOffset << " " << w->dataSize << " " << w->firstEvent << " " << w->nevents << endl;
+
+		compressedOffset += w->data.size();
+
+		compressed.erase(nextToWrite);
+		delete w;
+		nextToWrite++;
+	}
+}
+
+void compressedStream::close()
+{
+	if(closing) return;
+
+	submitBlock();
+
+	{
+		lock_guard<mutex> lock(queueMutex);
+		closing = true;
+	}
+	queueChanged.notify_all();
+
+	for(auto &w: workers) w.join();
+	workers.clear();
+
+	file.close();
+	index.close();
+}
@@ -0,0 +1,130 @@
+/// \file compressedStream.h
+/// Defines the gemc compressed output stream.\n
+/// The output is divided in blocks of whole events. Each block is
+/// compressed with zlib on a worker thread into an independent gzip member:
+/// the file can be read with gunzip / zcat as a single stream.\n
+/// The blocks are written in order. The sidecar index <filename>.idx
+/// lists for each block its compressed offset and size, the uncompressed
+/// offset and size, the first event number and the number of events,
+/// so that a reader can seek to the block containing an event range
+/// and inflate that block only.\n
+/// If zlib fails on a block, the block is written as a stored (uncompressed)
+/// gzip member, so the file stays readable, and the stream is marked bad.
+/// \author \n Maurizio Ungaro
+/// \author mail: ungaro@jlab.org\n\n\n
+#ifndef COMPRESSED_STREAM_H
+#define COMPRESSED_STREAM_H 1
+
+// C++ headers
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+using namespace std;
+
+
+/// \class compressedBlock
+/// <b> compressedBlock </b>\n\n
+/// A block of events, before and after compression
+class compressedBlock
+{
+public:
+	unsigned long sequence;
+	long          uncompressedOffset;
+	int           firstEvent;
+	int           nevents;
+	vector<char>  data;        ///< uncompressed, replaced by the gzip member once compressed
+	unsigned long dataSize;    ///< uncompressed size
+};
+
+
+/// \class compressedStreambuf
+/// <b> compressedStreambuf </b>\n\n
+/// Collects the characters of the current block
+class compressedStreambuf : public streambuf
+{
+public:
+	vector<char> block;
+
+protected:
+	int overflow(int c)
+	{
+		if(c != EOF) block.push_back((char) c);
+		return c;
+	}
+
+	streamsize xsputn(const char *s, streamsize n)
+	{
+		block.insert(block.end(), s, s + n);
+		return n;
+	}
+};
+
+
+/// \class compressedStream
+/// <b> compressedStream </b>\n\n
+/// ostream writing blocks of events compressed on worker threads.\n
+/// endEvent marks the end of an event: the block is sent to
+/// the workers when it is larger than blockSize.
+class compressedStream : public ostream
+{
+public:
+	// level: zlib compression level, 1 to 9
+	// nthreads: 0 compresses in the calling thread
+	compressedStream(string filename, int level, unsigned long blockSize, int nthreads);
+	~compressedStream();
+
+	// false if the files could not be opened or a block could not be compressed
+	bool isGood() const {return good;}
+	unsigned long storedBlocks() const {return nstored;}
+
+	// bytes written so far, before compression
+	long uncompressedSize() const {return uncompressedOffset + (long) buffer.block.size();}
+
+	void endEvent(int evn);
+
+	// compresses the last block, waits for the workers and closes the files
+	void close();
+
+private:
+	compressedStreambuf buffer;
+	ofstream file;
+	ofstream index;
+	atomic<bool> good;
+	atomic<unsigned long> nstored;   ///< blocks written uncompressed because zlib failed
+
+	int level;
+	unsigned long blockSize;
+
+	// current block infos
+	int  firstEvent;
+	int  nevents;
+	long uncompressedOffset;
+	long compressedOffset;
+	unsigned long nextSequence;
+
+	// blocks waiting for a worker, compressed blocks waiting to be written
+	vector<thread> workers;
+	mutex queueMutex;
+	mutex fileMutex;
+	condition_variable queueChanged;
+	deque<compressedBlock*> queue;
+	map<unsigned long, compressedBlock*> compressed;
+	unsigned long nextToWrite;
+	unsigned maxQueue;
+	bool closing;
+
+	void submitBlock();
+	void work();
+	bool compress(compressedBlock *b);
+	void store(compressedBlock *b);
+	void writeCompleted(compressedBlock *b);
+};
+
+
+#endif
@@ -0,0 +1,152 @@
+// gemc headers
+#include "evioEventBuffer.h"
+
+// C++ headers
+#include <iostream>
+#include <cstring>
+
+bool     evioEventBuffer::typesSet      = false;
+uint32_t evioEventBuffer::eventType     = 0;
+uint32_t evioEventBuffer::containerType = 0;
+uint32_t evioEventBuffer::intType       = 0;
+uint32_t evioEventBuffer::doubleType    = 0;
+
+// tag, num and type in the second word of a bank header
+#define BANK_HEADER(tag, type, num) ((((uint32_t)(tag) & 0xffff) << 16) | ((type) << 8) | ((uint32_t)(num) & 0xff))
+
+// probe event: bank of banks containing one int and one double
+static void fillProbeTree(evioDOMTree &probe)
+{
+	int    ivalue = 7;
+	double dvalue = 1.5;
+	evioDOMNodeP container = evioDOMNode::createEvioDOMNode(2, 0);
+	*container << evioDOMNode::createEvioDOMNode(3, 1, &ivalue, 1);
+	*container << evioDOMNode::createEvioDOMNode(4, 2, &dvalue, 1);
+	probe << container;
+}
+
+
+evioEventBuffer::evioEventBuffer(unsigned initialWords) : words(initialWords), used(0)
+{
+	if(!typesSet) setTypes();
+}
+
+// the type codes are read from the serialized probe event:
+//  0: event length 1: event header 2: container length 3: container header
+//  4: int length   5: int header   6: int value
+//  7: double length 8: double header
+void evioEventBuffer::setTypes()
+{
+	uint32_t pbuf[64];
+
+	evioDOMTree probe(1, 0);
+	fillProbeTree(probe);
+	probe.toEVIOBuffer(pbuf, 64);
+
+	eventType     = (pbuf[1] >> 8) & 0x3f;
+	containerType = (pbuf[3] >> 8) & 0x3f;
+	intType       = (pbuf[5] >> 8) & 0x3f;
+	doubleType    = (pbuf[8] >> 8) & 0x3f;
+
+	typesSet = true;
+}
+
+void evioEventBuffer::startEvent(int tag, int num)
+{
+	used = 0;
+	open.clear();
+
+	open.push_back(used);
+	uint32_t *h = reserve(2);
+	h[0] = 0;
+	h[1] = BANK_HEADER(tag, eventType, num);
+}
+
+void evioEventBuffer::openBank(int tag, int num)
+{
+	open.push_back(used);
+	uint32_t *h = reserve(2);
+	h[0] = 0;
+	h[1] = BANK_HEADER(tag, containerType, num);
+}
+
+void evioEventBuffer::closeBank()
+{
+	if(open.empty()) return;
+
+	words[open.back()] = used - open.back() - 1;
+	open.pop_back();
+}
+
+void evioEventBuffer::closeBanks(unsigned depth)
+{
+	while(open.size() > depth)
+		closeBank();
+}
+
+void evioEventBuffer::addBank(int tag, int num, const int *values, unsigned n)
+{
+	uint32_t *h = reserve(2 + n);
+	h[0] = n + 1;
+	h[1] = BANK_HEADER(tag, intType, num);
+	if(n) memcpy(h + 2, values, n*sizeof(int));
+}
+
+void evioEventBuffer::addBank(int tag, int num, const double *values, unsigned n)
+{
+	uint32_t *h = reserve(2 + 2*n);
+	h[0] = 2*n + 1;
+	h[1] = BANK_HEADER(tag, doubleType, num);
+	if(n) memcpy(h + 2, values, n*sizeof(double));
+}
+
+void evioEventBuffer::addNode(evioDOMNodeP node, unsigned payloadWords)
+{
+	// room for the headers and the composite format string
+	unsigned room = payloadWords + 64;
+	if(used + room > words.size()) words.resize(2*(used + room));
+
+	// the node becomes the root of a tree: it is serialized with a bank header,
+	// as inside a bank of banks, and deleted with the tree
+	evioDOMTree node_tree(node);
+	node_tree.toEVIOBuffer(&words[used], room);
+
+	used += words[used] + 1;
+}
+
+void evioEventBuffer::addStrings(int tag, int num, const vector<string> &values)
+{
+	unsigned nbytes = 0;
+	for(auto &s: values) nbytes += s.size() + 1;
+
+	addNode(evioDOMNode::createEvioDOMNode(tag, num, values), nbytes/4 + 2);
+}
+
+const uint32_t *evioEventBuffer::event()
+{
+	closeBanks(0);
+	return words.data();
+}
+
+
+bool evioEventBuffer::checkLayout()
+{
+	uint32_t domBuffer[64];
+
+	evioDOMTree probe(1, 0);
+	fillProbeTree(probe);
+	probe.toEVIOBuffer(domBuffer, 64);
+
+	int    ivalue = 7;
+	double dvalue = 1.5;
+	evioEventBuffer direct(64);
+	direct.startEvent(1, 0);
+	direct.openBank(2, 0);
+	direct.addBank(3, 1, &ivalue, 1);
+	direct.addBank(4, 2, &dvalue, 1);
+	const uint32_t *directBuffer = direct.event();
+
+	if(direct.size() != domBuffer[0] + 1) return false;
+
+	return memcmp(directBuffer, domBuffer, direct.size()*sizeof(uint32_t)) == 0;
+}
@@ -0,0 +1,91 @@
+/// \file evioEventBuffer.h
+/// Defines the evio event buffer.\n
+/// Banks are serialized directly into a buffer that is reused
+/// for every event, instead of building an evioDOMTree:
+/// - bank headers are reserved when a bank is opened
+/// - int and double payloads are appended in place
+/// - lengths are backpatched when a bank is closed\n
+/// Strings and composite data keep the evio library layout:
+/// their node is serialized by evio straight into the buffer.\n
+/// The bank type codes are taken from the evio library at the first use,
+/// and the layout is checked against the evioDOMTree serialization.
+/// \author \n Maurizio Ungaro
+/// \author mail: ungaro@jlab.org\n\n\n
+#ifndef EVIO_EVENT_BUFFER_H
+#define EVIO_EVENT_BUFFER_H 1
+
+// EVIO
+#include "evioUtil.hxx"
+using namespace evio;
+
+// C++ headers
+#include <vector>
+#include <string>
+#include <stdint.h>
+using namespace std;
+
+
+class evioEventBuffer
+{
+public:
+	evioEventBuffer(unsigned initialWords = 1000000);
+
+	// clears the buffer and opens the event bank
+	void startEvent(int tag, int num);
+
+	// bank of banks
+	void openBank(int tag, int num);
+
+	// backpatches the length of the innermost open bank
+	void closeBank();
+
+	// closes the open banks until depth are left open
+	void closeBanks(unsigned depth);
+
+	unsigned depth() const {return (unsigned) open.size();}
+
+	// leaf banks
+	void addBank(int tag, int num, const int    *values, unsigned n);
+	void addBank(int tag, int num, const double *values, unsigned n);
+	void addBank(int tag, int num, const vector<int>    &values) {addBank(tag, num, values.data(), (unsigned) values.size());}
+	void addBank(int tag, int num, const vector<double> &values) {addBank(tag, num, values.data(), (unsigned) values.size());}
+
+	// the node is serialized by the evio library, then deleted
+	// payloadWords is the size of its data, headers excluded
+	void addNode(evioDOMNodeP node, unsigned payloadWords);
+
+	// string banks, with the evio library layout
+	void addStrings(int tag, int num, const vector<string> &values);
+
+	// closes all banks and returns the event, ready for evioChannel::write
+	const uint32_t *event();
+
+	// number of words used by the event
+	unsigned size() const {return used;}
+
+	// serializes a small event with an evioDOMTree and with the buffer
+	// returns false if they differ
+	static bool checkLayout();
+
+private:
+	vector<uint32_t> words;
+	unsigned used;
+	vector<unsigned> open;      ///< positions of the headers of the open banks
+
+	// makes room for n more words, returns the first
+	inline uint32_t *reserve(unsigned n)
+	{
+		if(used + n > words.size()) words.resize(2*(used + n));
+		uint32_t *w = &words[used];
+		used += n;
+		return w;
+	}
+
+	// bank type codes of the evio library
+	static bool typesSet;
+	static uint32_t eventType, containerType, intType, doubleType;
+	static void setTypes();
+};
+
+
+#endif
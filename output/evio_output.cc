@@ -4,6 +4,7 @@
 
 // C++ headers
 #include <fstream>
+#include <algorithm>
 
 // CLHEP units
 #include "CLHEP/Units/PhysicalConstants.h"
@@ -17,6 +18,7 @@ static unsigned int buf[MAXEVIOBUF];
 
 
 const int evio_output::fadc_mode1_banktag = 0xe101;
+const int evio_output::fadc_mode7_banktag = 0xe102;
 
 
 // This variable is just a flag for checking, whether the FADC configuration parameters
@@ -52,31 +54,32 @@ void evio_output :: recordSimConditions(outputContainer* output, map<string, str
 
 	evioDOMTree *conditionsBank = new evioDOMTree(SIMULATION_CONDITIONS_BANK_TAG, 0);
 	*conditionsBank << evioDOMNode::createEvioDOMNode(SIMULATION_CONDITIONS_BANK_TAG, 1, data);
-	output->pchan->write(*conditionsBank);
+	output->writeEvio(conditionsBank);
 	delete conditionsBank;
 
 	jdata.push_back(sims["JSON"]);
 	evioDOMTree *jconditionsBank = new evioDOMTree(SIMULATION_JCONDITIONS_BANK_TAG, 0);
 	*jconditionsBank << evioDOMNode::createEvioDOMNode(SIMULATION_JCONDITIONS_BANK_TAG, 1, jdata);
 
-	output->pchan->write(jconditionsBank);
+	output->writeEvio(jconditionsBank);
 	delete jconditionsBank;
 
 
 }
 
-// instantiates the DOM tree
+// starts the event in the output buffer
 // write header bank
-// each variable is a domnode
+// each variable is a bank
 void evio_output :: writeHeader(outputContainer* output, map<string, double> data, gBank bank)
 {
-	event = new evioDOMTree(1, 0);
+	event = output->evioBuffer;
+	event->startEvent(1, 0);
 
-	evioDOMNodeP headerBank = evioDOMNode::createEvioDOMNode(HEADER_BANK_TAG, 0);
+	event->openBank(HEADER_BANK_TAG, 0);
 
 	// timestamp
 	string time = timeStamp();
-	*headerBank << addVariable(HEADER_BANK_TAG, bank.getVarId("time"), "s", time);
+	addVariable(event, HEADER_BANK_TAG, bank.getVarId("time"), "s", time);
 
 	for(map<string, double> :: iterator it = data.begin(); it != data.end(); it++) {
 
@@ -84,7 +87,7 @@ void evio_output :: writeHeader(outputContainer* output, map<string, double> dat
 
 		// bankID 1 is time, no need to repeat that info here.
 		if(bankId > 0) {
-			*headerBank << addVariable(HEADER_BANK_TAG, bankId, bank.getVarType(it->first), it->second);
+			addVariable(event, HEADER_BANK_TAG, bankId, bank.getVarType(it->first), it->second);
 		}
 
 		// storing event number in memory
@@ -92,50 +95,52 @@ void evio_output :: writeHeader(outputContainer* output, map<string, double> dat
 		evn = it->second;
 
 	}
-	*event << headerBank;
+	event->closeBank();
 }
 
 // write user infos header
 void evio_output :: writeUserInfoseHeader(outputContainer* output, map<string, double> data)
 {
-	evioDOMNodeP userHeaderBank = evioDOMNode::createEvioDOMNode(USER_HEADER_BANK_TAG, 0);
+	event->closeBanks(1);
+	event->openBank(USER_HEADER_BANK_TAG, 0);
 	// bank starts from 2 cause timestamp already there
 	int banknum = 1;
 	for(map<string, double> :: iterator it = data.begin(); it != data.end(); it++) {
-		*userHeaderBank << addVariable(USER_HEADER_BANK_TAG, banknum, "d", it->second);
+		addVariable(event, USER_HEADER_BANK_TAG, banknum, "d", it->second);
 		banknum++;
 	}
 
 	unsigned minNumberOfVarsToWrite = 10;
 	for(unsigned i=data.size(); i<minNumberOfVarsToWrite; i++) {
-		*userHeaderBank << addVariable(USER_HEADER_BANK_TAG, banknum, "d", 0.0);
+		addVariable(event, USER_HEADER_BANK_TAG, banknum, "d", 0.0);
 		banknum++;
 
 	}
 
-	*event << userHeaderBank;
+	event->closeBank();
 }
 
 
 void evio_output :: writeRFSignal(outputContainer* output, FrequencySyncSignal rfsignals, gBank bank)
 {
 	// creating and inserting generated particles bank  >> TAG=10 NUM=0 <<
-	evioDOMNodeP rfbank = evioDOMNode::createEvioDOMNode(RF_BANK_TAG, 0);
+	event->closeBanks(1);
+	event->openBank(RF_BANK_TAG, 0);
 
 	vector<oneRFOutput> rfs = rfsignals.getOutput();
 	for(unsigned i=0; i<rfs.size(); i++) {
 
 		// each rf signal is a different container bank
-		evioDOMNodeP erfsignalContainer = evioDOMNode::createEvioDOMNode(RF_BANK_TAG + i + 1, 0);
+		event->openBank(RF_BANK_TAG + i + 1, 0);
 
-		*erfsignalContainer << addVector(RF_BANK_TAG + i + 1, bank.getVarId("id"), bank.getVarType("id"), rfs[i].getIDs());
-		*erfsignalContainer << addVector(RF_BANK_TAG + i + 1, bank.getVarId("rf"), bank.getVarType("rf"), rfs[i].getValues());
+		addVector(event, RF_BANK_TAG + i + 1, bank.getVarId("id"), bank.getVarType("id"), rfs[i].getIDs());
+		addVector(event, RF_BANK_TAG + i + 1, bank.getVarId("rf"), bank.getVarType("rf"), rfs[i].getValues());
 
-		*rfbank << erfsignalContainer;
+		event->closeBank();
 
 	}
 
-	*event  << rfbank;
+	event->closeBank();
 
 }
 
@@ -177,17 +182,18 @@ void evio_output :: writeGenerated(outputContainer* output, vector<generatedPart
 	}
 
 	// creating and inserting generated particles bank  >> TAG=10 NUM=0 <<
-	evioDOMNodeP generatedp = evioDOMNode::createEvioDOMNode(GENERATED_PARTICLES_BANK_TAG, 0);
+	event->closeBanks(1);
+	event->openBank(GENERATED_PARTICLES_BANK_TAG, 0);
 
-	*generatedp << addVector(GENERATED_PARTICLES_BANK_TAG, bank.getVarId("pid"),           bank.getVarType("pid"), pid);
-	*generatedp << addVector(GENERATED_PARTICLES_BANK_TAG, bank.getVarId("px"),            bank.getVarType("px"),  px);
-	*generatedp << addVector(GENERATED_PARTICLES_BANK_TAG, bank.getVarId("py"),            bank.getVarType("py"),  py);
-	*generatedp << addVector(GENERATED_PARTICLES_BANK_TAG, bank.getVarId("pz"),            bank.getVarType("pz"),  pz);
-	*generatedp << addVector(GENERATED_PARTICLES_BANK_TAG, bank.getVarId("vx"),            bank.getVarType("vx"),  vx);
-	*generatedp << addVector(GENERATED_PARTICLES_BANK_TAG, bank.getVarId("vy"),            bank.getVarType("vy"),  vy);
-	*generatedp << addVector(GENERATED_PARTICLES_BANK_TAG, bank.getVarId("vz"),            bank.getVarType("vz"),  vz);
-	*generatedp << addVector(GENERATED_PARTICLES_BANK_TAG, bank.getVarId("time"),          bank.getVarType("time"), btime);
-	*generatedp << addVector(GENERATED_PARTICLES_BANK_TAG, bank.getVarId("multiplicity"),  bank.getVarType("multiplicity"), multiplicity);
+	addVector(event, GENERATED_PARTICLES_BANK_TAG, bank.getVarId("pid"),           bank.getVarType("pid"), pid);
+	addVector(event, GENERATED_PARTICLES_BANK_TAG, bank.getVarId("px"),            bank.getVarType("px"),  px);
+	addVector(event, GENERATED_PARTICLES_BANK_TAG, bank.getVarId("py"),            bank.getVarType("py"),  py);
+	addVector(event, GENERATED_PARTICLES_BANK_TAG, bank.getVarId("pz"),            bank.getVarType("pz"),  pz);
+	addVector(event, GENERATED_PARTICLES_BANK_TAG, bank.getVarId("vx"),            bank.getVarType("vx"),  vx);
+	addVector(event, GENERATED_PARTICLES_BANK_TAG, bank.getVarId("vy"),            bank.getVarType("vy"),  vy);
+	addVector(event, GENERATED_PARTICLES_BANK_TAG, bank.getVarId("vz"),            bank.getVarType("vz"),  vz);
+	addVector(event, GENERATED_PARTICLES_BANK_TAG, bank.getVarId("time"),          bank.getVarType("time"), btime);
+	addVector(event, GENERATED_PARTICLES_BANK_TAG, bank.getVarId("multiplicity"),  bank.getVarType("multiplicity"), multiplicity);
 
 
 
@@ -240,33 +246,33 @@ void evio_output :: writeGenerated(outputContainer* output, vector<generatedPart
 			}
 		}
 
-		evioDOMNodeP summaryBank = evioDOMNode::createEvioDOMNode(GENERATED_SUMMARY_BANK_TAG, 0);
-		*summaryBank << addVector(GENERATED_SUMMARY_BANK_TAG, sbank.getVarId("dname"), bank.getVarType("dname"), dname);
-		*summaryBank << addVector(GENERATED_SUMMARY_BANK_TAG, sbank.getVarId("stat"),  bank.getVarType("stat"),  stat);
-		*summaryBank << addVector(GENERATED_SUMMARY_BANK_TAG, sbank.getVarId("etot"),  bank.getVarType("etot"),  etot);
-		*summaryBank << addVector(GENERATED_SUMMARY_BANK_TAG, sbank.getVarId("nphe"),  bank.getVarType("nphe"),  etot);
-		*summaryBank << addVector(GENERATED_SUMMARY_BANK_TAG, sbank.getVarId("t"),     bank.getVarType("t"),     time);
+		event->openBank(GENERATED_SUMMARY_BANK_TAG, 0);
+		addVector(event, GENERATED_SUMMARY_BANK_TAG, sbank.getVarId("dname"), bank.getVarType("dname"), dname);
+		addVector(event, GENERATED_SUMMARY_BANK_TAG, sbank.getVarId("stat"),  bank.getVarType("stat"),  stat);
+		addVector(event, GENERATED_SUMMARY_BANK_TAG, sbank.getVarId("etot"),  bank.getVarType("etot"),  etot);
+		addVector(event, GENERATED_SUMMARY_BANK_TAG, sbank.getVarId("nphe"),  bank.getVarType("nphe"),  etot);
+		addVector(event, GENERATED_SUMMARY_BANK_TAG, sbank.getVarId("t"),     bank.getVarType("t"),     time);
 
 		if(writeFastMC) {
-			*summaryBank << addVector(GENERATED_SUMMARY_BANK_TAG, sbank.getVarId("upx"),   bank.getVarType("upx"),    ufpx);
-			*summaryBank << addVector(GENERATED_SUMMARY_BANK_TAG, sbank.getVarId("upy"),   bank.getVarType("upy"),    ufpy);
-			*summaryBank << addVector(GENERATED_SUMMARY_BANK_TAG, sbank.getVarId("upz"),   bank.getVarType("upz"),    ufpz);
-			*summaryBank << addVector(GENERATED_SUMMARY_BANK_TAG, sbank.getVarId("spx"),   bank.getVarType("spx"),    sfpx);
-			*summaryBank << addVector(GENERATED_SUMMARY_BANK_TAG, sbank.getVarId("spy"),   bank.getVarType("spy"),    sfpy);
-			*summaryBank << addVector(GENERATED_SUMMARY_BANK_TAG, sbank.getVarId("spz"),   bank.getVarType("spz"),    sfpz);
+			addVector(event, GENERATED_SUMMARY_BANK_TAG, sbank.getVarId("upx"),   bank.getVarType("upx"),    ufpx);
+			addVector(event, GENERATED_SUMMARY_BANK_TAG, sbank.getVarId("upy"),   bank.getVarType("upy"),    ufpy);
+			addVector(event, GENERATED_SUMMARY_BANK_TAG, sbank.getVarId("upz"),   bank.getVarType("upz"),    ufpz);
+			addVector(event, GENERATED_SUMMARY_BANK_TAG, sbank.getVarId("spx"),   bank.getVarType("spx"),    sfpx);
+			addVector(event, GENERATED_SUMMARY_BANK_TAG, sbank.getVarId("spy"),   bank.getVarType("spy"),    sfpy);
+			addVector(event, GENERATED_SUMMARY_BANK_TAG, sbank.getVarId("spz"),   bank.getVarType("spz"),    sfpz);
 		}
 
 
 
-		*generatedp << summaryBank;
+		event->closeBank();
 	}
 
-	*event << generatedp;
+	event->closeBank();
 
 	// user information
 	// storing 25 info / particles
 	// if no user infos, these are all 0s
-	evioDOMNodeP userInfoBank = evioDOMNode::createEvioDOMNode(GENERATED_USE_INFO_TAG, 0);
+	event->openBank(GENERATED_USE_INFO_TAG, 0);
 	for(unsigned i=0; i<25; i++) {
 		// particle is the index
 		vector<double> userVar(userInfo.size(), 0);
@@ -276,9 +282,9 @@ void evio_output :: writeGenerated(outputContainer* output, vector<generatedPart
 				userVar[p] = userInfo[p].infos[i];
 			}
 		}
-		*userInfoBank << addVector(GENERATED_USE_INFO_TAG, i+1, "d", userVar);
+		addVector(event, GENERATED_USE_INFO_TAG, i+1, "d", userVar);
 	}
-	*event << userInfoBank;
+	event->closeBank();
 
 }
 
@@ -310,87 +316,53 @@ void evio_output :: writeAncestors (outputContainer* output, vector<ancestorInfo
     }
 
   // creating and inserting ancestors bank  
-  evioDOMNodeP ancestorsp = evioDOMNode::createEvioDOMNode(ANCESTORS_BANK_TAG, 0);
+  event->closeBanks(1);
+  event->openBank(ANCESTORS_BANK_TAG, 0);
   
-  *ancestorsp << addVector(ANCESTORS_BANK_TAG, bank.getVarId("pid"),
+  addVector(event, ANCESTORS_BANK_TAG, bank.getVarId("pid"),
 			   bank.getVarType("pid"), pid);
-  *ancestorsp << addVector(ANCESTORS_BANK_TAG, bank.getVarId("tid"),
+  addVector(event, ANCESTORS_BANK_TAG, bank.getVarId("tid"),
 			   bank.getVarType("tid"), tid);
-  *ancestorsp << addVector(ANCESTORS_BANK_TAG, bank.getVarId("mtid"),
+  addVector(event, ANCESTORS_BANK_TAG, bank.getVarId("mtid"),
 			   bank.getVarType("mtid"), mtid);
-  *ancestorsp << addVector(ANCESTORS_BANK_TAG, bank.getVarId("trackE"),
+  addVector(event, ANCESTORS_BANK_TAG, bank.getVarId("trackE"),
 			   bank.getVarType("trackE"), trackE);
-  *ancestorsp << addVector(ANCESTORS_BANK_TAG, bank.getVarId("px"),
+  addVector(event, ANCESTORS_BANK_TAG, bank.getVarId("px"),
 			   bank.getVarType("px"),  px);
-  *ancestorsp << addVector(ANCESTORS_BANK_TAG, bank.getVarId("py"),
+  addVector(event, ANCESTORS_BANK_TAG, bank.getVarId("py"),
 			   bank.getVarType("py"),  py);
-  *ancestorsp << addVector(ANCESTORS_BANK_TAG, bank.getVarId("pz"),
+  addVector(event, ANCESTORS_BANK_TAG, bank.getVarId("pz"),
 			   bank.getVarType("pz"),  pz);
-  *ancestorsp << addVector(ANCESTORS_BANK_TAG, bank.getVarId("vx"),
+  addVector(event, ANCESTORS_BANK_TAG, bank.getVarId("vx"),
 			   bank.getVarType("vx"),  vx);
-  *ancestorsp << addVector(ANCESTORS_BANK_TAG, bank.getVarId("vy"),
+  addVector(event, ANCESTORS_BANK_TAG, bank.getVarId("vy"),
 			   bank.getVarType("vy"),  vy);
-  *ancestorsp << addVector(ANCESTORS_BANK_TAG, bank.getVarId("vz"),
+  addVector(event, ANCESTORS_BANK_TAG, bank.getVarId("vz"),
 			   bank.getVarType("vz"),  vz);
-  *event << ancestorsp;
+  event->closeBank();
 }
 
+// the detector bank stays open while its sub-banks are written
+// a new detector or sub-bank closes the previous one
 void evio_output :: initBank(outputContainer* output, gBank thisHitBank, int what)
 {
-
-	static int oldEvn;
-
-	// new event, initialize everything
-	if(oldEvn != evn)
-	{
-		insideBank.clear();
-		insideRawIntBank.clear();
-		insideDgtIntBank.clear();
-		insideRawAllBank.clear();
-		oldEvn = evn;
-	}
-
-	if(!insideBank[thisHitBank.bankName])
+	// master bank
+	if(detectorBank != thisHitBank.bankName || event->depth() < 2)
 	{
-		// master bank
-		detectorBank = evioDOMNode::createEvioDOMNode(thisHitBank.idtag, DETECTOR_BANK_ID);
-		*event << detectorBank;
-		insideBank[thisHitBank.bankName] = 1;
+		event->closeBanks(1);
+		event->openBank(thisHitBank.idtag, DETECTOR_BANK_ID);
+		detectorBank    = thisHitBank.bankName;
+		detectorSubBank = -1;
 	}
 
-	// true information (integrated)
-	if(!insideRawIntBank[thisHitBank.bankName] && what == RAWINT_ID)
+	// true information (integrated), digitized information,
+	// true information (step by step), charge / time information (step by step)
+	if(detectorSubBank != what)
 	{
-		detectorRawIntBank[thisHitBank.bankName] = evioDOMNode::createEvioDOMNode(thisHitBank.idtag + RAWINT_ID, 0);
-		*detectorBank << detectorRawIntBank[thisHitBank.bankName];
-		insideRawIntBank[thisHitBank.bankName] = 1;
+		event->closeBanks(2);
+		event->openBank(thisHitBank.idtag + what, 0);
+		detectorSubBank = what;
 	}
-
-	// digitized information
-	if(!insideDgtIntBank[thisHitBank.bankName] && what == DGTINT_ID)
-	{
-		detectorDgtIntBank[thisHitBank.bankName] = evioDOMNode::createEvioDOMNode(thisHitBank.idtag + DGTINT_ID, 0);
-		*detectorBank << detectorDgtIntBank[thisHitBank.bankName];
-		insideDgtIntBank[thisHitBank.bankName] = 1;
-	}
-
-	// true information (step by step)
-	if(!insideRawAllBank[thisHitBank.bankName] && what == RAWSTEP_ID)
-	{
-		detectorRawAllBank[thisHitBank.bankName] = evioDOMNode::createEvioDOMNode(thisHitBank.idtag + RAWSTEP_ID, 0);
-		*detectorBank << detectorRawAllBank[thisHitBank.bankName];
-		insideRawAllBank[thisHitBank.bankName] = 1;
-	}
-
-	// charge / time information (step by step)
-	if(!insideChargeTimeBank[thisHitBank.bankName] && what == CHARGE_TIME_ID)
-	{
-		detectorChargeTimeBank[thisHitBank.bankName] = evioDOMNode::createEvioDOMNode(thisHitBank.idtag + CHARGE_TIME_ID, 0);
-		*detectorBank << detectorChargeTimeBank[thisHitBank.bankName];
-		insideChargeTimeBank[thisHitBank.bankName] = 1;
-	}
-
-
 }
 
 
@@ -419,7 +391,7 @@ void evio_output :: writeG4RawIntegrated(outputContainer* output, vector<hitOutp
 				map<string, double> theseRaws = HO[nh].getRaws();
 				thisVar.push_back(theseRaws[it->second]);
 			}
-			*(detectorRawIntBank[thisHitBank.bankName]) << addVector(rawBank.idtag + thisHitBank.idtag, bankId, rawBank.getVarType(it->second), thisVar);
+			addVector(event, rawBank.idtag + thisHitBank.idtag, bankId, rawBank.getVarType(it->second), thisVar);
 		}
 	}
 }
@@ -450,7 +422,7 @@ void evio_output :: writeG4DgtIntegrated(outputContainer* output, vector<hitOutp
 				map<string, double> theseDgts = HO[nh].getDgtz();
 				thisVar.push_back(theseDgts[it->second]);
 			}
-			*(detectorDgtIntBank[thisHitBank.bankName]) << addVector(dgtBank.idtag + thisHitBank.idtag, bankId, dgtBank.getVarType(it->second), thisVar);
+			addVector(event, dgtBank.idtag + thisHitBank.idtag, bankId, dgtBank.getVarType(it->second), thisVar);
 		}
 	}
 }
@@ -505,15 +477,15 @@ void evio_output :: writeChargeTime(outputContainer* output, vector<hitOutput> H
 	if(chargeTimeBank.getVarBankType("id") == CHARGE_TIME_ID)
 	{
 		// hit number
-		*(detectorChargeTimeBank[thisHitBank.bankName]) << addVector(chargeTimeBank.idtag + thisHitBank.idtag, chargeTimeBank.getVarId("hitn"), chargeTimeBank.getVarType("hitn"), allHitN);
+		addVector(event, chargeTimeBank.idtag + thisHitBank.idtag, chargeTimeBank.getVarId("hitn"), chargeTimeBank.getVarType("hitn"), allHitN);
 		// step index
-		*(detectorChargeTimeBank[thisHitBank.bankName]) << addVector(chargeTimeBank.idtag + thisHitBank.idtag, chargeTimeBank.getVarId("stepi"), chargeTimeBank.getVarType("stepi"), allStep);
+		addVector(event, chargeTimeBank.idtag + thisHitBank.idtag, chargeTimeBank.getVarId("stepi"), chargeTimeBank.getVarType("stepi"), allStep);
 		// vector of identifiers - have to match the translation table
-		*(detectorChargeTimeBank[thisHitBank.bankName]) << addVector(chargeTimeBank.idtag + thisHitBank.idtag, chargeTimeBank.getVarId("id"), chargeTimeBank.getVarType("id"), allID);
+		addVector(event, chargeTimeBank.idtag + thisHitBank.idtag, chargeTimeBank.getVarId("id"), chargeTimeBank.getVarType("id"), allID);
 		// charge at electronics
-		*(detectorChargeTimeBank[thisHitBank.bankName]) << addVector(chargeTimeBank.idtag + thisHitBank.idtag, chargeTimeBank.getVarId("q"), chargeTimeBank.getVarType("q"), allCharge);
+		addVector(event, chargeTimeBank.idtag + thisHitBank.idtag, chargeTimeBank.getVarId("q"), chargeTimeBank.getVarType("q"), allCharge);
 		// time at electronics
-		*(detectorChargeTimeBank[thisHitBank.bankName]) << addVector(chargeTimeBank.idtag + thisHitBank.idtag, chargeTimeBank.getVarId("t"), chargeTimeBank.getVarType("t"), allTime);
+		addVector(event, chargeTimeBank.idtag + thisHitBank.idtag, chargeTimeBank.getVarId("t"), chargeTimeBank.getVarType("t"), allTime);
 	}
 
 
@@ -552,741 +524,376 @@ void evio_output :: writeG4RawAll(outputContainer* output, vector<hitOutput> HO,
 			}
 
 
-			*(detectorRawAllBank[thisHitBank.bankName]) << addVector(allRawsBank.idtag + thisHitBank.idtag, bankId, allRawsBank.getVarType(it->second), thisVar);
+			addVector(event, allRawsBank.idtag + thisHitBank.idtag, bankId, allRawsBank.getVarType(it->second), thisVar);
 		}
 	}
 }
 
-void evio_output :: writeFADCMode1( map<int,  vector<hitOutput> > HO , int ev_number){
-
-	if(HO.size() == 0) return;
-
-	// ==== Following variables are needed for EVIO util functions PUT16, PUT31 etc
-	unsigned char *b08out;
-	unsigned short *b16;
-	unsigned int *b32;
-	unsigned long long *b64;
-
-	// This variable will store the buffer address when crate changes
-	unsigned int *buf_crate_begin = nullptr; //
-
-	// The map of hardware data, The Key is the crate/slot/channel combination,
-	// and the value is a map of FADC counts as a function of sample number.
-	// Note: 1st three counts represents actually the hardware identification info, i.e. crate/slot/channel, and other elements starting
-	// from 3 up to nsamples+3 represent FADC counts
-	map<string, map<int, int> > hardwareData;
+// collects the FADC channels of the hits: crate/slot/channel packed key, pedestal and samples
+// only hits with steps in the electronic time window are used
+static void addFADCChannels(const vector<hitOutput> &HO, vector<fadcChannel> &channels)
+{
+	for(auto &hit: HO) {
 
-	// map that counts how many channels are in the crate
-	map<string, int> numberOfChannelsPerCrate;
+		const map<int, vector<double> > &chargeTime = hit.getChargeTime();
+		map<int, vector<double> >::const_iterator stepTimes = chargeTime.find(3);
+		if(stepTimes == chargeTime.end() || stepTimes->second.size() == 0) continue;
 
-	//for(unsigned int nh=0; nh<HO.size(); nh++) {
-	for (std::map<int, vector<hitOutput> >::iterator it_crate=HO.begin(); it_crate!=HO.end(); ++it_crate){
 		// QuantumS is a map, KEY is an FADC sample number, and value is the FADC counts
 		// NOTE 1st three elements of it (KEY = 0, 1, 2) represent crate/slot/chann, and KEYs (3, 4, ... nsampes+2 ) represent FADC counts
+		const map<int, int> &quantumS = hit.getQuantumS();
+		if(quantumS.size() < 3) continue;
 
-		for( unsigned int i_hit = 0; i_hit < it_crate->second.size(); i_hit++ ){
-
-			map<int, int> quantumS = (it_crate->second).at(i_hit).getQuantumS();
-
-			// Let's get hardware identifiers
-			string crate = fillDigits(to_string((int) quantumS[0]), "#", 5);
-			string slot  = fillDigits(to_string((int) quantumS[1]), "#", 5);
-			string chann = fillDigits(to_string((int) quantumS[2]), "#", 5);
+		map<int, int>::const_iterator it = quantumS.begin();
+		int crate = (it++)->second;
+		int slot  = (it++)->second;
+		int chann = (it++)->second;
 
-			// crate-slot-channel key
-			string hardwareKey = crate + "-" + slot + "-" + chann;
+		fadcChannel channel(crate, slot, chann);
 
-			// only fill hardware if it's not present already
-			// the time window of a detector could be smaller than
-			// the electronic time window
-			// Make sure also the vector of step times is not empty,
-			if(hardwareData.find(hardwareKey) == hardwareData.end() && (it_crate->second.at(i_hit).getChargeTime()[3]).size() > 0  ) {
-				hardwareData[hardwareKey] = it_crate->second.at(i_hit).getQuantumS();
-			} else {
-				// ======== It was checked, here we have only empty hits, or hits that way off in time, e.g. hit_t = 1200ns
-//                            cout<<"Warning this hardware is already filled"<<endl;
-//			    cout<<"hardwareKey is "<<hardwareKey<<"      !!!"<<endl;
-//                            for( int ii = 0; ii < (it_crate->second.at(i_hit).getChargeTime()[3]).size();ii++ ){
-//                            
-//                               cout<<"       time = " <<(it_crate->second.at(i_hit).getChargeTime()[3]).at(ii)<<"     ";
-//                            }
-//                            cout<<endl;
-                            
-		            continue;
-			}
+		map<int, vector<double> >::const_iterator hardware = chargeTime.find(5);
+		if(hardware != chargeTime.end() && hardware->second.size() > 3)
+			channel.pedestal = (int) hardware->second[3];
 
-			// We should keep track of number of channels in the crate
-			// With this counter, This counter will show, whether all the channels in that crate are already processed
+		channel.samples.reserve(quantumS.size() - 3);
+		for(; it != quantumS.end(); it++)
+			channel.samples.push_back((uint16_t) abs(it->second));
 
-			string CrateKey = crate;
-
-			if( numberOfChannelsPerCrate.find(CrateKey) == numberOfChannelsPerCrate.end() ){
-				numberOfChannelsPerCrate[CrateKey] = 1;
-			} else {
-				numberOfChannelsPerCrate[CrateKey] ++;
-			}
-
-		}
+		channels.push_back(channel);
 	}
+}
 
-	// Now we have hardware data for all crate/slot/channel combinations, and can start filling the buffer
-
-	int oldCrate    = -1;
-	int oldSlot     = -1;
-
-	b08out = (uint8_t*) buf;
-
-	uint32_t *nchannels = nullptr;
-	uint32_t *nsamples;
-
-	evioDOMNodeP newCrate = nullptr;
-
-	int nchannelThisCrate = 0;
-	int ncrates = 0;
-
-
-	for(auto &hd : hardwareData) {
-
-		vector<string> thisHardwareKey = getStringVectorFromStringWithDelimiter(hd.first, "-");
-
-		int crate = stoi(trimSpacesFromString(replaceCharInStringWithChars(thisHardwareKey[0], "#", " ")));
-		int slot  = stoi(trimSpacesFromString(replaceCharInStringWithChars(thisHardwareKey[1], "#", " ")));
-		int chann = stoi(trimSpacesFromString(replaceCharInStringWithChars(thisHardwareKey[2], "#", " ")));
-
-		string scrate = fillDigits(to_string(crate), "#", 5);
-		string sslot  = fillDigits(to_string(slot),  "#", 5);
-		string hardwareKey = scrate + "-" + sslot;
-		string sCrateKey = scrate;
-
-
-		//  Check, if the crate is new crate, then save the curre
-		if(oldCrate != crate) {
-			oldCrate = crate;
-			oldSlot = -1;  // resetting slot, it's a new crate
-			nchannelThisCrate  = 0;
-
-			buf_crate_begin = (unsigned int*)b08out;
-			//buf_crate_begin = (char*)b08out;
-			ncrates = ncrates + 1;
-
-			newCrate = evioDOMNode::createEvioDOMNode(crate, 0);
-
-			// We want to check whether FADC conf data is written into evio, if not it will
-			// write data and will erase corresponding crate element from the vector, for the
-			// next time this data to not be written
-			std::vector<int>::iterator it_crate = find(detector_crates.begin(), detector_crates.end(), crate);
-
-			//
-			if( it_crate != detector_crates.end() ){
-
-				int confbankbanktag = 0xe10e;
-
-				evioDOMNodeP confbank = evioDOMNode::createEvioDOMNode<string>(confbankbanktag, crate);
-
-				int n_slotes = 19;
-				int n_chann = 16;
-
-				string conf_parms;
-
-				conf_parms = conf_parms + "\n";
-				for( int i_sl = 0; i_sl < n_slotes; i_sl++ ){
-
-					conf_parms = conf_parms + "FADC250_SLOT " + to_string(i_sl) + "\nFADC250_NSB " + to_string(12) + "\nFADC250_NSA " + to_string(36) + "\nFADC250_ALLCH_PED ";
-					for( int i_ch = 0; i_ch < n_chann; i_ch++ ){
-						conf_parms = conf_parms + " " + to_string(101.0);
-					}
-					conf_parms = conf_parms +"\n";
-					conf_parms = conf_parms + "FADC250_ALLCH_TET ";
-					for( int i_ch = 0; i_ch < n_chann; i_ch++ ){
-						conf_parms = conf_parms + " " + to_string(20);
-					}
-					conf_parms = conf_parms +"\n";
-					conf_parms = conf_parms + "FADC250_ALLCH_GAIN ";
-					for( int i_ch = 0; i_ch < n_chann; i_ch++ ){
-						conf_parms = conf_parms + " " + to_string(1.);
-					}
-
-					conf_parms = conf_parms +"\n";
-
-				}
-
-				*confbank<<conf_parms;
-				*newCrate << confbank;
-				*event << newCrate;
-
-				detector_crates.erase(it_crate);
-			}
-
-		}
-
-		nchannelThisCrate = nchannelThisCrate + 1;
-
-		// every slot has its own bank
-		if(oldSlot != slot) {
+// FADC configuration of a crate
+static string fadcConfiguration(int TET, int NSB, int NSA)
+{
+	int n_slotes = 19;
+	int n_chann = 16;
 
-			oldSlot = slot;
+	string conf_parms = "\n";
+	for( int i_sl = 0; i_sl < n_slotes; i_sl++ ){
 
-			PUT8(slot); // slot number
-			PUT32(ev_number);   // event number
-			PUT64(1);   // time stamp
-			nchannels = (uint32_t*) b08out; // put channels dinamically: first, save current position
-			PUT32(0);   // now reserve space for channel counter
+		conf_parms = conf_parms + "FADC250_SLOT " + to_string(i_sl) + "\nFADC250_NSB " + to_string(NSB) + "\nFADC250_NSA " + to_string(NSA) + "\nFADC250_ALLCH_PED ";
+		for( int i_ch = 0; i_ch < n_chann; i_ch++ ){
+			conf_parms = conf_parms + " " + to_string(101.0);
 		}
-
-		if(nchannels != nullptr) *nchannels = *nchannels + 1;
-
-		PUT8(chann); // channel number
-
-		nsamples = (uint32_t*) b08out; // put multi-hit dinamically: first, save current position
-		PUT32(0); // now reserve space for sample counter
-		for( map<int, int>::iterator it_isample = (hd.second).begin(); it_isample != (hd.second).end(); it_isample++ ) {
-
-			// Remember 1st three elements are crate/slot/chann, therefore we want other elements hd[3], hd[4] ... hd[nsample + 3 -1]
-			if( it_isample->first < 3 ){
-				continue;
-			}
-
-			//cout<<"value = "<<it_isample->second<<endl;
-			PUT16(abs(it_isample->second));
-			*nsamples = *nsamples + 1;
+		conf_parms = conf_parms +"\n";
+		conf_parms = conf_parms + "FADC250_ALLCH_TET ";
+		for( int i_ch = 0; i_ch < n_chann; i_ch++ ){
+			conf_parms = conf_parms + " " + to_string(TET);
 		}
-
-
-
-		// Check if all the data under this crate is processed, if yes, the
-		// data should be dumped into evio
-		if( nchannelThisCrate == numberOfChannelsPerCrate[sCrateKey] && newCrate != nullptr ){
-
-			//int finalNumberOfWords = (b08out - (uint8_t*)buf_crate_begin + 3) / 4;
-			//int finalNumberOfWords = (b08out - (uint8_t*)buf_crate_begin + 3) / 4;
-			//int finalNumberOfWords = (b08out + 4 - (uint8_t*)buf_crate_begin) / 4;
-
-			//int padding = (uint8_t*)buf_crate_begin + 4*finalNumberOfWords - b08out;
-
-			//*newCrate << evioDOMNode::createEvioDOMNode(banktag, 0, strlen("c,i,l,N(c,Ns)"), "c,i,l,N(c,Ns)", 63, 64, buf_crate_begin, finalNumberOfWords, padding);  // Sergei wanted num to be set 0
-			*newCrate << evioDOMNode::createEvioDOMNode(fadc_mode1_banktag, 0, "c,i,l,N(c,Ns)", 63, 64, buf_crate_begin, (uint32_t*)b08out);  // Sergei wanted num to be set 0
-			*event << newCrate;
+		conf_parms = conf_parms +"\n";
+		conf_parms = conf_parms + "FADC250_ALLCH_GAIN ";
+		for( int i_ch = 0; i_ch < n_chann; i_ch++ ){
+			conf_parms = conf_parms + " " + to_string(1.);
 		}
-
+		conf_parms = conf_parms +"\n";
 	}
 
-	// ======= At this moment all the FADCMode1 data is already written, so below
-	// the program should iterate over remaining elements of detector_crates, and for each one
-	// write FADC_conf paratmeters into evio
-
-
-	if( detector_crates.size() >=1 ){
-
-		for( vector<int>::iterator it_crate = detector_crates.begin(); it_crate != detector_crates.end(); it_crate++ ){
-
-			int cur_crate = *it_crate;
-
-			newCrate = evioDOMNode::createEvioDOMNode(cur_crate, 0);
+	return conf_parms;
+}
 
-			int confbanktag = 0xe10e;
+// firmware style pulse finding: a pulse starts when a sample crosses pedestal + TET
+// the integral is the sum of the samples from NSB samples before to NSA samples after the crossing
+// pulse min is the average of the first 4 samples of the window, pulse max the peak
+// the pulse time is in 1/64 of sample, at half amplitude on the leading edge
+static vector<fadcPulse> findFADCPulses(const fadcChannel &channel, int TET, int NSB, int NSA)
+{
+	// the firmware reports up to 4 pulses
+	const unsigned maxPulses = 4;
 
-			evioDOMNodeP confbank = evioDOMNode::createEvioDOMNode<string>(confbanktag, cur_crate);  // Sergei mentioned that Num should be crate number,
+	vector<fadcPulse> pulses;
+	const vector<uint16_t> &s = channel.samples;
+	int n = s.size();
 
-			int n_slotes = 19;
-			int n_chann = 16;
+	int i = 0;
+	while(i < n && pulses.size() < maxPulses) {
 
-			string conf_parms;
+		if(s[i] - channel.pedestal <= TET) {
+			i++;
+			continue;
+		}
 
-			conf_parms = conf_parms + "\n";
-			for( int i_sl = 0; i_sl < n_slotes; i_sl++ ){
+		int first = max(0, i - NSB);
+		int last  = min(n - 1, i + NSA);
+
+		fadcPulse pulse;
+		pulse.integral = 0;
+		pulse.max = 0;
+		int peak = i;
+		for(int k=first; k<=last; k++) {
+			pulse.integral += s[k];
+			if(s[k] > pulse.max) {
+				pulse.max = s[k];
+				peak = k;
+			}
+		}
 
-				conf_parms = conf_parms + "FADC250_SLOT " + to_string(i_sl) +  "\nFADC250_NSB " + to_string(12) + "\nFADC250_NSA " + to_string(36) + "\nFADC250_ALLCH_PED ";
-				for( int i_ch = 0; i_ch < n_chann; i_ch++ ){
-					conf_parms = conf_parms + " " + to_string(101.0);
-				}
-				conf_parms = conf_parms +"\n";
-				conf_parms = conf_parms + "FADC250_ALLCH_TET ";
-				for( int i_ch = 0; i_ch < n_chann; i_ch++ ){
-					conf_parms = conf_parms + " " + to_string(20);
-				}
-				conf_parms = conf_parms +"\n";
-				conf_parms = conf_parms + "FADC250_ALLCH_GAIN ";
-				for( int i_ch = 0; i_ch < n_chann; i_ch++ ){
-					conf_parms = conf_parms + " " + to_string(1.);
-				}
+		int nped = min(4, last - first + 1);
+		int ped  = 0;
+		for(int k=first; k<first+nped; k++) ped += s[k];
+		pulse.min = ped / nped;
 
-				conf_parms = conf_parms +"\n";
+		double vmid = 0.5*(pulse.min + pulse.max);
+		int k = first;
+		while(k < peak && s[k] < vmid) k++;
+		if(k > first && s[k] != s[k-1])
+			pulse.time = (uint16_t) (64*(k - 1) + 64*(vmid - s[k-1])/(s[k] - s[k-1]));
+		else
+			pulse.time = (uint16_t) (64*k);
 
-			}
+		pulses.push_back(pulse);
 
-			*confbank<<conf_parms;
-			*newCrate << confbank;
-			*event << newCrate;
-		}
-		detector_crates.clear();
+		i = last + 1;
 	}
 
-
+	return pulses;
 }
 
 
-// write fadc mode 1 (full signal shape) - jlab hybrid banks. This uses the translation table to write the crate/slot/channel
-// This function takes as an argument vector of hitOutputs, and writes all hits into evio in a Mode1 format
-void evio_output :: writeFADCMode1(outputContainer* output, vector<hitOutput> HO, int ev_number)
+// writes the FADC crates of the event
+// FADC_MODE full: mode 1 waveforms, zs: waveforms of the channels above threshold, pulse: mode 7 pulses
+void evio_output :: writeFADCChannels(outputContainer* output, vector<fadcChannel> &channels, int ev_number, bool pulses)
 {
-	if(HO.size() == 0) return;
-
 	// ==== Following variables are needed for EVIO util functions PUT16, PUT31 etc
 	unsigned char *b08out;
 	unsigned short *b16;
 	unsigned int *b32;
 	unsigned long long *b64;
 
+	// sorted once by crate/slot/channel. The first hit of a channel is written:
+	// the time window of a detector could be smaller than the electronic time window
+	stable_sort(channels.begin(), channels.end(), [](const fadcChannel &a, const fadcChannel &b) {return a.key < b.key;});
+	channels.erase(unique(channels.begin(), channels.end(), [](const fadcChannel &a, const fadcChannel &b) {return a.key == b.key;}), channels.end());
+
+	int TET = output->fadcTET;
+	int NSB = (int) (output->fadcNSB / output->fadcSampling);
+	int NSA = (int) (output->fadcNSA / output->fadcSampling);
+	bool zeroSuppressed = output->fadcMode == "zs";
+
+	// crates are written at the event level
+	event->closeBanks(1);
+
+	unsigned c = 0;
+	while(c < channels.size()) {
+
+		int crate = channels[c].crate();
+
+		// channels of this crate
+		unsigned cend = c;
+		while(cend < channels.size() && channels[cend].crate() == crate) cend++;
+
+		// channels written: all of them in full mode, above threshold in zs mode, with pulses in pulse mode
+		vector<unsigned> selected;
+		vector<vector<fadcPulse> > selectedPulses;
+		for(unsigned ch=c; ch<cend; ch++) {
+			const fadcChannel &channel = channels[ch];
+
+			if(pulses) {
+				vector<fadcPulse> channelPulses = findFADCPulses(channel, TET, NSB, NSA);
+				if(channelPulses.size() == 0) continue;
+				selectedPulses.push_back(channelPulses);
+			} else if(zeroSuppressed) {
+				bool above = false;
+				for(auto sample: channel.samples)
+					if(sample - channel.pedestal > TET) {
+						above = true;
+						break;
+					}
+				if(!above) continue;
+			}
+			selected.push_back(ch);
+		}
 
-	// This variable will store the buffer address when crate changes
-	unsigned int *buf_crate_begin = nullptr; //
-	//char *buf_crate_begin; //
-
-	// The FADC Mode1 Bank tag
-	int banktag = 0xe101;
-
-
-	// The map of hardware data, The Key is the crate/slot/channel combination,
-	// and the value is a map of FADC counts as a function of sample number.
-	// Note: 1st three counts represents actually the hardware identification info, i.e. crate/slot/channel, and other elements starting
-	// from 3 up to nsamples+3 represent FADC counts
-	map<string, map<int, int> > hardwareData;
-
-	// map that counts how many channels are in the crate
-	map<string, int> numberOfChannelsPerCrate;
-
-	for(unsigned int nh=0; nh<HO.size(); nh++) {
-
-		// QuantumS is a map, KEY is an FADC sample number, and value is the FADC counts
-		// NOTE 1st three elements of it (KEY = 0, 1, 2) represent crate/slot/chann, and KEYs (3, 4, ... nsampes+2 ) represent FADC counts
-		map<int, int> quantumS = HO[nh].getQuantumS();
-
-		// Let's get hardware identifiers
-		string crate = fillDigits(to_string((int) quantumS[0]), "#", 5);
-		string slot  = fillDigits(to_string((int) quantumS[1]), "#", 5);
-		string chann = fillDigits(to_string((int) quantumS[2]), "#", 5);
-
-		// crate-slot-channel key
-		string hardwareKey = crate + "-" + slot + "-" + chann;
-
-		// only fill hardware if it's not present already
-		// the time window of a detector could be smaller than
-		// the electronic time window
-		// Make sure also the vector of step times is not empty,
-		if(hardwareData.find(hardwareKey) == hardwareData.end() && (HO[nh].getChargeTime()[3]).size() > 0  ) {
-			hardwareData[hardwareKey] = HO[nh].getQuantumS();
-
-			vector<double> stepTimes   = HO[nh].getChargeTime()[3];
-
-		} else {
-
-			// ======== It was checked, here we have only empty hits, or hits that way off in time, e.g. hit_t = 1200ns
-			//cout<<"hardwareKey is "<<hardwareKey<<"      !!!"<<endl;
+		// no empty crate bank. If this is the first time the crate is seen,
+		// its configuration is written with the crates without hits below
+		if(selected.empty()) {
+			c = cend;
 			continue;
 		}
 
-		// We should keep track of number of channels in the crate
-		// With this counter, This counter will show, whether all the channels in that crate are already processed
-
-		string CrateKey = crate;
-
-		if( numberOfChannelsPerCrate.find(CrateKey) == numberOfChannelsPerCrate.end() ){
-			numberOfChannelsPerCrate[CrateKey] = 1;
-		} else {
-			numberOfChannelsPerCrate[CrateKey] ++;
+		// the mode 7 crate banks have num 1
+		event->openBank(crate, pulses ? 1 : 0);
+
+		// the FADC configuration is written only once, in the first physics event with the crate
+		vector<int>::iterator it_crate = find(detector_crates.begin(), detector_crates.end(), crate);
+		if(it_crate != detector_crates.end()) {
+			string conf_parms = fadcConfiguration(output->fadcTET, output->fadcNSB, output->fadcNSA);
+			evioDOMNodeP confbank = evioDOMNode::createEvioDOMNode<string>(0xe10e, crate);  // Sergei mentioned that Num should be crate number,
+			*confbank << conf_parms;
+			event->addNode(confbank, conf_parms.size()/4 + 2);
+			detector_crates.erase(it_crate);
 		}
 
+		b08out = (uint8_t*) buf;
 
-	}
-
-
-	// Now we have hardware data for all crate/slot/channel combinations, and can start filling the buffer
-
-	int oldCrate    = -1;
-	int oldSlot     = -1;
-
-	b08out = (uint8_t*) buf;
-
-	uint32_t *nchannels = nullptr;
-	uint32_t *nsamples;
-
-	evioDOMNodeP newCrate = nullptr;
-
-	int nchannelThisCrate = 0;
-	int ncrates = 0;
-
-	for(auto &hd : hardwareData) {
-
-		vector<string> thisHardwareKey = getStringVectorFromStringWithDelimiter(hd.first, "-");
-
-		int crate = stoi(trimSpacesFromString(replaceCharInStringWithChars(thisHardwareKey[0], "#", " ")));
-		int slot  = stoi(trimSpacesFromString(replaceCharInStringWithChars(thisHardwareKey[1], "#", " ")));
-		int chann = stoi(trimSpacesFromString(replaceCharInStringWithChars(thisHardwareKey[2], "#", " ")));
-
-		string scrate = fillDigits(to_string(crate), "#", 5);
-		string sslot  = fillDigits(to_string(slot),  "#", 5);
-		string hardwareKey = scrate + "-" + sslot;
-		string sCrateKey = scrate;
-
-
-		//  Check, if the crate is new crate, then save the curre
-		if(oldCrate != crate) {
-			oldCrate = crate;
-			oldSlot = -1;  // resetting slot, it's a new crate
-			nchannelThisCrate  = 0;
+		uint32_t *nchannels = nullptr;
+		int oldSlot = -1;
 
-			buf_crate_begin = (unsigned int*)b08out;
-			//buf_crate_begin = (char*)b08out;
-			ncrates = ncrates + 1;
+		for(unsigned s=0; s<selected.size(); s++) {
 
-			newCrate = evioDOMNode::createEvioDOMNode(crate, 0);
+			const fadcChannel &channel = channels[selected[s]];
 
-			// We want to check whether FADC conf data is written into evio, if not it will
-			// write data and will erase corresponding crate element from the vector, for the
-			// next time this data to not be written
-			std::vector<int>::iterator it_crate = find(detector_crates.begin(), detector_crates.end(), crate);
+			// every slot has its own bank
+			if(oldSlot != channel.slot()) {
+				oldSlot = channel.slot();
 
-			//
-			if( it_crate != detector_crates.end() ){
-
-				int confbankbanktag = 0xe10e;
-
-				evioDOMNodeP confbank = evioDOMNode::createEvioDOMNode<string>(confbankbanktag, crate);
-
-				int n_slotes = 19;
-				int n_chann = 16;
-
-				string conf_parms;
-
-				conf_parms = conf_parms + "\n";
-				for( int i_sl = 0; i_sl < n_slotes; i_sl++ ){
-
-					conf_parms = conf_parms + "FADC250_SLOT " + to_string(i_sl) + "\nFADC250_NSB " + to_string(12) + "\nFADC250_NSA " + to_string(36) + "\nFADC250_ALLCH_PED ";
-					for( int i_ch = 0; i_ch < n_chann; i_ch++ ){
-						conf_parms = conf_parms + " " + to_string(101.0);
-					}
-					conf_parms = conf_parms +"\n";
-					conf_parms = conf_parms + "FADC250_ALLCH_TET ";
-					for( int i_ch = 0; i_ch < n_chann; i_ch++ ){
-						conf_parms = conf_parms + " " + to_string(20);
-					}
-					conf_parms = conf_parms +"\n";
-					conf_parms = conf_parms + "FADC250_ALLCH_GAIN ";
-					for( int i_ch = 0; i_ch < n_chann; i_ch++ ){
-						conf_parms = conf_parms + " " + to_string(1.);
-					}
+				PUT8(channel.slot()); // slot number
+				PUT32(ev_number);     // event number
+				PUT64(1);             // time stamp
+				nchannels = (uint32_t*) b08out; // put channels dinamically: first, save current position
+				PUT32(0);             // now reserve space for channel counter
+			}
 
-					conf_parms = conf_parms +"\n";
+			*nchannels = *nchannels + 1;
 
-				}
+			PUT8(channel.channel()); // channel number
 
-				*confbank<<conf_parms;
-				if(newCrate != nullptr) {
-					*newCrate << confbank;
-					*event << newCrate;
+			if(pulses) {
+				PUT32(selectedPulses[s].size());
+				for(auto &pulse: selectedPulses[s]) {
+					PUT16(pulse.time);     // pulse time
+					PUT32(pulse.integral); // pulse integral
+					PUT16(pulse.min);      // pulse min
+					PUT16(pulse.max);      // pulse max
 				}
-				detector_crates.erase(it_crate);
+			} else {
+				PUT32(channel.samples.size());
+				for(auto sample: channel.samples)
+					PUT16(sample);
 			}
-
 		}
 
-		nchannelThisCrate = nchannelThisCrate + 1;
-
-		// every slot has its own bank
-		if(oldSlot != slot) {
-
-			oldSlot = slot;
-
-			PUT8(slot); // slot number
-			PUT32(ev_number);   // event number
-			PUT64(1);   // time stamp
-			nchannels = (uint32_t*) b08out; // put channels dinamically: first, save current position
-			PUT32(0);   // now reserve space for channel counter
+		// padding the last word
+		unsigned nbytes = b08out - (uint8_t*) buf;
+		while(nbytes%4) {
+			PUT8(0);
+			nbytes++;
 		}
+		unsigned nwords = nbytes/4;
 
-		if(nchannels != nullptr)		*nchannels = *nchannels + 1;
-
-		PUT8(chann); // channel number
-
-		nsamples = (uint32_t*) b08out; // put multi-hit dinamically: first, save current position
-		PUT32(0); // now reserve space for sample counter
-		for( map<int, int>::iterator it_isample = (hd.second).begin(); it_isample != (hd.second).end(); it_isample++ ) {
-
-			// Remember 1st three elements are crate/slot/chann, therefore we want other elements hd[3], hd[4] ... hd[nsample + 3 -1]
-			if( it_isample->first < 3 ){
-				continue;
-			}
-
-			//cout<<"value = "<<it_isample->second<<endl;
-			PUT16(abs(it_isample->second));
-			*nsamples = *nsamples + 1;
+		if(nwords) {
+			if(pulses)
+				event->addNode(evioDOMNode::createEvioDOMNode(fadc_mode7_banktag, 0, "c,i,l,N(c,N(s,i,s,s))", 66, 67, buf, buf + nwords), nwords);  // Sergei wanted num to be set 0
+			else
+				event->addNode(evioDOMNode::createEvioDOMNode(fadc_mode1_banktag, 0, "c,i,l,N(c,Ns)", 63, 64, buf, buf + nwords), nwords);  // Sergei wanted num to be set 0
 		}
 
+		event->closeBank();
 
-
-		// Check if all the data under this crate is processed, if yes, the
-		// data should be dumped into evio
-		if( nchannelThisCrate == numberOfChannelsPerCrate[sCrateKey] ){
-
-			//int finalNumberOfWords = (b08out - (uint8_t*)buf_crate_begin + 3) / 4;
-			//int finalNumberOfWords = (b08out - (uint8_t*)buf_crate_begin + 3) / 4;
-			//int finalNumberOfWords = (b08out + 4 - (uint8_t*)buf_crate_begin) / 4;
-
-			//int padding = (uint8_t*)buf_crate_begin + 4*finalNumberOfWords - b08out;
-
-			//*newCrate << evioDOMNode::createEvioDOMNode(banktag, 0, strlen("c,i,l,N(c,Ns)"), "c,i,l,N(c,Ns)", 63, 64, buf_crate_begin, finalNumberOfWords, padding);  // Sergei wanted num to be set 0
-			*newCrate << evioDOMNode::createEvioDOMNode(banktag, 0, "c,i,l,N(c,Ns)", 63, 64, buf_crate_begin, (uint32_t*)b08out);  // Sergei wanted num to be set 0
-			*event << newCrate;
-		}
-
+		c = cend;
 	}
 
-	// ======= At this moment all the FADCMode1 data is already written, so below
+	// ======= At this moment all the FADC data is already written, so below
 	// the program should iterate over remaining elements of detector_crates, and for each one
 	// write FADC_conf paratmeters into evio
+	if(detector_crates.size()) {
 
+		string conf_parms = fadcConfiguration(output->fadcTET, output->fadcNSB, output->fadcNSA);
 
-	if( detector_crates.size() >=1 ){
-
-		for( vector<int>::iterator it_crate = detector_crates.begin(); it_crate != detector_crates.end(); it_crate++ ){
-
-			int cur_crate = *it_crate;
-
-			newCrate = evioDOMNode::createEvioDOMNode(cur_crate, 0);
-
-			int confbanktag = 0xe10e;
-
-			evioDOMNodeP confbank = evioDOMNode::createEvioDOMNode<string>(confbanktag, cur_crate);  // Sergei mentioned that Num should be crate number,
-
-			int n_slotes = 19;
-			int n_chann = 16;
-
-			string conf_parms;
-
-			conf_parms = conf_parms + "\n";
-			for( int i_sl = 0; i_sl < n_slotes; i_sl++ ){
-
-				conf_parms = conf_parms + "FADC250_SLOT " + to_string(i_sl) +  "\nFADC250_NSB " + to_string(12) + "\nFADC250_NSA " + to_string(36) + "\nFADC250_ALLCH_PED ";
-				for( int i_ch = 0; i_ch < n_chann; i_ch++ ){
-					conf_parms = conf_parms + " " + to_string(101.0);
-				}
-				conf_parms = conf_parms +"\n";
-				conf_parms = conf_parms + "FADC250_ALLCH_TET ";
-				for( int i_ch = 0; i_ch < n_chann; i_ch++ ){
-					conf_parms = conf_parms + " " + to_string(20);
-				}
-				conf_parms = conf_parms +"\n";
-				conf_parms = conf_parms + "FADC250_ALLCH_GAIN ";
-				for( int i_ch = 0; i_ch < n_chann; i_ch++ ){
-					conf_parms = conf_parms + " " + to_string(1.);
-				}
-
-				conf_parms = conf_parms +"\n";
-
-			}
-
-			*confbank<<conf_parms;
-			*newCrate << confbank;
-			*event << newCrate;
+		for(auto cur_crate: detector_crates) {
+			event->openBank(cur_crate, pulses ? 1 : 0);
+			evioDOMNodeP confbank = evioDOMNode::createEvioDOMNode<string>(0xe10e, cur_crate);  // Sergei mentioned that Num should be crate number,
+			*confbank << conf_parms;
+			event->addNode(confbank, conf_parms.size()/4 + 2);
+			event->closeBank();
 		}
 		detector_crates.clear();
 	}
-
-
 }
 
-
-// write fadc mode 7 (integrated mode) - jlab hybrid banks. This uses the translation table to write the crate/slot/channel
-void evio_output :: writeFADCMode7(outputContainer* output, vector<hitOutput> HO, int ev_number)
+// write fadc mode 1 (full signal shape) - jlab hybrid banks. This uses the translation table to write the crate/slot/channel
+// The argument is a map<int crate_id, vector<hitoutput> (vector of all hits from that crate) >
+// The FADC_MODE option selects full waveforms, zero suppressed waveforms or pulses
+void evio_output :: writeFADCMode1(outputContainer* output, const map<int, vector<hitOutput> > &HO, int ev_number)
 {
-	unsigned char *b08out;
-	unsigned short *b16;
-	unsigned int *b32;
-	unsigned long long *b64;
-
-	int banktag = 0xe102;
-
-	map<string, map<int, int> > hardwareData;
-
-	// map that counts how many channels are active / slot
-	map<string, int> numberOfChannelsPerSlot;
-
-	// first, reorder all hits into a map
-	for(unsigned int nh=0; nh<HO.size(); nh++) {
-
-		vector<double> hardware = HO[nh].getChargeTime()[5];
-		vector<double> identifier = HO[nh].getChargeTime()[4];
-
-		string crate = fillDigits(to_string((int) hardware[0]), "#", 5);
-		string slot  = fillDigits(to_string((int) hardware[1]), "#", 5);
-		string chann = fillDigits(to_string((int) hardware[2]), "#", 5);
-
-		// crate-slot-channel key
-		string hardwareKey = crate + "-" + slot + "-" + chann;
-
-		// only fill hardware if it's not present already
-		// the time window of a detector could be smaller than
-		// the electronic time window
-		if(hardwareData.find(hardwareKey) == hardwareData.end()) {
-			hardwareData[hardwareKey] = HO[nh].getQuantumS();
-		} else {
-			continue;
-		}
-
-		// crate-slot key
-		hardwareKey = crate + "-" + slot;
-
-		// keeping track of how many channels / slot so we know when to write data
-		if(numberOfChannelsPerSlot.find(hardwareKey) == numberOfChannelsPerSlot.end()) {
-			numberOfChannelsPerSlot[hardwareKey] = 1;
-		} else {
-			numberOfChannelsPerSlot[hardwareKey]++;
-		}
-	}
-
-	int oldCrate    = -1;
-	int oldSlot     = -1;
-
-	b08out = (uint8_t*) buf;
-
-	uint32_t *nchannels = nullptr;
-	uint32_t *nhits;
-
-	evioDOMNodeP newCrate = nullptr;
-
-	int nchannelThisSlot = 0;
-
-	for(auto &hd : hardwareData) {
-
-		vector<string> thisHardwareKey = getStringVectorFromStringWithDelimiter(hd.first, "-");
-
-		int crate = stoi(trimSpacesFromString(replaceCharInStringWithChars(thisHardwareKey[0], "#", " ")));
-		int slot  = stoi(trimSpacesFromString(replaceCharInStringWithChars(thisHardwareKey[1], "#", " ")));
-		int chann = stoi(trimSpacesFromString(replaceCharInStringWithChars(thisHardwareKey[2], "#", " ")));
-
-		string scrate = fillDigits(to_string(crate), "#", 5);
-		string sslot  = fillDigits(to_string(slot),  "#", 5);
-		string hardwareKey = scrate + "-" + sslot;
-
-		if(oldCrate != crate) {
-			oldCrate = crate;
-			oldSlot = -1;  // resetting slot, it's a new crate
-
-			//cout << " creating new crate node " << endl;
-
-			newCrate = evioDOMNode::createEvioDOMNode(crate, 1);
-		}
-
-		// every slot has its own bank
-		if(oldSlot != slot) {
-
-			nchannelThisSlot = 0;
-
-			// cout << " !  crate " << crate << "  slot " << slot << "  channel " << chann << " totChannels " << numberOfChannelsPerSlot[hardwareKey] << " count so far " << nchannelThisSlot << " " << hardwareKey << endl;
-
-			oldSlot = slot;
-			
-			PUT8(slot); // slot number
-			PUT32(ev_number);   // event number
-			PUT64(1);   // time stamp
-			nchannels = (uint32_t*) b08out; // put channels dinamically: first, save current position
-			PUT32(0);   // now reserve space for channel counter
-
-		}
-
-		// every entry is a new channel
-		nchannelThisSlot++;
+	if(HO.size() == 0) return;
 
-		if(nchannels != nullptr) *nchannels = *nchannels + 1;
+	vector<fadcChannel> channels;
+	for(auto &crateHits: HO)
+		addFADCChannels(crateHits.second, channels);
 
-		PUT8(chann); // channel number
-		nhits = (uint32_t*) b08out; // put multi-hit dinamically: first, save current position
-		PUT32(0); // now reserve space for hit counter
-		*nhits = *nhits + 1; // in our case, only 1 hit
-		PUT16(2); // pulse time
-		PUT32(3); // pulse integral
-		PUT16(4); // pulse min
-		PUT16(5); // pulse max
+	writeFADCChannels(output, channels, ev_number, output->fadcMode == "pulse");
+}
 
+// write fadc mode 1 (full signal shape) - jlab hybrid banks. This uses the translation table to write the crate/slot/channel
+// This function takes as an argument vector of hitOutputs, and writes all hits into evio in a Mode1 format
+void evio_output :: writeFADCMode1(outputContainer* output, vector<hitOutput> HO, int ev_number)
+{
+	if(HO.size() == 0) return;
 
-		// cout << " >  crate " << crate << "  slot " << slot << "  channel " << chann << " totChannels " << numberOfChannelsPerSlot[hardwareKey] << " count so far " << nchannelThisSlot << " " << hardwareKey  << endl;
+	vector<fadcChannel> channels;
+	addFADCChannels(HO, channels);
 
-		// channel is new, writing
-		if(nchannelThisSlot == numberOfChannelsPerSlot[hardwareKey] && newCrate != nullptr) {
+	writeFADCChannels(output, channels, ev_number, false);
+}
 
-			int finalNumberOfWords = (b08out - (uint8_t*)buf + 3) / 4;
+// write fadc mode 7 (integrated mode) - jlab hybrid banks. This uses the translation table to write the crate/slot/channel
+void evio_output :: writeFADCMode7(outputContainer* output, vector<hitOutput> HO, int ev_number)
+{
+	if(HO.size() == 0) return;
 
-			// filling crate bank
-			*newCrate << evioDOMNode::createEvioDOMNode(banktag, 0, 65, "c,i,l,N(c,N(s,i,s,s))", 66, 67, buf,finalNumberOfWords); // Sergei wanted num to be set 0
-			*event << newCrate;
+	vector<fadcChannel> channels;
+	addFADCChannels(HO, channels);
 
-		}
-	}
+	writeFADCChannels(output, channels, ev_number, true);
 }
 
 
 
 
-evioDOMNodeP addVariable(int tag, int num, string type, double value)
+void addVariable(evioEventBuffer *event, int tag, int num, string type, double value)
 {
-	// return right away if "d"
-	if(type == "d")
-	return evioDOMNode::createEvioDOMNode(tag, num, &value, 1);
-
-	// otherwise check
 	if(type == "i")
 	{
 		int    varI = (int) value;
-		return evioDOMNode::createEvioDOMNode(tag, num, &varI, 1);
+		event->addBank(tag, num, &varI, 1);
+	}
+	else
+	{
+		event->addBank(tag, num, &value, 1);
 	}
-
-	// repeated return to make compiler happy
-	return evioDOMNode::createEvioDOMNode(tag, num, &value, 1);
-
 }
 
 
-evioDOMNodeP addVariable(int tag, int num, string type, int value)
+void addVariable(evioEventBuffer *event, int tag, int num, string type, int value)
 {
-	return evioDOMNode::createEvioDOMNode(tag, num, &value, 1);
+	event->addBank(tag, num, &value, 1);
 }
 
-evioDOMNodeP addVariable(int tag, int num, string type, string value)
+void addVariable(evioEventBuffer *event, int tag, int num, string type, string value)
 {
-	return evioDOMNode::createEvioDOMNode(tag, num, &value, 1);
+	event->addStrings(tag, num, vector<string>(1, value));
 }
 
 
-evioDOMNodeP addVector(int tag, int num, string type, vector<double> value)
+void addVector(evioEventBuffer *event, int tag, int num, string type, const vector<double> &value)
 {
-	// return right away if "d"
-	if(type == "d")
-	return evioDOMNode::createEvioDOMNode(tag, num, value);
-
-	// otherwise convert the double into int
+	// convert the double into int if "i"
 	if(type == "i")
 	{
 		vector<int> VI;
 		for(unsigned i=0; i<value.size(); i++)
 		VI.push_back(value[i]);
 
-		return evioDOMNode::createEvioDOMNode(tag, num, VI);
+		event->addBank(tag, num, VI);
+	}
+	else
+	{
+		event->addBank(tag, num, value);
 	}
-
-	return evioDOMNode::createEvioDOMNode(tag, num, value);
 }
 
 // we don't convert back to double, that should be in the
 // variable definition
-evioDOMNodeP addVector(int tag, int num, string type, vector<int> value)
+void addVector(evioEventBuffer *event, int tag, int num, string type, const vector<int> &value)
 {
-	return evioDOMNode::createEvioDOMNode(tag, num, value);
+	event->addBank(tag, num, value);
 }
 
 
-evioDOMNodeP addVector(int tag, int num, string type, vector<string> value)
+void addVector(evioEventBuffer *event, int tag, int num, string type, const vector<string> &value)
 {
-	return evioDOMNode::createEvioDOMNode(tag, num, value);
+	event->addStrings(tag, num, value);
 }
 
 
@@ -1294,7 +901,5 @@ evioDOMNodeP addVector(int tag, int num, string type, vector<string> value)
 
 void evio_output :: writeEvent(outputContainer* output)
 {
-	output->pchan->write(*event);
-	delete event;
+	output->writeEvio(event->event());
 }
-
@@ -2,8 +2,8 @@
 /// Defines the EVIO Output Class.\n
 /// The pointer to the evioFileChannel
 /// is passed by the outputContainer class.\n
-/// The evioDOMTree and evioDOMNodeP are 
-/// created on the heap.
+/// The banks are serialized directly in the
+/// outputContainer evioEventBuffer.
 /// \author \n Maurizio Ungaro
 /// \author mail: ungaro@jlab.org\n\n\n
 #ifndef EVIO_OUTPUT_H
@@ -13,11 +13,44 @@
 #include "outputFactory.h"
 
 
+/// \class fadcChannel
+/// <b> fadcChannel </b>\n\n
+/// FADC channel of the event: crate/slot/channel packed in
+/// a 32 bit key (crate << 16 | slot << 8 | channel),
+/// pedestal and samples
+class fadcChannel
+{
+public:
+	fadcChannel(int crate, int slot, int channel) : key(((uint32_t) crate << 16) | ((slot & 0xff) << 8) | (channel & 0xff)), pedestal(0) {;}
+
+	uint32_t key;
+	int pedestal;
+	vector<uint16_t> samples;
+
+	int crate()   const {return key >> 16;}
+	int slot()    const {return (key >> 8) & 0xff;}
+	int channel() const {return key & 0xff;}
+};
+
+/// \class fadcPulse
+/// <b> fadcPulse </b>\n\n
+/// Pulse found in the FADC samples, as in the mode 7 bank
+class fadcPulse
+{
+public:
+	uint16_t time;      ///< in 1/64 of sample
+	uint32_t integral;
+	uint16_t min;
+	uint16_t max;
+};
+
+
 // Class definition
 class evio_output : public outputFactory
 {
 	public:
-		~evio_output(){;}  ///< event is deleted in WriteEvent routine
+		evio_output() : event(nullptr), detectorBank(""), detectorSubBank(-1) {;}
+		~evio_output(){;}
 		static outputFactory *createOutput() {return new evio_output;}
   
 	// record the simulation conditions on the file
@@ -57,9 +90,10 @@ class evio_output : public outputFactory
 	virtual void writeFADCMode1(outputContainer*, vector<hitOutput>, int);
 
         // write fadc mode 1 (full signal shape) - jlab hybrid banks. This uses the translation table to write the crate/slot/channel
-        // This method should be called once at the end of event action, and the 1st argument 
+        // This method should be called once at the end of event action, and the 2nd argument 
         // is a map<int crate_id, vector<hitoutput> (vector of all hits from that crate) >
-	virtual void writeFADCMode1( map<int, vector<hitOutput> >, int);
+        // FADC_MODE selects full waveforms, zero suppressed waveforms or pulses
+	virtual void writeFADCMode1(outputContainer*, const map<int, vector<hitOutput> >&, int);
 
 	// write fadc mode 7 (integrated mode) - jlab hybrid banks. This uses the translation table to write the crate/slot/channel
 	virtual void writeFADCMode7(outputContainer*, vector<hitOutput>, int);
@@ -68,18 +102,11 @@ class evio_output : public outputFactory
 	void writeEvent(outputContainer*) ;
 
 	
-	evioDOMTree *event;
-	evioDOMNodeP detectorBank;
-	map<string, evioDOMNodeP> detectorRawIntBank; 
-	map<string, evioDOMNodeP> detectorDgtIntBank;
-	map<string, evioDOMNodeP> detectorRawAllBank;
-	map<string, evioDOMNodeP> detectorChargeTimeBank;
-
-	map<string, bool> insideBank;
-	map<string, bool> insideRawIntBank;
-	map<string, bool> insideDgtIntBank;
-	map<string, bool> insideRawAllBank;
-	map<string, bool> insideChargeTimeBank;
+	evioEventBuffer *event;
+
+	// open detector bank and sub-bank (RAWINT_ID, DGTINT_ID, ...)
+	string detectorBank;
+	int    detectorSubBank;
 
 	int evn;
 
@@ -90,18 +117,22 @@ class evio_output : public outputFactory
         private:
             
         static const int fadc_mode1_banktag;
+        static const int fadc_mode7_banktag;
+
+	// writes the crates, sorting the channels by crate/slot/channel
+	void writeFADCChannels(outputContainer*, vector<fadcChannel>&, int, bool pulses);
         
 };
 
-// returns a evioDOMNodeP based on the type specified by the string
+// write a bank in the event buffer based on the type specified by the string
 // only double is casted back
-evioDOMNodeP addVariable(int, int, string, double);
-evioDOMNodeP addVariable(int, int, string, int);
-evioDOMNodeP addVariable(int, int, string, string);
+void addVariable(evioEventBuffer*, int, int, string, double);
+void addVariable(evioEventBuffer*, int, int, string, int);
+void addVariable(evioEventBuffer*, int, int, string, string);
 
-evioDOMNodeP addVector(int, int, string, vector<double>);
-evioDOMNodeP addVector(int, int, string, vector<int>);
-evioDOMNodeP addVector(int, int, string, vector<string>);
+void addVector(evioEventBuffer*, int, int, string, const vector<double>&);
+void addVector(evioEventBuffer*, int, int, string, const vector<int>&);
+void addVector(evioEventBuffer*, int, int, string, const vector<string>&);
 
 
 #endif
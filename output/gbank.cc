@@ -44,6 +44,10 @@ map<string, gBank> read_banks(goptions gemcOpt, map<string, string> allSystems)
 	abank.load_variable("evn",        3, "Ni", "Event Number");
 	abank.load_variable("evn_type",   4, "Ni", "Event Type. 1 for physics events, 10 for scaler. Negative sign for MC.");
 	abank.load_variable("beamPol",    5, "Nd", "Beam Polarization");
+	abank.load_variable("weight",     6, "Nd", "Event weight");
+	abank.load_variable("ngenerated", 7, "Ni", "Events generated since the start of the run");
+	abank.load_variable("naccepted",  8, "Ni", "Events accepted by the generator filter since the start of the run");
+	abank.load_variable("nsource",    9, "Ni", "Events simulated to record the phase space input file");
 	abank.orderNames();
 	banks["header"] = abank;
 
@@ -30,35 +30,256 @@ outputFactory *getOutputFactory(map<string, outputFactoryInMap> *outputFactoryMa
 
 outputContainer::outputContainer(goptions Opts)
 {
-	// EVIO Buffer size set to 30M words
-	int evio_buffer = EVIO_BUFFER;
-
 	gemcOpt = Opts;
 	string hd_msg  = gemcOpt.optMap["LOG_MSG"].args + " Output File: >> ";
 
+	txtoutput  = nullptr;
+	pchan      = nullptr;
+	evioBuffer = nullptr;
+	zoutput    = nullptr;
+	evioBlockNumber   = 1;
+	conditionsFactory = nullptr;
+
 	string optf = gemcOpt.optMap["OUTPUT"].args;
 	outType.assign(optf, 0, optf.find(",")) ;
 	outFile.assign(optf,    optf.find(",") + 1, optf.size()) ;
+	outFile = trimSpacesFromString(outFile);
+
+	// compressed output: zlib, level, block size in MB, number of threads
+	compressionLevel   = 0;
+	compressionBlock   = 0;
+	compressionThreads = 0;
+	vector<string> zpars = getStringVectorFromStringWithDelimiter(gemcOpt.optMap["OUTPUT_COMPRESSION"].args, ",");
+	if(outType != "no" && zpars.size() && trimSpacesFromString(zpars[0]) != "no") {
+		if(trimSpacesFromString(zpars[0]) != "zlib") {
+			cout << hd_msg << " !!! Error: OUTPUT_COMPRESSION supports zlib only. Exiting." << endl;
+			exit(1);
+		}
+		compressionLevel   = zpars.size() > 1 ? (int) get_number(zpars[1]) : 6;
+		compressionBlock   = zpars.size() > 2 ? (unsigned long) get_number(zpars[2]) : 4;
+		compressionThreads = zpars.size() > 3 ? (int) get_number(zpars[3]) : 2;
+
+		cout << hd_msg << " Output compressed with zlib level " << compressionLevel << " in blocks of " << compressionBlock << " MB on "
+		     << compressionThreads << " threads. Block index: <output file>.idx" << endl;
+	}
+
+	// FADC banks: mode, threshold, samples before and after the threshold crossing
+	vector<string> fpars = getStringVectorFromStringWithDelimiter(gemcOpt.optMap["FADC_MODE"].args, ",");
+	fadcMode     = fpars.size() ? trimSpacesFromString(fpars[0]) : "full";
+	fadcTET      = fpars.size() > 1 ? (int) get_number(fpars[1]) : 20;
+	fadcNSB      = fpars.size() > 2 ? (int) get_number(fpars[2]) : 12;
+	fadcNSA      = fpars.size() > 3 ? (int) get_number(fpars[3]) : 36;
+	fadcSampling = get_number(getStringVectorFromStringWithDelimiter(gemcOpt.optMap["TSAMPLING"].args, ",").front());
+	if(fadcMode != "full" && fadcMode != "zs" && fadcMode != "pulse") {
+		cout << hd_msg << " !!! Error: FADC_MODE " << fadcMode << " not supported: use full, zs or pulse. Exiting." << endl;
+		exit(1);
+	}
+	if(fadcSampling <= 0) fadcSampling = 4;
+
+	// split output: number of events, size in MB. 0 means no limit
+	maxEvents = 0;
+	maxBytes  = 0;
+	fileIndex = 0;
+	vector<string> spars = getStringVectorFromStringWithDelimiter(gemcOpt.optMap["OUTPUT_SPLIT"].args, ",");
+	if(outType != "no" && spars.size() && trimSpacesFromString(spars[0]) != "no") {
+		maxEvents = (long) get_number(spars[0]);
+		if(spars.size() > 1) maxBytes = (long) (get_number(spars[1])*1024*1024);
+		fileIndex = 1;
+		ranges.open((outFile + ".ranges").c_str());
+		ranges << "# file  first_event  last_event  nevents" << endl;
+
+		cout << hd_msg << " Output split every " << maxEvents << " events or " << maxBytes/1024/1024 << " MB (0: no limit)."
+		     << " Event ranges: " << outFile << ".ranges" << endl;
+	}
 
-	if(outType != "no") cout << hd_msg << " Opening output file \"" << trimSpacesFromString(outFile) << "\"." << endl;
-	if(outType == "txt" || outType == "txt_simple")  txtoutput = new ofstream(trimSpacesFromString(outFile).c_str());
 	if(outType == "evio")
 	{
-		pchan = new evioFileChannel(trimSpacesFromString(outFile).c_str(), "w", evio_buffer);
-		pchan->open();
+		// events are serialized directly: the layout must be the one of the evio library
+		evioBuffer = new evioEventBuffer();
+		if(!evioEventBuffer::checkLayout()) {
+			cout << hd_msg << " !!! Error: the evio event buffer layout does not match the evio library. Exiting." << endl;
+			exit(1);
+		}
 	}
+
+	if(outType != "no") openFiles(fileIndex ? splitFileName(fileIndex) : outFile);
 }
 
 outputContainer::~outputContainer()
 {
+	if(outType != "no") closeFiles();
+	if(ranges.is_open()) ranges.close();
+	delete evioBuffer;
+}
+
+// out.ev -> out.0001.ev
+string outputContainer::splitFileName(int index)
+{
+	string findex = to_string(index);
+	while(findex.size() < 4) findex = "0" + findex;
+
+	size_t dot   = outFile.find_last_of(".");
+	size_t slash = outFile.find_last_of("/");
+	if(dot == string::npos || (slash != string::npos && dot < slash) || dot == 0)
+		return outFile + "." + findex;
+
+	return outFile.substr(0, dot) + "." + findex + outFile.substr(dot);
+}
+
+void outputContainer::openFiles(string filename)
+{
+	// EVIO Buffer size set to 30M words
+	int evio_buffer = EVIO_BUFFER;
+
 	string hd_msg  = gemcOpt.optMap["LOG_MSG"].args + " Output File: >> ";
 
-	if(outType != "no")   cout << " Closing " << outFile << "." << endl;
-	if(outType == "txt" || outType == "txt_simple")  txtoutput->close();
+	currentFile      = filename;
+	eventsInFile     = 0;
+	firstEventInFile = -1;
+	lastEventInFile  = -1;
+	evioBytes        = 0;
+	fileFull         = false;
+	evioBlockNumber  = 1;
+
+	cout << hd_msg << " Opening output file \"" << filename << "\"." << endl;
+
+	if(compressionLevel > 0) {
+		zoutput = new compressedStream(filename, compressionLevel, compressionBlock*1024*1024, compressionThreads);
+		if(!zoutput->isGood()) {
+			cout << hd_msg << " !!! Error: cannot open " << filename << " for writing. Exiting." << endl;
+			exit(1);
+		}
+	}
+
+	if(outType == "txt" || outType == "txt_simple") {
+		if(zoutput) txtoutput = zoutput;
+		else        txtoutput = new ofstream(filename.c_str());
+	}
+	if(outType == "evio" && zoutput == nullptr)
+	{
+		pchan = new evioFileChannel(filename.c_str(), "w", evio_buffer);
+		pchan->open();
+	}
+}
+
+void outputContainer::closeFiles()
+{
+	cout << " Closing " << currentFile << "." << endl;
+
+	if(outType == "txt" || outType == "txt_simple") {
+		if(zoutput == nullptr) delete txtoutput;
+		txtoutput = nullptr;
+	}
 	if(outType == "evio")
 	{
-		pchan->close();
-		delete pchan;
+		if(pchan) {
+			pchan->close();
+			delete pchan;
+			pchan = nullptr;
+		}
+		// last evio block: empty, with the last block bit
+		if(zoutput) writeEvio((const uint32_t*) nullptr);
+	}
+	if(zoutput) {
+		zoutput->close();
+		if(!zoutput->isGood())
+			cout << " !!! Error: " << zoutput->storedBlocks() << " blocks of " << currentFile << " could not be compressed and are stored uncompressed." << endl;
+		delete zoutput;
+		zoutput = nullptr;
+	}
+
+	// the file is complete: it can be processed
+	if(ranges.is_open())
+		ranges << currentFile << " " << firstEventInFile << " " << lastEventInFile << " " << eventsInFile << endl;
+}
+
+// bytes written in the current file, before compression
+// for evio the channel buffers the events: the events sizes are counted instead
+long outputContainer::fileBytes()
+{
+	if(outType == "evio") return evioBytes;
+	if(zoutput)           return zoutput->uncompressedSize();
+	if(txtoutput)         return (long) txtoutput->tellp();
+	return 0;
+}
+
+void outputContainer::recordSimConditions(map<string, string> sims, outputFactory *(*factory)())
+{
+	simConditions     = sims;
+	conditionsFactory = factory;
+
+	outputFactory *processOutputFactory = conditionsFactory();
+	processOutputFactory->recordSimConditions(this, simConditions);
+	delete processOutputFactory;
+}
+
+void outputContainer::beginEvent()
+{
+	if(!fileFull) return;
+
+	closeFiles();
+	openFiles(splitFileName(++fileIndex));
+
+	if(conditionsFactory != nullptr) {
+		outputFactory *processOutputFactory = conditionsFactory();
+		processOutputFactory->recordSimConditions(this, simConditions);
+		delete processOutputFactory;
+	}
+}
+
+// with compression the evio file is written here, one event per evio (version 4) block:
+// 0: block length (words) 1: block number 2: header length 3: number of events
+// 4: reserved 5: version and bit info 6: reserved 7: magic number
+// a null event writes the last, empty block
+void outputContainer::writeEvio(const uint32_t *evioEvent)
+{
+	if(evioEvent) evioBytes += (evioEvent[0] + 1)*sizeof(uint32_t);
+
+	if(zoutput == nullptr) {
+		pchan->write(evioEvent);
+		return;
+	}
+
+	uint32_t eventLength = evioEvent ? evioEvent[0] + 1 : 0;
+
+	uint32_t header[8];
+	header[0] = 8 + eventLength;
+	header[1] = evioBlockNumber++;
+	header[2] = 8;
+	header[3] = evioEvent ? 1 : 0;
+	header[4] = 0;
+	header[5] = 4 | (evioEvent ? 0 : 0x200);
+	header[6] = 0;
+	header[7] = 0xc0da0100;
+
+	zoutput->write((const char*) header, sizeof(header));
+	if(evioEvent) zoutput->write((const char*) evioEvent, eventLength*sizeof(uint32_t));
+}
+
+void outputContainer::writeEvio(evioDOMTree *tree)
+{
+	if(zoutput == nullptr) {
+		pchan->write(*tree);
+		return;
+	}
+
+	vector<uint32_t> treeBuffer(EVIO_BUFFER/8);
+	tree->toEVIOBuffer(treeBuffer.data(), treeBuffer.size());
+	writeEvio(treeBuffer.data());
+}
+
+void outputContainer::endEvent(int evn)
+{
+	if(zoutput) zoutput->endEvent(evn);
+
+	if(firstEventInFile < 0) firstEventInFile = evn;
+	lastEventInFile = evn;
+	eventsInFile++;
+
+	// the next file is opened when the next event begins
+	if(fileIndex > 0) {
+		if(maxEvents > 0 && eventsInFile >= maxEvents) fileFull = true;
+		if(maxBytes  > 0 && fileBytes()  >= maxBytes)  fileFull = true;
 	}
 }
 
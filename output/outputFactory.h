@@ -13,6 +13,7 @@
 #include "gbank.h"
 #include "options.h"
 #include "MPrimaryGeneratorAction.h"
+#include "compressedStream.h"
 
 // mlibrary
 #include "frequencySyncSignal.h"
@@ -20,6 +21,7 @@
 // EVIO
 #include "evioUtil.hxx"
 #include "evioFileChannel.hxx"
+#include "evioEventBuffer.h"
 using namespace evio;
 
 // geant4
@@ -97,8 +99,8 @@ public:
 	map<string, double>            getDgtz()       {return dgtz;}
 	map< string, vector <double> > getAllRaws()    {return allRaws;}
 	map< string, vector <int> >    getMultiDgt()   {return multiDgt;}
-	map< int, vector <double> >    getChargeTime() {return chargeTime;}
-	map< int, int >         	   getQuantumS()   {return quantumS;}
+	const map< int, vector <double> > &getChargeTime() const {return chargeTime;}
+	const map< int, int >             &getQuantumS()   const {return quantumS;}
 
 	double getIntRawVar(string s)
 	{
@@ -218,9 +220,15 @@ class ancestorInfo
 };
 
 
+class outputFactory;
+
 /// \class outputContainer
 /// <b> outputContainer </b>\n\n
-/// Contains all possible outputs.
+/// Contains all possible outputs.\n
+/// With OUTPUT_SPLIT the output rolls over to a new file after a number
+/// of events or bytes. The files are named <name>.0001.<extension>, ...
+/// and each one starts with the simulation conditions. The event ranges
+/// of the closed files are listed in <output filename>.ranges
 class outputContainer
 {
 public:
@@ -231,8 +239,60 @@ public:
 	string outType;
 	string outFile;
 
-	ofstream        *txtoutput;
+	ostream         *txtoutput;
 	evioFileChannel *pchan;
+	evioEventBuffer *evioBuffer;   ///< reused by every evio event
+
+	// OUTPUT_COMPRESSION: all outputs are written in this stream
+	// the evio events are then written in evio blocks instead of the evioFileChannel
+	compressedStream *zoutput;
+	unsigned evioBlockNumber;
+
+	// FADC_MODE: full, zs (zero suppressed) or pulse
+	// threshold above pedestal in ADC counts, pulse window in ns
+	string fadcMode;
+	int    fadcTET;
+	int    fadcNSB;
+	int    fadcNSA;
+	double fadcSampling;
+
+	void writeEvio(const uint32_t *evioEvent);
+	void writeEvio(evioDOMTree *tree);
+
+	// writes the simulation conditions with the output factory
+	// they are written again at the beginning of each split file
+	void recordSimConditions(map<string, string> sims, outputFactory *(*factory)());
+
+	// opens the next split file if the current one is full
+	void beginEvent();
+
+	// marks the end of the event in the compressed stream, counts events and bytes for the split
+	void endEvent(int evn);
+
+private:
+	// OUTPUT_SPLIT
+	long   maxEvents;
+	long   maxBytes;
+	int    fileIndex;
+	string currentFile;
+	long   eventsInFile;
+	int    firstEventInFile;
+	int    lastEventInFile;
+	long   evioBytes;
+	bool   fileFull;
+	ofstream ranges;
+
+	map<string, string> simConditions;
+	outputFactory *(*conditionsFactory)();
+
+	int    compressionLevel;
+	unsigned long compressionBlock;
+	int    compressionThreads;
+
+	void openFiles(string filename);
+	void closeFiles();
+	long fileBytes();
+	string splitFileName(int index);
 };
 
 /// \class outputFactory
@@ -278,9 +338,9 @@ public:
 	virtual void writeFADCMode1(outputContainer*, vector<hitOutput>, int) = 0;
 
         // write fadc mode 1 (full signal shape) - jlab hybrid banks. This uses the translation table to write the crate/slot/channel
-        // This method should be called once at the end of event action, and the 1st argument 
+        // This method should be called once at the end of event action, and the 2nd argument 
         // is a map<int crate_id, vector<hitoutput> (vector of all hits from that crate) >
-	virtual void writeFADCMode1( map<int, vector<hitOutput> >, int)  = 0;
+	virtual void writeFADCMode1(outputContainer*, const map<int, vector<hitOutput> >&, int)  = 0;
         
 	// write fadc mode 7 (integrated mode) - jlab hybrid banks. This uses the translation table to write the crate/slot/channel
 	virtual void writeFADCMode7(outputContainer*, vector<hitOutput>, int) = 0;
@@ -0,0 +1,522 @@
+// gemc headers
+#include "stepRecord.h"
+
+// mlibrary
+#include "gstring.h"
+using namespace gstring;
+
+// C++ headers
+#include <iostream>
+using namespace std;
+
+// the file starts with this tag followed by the version
+static const string stepRecordTag = "gemc step record";
+
+
+// binary helpers. Every vector is written with its size first
+template <class T> static void writeValue(ostream *out, T v)
+{
+	out->write((const char*) &v, sizeof(T));
+}
+
+template <class T> static bool readValue(istream *in, T &v)
+{
+	in->read((char*) &v, sizeof(T));
+	return in->good();
+}
+
+static void writeString(ostream *out, const string &s)
+{
+	writeValue<int>(out, (int) s.size());
+	out->write(s.data(), s.size());
+}
+
+static string readString(istream *in)
+{
+	int n = 0;
+	if(!readValue(in, n) || n < 0) return "";
+	string s(n, ' ');
+	in->read(&s[0], n);
+	return s;
+}
+
+template <class T> static void writeVector(ostream *out, const vector<T> &v)
+{
+	writeValue<int>(out, (int) v.size());
+	if(v.size()) out->write((const char*) v.data(), v.size()*sizeof(T));
+}
+
+template <class T> static vector<T> readVector(istream *in)
+{
+	int n = 0;
+	readValue(in, n);
+	vector<T> v(n > 0 ? n : 0);
+	if(n > 0) in->read((char*) v.data(), n*sizeof(T));
+	return v;
+}
+
+static void writeThreeVectors(ostream *out, const vector<G4ThreeVector> &v)
+{
+	writeValue<int>(out, (int) v.size());
+	for(auto &p: v) {
+		writeValue(out, p.x());
+		writeValue(out, p.y());
+		writeValue(out, p.z());
+	}
+}
+
+static vector<G4ThreeVector> readThreeVectors(istream *in)
+{
+	int n = 0;
+	readValue(in, n);
+	vector<G4ThreeVector> v;
+	for(int i=0; i<n; i++) {
+		double x = 0, y = 0, z = 0;
+		readValue(in, x);
+		readValue(in, y);
+		readValue(in, z);
+		v.push_back(G4ThreeVector(x, y, z));
+	}
+	return v;
+}
+
+// material and volume names are the same for long runs of steps:
+// they are written as (count, name) pairs
+static void writeNames(ostream *out, const vector<string> &names)
+{
+	vector<pair<int, string> > runs;
+	for(auto &n: names) {
+		if(runs.size() && runs.back().second == n) runs.back().first++;
+		else runs.push_back(make_pair(1, n));
+	}
+
+	writeValue<int>(out, (int) runs.size());
+	for(auto &r: runs) {
+		writeValue<int>(out, r.first);
+		writeString(out, r.second);
+	}
+}
+
+static vector<string> readNames(istream *in)
+{
+	int nruns = 0;
+	readValue(in, nruns);
+	vector<string> names;
+	for(int r=0; r<nruns; r++) {
+		int count = 0;
+		readValue(in, count);
+		string name = readString(in);
+		for(int i=0; i<count; i++) names.push_back(name);
+	}
+	return names;
+}
+
+
+void stepRecordEvent::clear()
+{
+	for(auto &sys: hits)
+		for(auto hit: sys.second)
+			delete hit;
+
+	hits.clear();
+	primaries.clear();
+	userInfo.clear();
+	ancestors.clear();
+	hasAncestors = false;
+	header.clear();
+	userHeader.clear();
+	rfsetup = "";
+}
+
+
+// header values are written as (name, value) pairs
+static void writeMap(ostream *out, const map<string, double> &m)
+{
+	writeValue<int>(out, (int) m.size());
+	for(auto &v: m) {
+		writeString(out, v.first);
+		writeValue<double>(out, v.second);
+	}
+}
+
+static map<string, double> readMap(istream *in)
+{
+	int n = 0;
+	readValue(in, n);
+	map<string, double> m;
+	for(int i=0; i<n; i++) {
+		string name = readString(in);
+		double value = 0;
+		readValue(in, value);
+		m[name] = value;
+	}
+	return m;
+}
+
+
+stepRecord::stepRecord(string fname, string mode)
+{
+	filename = trimSpacesFromString(fname);
+	out  = nullptr;
+	in   = nullptr;
+	good = false;
+
+	if(mode == "w") {
+		out = new ofstream(filename.c_str(), ios::binary);
+		if(out->good()) {
+			writeString(out, stepRecordTag);
+			writeValue<int>(out, STEP_RECORD_VERSION);
+			good = true;
+			cout << " > Writing step record to " << filename << endl;
+		} else {
+			cout << " !!! Error: step record file " << filename << " could not be opened for writing." << endl;
+		}
+	} else {
+		in = new ifstream(filename.c_str(), ios::binary);
+		if(in->good()) {
+			string tag  = readString(in);
+			int version = 0;
+			readValue(in, version);
+			if(tag == stepRecordTag && version == STEP_RECORD_VERSION) {
+				good = true;
+				firstEvent = in->tellg();
+				cout << " > Reading step record from " << filename << endl;
+			} else {
+				cout << " !!! Error: " << filename << " is not a gemc step record version " << STEP_RECORD_VERSION << "." << endl;
+			}
+		} else {
+			cout << " !!! Error: step record file " << filename << " could not be opened." << endl;
+		}
+	}
+}
+
+stepRecord::~stepRecord()
+{
+	if(out) {
+		out->close();
+		delete out;
+	}
+	if(in) {
+		in->close();
+		delete in;
+	}
+}
+
+
+// the event is built in memory and written to the file by endEvent
+void stepRecord::beginEvent(map<string, double> header, map<string, double> userHeader, string rfsetup)
+{
+	if(!good) return;
+
+	eventBuffer.str("");
+	eventBuffer.clear();
+
+	ostream *out = &eventBuffer;
+	writeMap(out, header);
+	writeMap(out, userHeader);
+	writeString(out, rfsetup);
+}
+
+void stepRecord::writeHits(string system, MHitCollection *MHC)
+{
+	if(!good || !MHC || !MHC->GetSize()) return;
+
+	ostream *out = &eventBuffer;
+	writeString(out, system);
+	writeValue<int>(out, (int) MHC->GetSize());
+
+	for(unsigned h=0; h<MHC->GetSize(); h++)
+		writeHit((*MHC)[h]);
+}
+
+// an empty system name closes the list of hit blocks
+void stepRecord::endEvent(vector<generatedParticle> primaries, vector<userInforForParticle> userInfo, vector<ancestorInfo> *ancestors)
+{
+	if(!good) return;
+
+	ostream *out = &eventBuffer;
+	writeString(out, "");
+
+	writeValue<int>(out, (int) primaries.size());
+	for(auto &p: primaries) {
+		writeValue<int>(out, p.PID);
+		writeValue<int>(out, p.multiplicity);
+		writeValue<double>(out, p.time);
+		writeThreeVectors(out, {p.vertex, p.momentum});
+
+		writeValue<int>(out, (int) p.pSum.size());
+		for(auto &s: p.pSum) {
+			writeString(out, s.dname);
+			writeValue<int>(out, s.stat);
+			writeValue<double>(out, s.etot);
+			writeValue<double>(out, s.t);
+			writeValue<int>(out, s.nphe);
+		}
+	}
+
+	writeValue<int>(out, (int) userInfo.size());
+	for(auto &u: userInfo)
+		writeVector(out, u.infos);
+
+	writeValue<int>(out, ancestors != nullptr);
+	if(ancestors != nullptr) {
+		writeValue<int>(out, (int) ancestors->size());
+		for(auto &a: *ancestors) {
+			writeValue<int>(out, a.pid);
+			writeValue<int>(out, a.tid);
+			writeValue<int>(out, a.mtid);
+			writeValue<double>(out, a.trackE);
+			writeThreeVectors(out, {a.p, a.vtx});
+		}
+	}
+
+	string event = eventBuffer.str();
+	writeValue<long long>(this->out, (long long) event.size());
+	this->out->write(event.data(), event.size());
+	this->out->flush();
+
+	eventBuffer.str("");
+}
+
+// events that are not written out are not recorded either
+void stepRecord::abortEvent()
+{
+	eventBuffer.str("");
+	eventBuffer.clear();
+}
+
+void stepRecord::writeHit(MHit *aHit)
+{
+	ostream *out = &eventBuffer;
+
+	writeValue<int>(out, aHit->isElectronicNoise);
+	writeValue<int>(out, aHit->isBackgroundHit);
+
+	vector<identifier> identity = aHit->GetId();
+	writeValue<int>(out, (int) identity.size());
+	for(auto &iden: identity) {
+		writeString(out, iden.name);
+		writeString(out, iden.rule);
+		writeValue<int>(out, iden.id);
+		writeValue<double>(out, iden.time);
+		writeValue<double>(out, iden.TimeWindow);
+		writeValue<int>(out, iden.TrackId);
+		writeValue<double>(out, iden.id_sharing);
+		writeVector(out, iden.userInfos);
+	}
+
+	writeThreeVectors(out, aHit->GetPos());
+	writeThreeVectors(out, aHit->GetLPos());
+	writeThreeVectors(out, aHit->GetVerts());
+	writeThreeVectors(out, aHit->GetMoms());
+	writeThreeVectors(out, aHit->GetmVerts());
+
+	writeVector(out, aHit->GetEdep());
+	writeVector(out, aHit->GetDx());
+	writeVector(out, aHit->GetTime());
+	writeVector(out, aHit->GetEs());
+	writeVector(out, aHit->GetMgnf());
+
+	writeVector(out, aHit->GetCharges());
+	writeVector(out, aHit->GetPIDs());
+	writeVector(out, aHit->GetmPIDs());
+	writeVector(out, aHit->GetTIds());
+	writeVector(out, aHit->GetmTrackIds());
+	writeVector(out, aHit->GetoTrackIds());
+	writeVector(out, aHit->GetProcIDs());
+
+	writeNames(out, aHit->GetMatNames());
+
+	vector<string> dnames;
+	for(auto &d: aHit->GetDetectors())
+		dnames.push_back(d.name);
+	writeNames(out, dnames);
+}
+
+
+bool stepRecord::readEvent(stepRecordEvent *event, map<string, detector> *hallMap)
+{
+	if(!good) return false;
+
+	event->clear();
+
+	long long size = 0;
+	if(!readValue(in, size)) return false;
+
+	event->header = readMap(in);
+	event->userHeader = readMap(in);
+	event->rfsetup    = readString(in);
+
+	event->evn   = (int) event->header["evn"];
+	event->runNo = (int) event->header["runNo"];
+
+	string system = readString(in);
+	while(system != "" && in->good()) {
+		int nhits = 0;
+		readValue(in, nhits);
+		for(int h=0; h<nhits; h++)
+			event->hits[system].push_back(readHit(hallMap));
+
+		system = readString(in);
+	}
+
+	int nprimaries = 0;
+	readValue(in, nprimaries);
+	for(int i=0; i<nprimaries; i++) {
+		generatedParticle p;
+		readValue(in, p.PID);
+		readValue(in, p.multiplicity);
+		readValue(in, p.time);
+		vector<G4ThreeVector> vm = readThreeVectors(in);
+		if(vm.size() == 2) {
+			p.vertex   = vm[0];
+			p.momentum = vm[1];
+		}
+
+		int nsum = 0;
+		readValue(in, nsum);
+		for(int s=0; s<nsum; s++) {
+			summaryForParticle sfp(readString(in));
+			readValue(in, sfp.stat);
+			readValue(in, sfp.etot);
+			readValue(in, sfp.t);
+			readValue(in, sfp.nphe);
+			p.pSum.push_back(sfp);
+		}
+		event->primaries.push_back(p);
+	}
+
+	int nuser = 0;
+	readValue(in, nuser);
+	for(int i=0; i<nuser; i++) {
+		userInforForParticle u;
+		u.infos = readVector<double>(in);
+		event->userInfo.push_back(u);
+	}
+
+	int hasAncestors = 0;
+	readValue(in, hasAncestors);
+	event->hasAncestors = hasAncestors;
+	if(hasAncestors) {
+		int nancestors = 0;
+		readValue(in, nancestors);
+		for(int i=0; i<nancestors; i++) {
+			ancestorInfo a;
+			readValue(in, a.pid);
+			readValue(in, a.tid);
+			readValue(in, a.mtid);
+			readValue(in, a.trackE);
+			vector<G4ThreeVector> pv = readThreeVectors(in);
+			if(pv.size() == 2) {
+				a.p   = pv[0];
+				a.vtx = pv[1];
+			}
+			event->ancestors.push_back(a);
+		}
+	}
+
+	if(!in->good()) {
+		cout << " !!! Error: step record " << filename << " is truncated at event " << event->evn << "." << endl;
+		event->clear();
+		return false;
+	}
+
+	return true;
+}
+
+vector<streampos> stepRecord::indexEvents()
+{
+	vector<streampos> offsets;
+	if(!good) return offsets;
+
+	in->clear();
+	in->seekg(0, ios::end);
+	streampos fileEnd = in->tellg();
+	in->seekg(firstEvent);
+
+	streampos offset = firstEvent;
+	long long size = 0;
+	while(readValue(in, size) && size > 0) {
+		streampos next = offset + (streamoff) (sizeof(long long) + size);
+		// an incomplete last event is not indexed
+		if(next > fileEnd) break;
+		offsets.push_back(offset);
+		in->seekg(next);
+		offset = next;
+	}
+
+	in->clear();
+	in->seekg(firstEvent);
+
+	return offsets;
+}
+
+bool stepRecord::readEventAt(streampos offset, stepRecordEvent *event, map<string, detector> *hallMap)
+{
+	if(!good) return false;
+
+	in->clear();
+	in->seekg(offset);
+	return readEvent(event, hallMap);
+}
+
+MHit* stepRecord::readHit(map<string, detector> *hallMap)
+{
+	MHit *aHit = new MHit();
+
+	readValue(in, aHit->isElectronicNoise);
+	readValue(in, aHit->isBackgroundHit);
+
+	int nid = 0;
+	readValue(in, nid);
+	vector<identifier> identity;
+	for(int i=0; i<nid; i++) {
+		identifier iden;
+		iden.name = readString(in);
+		iden.rule = readString(in);
+		readValue(in, iden.id);
+		readValue(in, iden.time);
+		readValue(in, iden.TimeWindow);
+		readValue(in, iden.TrackId);
+		readValue(in, iden.id_sharing);
+		iden.userInfos = readVector<double>(in);
+		identity.push_back(iden);
+	}
+	aHit->SetId(identity);
+
+	for(auto &p: readThreeVectors(in)) aHit->SetPos(p);
+	for(auto &p: readThreeVectors(in)) aHit->SetLPos(p);
+	for(auto &p: readThreeVectors(in)) aHit->SetVert(p);
+	for(auto &p: readThreeVectors(in)) aHit->SetMom(p);
+	aHit->SetmVerts(readThreeVectors(in));
+
+	for(auto v: readVector<double>(in)) aHit->SetEdep(v);
+	for(auto v: readVector<double>(in)) aHit->SetDx(v);
+	for(auto v: readVector<double>(in)) aHit->SetTime(v);
+	for(auto v: readVector<double>(in)) aHit->SetE(v);
+	for(auto v: readVector<double>(in)) aHit->SetMgnf(v);
+
+	for(auto v: readVector<int>(in)) aHit->SetCharge(v);
+	for(auto v: readVector<int>(in)) aHit->SetPID(v);
+	aHit->SetmPIDs(readVector<int>(in));
+	for(auto v: readVector<int>(in)) aHit->SetTrackId(v);
+	aHit->SetmTrackIds(readVector<int>(in));
+	aHit->SetoTrackIds(readVector<int>(in));
+	aHit->SetProcID(readVector<int>(in));
+
+	aHit->SetMatNames(readNames(in));
+
+	for(auto &dname: readNames(in)) {
+		auto itd = hallMap->find(dname);
+		if(itd != hallMap->end()) {
+			aHit->SetDetector(itd->second);
+		} else {
+			cout << " !!! Warning: volume " << dname << " from the step record is not in the detector map." << endl;
+			detector missing;
+			missing.name = dname;
+			aHit->SetDetector(missing);
+		}
+	}
+
+	return aHit;
+}
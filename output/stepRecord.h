@@ -0,0 +1,103 @@
+/// \file stepRecord.h
+/// Defines the gemc step record.\n
+/// The step record is a compact binary dump of the MHit step arrays,
+/// identifiers and detector names of each event. It is written with
+/// the STEP_RECORD option and read back with DIGITIZE_ONLY to run
+/// the digitization again without geometry or tracking.\n
+/// \author \n Maurizio Ungaro
+/// \author mail: ungaro@jlab.org\n\n\n
+#ifndef stepRecord_H
+#define stepRecord_H 1
+
+// gemc headers
+#include "Hit.h"
+#include "outputFactory.h"
+
+// C++ headers
+#include <fstream>
+#include <sstream>
+#include <map>
+using namespace std;
+
+#define STEP_RECORD_VERSION 3
+
+
+/// \class stepRecordEvent
+/// <b> stepRecordEvent </b>\n\n
+/// One event read from the step record:
+/// - header, user header and RF setup
+/// - hits for each sensitive detector, key is the hit collection name
+/// - generated particles, including the per detector summaries, and their user infos
+/// - ancestors, if they were saved with SAVE_ALL_ANCESTORS
+class stepRecordEvent
+{
+public:
+	stepRecordEvent() : hasAncestors(false) {;}
+	~stepRecordEvent() {clear();}
+
+	int    evn;
+	int    runNo;
+
+	map<string, double> header;       ///< event header bank
+	map<string, double> userHeader;   ///< user defined header variables
+	string              rfsetup;      ///< RF signal setup, empty if the RF is not written
+
+	map<string, vector<MHit*> > hits;
+	vector<generatedParticle>   primaries;
+	vector<userInforForParticle> userInfo;   ///< generated particles user infos (LUND additional columns)
+
+	bool                 hasAncestors;
+	vector<ancestorInfo> ancestors;
+
+	// deletes the hits and resets the event
+	void clear();
+};
+
+
+/// \class stepRecord
+/// <b> stepRecord </b>\n\n
+/// Writes (mode "w") or reads (mode "r") the step record file.\n
+/// Each event is its size in bytes, a header, one block per sensitive detector,
+/// the generated particles and the ancestors. The size allows to index the events without reading them. Every step array is stored with its
+/// own length so that the MHit is restored exactly as it was at the
+/// end of the event.
+class stepRecord
+{
+public:
+	stepRecord(string filename, string mode);
+	~stepRecord();
+
+	// writing. abortEvent drops an event that is not written out
+	void beginEvent(map<string, double> header, map<string, double> userHeader, string rfsetup);
+	void writeHits(string system, MHitCollection *MHC);
+	// ancestors is null if they are not saved
+	void endEvent(vector<generatedParticle> primaries, vector<userInforForParticle> userInfo, vector<ancestorInfo> *ancestors);
+	void abortEvent();
+
+	// reading. The detector map is used to restore the MHit detectors
+	// returns false at the end of the file
+	bool readEvent(stepRecordEvent *event, map<string, detector> *hallMap);
+
+	// file offsets of all the complete events. The file is rewound to the first event
+	vector<streampos> indexEvents();
+
+	// reads the event at a file offset given by indexEvents
+	bool readEventAt(streampos offset, stepRecordEvent *event, map<string, detector> *hallMap);
+
+	bool isGood() {return good;}
+
+private:
+	string    filename;
+	ofstream *out;
+	ifstream *in;
+	bool      good;
+	streampos firstEvent;        ///< offset of the first event
+
+	ostringstream eventBuffer;   ///< event being written
+
+	void  writeHit(MHit*);
+	MHit* readHit(map<string, detector> *hallMap);
+};
+
+
+#endif
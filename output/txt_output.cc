@@ -14,7 +14,7 @@ using namespace CLHEP;
 // the format is a string for each variable
 void txt_output :: recordSimConditions(outputContainer* output, map<string, string> simcons)
 {
-	ofstream *txtout = output->txtoutput ;
+	ostream *txtout = output->txtoutput ;
 	
 	*txtout << "   Simulation Conditions, TAG " << SIMULATION_CONDITIONS_BANK_TAG << ":" << endl;
 	
@@ -41,7 +41,7 @@ void txt_output :: recordSimConditions(outputContainer* output, map<string, stri
 void txt_output :: writeHeader(outputContainer* output, map<string, double> data, gBank bank)
 {
 	insideBank.clear();
-	ofstream *txtout = output->txtoutput ;
+	ostream *txtout = output->txtoutput ;
 	
 	
 	*txtout << " --- Header Bank -- " << endl;
@@ -64,7 +64,7 @@ void txt_output :: writeHeader(outputContainer* output, map<string, double> data
 void txt_output :: writeUserInfoseHeader(outputContainer* output, map<string, double> data)
 {
 
-	ofstream *txtout = output->txtoutput ;
+	ostream *txtout = output->txtoutput ;
 
 	*txtout << " --- User Header Bank -- " << endl;
 
@@ -81,7 +81,7 @@ void txt_output :: writeUserInfoseHeader(outputContainer* output, map<string, do
 
 void txt_output :: writeRFSignal(outputContainer* output, FrequencySyncSignal rfsignals, gBank bank)
 {
-	ofstream *txtout = output->txtoutput ;
+	ostream *txtout = output->txtoutput ;
 
 	*txtout << " --- RF Signals Bank -- " << endl;
 
@@ -105,7 +105,7 @@ void txt_output :: writeRFSignal(outputContainer* output, FrequencySyncSignal rf
 void txt_output :: writeGenerated(outputContainer* output, vector<generatedParticle> MGP, map<string, gBank> *banksMap, vector<userInforForParticle> userInfo)
 {
 	double MAXP = output->gemcOpt.optMap["NGENP"].arg;
-	ofstream *txtout = output->txtoutput ;
+	ostream *txtout = output->txtoutput ;
 
 	gBank bank = getBankFromMap("generated", banksMap);
 
@@ -170,7 +170,7 @@ void txt_output :: writeGenerated(outputContainer* output, vector<generatedParti
 
 void txt_output :: writeAncestors (outputContainer* output, vector<ancestorInfo> ainfo, gBank bank)
 {
-  ofstream *txtout = output->txtoutput ;
+  ostream *txtout = output->txtoutput ;
 
   *txtout << " --- Ancestors Bank -- " << endl;
 
@@ -194,7 +194,7 @@ void txt_output ::  initBank(outputContainer* output, gBank thisHitBank)
 {
 	if(!insideBank[thisHitBank.bankName])
 	{
-		ofstream *txtout = output->txtoutput ;
+		ostream *txtout = output->txtoutput ;
 		*txtout << " --- " << thisHitBank.bankName << "  (" << thisHitBank.idtag << ", " << DETECTOR_BANK_ID << ") ---- " << endl;
 		insideBank[thisHitBank.bankName] = 1;
 	}
@@ -210,7 +210,7 @@ void txt_output ::  writeG4RawIntegrated(outputContainer* output, vector<hitOutp
 	gBank rawBank = getBankFromMap("raws", banksMap);
 
 	initBank(output, thisHitBank);
-	ofstream *txtout = output->txtoutput ;
+	ostream *txtout = output->txtoutput ;
 		
 	*txtout << "   -- integrated true infos bank  (" << thisHitBank.idtag + RAWINT_ID << ", 0) -- " << endl;
 	for(map<int, string>::iterator it =  rawBank.orderedNames.begin(); it != rawBank.orderedNames.end(); it++)
@@ -249,7 +249,7 @@ void txt_output ::  writeG4RawAll(outputContainer* output, vector<hitOutput> HO,
 	gBank allRawsBank = getBankFromMap("allraws", banksMap);
 
 	initBank(output, thisHitBank);
-	ofstream *txtout = output->txtoutput ;
+	ostream *txtout = output->txtoutput ;
 		
 	*txtout << "   -- step by step true infos bank  (" << thisHitBank.idtag + RAWSTEP_ID << ", 0) -- " << endl;
 	for(map<int, string>::iterator it =  allRawsBank.orderedNames.begin(); it != allRawsBank.orderedNames.end(); it++)
@@ -288,7 +288,7 @@ void txt_output ::  writeG4DgtIntegrated(outputContainer* output, vector<hitOutp
 	gBank dgtBank = getDgtBankFromMap(hitType, banksMap);
 	
 	initBank(output, thisHitBank);
-	ofstream *txtout = output->txtoutput ;
+	ostream *txtout = output->txtoutput ;
 	
 	*txtout << "   -- integrated digitized bank  (" << thisHitBank.idtag + DGTINT_ID << ", 0) -- " << endl;
 
@@ -330,7 +330,7 @@ void txt_output :: writeChargeTime(outputContainer* output, vector<hitOutput> HO
 	gBank chargeTimeBank = getBankFromMap("chargeTime", banksMap);
 
 	initBank(output, thisHitBank);
-	ofstream *txtout = output->txtoutput ;
+	ostream *txtout = output->txtoutput ;
 
 	*txtout << "   -- charge time infos (as seen by electronics) bank  (" << thisHitBank.idtag + CHARGE_TIME_ID << ", 0) -- " << endl;
 
@@ -385,7 +385,7 @@ void txt_output :: writeFADCMode1(outputContainer* output, vector<hitOutput> HO,
 }
 
 
-void txt_output :: writeFADCMode1( map<int, vector<hitOutput> >, int)
+void txt_output :: writeFADCMode1(outputContainer*, const map<int, vector<hitOutput> >&, int)
 {
 }
 
@@ -399,7 +399,7 @@ void txt_output :: writeEvent(outputContainer* output)
 {
 	if(insideBank.size())
 	{
-		ofstream *txtout = output->txtoutput ;
+		ostream *txtout = output->txtoutput ;
 		*txtout << " ---- End of Event  ---- " << endl;
 		
 	}
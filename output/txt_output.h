@@ -56,7 +56,7 @@ class txt_output : public outputFactory
 	virtual void writeFADCMode1(outputContainer*, vector<hitOutput>, int);
 
         // write fadc mode 1 (full signal shape) - jlab hybrid banks. This uses the translation table to write the crate/slot/channel
-        virtual void writeFADCMode1( map<int, vector<hitOutput> >, int);
+        virtual void writeFADCMode1(outputContainer*, const map<int, vector<hitOutput> >&, int);
         
 	// write fadc mode 7 (integrated mode) - jlab hybrid banks. This uses the translation table to write the crate/slot/channel
 	virtual void writeFADCMode7(outputContainer*, vector<hitOutput>, int);
@@ -22,7 +22,7 @@ string indent(int depth)
 // the format is a string for each variable
 void txt_simple_output :: recordSimConditions(outputContainer* output, map<string, string> simcons)
 {
-	ofstream *txtout = output->txtoutput ;
+	ostream *txtout = output->txtoutput ;
 
 	*txtout << "Simulation Conditions, TAG " << SIMULATION_CONDITIONS_BANK_TAG << " {" << endl;
 
@@ -40,7 +40,7 @@ void txt_simple_output :: recordSimConditions(outputContainer* output, map<strin
 void txt_simple_output :: writeHeader(outputContainer* output, map<string, double> data, gBank bank)
 {
 	insideBank.clear();
-	ofstream *txtout = output->txtoutput ;
+	ostream *txtout = output->txtoutput ;
 
 	*txtout << "Event {" << endl;
 	*txtout << indent(1) << "Header Bank {" << endl;
@@ -63,7 +63,7 @@ void txt_simple_output :: writeHeader(outputContainer* output, map<string, doubl
 void txt_simple_output :: writeUserInfoseHeader(outputContainer* output, map<string, double> data)
 {
 
-	ofstream *txtout = output->txtoutput ;
+	ostream *txtout = output->txtoutput ;
 
 	*txtout << indent(1) << "User Header Bank {" << endl;
 
@@ -80,7 +80,7 @@ void txt_simple_output :: writeUserInfoseHeader(outputContainer* output, map<str
 
 void txt_simple_output :: writeRFSignal(outputContainer* output, FrequencySyncSignal rfsignals, gBank bank)
 {
-	ofstream *txtout = output->txtoutput ;
+	ostream *txtout = output->txtoutput ;
 
 	*txtout << indent(1) << "RF Signals Bank {" << endl;
 
@@ -111,7 +111,7 @@ string plural_or_sing(string stem, int n){
 void txt_simple_output :: writeGenerated(outputContainer* output, vector<generatedParticle> MGP, map<string, gBank> *banksMap, vector<userInforForParticle> userInfo)
 {
 	double MAXP = output->gemcOpt.optMap["NGENP"].arg;
-	ofstream *txtout = output->txtoutput ;
+	ostream *txtout = output->txtoutput ;
 
 	gBank bank = getBankFromMap("generated", banksMap);
 
@@ -180,7 +180,7 @@ void txt_simple_output :: writeGenerated(outputContainer* output, vector<generat
 
 void txt_simple_output :: writeAncestors (outputContainer* output, vector<ancestorInfo> ainfo, gBank bank)
 {
-  ofstream *txtout = output->txtoutput ;
+  ostream *txtout = output->txtoutput ;
 
   *txtout << indent(1) << "Ancestors Bank {" << endl;
 
@@ -241,7 +241,7 @@ void txt_simple_output ::  writeG4RawIntegrated(outputContainer* output, vector<
 	gBank thisHitBank = getBankFromMap(hitType, banksMap);
 	gBank rawBank = getBankFromMap("raws", banksMap);
 
-	ofstream *txtout = output->txtoutput ;
+	ostream *txtout = output->txtoutput ;
 	*txtout << indent(1) << thisHitBank.bankName << " (" << thisHitBank.idtag << ", " << DETECTOR_BANK_ID << ") integrated true infos bank (" << thisHitBank.idtag + RAWINT_ID << ", 0) {" << endl;
 
 	for(map<int, string>::iterator it =  rawBank.orderedNames.begin(); it != rawBank.orderedNames.end(); it++)
@@ -280,7 +280,7 @@ void txt_simple_output ::  writeG4RawAll(outputContainer* output, vector<hitOutp
 	gBank thisHitBank = getBankFromMap(hitType, banksMap);
 	gBank allRawsBank = getBankFromMap("allraws", banksMap);
 
-	ofstream *txtout = output->txtoutput ;
+	ostream *txtout = output->txtoutput ;
 	*txtout << indent(1) << thisHitBank.bankName << " (" << thisHitBank.idtag << ", " << DETECTOR_BANK_ID << ") step by step true infos bank (" << thisHitBank.idtag + RAWSTEP_ID << ", 0) {" << endl;
 
 	for(map<int, string>::iterator it =  allRawsBank.orderedNames.begin(); it != allRawsBank.orderedNames.end(); it++)
@@ -318,7 +318,7 @@ void txt_simple_output ::  writeG4DgtIntegrated(outputContainer* output, vector<
 	gBank thisHitBank = getBankFromMap(hitType, banksMap);
 	gBank dgtBank = getDgtBankFromMap(hitType, banksMap);
 
-	ofstream *txtout = output->txtoutput ;
+	ostream *txtout = output->txtoutput ;
 	*txtout << indent(1) << thisHitBank.bankName << " (" << thisHitBank.idtag << ", " << DETECTOR_BANK_ID << ") integrated digitized bank (" << thisHitBank.idtag + DGTINT_ID << ", 0) {" << endl;
 
 	for(map<int, string>::iterator it =  dgtBank.orderedNames.begin(); it != dgtBank.orderedNames.end(); it++)
@@ -358,7 +358,7 @@ void txt_simple_output :: writeChargeTime(outputContainer* output, vector<hitOut
 	gBank thisHitBank    = getBankFromMap(hitType, banksMap);
 	gBank chargeTimeBank = getBankFromMap("chargeTime", banksMap);
 
-	ofstream *txtout = output->txtoutput ;
+	ostream *txtout = output->txtoutput ;
 	*txtout << indent(1) << thisHitBank.bankName << " (" << thisHitBank.idtag << ", " << DETECTOR_BANK_ID << ") charge time infos (as seen by electronics) bank  (" << thisHitBank.idtag + CHARGE_TIME_ID << ", 0) {" << endl;
 
 	for(unsigned int nh=0; nh<HO.size(); nh++) {
@@ -414,7 +414,7 @@ void txt_simple_output :: writeFADCMode1(outputContainer* output, vector<hitOutp
 }
 
 
-void txt_simple_output :: writeFADCMode1( map<int, vector<hitOutput> >, int)
+void txt_simple_output :: writeFADCMode1(outputContainer*, const map<int, vector<hitOutput> >&, int)
 {
 }
 
@@ -426,6 +426,6 @@ void txt_simple_output :: writeFADCMode7(outputContainer* output, vector<hitOutp
 
 void txt_simple_output :: writeEvent(outputContainer* output)
 {
-	ofstream *txtout = output->txtoutput ;
+	ostream *txtout = output->txtoutput ;
 	*txtout << "}" << endl;
 }
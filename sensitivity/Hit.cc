@@ -20,6 +20,7 @@ MHit::MHit() : G4VHit()
 	hasTrigger = 0;
 	isElectronicNoise = 0;
 	isBackgroundHit = 0;
+	accumulated = false;
 
 }
 
@@ -65,6 +66,9 @@ void MHit::Draw()
 MHit::MHit(double energy, double tim, vector<identifier> vid, int pid)
 {
 	isElectronicNoise = 1;
+	isBackgroundHit   = 0;
+	hasTrigger        = 0;
+	accumulated       = false;
 
 	pos.push_back(G4ThreeVector(0,0,0));
 	Lpos.push_back(G4ThreeVector(0,0,0));
@@ -93,7 +97,10 @@ MHit::MHit(double energy, double tim, vector<identifier> vid, int pid)
 // background hit constructor
 MHit::MHit(double energy, double tim, int nphe, vector<identifier> vid)
 {
-	isBackgroundHit = 1;
+	isBackgroundHit   = 1;
+	isElectronicNoise = 0;
+	hasTrigger        = 0;
+	accumulated       = false;
 
 	pos.push_back(G4ThreeVector(0,0,0));
 	Lpos.push_back(G4ThreeVector(0,0,0));
@@ -125,3 +132,19 @@ MHit::MHit(double energy, double tim, int nphe, vector<identifier> vid)
 
 
 
+
+void MHit::shiftTime(double dt)
+{
+	for(auto &t: time)
+		t += dt;
+
+	for(auto &iden: identity)
+		iden.time += dt;
+
+	if(accumulated)
+	{
+		accumulator.tFirst += dt;
+		accumulator.eTime  += dt*accumulator.eTot;
+		accumulator.time   += dt*accumulator.nsteps;
+	}
+}
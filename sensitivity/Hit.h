@@ -22,6 +22,53 @@ using namespace std;
 // TODO: Many of these quantities could be calculated as needed if the Touchable history is given.
 
 
+/// \class hitAccumulator
+/// <b> hitAccumulator </b>\n\n
+/// Running sums over the steps of a hit.\n
+/// Used instead of the step vectors when the hit process does not need them
+/// (see HitProcess::stepsNeeded): the hit keeps its first step and these sums,
+/// so its size does not grow with the number of steps.
+class hitAccumulator
+{
+public:
+	hitAccumulator()
+	{
+		nsteps = 0;
+		eTot   = 0;
+		eTime  = 0;
+		time   = 0;
+		tFirst = 0;
+		ePos   = eLpos = G4ThreeVector(0,0,0);
+		pos    = Lpos  = G4ThreeVector(0,0,0);
+	}
+
+	unsigned int  nsteps;   ///< number of steps (number of photons for optical hits)
+	double        eTot;     ///< total energy deposited
+	double        tFirst;   ///< time of the earliest step
+
+	G4ThreeVector ePos;     ///< energy weighted sum of the positions
+	G4ThreeVector eLpos;    ///< energy weighted sum of the local positions
+	double        eTime;    ///< energy weighted sum of the times
+
+	G4ThreeVector pos;      ///< sum of the positions, for hits with no energy deposited
+	G4ThreeVector Lpos;     ///< sum of the local positions
+	double        time;     ///< sum of the times
+
+	inline void add(G4ThreeVector xyz, G4ThreeVector Lxyz, double t, double e)
+	{
+		if(nsteps == 0 || t < tFirst) tFirst = t;
+		nsteps++;
+		eTot  += e;
+		ePos  += e*xyz;
+		eLpos += e*Lxyz;
+		eTime += e*t;
+		pos   += xyz;
+		Lpos  += Lxyz;
+		time  += t;
+	}
+};
+
+
 // Class definition
 class MHit : public G4VHit
 {
@@ -78,6 +125,9 @@ private:
 
 	int hasTrigger;                 ///< is 1 if this hit produces a signal above threshold
 
+	bool accumulated;               ///< true if the steps after the first one are only summed in accumulator
+	hitAccumulator accumulator;     ///< running sums over all steps, including the first one
+
 public:
 	// infos filled in Sensitive Detector
 	inline void SetPos(G4ThreeVector xyz)       { pos.push_back(xyz); }
@@ -112,6 +162,7 @@ public:
 	inline vector<double> GetEs()               { return E; }
 
 	inline void SetTrackId(int tid)             { trackID.push_back(tid); }
+	inline void SetTrackIds(vector<int> tids)   { trackID = tids; }
 	inline int GetTId()                         { return trackID[0]; }
 	inline vector<int> GetTIds()                { return trackID; }
 
@@ -197,6 +248,18 @@ public:
 	inline vector<int> getQuantumTR(){return quantumTR;}
 	inline void setQuantumTR(vector<int> t)   { quantumTR = t; }
 
+	// step accumulation: the step vectors keep the first step only
+	inline void accumulate(G4ThreeVector xyz, G4ThreeVector Lxyz, double t, double e)
+	{
+		accumulated = true;
+		accumulator.add(xyz, Lxyz, t, e);
+	}
+	inline bool isAccumulated()                   { return accumulated; }
+
+	// moves the hit (steps, identifiers and running sums) by dt. Used by the event mixing
+	void shiftTime(double dt);
+	inline const hitAccumulator& GetAccumulator() { return accumulator; }
+
 	// trigger
 	inline void passedTrigger(){hasTrigger = 1;}
 	inline int diditpassTrigger(){return hasTrigger;}
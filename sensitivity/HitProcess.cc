@@ -98,7 +98,7 @@ map<string, double> HitProcess::integrateRaw(MHit* aHit, int hitn, bool WRITEBAN
 			raws["mvz"]     = aHit->GetmVert().getZ();
 			raws["avg_t"]   = tInfos.time;
 			raws["procID"]  = aHit->GetProcID();
-			raws["nsteps"]  = aHit->GetPIDs().size();
+			raws["nsteps"]  = tInfos.nsteps;
 		}
 	}
 	return raws;
@@ -207,6 +207,35 @@ trueInfos::trueInfos(MHit* aHit)
 	time = 0;
 	x = y = z = lx = ly = lz = 0;
 
+	// accumulated hit: the averages come from the running sums
+	if(aHit->isAccumulated())
+	{
+		const hitAccumulator &acc = aHit->GetAccumulator();
+		nsteps = acc.nsteps;
+		eTot   = acc.eTot;
+
+		G4ThreeVector avg, lavg;
+		if(eTot)
+		{
+			avg  = acc.ePos/eTot;
+			lavg = acc.eLpos/eTot;
+			time = acc.eTime/eTot;
+		}
+		else
+		{
+			avg  = acc.pos/nsteps;
+			lavg = acc.Lpos/nsteps;
+			time = acc.time/nsteps;
+		}
+		x  = avg.x();
+		y  = avg.y();
+		z  = avg.z();
+		lx = lavg.x();
+		ly = lavg.y();
+		lz = lavg.z();
+		return;
+	}
+
 	// getting vectors of energy deposited, positions and times
 	// nsteps is the size
 
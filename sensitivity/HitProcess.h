@@ -132,6 +132,12 @@ public:
 	// - smearing momentum
 	virtual G4ThreeVector psmear(G4ThreeVector p) { return p;}
 
+	// - stepsNeeded: return false if the digitization only uses trueInfos and the first step
+	//   (pid, track ids, momentum, vertex, detector). The sensitive detector then sums
+	//   the steps in the hit accumulator instead of storing them, unless the steps are
+	//   requested by the output options (see sensitiveDetector)
+	virtual bool stepsNeeded() { return true; }
+
 	
 protected:
 
@@ -0,0 +1,110 @@
+// G4 headers
+#include "G4Poisson.hh"
+#include "Randomize.hh"
+
+// gemc headers
+#include "noiseEngine.h"
+#include "string_utilities.h"
+
+// mlibrary
+#include "gstring.h"
+using namespace gstring;
+
+// CLHEP units
+#include "CLHEP/Units/PhysicalConstants.h"
+using namespace CLHEP;
+
+
+noiseEngine::noiseEngine(string sys, goptions gemcOpt, sensitiveID SDID)
+{
+	system    = sys;
+	verbosity = gemcOpt.optMap["HIT_VERBOSITY"].arg;
+
+	string hd_msg = gemcOpt.optMap["LOG_MSG"].args + " Noise Engine: >> ";
+
+	vector<aopt> NOISE_ENGINE = gemcOpt.getArgs("NOISE_ENGINE");
+	for(auto &opt: NOISE_ENGINE) {
+		vector<string> pars = getStringVectorFromStringWithDelimiter(opt.args, ",");
+
+		// system, rate, tmin, tmax, edep, sigma, pid and at least one range
+		if(pars.size() < 8 || trimSpacesFromString(pars[0]) != system)
+			continue;
+
+		noiseSource source;
+		source.rate  = get_number(pars[1]);
+		source.tmin  = get_number(pars[2]);
+		source.tmax  = get_number(pars[3]);
+		source.edep  = get_number(pars[4]);
+		source.sigma = get_number(pars[5]);
+		source.pid   = (int) get_number(pars[6]);
+		source.nchannels = 1;
+
+		for(unsigned i=7; i<pars.size(); i++) {
+			vector<string> range = getStringVectorFromString(pars[i]);
+			if(range.size() != 3) {
+				cout << hd_msg << " !!! Error: identifier range <" << pars[i] << "> of " << system << " should be \"name min max\". Source ignored." << endl;
+				source.nchannels = 0;
+				break;
+			}
+			noiseChannelRange r;
+			r.name = range[0];
+			r.min  = (int) get_number(range[1]);
+			r.max  = (int) get_number(range[2]);
+			if(r.max < r.min) swap(r.min, r.max);
+			source.ranges.push_back(r);
+			source.nchannels *= r.max - r.min + 1;
+		}
+
+		if(source.nchannels == 0)
+			continue;
+
+		if(source.ranges.size() != SDID.identifiers.size())
+			cout << hd_msg << " Warning: " << system << " has " << SDID.identifiers.size() << " identifiers, the noise source defines "
+			     << source.ranges.size() << " ranges." << endl;
+
+		source.mean = source.nchannels*source.rate*(source.tmax - source.tmin);
+		sources.push_back(source);
+
+		cout << hd_msg << " " << system << ": " << source.nchannels << " channels, rate per channel: " << source.rate*s << " Hz, "
+		     << " time window: [" << source.tmin/ns << ", " << source.tmax/ns << "] ns, mean number of hits per event: " << source.mean << endl;
+	}
+}
+
+
+vector<noiseHit> noiseEngine::noiseHits(sensitiveID SDID)
+{
+	vector<noiseHit> hits;
+
+	for(auto &source: sources) {
+		long nhits = G4Poisson(source.mean);
+
+		for(long h=0; h<nhits; h++) {
+			noiseHit noise;
+			noise.time = source.tmin + G4UniformRand()*(source.tmax - source.tmin);
+			noise.edep = source.edep;
+			if(source.sigma > 0) noise.edep = G4RandGauss::shoot(source.edep, source.sigma);
+			if(noise.edep < 0) noise.edep = 0;
+			noise.pid = source.pid;
+
+			// one channel uniformly inside the ranges
+			for(auto &r: source.ranges) {
+				identifier iden;
+				iden.name       = r.name;
+				iden.rule       = "manual";
+				iden.id         = r.min + (int) (G4UniformRand()*(r.max - r.min + 1));
+				if(iden.id > r.max) iden.id = r.max;
+				iden.time       = noise.time;
+				iden.TimeWindow = SDID.timeWindow;
+				iden.TrackId    = 0;
+				noise.identity.push_back(iden);
+			}
+
+			if(verbosity > 4)
+				cout << " Noise hit in " << system << " at " << noise.time/ns << " ns, edep " << noise.edep/MeV << " MeV. Identity:" << endl << noise.identity;
+
+			hits.push_back(noise);
+		}
+	}
+
+	return hits;
+}
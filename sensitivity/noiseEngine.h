@@ -0,0 +1,93 @@
+/// \file noiseEngine.h
+/// Defines the gemc generic electronic noise engine.\n
+/// Each NOISE_ENGINE source injects, in every event, random hits in the
+/// channels of a system. The channels are the product of the identifier ranges
+/// of the source. The number of noisy channels is drawn from a Poisson
+/// distribution with mean nchannels*rate*(tmax - tmin), so there is no loop
+/// over the channels. The sensitive detector turns each noise hit into an ordinary
+/// MHit in the volume that owns the channel, or adds it as a step to the hit
+/// already in that channel, so it goes through the normal digitization of the system hit process.\n
+/// \author \n Maurizio Ungaro
+/// \author mail: ungaro@jlab.org\n\n\n
+#ifndef noiseEngine_H
+#define noiseEngine_H 1
+
+// gemc headers
+#include "identifier.h"
+#include "sensitiveID.h"
+#include "options.h"
+
+// C++ headers
+#include <string>
+#include <vector>
+using namespace std;
+
+
+/// \class noiseChannelRange
+/// <b> noiseChannelRange</b>\n\n
+/// Range of an identifier: the channels are all the ids from min to max
+class noiseChannelRange
+{
+public:
+	string name;
+	int min;
+	int max;
+};
+
+
+/// \class noiseHit
+/// <b> noiseHit</b>\n\n
+/// Channel, time, energy and particle id of one noise hit
+class noiseHit
+{
+public:
+	vector<identifier> identity;
+	double time;
+	double edep;
+	int    pid;
+};
+
+
+/// \class noiseSource
+/// <b> noiseSource</b>\n\n
+/// One NOISE_ENGINE entry. Pedestal noise, dark counts and random hits
+/// are separate sources with different rates, energies and time windows.
+class noiseSource
+{
+public:
+	double rate;       ///< rate per channel
+	double tmin;       ///< time window start
+	double tmax;       ///< time window end
+	double edep;       ///< mean energy of the noise hit
+	double sigma;      ///< energy spread of the noise hit
+	int    pid;        ///< particle id assigned to the noise hit
+
+	vector<noiseChannelRange> ranges;
+
+	double nchannels;  ///< product of the ranges
+	double mean;       ///< mean number of noise hits in the time window
+};
+
+
+/// \class noiseEngine
+/// <b> noiseEngine</b>\n\n
+/// Noise sources of a system, from the NOISE_ENGINE options.\n
+/// Usage: -NOISE_ENGINE="system, rate, tmin, tmax, edep, sigma, pid, id1 min max, id2 min max, ..."
+class noiseEngine
+{
+public:
+	noiseEngine(){;}
+	noiseEngine(string system, goptions gemcOpt, sensitiveID SDID);
+
+	bool isActive() { return sources.size() > 0; }
+
+	// returns the noise hits of one event
+	vector<noiseHit> noiseHits(sensitiveID SDID);
+
+private:
+	string           system;
+	vector<noiseSource> sources;
+	int              verbosity;
+};
+
+#endif
@@ -38,6 +38,19 @@ sensitiveDetector::sensitiveDetector(G4String name, goptions opt, string factory
 		
 	SDID = sensitiveID(HCname, gemcOpt, factory, variation, system);
 
+	// the step vectors are needed by the step by step outputs, the step record,
+	// the mother infos (per step track ids) and the hadron filter (per step pids)
+	stepsOptional = true;
+	if(gemcOpt.optMap["ALLRAWS"].args.find(HCname)  != string::npos) stepsOptional = false;
+	if(gemcOpt.optMap["SIGNALVT"].args.find(HCname) != string::npos) stepsOptional = false;
+	if(gemcOpt.optMap["STEP_RECORD"].args != "no")                    stepsOptional = false;
+	if(gemcOpt.optMap["SAVE_ALL_MOTHERS"].arg   != 0)                 stepsOptional = false;
+	if(gemcOpt.optMap["SAVE_ALL_ANCESTORS"].arg != 0)                 stepsOptional = false;
+	if(gemcOpt.optMap["FILTER_HADRONS"].arg     != 0)                 stepsOptional = false;
+	if(fastMCMode != 0)                                               stepsOptional = false;
+	accumulateSteps = false;
+
+	noise = noiseEngine(HCname, gemcOpt, SDID);
 }
 
 sensitiveDetector::~sensitiveDetector(){}
@@ -106,6 +119,8 @@ G4bool sensitiveDetector::ProcessHits(G4Step* aStep, G4TouchableHistory*)
 	if(ProcessHitRoutine == NULL)
 	{
 		ProcessHitRoutine = getHitProcess(hitProcessMap, GetDetectorHitType(name));
+		if(ProcessHitRoutine)
+			accumulateSteps = stepsOptional && !ProcessHitRoutine->stepsNeeded();
 	}
 	
 	// if not existing, exit
@@ -199,6 +214,8 @@ G4bool sensitiveDetector::ProcessHits(G4Step* aStep, G4TouchableHistory*)
 			thisHit->SetProcID(processID(processName));
             thisHit->SetSDID(SDID);
             thisHit->SetMgnf(hitFieldValue);
+			if(accumulateSteps)
+				thisHit->accumulate(xyz, Lxyz, ctime, depe*mhPID[singl_hit_size-1].id_sharing);
 			hitCollection->insert(thisHit);
 			Id_Set.insert(mhPID);
 			
@@ -226,6 +243,11 @@ G4bool sensitiveDetector::ProcessHits(G4Step* aStep, G4TouchableHistory*)
 					cout << " Hit not found in collection but found in PID. This should never happen. Exiting." << endl;
 					exit(0);
 				}
+				else if(thisHit->isAccumulated())
+				{
+					// only the running sums are updated, the hit size stays constant
+					thisHit->accumulate(xyz, Lxyz, ctime, depe*mhPID[singl_hit_size-1].id_sharing);
+				}
 				else
 				{
 					thisHit->SetPos(xyz);
@@ -270,6 +292,14 @@ G4bool sensitiveDetector::ProcessHits(G4Step* aStep, G4TouchableHistory*)
 
 void sensitiveDetector::EndOfEvent(G4HCofThisEvent *HCE)
 {
+	// generic noise engine: the hits are added also if the detector was not hit
+	if(noise.isActive())
+	{
+		vector<noiseHit> noiseHits = noise.noiseHits(SDID);
+		for(auto &nh: noiseHits)
+			addNoiseHit(nh);
+	}
+
 	int nhitC = hitCollection->GetSize();
 	if(!nhitC) return;
 
@@ -277,7 +307,7 @@ void sensitiveDetector::EndOfEvent(G4HCofThisEvent *HCE)
 	// only if requested by user
 	// notice: there should be routine to decide if hit is in the same TW
 	// (in that case it is not a new hit)
-	if(ELECTRONICNOISE.find(HCname) != string::npos)
+	if(ELECTRONICNOISE.find(HCname) != string::npos && ProcessHitRoutine)
 	{
 		vector<MHit*> noiseHits = ProcessHitRoutine->electronicNoise();
 		for(unsigned int h=0; h<noiseHits.size(); h++)
@@ -394,3 +424,125 @@ int sensitiveDetector::processID(string procName)
 }
 
 
+// the volume owning a channel is the one with this sensitivity whose identifiers
+// match the channel in the most leading positions. Identifiers set by copy number
+// or by processID (not manual) match any id
+string sensitiveDetector::noiseOwner(const vector<identifier> &identity)
+{
+	vector<int> ids;
+	for(auto &iden: identity)
+		ids.push_back(iden.id);
+
+	auto owner = noiseOwners.find(ids);
+	if(owner != noiseOwners.end())
+		return owner->second;
+
+	string best = "";
+	int bestMatch = -1;
+	for(auto &det: *hallMap)
+	{
+		if(det.second.sensitivity != HCname) continue;
+
+		int match = 0;
+		for(unsigned i=0; i<identity.size() && i<det.second.identity.size(); i++)
+		{
+			const identifier &vid = det.second.identity[i];
+			if(vid.name != identity[i].name) break;
+			if(vid.rule == "manual" && vid.id != identity[i].id) break;
+			match++;
+		}
+		if(match > bestMatch)
+		{
+			bestMatch = match;
+			best = det.first;
+		}
+	}
+
+	// global position of the volume, through its mother chain
+	if(best != "" && noisePositions.find(best) == noisePositions.end())
+	{
+		G4ThreeVector center(0, 0, 0);
+		string dname = best;
+		while(hallMap->find(dname) != hallMap->end() && (*hallMap)[dname].GetPhysical() != nullptr)
+		{
+			G4VPhysicalVolume *pv = (*hallMap)[dname].GetPhysical();
+			center = pv->GetObjectRotationValue()*center + pv->GetObjectTranslation();
+			dname = (*hallMap)[dname].mother;
+		}
+		noisePositions[best] = center;
+	}
+
+	noiseOwners[ids] = best;
+	return best;
+}
+
+// the noise hit is an ordinary hit at the center of the volume owning the channel:
+// a new hit, or a step of the hit already in the same channel and time window
+void sensitiveDetector::addNoiseHit(noiseHit &noise)
+{
+	string name = noiseOwner(noise.identity);
+	if(name == "")
+	{
+		if(verbosity > 4)
+			cout << hd_msg2 << " No volume of " << HCname << " owns the noise channel:" << endl << noise.identity;
+		return;
+	}
+
+	detector &owner = (*hallMap)[name];
+
+	// same rules as the hits of the volume, so that the noise can share a hit with the steps
+	for(unsigned i=0; i<noise.identity.size() && i<owner.identity.size(); i++)
+		noise.identity[i].rule = owner.identity[i].rule;
+
+	G4ThreeVector xyz  = noisePositions[name];
+	G4ThreeVector Lxyz = G4ThreeVector(0, 0, 0);
+	G4ThreeVector zero = G4ThreeVector(0, 0, 0);
+
+	MHit *thisHit = nullptr;
+	for(auto &itid: Id_Set)
+	{
+		if(itid == noise.identity)
+		{
+			thisHit = find_existing_hit(itid);
+			break;
+		}
+	}
+
+	if(thisHit && thisHit->isAccumulated())
+	{
+		thisHit->accumulate(xyz, Lxyz, noise.time, noise.edep);
+		return;
+	}
+
+	bool newHit = thisHit == nullptr;
+	if(newHit)
+	{
+		thisHit = new MHit();
+		thisHit->SetId(noise.identity);
+		thisHit->SetSDID(SDID);
+	}
+
+	thisHit->SetPos(xyz);
+	thisHit->SetLPos(Lxyz);
+	thisHit->SetVert(zero);
+	thisHit->SetTime(noise.time);
+	thisHit->SetEdep(noise.edep);
+	thisHit->SetDx(0);
+	thisHit->SetMom(zero);
+	thisHit->SetE(0);
+	thisHit->SetTrackId(0);
+	thisHit->SetPID(noise.pid);
+	thisHit->SetCharge(0);
+	thisHit->SetMatName(owner.material);
+	thisHit->SetProcID(999);            // no process, as "na"
+	thisHit->SetDetector(owner);
+	thisHit->SetMgnf(0);
+
+	if(newHit)
+	{
+		if(accumulateSteps)
+			thisHit->accumulate(xyz, Lxyz, noise.time, noise.edep);
+		hitCollection->insert(thisHit);
+		Id_Set.insert(noise.identity);
+	}
+}
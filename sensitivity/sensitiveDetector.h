@@ -17,6 +17,7 @@
 #include "Hit.h"
 #include "HitProcess.h"
 #include "backgroundHits.h"
+#include "noiseEngine.h"
 
 // C++ headers
 #include <iostream>
@@ -68,6 +69,14 @@ private:
 	double RECORD_OPTICALPHOTONS;    ///< If set to one, records particles in the mirror detectors
 	string ELECTRONICNOISE;  ///< List of detectors for which electronic noise routines will be called
 	int fastMCMode;          ///< In fast MC mode, the particle smeared/unsmeared momenta are saved
+	bool stepsOptional;      ///< true if no output option needs the step vectors of this detector
+	bool accumulateSteps;    ///< true if the hits of this event sum their steps (see HitProcess::stepsNeeded)
+	noiseEngine noise;       ///< NOISE_ENGINE sources of this detector
+	map<vector<int>, string> noiseOwners;      ///< volume that owns each noise channel, found at the first noise hit of the channel
+	map<string, G4ThreeVector> noisePositions; ///< global position of the volumes owning noise channels
+
+	string noiseOwner(const vector<identifier> &identity);   ///< volume owning a channel: the one with most leading identifiers matching
+	void addNoiseHit(noiseHit &noise);                       ///< adds a noise hit as a new hit or as a step of the hit in the same channel
 
 
 public:
@@ -354,7 +354,9 @@ void MDetectorConstruction::hasMagfield(detector detect)
 		}
 		
 		activeFields.insert(magf);
-		detect.AssignMFM(itr->second.get_MFM());
+		for(auto &c: itr->second.components)
+			activeFields.insert(c.name);
+		detect.AssignMFM(itr->second.get_MFM(fieldsMap));
 		
 		if((verbosity > 1 && verbosity != 99) || detect.name.find(catch_v) != string::npos )
 			cout << hd_msg  << " Field <" <<  magf << "> is built and assigned to " << detect.name << "." << endl;
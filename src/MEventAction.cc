@@ -3,6 +3,7 @@
 #include "G4RunManager.hh"
 #include "G4Trajectory.hh"
 #include "G4UImanager.hh"
+#include "Randomize.hh"
 
 // gemc headers
 #include "MEventAction.h"
@@ -12,6 +13,10 @@
 #include "frequencySyncSignal.h"
 
 #include <iostream>
+#include <sstream>
+#include <thread>
+#include <atomic>
+#include <algorithm>
 using namespace std;
 
 // CLHEP units
@@ -80,6 +85,52 @@ vector<G4ThreeVector> vector_mvert(map<int, TInfos> tinfos, vector<int> tids)
 	return mvert;
 }
 
+// samples the voltage of a hit every tsampling ns, starting from the charge / time of each step
+// the first three entries are crate/slot/channel from the translation table
+map<int, int> vtSignal(HitProcess *hitProcessRoutine, map< int, vector <double> > chargeTime, double tsampling, double nsamplings)
+{
+	vector<double> stepTimes   = chargeTime[3]; // time at electronics
+	vector<double> stepCharges = chargeTime[2]; // charge at electronics
+	vector<double> hardware    = chargeTime[5]; // crate/slot/channel
+	
+	map<int, int> vSignal;
+	
+	// crate, slot, channels as from translation table
+	vSignal[0] = hardware[0];           // crate
+	vSignal[1] = hardware[1];           // slot
+	vSignal[2] = hardware[2];           // channel
+	
+	// Add comments what are these
+	double pedestal_mean = hardware[3];
+	double pedestal_sigm = hardware[4];
+	
+	for(unsigned ts = 0; ts<nsamplings; ts++) {
+		double forTime = ts*tsampling;
+		double voltage = 0;
+		
+		// create the voltage output based on the hit process
+		// routine voltage(double charge, double time, double forTime)
+		for(unsigned s=0; s<stepTimes.size(); s++) {
+			
+			double stepTime   = stepTimes[s];
+			double stepCharge = stepCharges[s];
+			
+			voltage += hitProcessRoutine->voltage(stepCharge, stepTime, forTime);
+		}
+		
+		// Now pedestal should be calculated, Assume it is a Gaussian
+		double pedestal = G4RandGauss::shoot(pedestal_mean, pedestal_sigm);
+		
+		// need conversion factor from double to int
+		// the first 3 entries are crate/slot/channels above
+		// the total signal is the pedestal + voltage (from actuall hit), here voltage is actually represents
+		// FADC counts
+		vSignal[ts+3] = int(pedestal) + (int) voltage;
+	}
+	
+	return vSignal;
+}
+
 MEventAction::MEventAction(goptions opts, map<string, double> gpars)
 {
 	gemcOpt          = opts;
@@ -137,6 +188,32 @@ MEventAction::MEventAction(goptions opts, map<string, double> gpars)
 	
 	backgroundEventNumber.clear();
 	
+	// digitization worker threads. The geant4 random engine is thread local
+	// only in multithreaded builds: otherwise the digitization stays serial
+	DIGITIZATION_THREADS = (int) gemcOpt.optMap["DIGITIZATION_THREADS"].arg;
+#ifndef G4MULTITHREADED
+	if(DIGITIZATION_THREADS > 1) {
+		cout << hd_msg << " Warning: DIGITIZATION_THREADS requires a multithreaded geant4 build. Digitizing serially." << endl;
+		DIGITIZATION_THREADS = 1;
+	}
+#endif
+	
+	mixer = nullptr;
+	bunchRecorder = nullptr;
+	phaseSpaceOutput = nullptr;
+	scoring = nullptr;
+
+	// EVENT_FILTER: compiled event selection
+	filter = nullptr;
+	if(gemcOpt.optMap["EVENT_FILTER"].args != "no")
+		filter = new eventFilter(gemcOpt);
+
+	// step record for DIGITIZE_ONLY
+	stepOutput = nullptr;
+	if(gemcOpt.optMap["STEP_RECORD"].args != "no") {
+		stepOutput = new stepRecord(gemcOpt.optMap["STEP_RECORD"].args, "w");
+	}
+	
 	// SAVE_SELECTED parameters
 	string arg = gemcOpt.optMap["SAVE_SELECTED"].args;
 	if (arg == "" || arg == "no")
@@ -176,6 +253,17 @@ MEventAction::~MEventAction()
 {
 	if(SAVE_ALL_MOTHERS>1)
 	lundOutput->close();
+	
+	if(stepOutput != nullptr)
+	delete stepOutput;
+
+	if(mixer != nullptr)
+	delete mixer;
+
+	if(filter != nullptr) {
+		filter->printSummary();
+		delete filter;
+	}
 }
 
 void MEventAction::BeginOfEventAction(const G4Event* evt)
@@ -231,6 +319,18 @@ void MEventAction::BeginOfEventAction(const G4Event* evt)
 
 void MEventAction::EndOfEventAction(const G4Event* evt)
 {
+	// LUMI_BUNCH_RECORD: each event is a bunch
+	if(bunchRecorder != nullptr)
+		bunchRecorder->endBunch();
+
+	// PHASESPACE_RECORD: particles that crossed the surface in this event
+	if(phaseSpaceOutput != nullptr)
+		phaseSpaceOutput->endEvent(evtN, gen_action->getEventWeight());
+
+	// SCORING_MESH, SCORING_VOLUME: contributions of this event
+	if(scoring != nullptr)
+		scoring->endEvent();
+
 	if ((gen_action->isFileOpen() == false) ||
 		 (gen_action->doneRerun() == true))
 	return;
@@ -280,6 +380,9 @@ void MEventAction::EndOfEventAction(const G4Event* evt)
 		if (not foundHad) return;
 	}
 	
+	// EVENT_FILTER: rejected events are not digitized nor written
+	if(filter != nullptr && !filter->accept(evt, SeDe_Map)) return;
+	
 	
 	if(evtN%Modulo == 0 )
 	cout << hd_msg << " Starting Event Action Routine " << evtN << "  Run Number: " << rw.runNo << endl;
@@ -446,6 +549,7 @@ void MEventAction::EndOfEventAction(const G4Event* evt)
 		return;
 	}
 	outputFactory *processOutputFactory = getOutputFactory(outputFactoryMap, outContainer->outType);
+	outContainer->beginEvent();
 	
 	
 	// Header Bank contains event number
@@ -455,6 +559,14 @@ void MEventAction::EndOfEventAction(const G4Event* evt)
 	header["evn"]      = evtN;
 	header["evn_type"] = -1;  // physics event. Negative is MonteCarlo event
 	header["beamPol"]  = gen_action->getBeamPol();
+	header["weight"]   = gen_action->getEventWeight();
+
+	// GENERATOR_FILTER normalization: accepted / generated events
+	header["ngenerated"] = gen_action->getGeneratedEvents();
+	header["naccepted"]  = gen_action->getAcceptedEvents();
+
+	// phase space replay normalization: events simulated to record the file
+	header["nsource"] = gen_action->getSourceEvents();
 	
 	// write event header bank
 	processOutputFactory->writeHeader(outContainer, header, getBankFromMap("header", banksMap));
@@ -478,6 +590,7 @@ void MEventAction::EndOfEventAction(const G4Event* evt)
 	
 	// write RF bank if present
 	// do not write in FASTMC mode
+	string rfsetup = "";
 	if(RFSETUP!= "no" && fastMCMode == 0) {
 		
 		double additionalTime = 0;
@@ -495,7 +608,7 @@ void MEventAction::EndOfEventAction(const G4Event* evt)
 		}
 		
 		// getting time window
-		string rfsetup = to_string(gen_action->getTimeWindow()) + " " ;
+		rfsetup  = to_string(gen_action->getTimeWindow()) + " " ;
 		
 		// getting start time of the event
 		rfsetup +=  to_string(gen_action->getStartTime() + additionalTime) + " " ;
@@ -543,6 +656,16 @@ void MEventAction::EndOfEventAction(const G4Event* evt)
 	
 	map<int, vector<hitOutput> > hit_outputs_from_AllSD;
 	
+	if(stepOutput != nullptr)
+	stepOutput->beginEvent(header, userHeader, rfsetup);
+	
+	// the hits of each detector are prepared here, serially: background, mother infos and raw information
+	// the digitization runs on DIGITIZATION_THREADS worker threads (inline if 1)
+	vector<detectorDigitization*> digitizations;
+	
+	// the same background events are mixed in all detectors
+	if(mixer != nullptr)
+	mixer->nextEvent();
 	
 	for(map<string, sensitiveDetector*>::iterator it = SeDe_Map.begin(); it!= SeDe_Map.end(); it++)
 	{
@@ -558,6 +681,14 @@ void MEventAction::EndOfEventAction(const G4Event* evt)
 			}
 		}
 		
+		// adding the hits of the mixed background events
+		if(mixer != nullptr && MHC) {
+			for(auto mixedHit: mixer->hitsForSystem(it->first)) {
+				mixedHit->SetSDID(it->second->SDID);
+				MHC->insert(mixedHit);
+			}
+		}
+		
 		if (MHC) nhits = MHC->GetSize();
 		else nhits = 0;
 		
@@ -579,8 +710,15 @@ void MEventAction::EndOfEventAction(const G4Event* evt)
 			
 			
 			HitProcess *hitProcessRoutine = getHitProcess(hitProcessMap, hitType);
-			if(!hitProcessRoutine)
-			return;
+			if(!hitProcessRoutine) {
+				if(stepOutput != nullptr)
+				stepOutput->abortEvent();
+				for(auto dd: digitizations) {
+					delete dd->hitProcessRoutine;
+					delete dd;
+				}
+				return;
+			}
 			
 			if(fastMCMode == 0 || fastMCMode > 9)
 			hitProcessRoutine->init(hitType, gemcOpt, gPars);
@@ -590,8 +728,28 @@ void MEventAction::EndOfEventAction(const G4Event* evt)
 			if(WRITE_INTRAW.find(hitType) != string::npos) WRITE_TRUE_INTEGRATED = 1;
 			if(WRITE_ALLRAW.find(hitType) != string::npos) WRITE_TRUE_ALL = 1;
 			
-			vector<hitOutput> allRawOutput;
-			vector<hitOutput> allDgtOutput;
+			detectorDigitization *thisDigitization = new detectorDigitization;
+			thisDigitization->hitType           = hitType;
+			thisDigitization->MHC               = MHC;
+			thisDigitization->hitProcessRoutine = hitProcessRoutine;
+			thisDigitization->seed              = 0;
+			thisDigitization->writeTrueIntegrated = WRITE_TRUE_INTEGRATED;
+			thisDigitization->writeTrueAll        = WRITE_TRUE_ALL;
+			
+			// geant4 integrated digitized information
+			// by default they are all ENABLED
+			// user can disable them one by one
+			// using the INTEGRATEDDGT option
+			// for FASTMC mode, do not digitize the info
+			thisDigitization->writeDgt = WRITE_INTDGT.find(hitType) == string::npos && (fastMCMode == 0 ||fastMCMode > 9);
+			
+			// geant4 voltage versus time
+			// by default they are all DISABLED
+			// user can enable them one by one
+			// using the SIGNALVT option
+			thisDigitization->writeVT  = SIGNALVT.find(hitType) != string::npos;
+			
+			vector<hitOutput> &allRawOutput = thisDigitization->allRawOutput;
 			
 			// creating summary information for each generated particle
 			for(unsigned pi = 0; pi<MPrimaries.size(); pi++) {
@@ -691,21 +849,10 @@ void MEventAction::EndOfEventAction(const G4Event* evt)
 				}
 			}
 			
-			// geant4 integrated raw information
-			// by default they are all DISABLED
-			// user can enable them one by one
-			// using the INTEGRATEDRAW option
-			if(WRITE_TRUE_INTEGRATED)
-			processOutputFactory->writeG4RawIntegrated(outContainer, allRawOutput, hitType, banksMap);
-			
-			// geant4 all raw information
-			// by default they are all DISABLED
-			// user can enable them one by one
-			// using the ALLRAWS option
-			if(WRITE_TRUE_ALL)
-			processOutputFactory->writeG4RawAll(outContainer, allRawOutput, hitType, banksMap);
-			
-			
+			// hits are saved after background merging and mother infos
+			// so DIGITIZE_ONLY sees them as the digitization below does
+			if(stepOutput != nullptr)
+			stepOutput->writeHits(hitType, MHC);
 			
 			if(VERB > 4)
 			for(unsigned pi = 0; pi<MPrimaries.size(); pi++)
@@ -721,189 +868,114 @@ void MEventAction::EndOfEventAction(const G4Event* evt)
 				
 			}
 			
-			// geant4 integrated digitized information
-			// by default they are all ENABLED
-			// user can disable them one by one
-			// using the INTEGRATEDDGT option
-			// for FASTMC mode, do not digitize the info
-			if(WRITE_INTDGT.find(hitType) == string::npos && (fastMCMode == 0 ||fastMCMode > 9))
-			{
-				hitProcessRoutine->initWithRunNumber(rw.runNo);
-				
-				for(int h=0; h<nhits; h++)
-				{
-					
-					hitOutput thisHitOutput;
-					MHit* aHit = (*MHC)[h];
-					
-					// calling integrateDgt will also set writeHit
-					thisHitOutput.setDgtz(hitProcessRoutine->integrateDgt(aHit, h+1));
-					
-					// include this hit. Users can set writeHit to false to avoid writing the hit
-					// the hitProcessRoutine variable detectorThreshold could be used in integrateDgt
-					if(hitProcessRoutine->writeHit) {
-						allDgtOutput.push_back(thisHitOutput);
-					}
-					
-					string vname = aHit->GetId()[aHit->GetId().size()-1].name;
-					if(VERB > 4 || vname.find(catch_v) != string::npos)
-					{
-						cout << hd_msg << " Hit " << h + 1 << " --  total number of steps this hit: " << aHit->GetPos().size() << endl;
-						cout << aHit->GetId();
-						double Etot = 0;
-						for(unsigned int e=0; e<aHit->GetPos().size(); e++) Etot = Etot + aHit->GetEdep()[e];
-						cout << "   Total energy deposited: " << Etot/MeV << " MeV" << endl;
-					}
-				}
-				processOutputFactory->writeG4DgtIntegrated(outContainer, allDgtOutput, hitType, banksMap);
-				
-			} // end of geant4 integrated digitized information
+			// the calibration constants are loaded here so the digitization
+			// tasks never access the database concurrently
+			if(thisDigitization->writeDgt)
+			hitProcessRoutine->initWithRunNumber(rw.runNo);
 			
+			// with worker threads each detector gets its own random seed, drawn in the
+			// SeDe_Map order, so the result does not depend on the scheduling
+			if(DIGITIZATION_THREADS > 1)
+			thisDigitization->seed = (long) (G4UniformRand()*2147483647);
+			else
+			digitizeDetector(thisDigitization);
 			
-			// geant4 voltage versus time
-			// by default they are all DISABLED
-			// user can enable them one by one
-			// using the SIGNALVT option
-			if(SIGNALVT.find(hitType) != string::npos) {
-				vector<hitOutput> allVTOutput;
-				
-				
-				for(int h=0; h<nhits; h++) {
-					
-					hitOutput thisHitOutput;
-					
-					MHit* aHit = (*MHC)[h];
-					
-					// process each step to produce a charge/time digitized information / step
-					thisHitOutput.setChargeTime(hitProcessRoutine->chargeTime(aHit, h));
-					
-					vector<double> stepTimes   = thisHitOutput.getChargeTime()[3]; // time at electronics
-					vector<double> stepCharges = thisHitOutput.getChargeTime()[2]; // charge at electronics
-					vector<double> hardware    = thisHitOutput.getChargeTime()[5]; // crate/slot/channel
-					
-					map<int, int> vSignal;
-					
-					// crate, slot, channels as from translation table
-					vSignal[0] = hardware[0];           // crate
-					vSignal[1] = hardware[1];           // slot
-					vSignal[2] = hardware[2];           // channel
-					
-					// Add comments what are these
-					double pedestal_mean = hardware[3];
-					double pedestal_sigm = hardware[4];
-					
-					for(unsigned ts = 0; ts<nsamplings; ts++) {
-						double forTime = ts*tsampling;
-						double voltage = 0;
-						
-						// create the voltage output based on the hit process
-						// routine voltage(double charge, double time, double forTime)
-						for(unsigned s=0; s<stepTimes.size(); s++) {
-							
-							double stepTime   = stepTimes[s];
-							double stepCharge = stepCharges[s];
-							
-							// cout<<"StepTime = "<<stepTime<<endl;
-							// cout<<"StepCharge =  = "<<stepCharge<<endl;
-							
-							voltage += hitProcessRoutine->voltage(stepCharge, stepTime, forTime);
-							
-							//cout<<"setpCharge = "<<stepCharge<<endl;
-							
-							// cout << " hit " << h <<    "step " << s << "  time: " << stepTime
-							// << "   charge " << stepCharge << "  voltage " << voltage << "  for time bunch " << ts << endl;
-						}
-						
-						
-						// Now pedestal should be calculated, Assume it is a Gaussian
-						double pedestal = G4RandGauss::shoot(pedestal_mean, pedestal_sigm);
-						
-						// need conversion factor from double to int
-						// the first 3 entries are crate/slot/channels above
-						// the total signal is the pedestal + voltage (from actuall hit), here voltage is actually represents
-						// FADC counts
-						vSignal[ts+3] = int(pedestal) + (int) voltage;
-					}
-					thisHitOutput.createQuantumS(vSignal);
-					
-					hit_outputs_from_AllSD[vSignal[0]].push_back(thisHitOutput);
-					allVTOutput.push_back(thisHitOutput);
-					
-					// this is not written out yet
-					
-					string vname = aHit->GetId()[aHit->GetId().size()-1].name;
-					
-					if(VERB > 4 || vname.find(catch_v) != string::npos)
-					{
-						cout << hd_msg << " Hit " << h + 1 << " --  total number of steps this hit: " << aHit->GetPos().size() << endl;
-						cout << aHit->GetId();
-						double Etot = 0;
-						for(unsigned int e=0; e<aHit->GetPos().size(); e++) Etot = Etot + aHit->GetEdep()[e];
-						cout << "   Total energy deposited: " << Etot/MeV << " MeV" << endl;
-					}
-				}
-				processOutputFactory->writeChargeTime(outContainer, allVTOutput, hitType, banksMap);
-				
-				// Event number (evtN) is needed in FADCMode1, therefore this is also passed as an argument
-				//processOutputFactory->writeFADCMode1(outContainer, allVTOutput, evtN);
-				
+			digitizations.push_back(thisDigitization);
+		}
+	}
+	
+	if(DIGITIZATION_THREADS > 1)
+	digitizeDetectors(digitizations);
+	
+	// writing the banks in the SeDe_Map order
+	for(auto thisDigitization: digitizations)
+	{
+		cout << thisDigitization->log;
+		
+		string hitType = thisDigitization->hitType;
+		nhits          = thisDigitization->MHC->GetSize();
+		
+		vector<hitOutput> &allRawOutput = thisDigitization->allRawOutput;
+		vector<hitOutput> &allDgtOutput = thisDigitization->allDgtOutput;
+		
+		// geant4 integrated raw information
+		// by default they are all DISABLED
+		// user can enable them one by one
+		// using the INTEGRATEDRAW option
+		if(thisDigitization->writeTrueIntegrated)
+		processOutputFactory->writeG4RawIntegrated(outContainer, allRawOutput, hitType, banksMap);
+		
+		// geant4 all raw information
+		// by default they are all DISABLED
+		// user can enable them one by one
+		// using the ALLRAWS option
+		if(thisDigitization->writeTrueAll)
+		processOutputFactory->writeG4RawAll(outContainer, allRawOutput, hitType, banksMap);
+		
+		if(thisDigitization->writeDgt)
+		processOutputFactory->writeG4DgtIntegrated(outContainer, allDgtOutput, hitType, banksMap);
+		
+		if(thisDigitization->writeVT) {
+			for(auto &thisHitOutput: thisDigitization->allVTOutput)
+			hit_outputs_from_AllSD[thisHitOutput.getQuantumS().at(0)].push_back(thisHitOutput);
+			
+			processOutputFactory->writeChargeTime(outContainer, thisDigitization->allVTOutput, hitType, banksMap);
+		}
+		
+		// Check whether to save RNG
+		if (ssp.enabled && ssp.decision == false)
+		for (int h = 0; h < nhits; ++h)
+		{
+			// Check if masked ID matches targetId
+			int id = allDgtOutput[h].getIntDgtVar ("id");
+			int id2 = id;
+			int j = ssp.tIdsize-1;
+			
+			for (; j >= 0; --j)
+			{
+				if (ssp.targetId[j] != 'x' && id2 % 10 != atoi (ssp.targetId.substr(j,1).c_str()))
+				break;
+				id2 /= 10;
 			}
+			if (j >= 0)
+			continue;
 			
+			// Check pid
+			int pid = allRawOutput[h].getIntRawVar ("pid");
+			if (pid != ssp.targetPid)
+			continue;
 			
-			// Check whether to save RNG
-			if (ssp.enabled && ssp.decision == false)
-			for (int h = 0; h < nhits; ++h)
+			// Check given variable
+			double varval = allRawOutput[h].getIntRawVar (ssp.variable);
+			if (varval == -99)
+			varval = allDgtOutput[h].getIntDgtVar (ssp.variable);
+			if (varval == -99)
 			{
-				// Check if masked ID matches targetId
-				int id = allDgtOutput[h].getIntDgtVar ("id");
-				int id2 = id;
-				int j = ssp.tIdsize-1;
-				
-				for (; j >= 0; --j)
-				{
-					if (ssp.targetId[j] != 'x' && id2 % 10 != atoi (ssp.targetId.substr(j,1).c_str()))
-					break;
-					id2 /= 10;
-				}
-				if (j >= 0)
-				continue;
-				
-				// Check pid
-				int pid = allRawOutput[h].getIntRawVar ("pid");
-				if (pid != ssp.targetPid)
-				continue;
-				
-				// Check given variable
-				double varval = allRawOutput[h].getIntRawVar (ssp.variable);
-				if (varval == -99)
-				varval = allDgtOutput[h].getIntDgtVar (ssp.variable);
-				if (varval == -99)
-				{
-					cout << "Unknown variable " << ssp.variable << " for SAVE_SELECTED, exiting" << endl;
-					exit (0);
-				}
-				
-				if (varval >= ssp.lowLim && varval <= ssp.hiLim)
-				{
-					ssp.decision = true;
-					break;
-				}
+				cout << "Unknown variable " << ssp.variable << " for SAVE_SELECTED, exiting" << endl;
+				exit (0);
 			}
 			
-			delete hitProcessRoutine;
+			if (varval >= ssp.lowLim && varval <= ssp.hiLim)
+			{
+				ssp.decision = true;
+				break;
+			}
 		}
+		
+		delete thisDigitization->hitProcessRoutine;
+		delete thisDigitization;
 	}
 	
-	processOutputFactory->writeFADCMode1( hit_outputs_from_AllSD, evtN);
+	processOutputFactory->writeFADCMode1(outContainer, hit_outputs_from_AllSD, evtN);
 	
 	// writing out generated particle infos
 	processOutputFactory->writeGenerated(outContainer, MPrimaries, banksMap, gen_action->userInfo);
 	
 	// For hits, store all ancestors
 	
+	vector<ancestorInfo> ainfo;
 	if (SAVE_ALL_ANCESTORS)
 	{
-		vector<ancestorInfo> ainfo;
 		set<int> storedTraj;
 		for (unsigned int i = 0; i < trajectoryContainer->size(); i++)
 		{
@@ -947,9 +1019,13 @@ void MEventAction::EndOfEventAction(const G4Event* evt)
 		processOutputFactory->writeAncestors (outContainer, ainfo, getBankFromMap("ancestors", banksMap));
 	}
 	
+	if(stepOutput != nullptr)
+	stepOutput->endEvent(MPrimaries, gen_action->userInfo, SAVE_ALL_ANCESTORS ? &ainfo : nullptr);
+	
 	
 	processOutputFactory->writeEvent(outContainer);
 	delete processOutputFactory;
+	outContainer->endEvent(evtN);
 	
 	// Save RNG; can't use G4RunManager::GetRunManager()->rndmSaveThisEvent()
 	// because GEANT doesn't know about GEMC run/event numbers
@@ -1036,3 +1112,103 @@ vector<BackgroundHit*> MEventAction::getNextBackgroundEvent(string forSystem)
 
 
 
+
+
+// digitizes one detector: integrated digitized information and voltage versus time
+// this can run on a worker thread: it only touches this detector hits and outputs
+void MEventAction::digitizeDetector(detectorDigitization *thisDigitization)
+{
+	MHitCollection *MHC          = thisDigitization->MHC;
+	HitProcess *hitProcessRoutine = thisDigitization->hitProcessRoutine;
+	int nhits = MHC->GetSize();
+	
+	// the messages are collected and printed by the main thread, so the workers do not interleave
+	ostringstream log;
+	
+	if(thisDigitization->writeDgt)
+	{
+		for(int h=0; h<nhits; h++)
+		{
+			hitOutput thisHitOutput;
+			MHit* aHit = (*MHC)[h];
+			
+			// calling integrateDgt will also set writeHit
+			thisHitOutput.setDgtz(hitProcessRoutine->integrateDgt(aHit, h+1));
+			
+			// include this hit. Users can set writeHit to false to avoid writing the hit
+			// the hitProcessRoutine variable detectorThreshold could be used in integrateDgt
+			if(hitProcessRoutine->writeHit) {
+				thisDigitization->allDgtOutput.push_back(thisHitOutput);
+			}
+			
+			string vname = aHit->GetId()[aHit->GetId().size()-1].name;
+			if(VERB > 4 || vname.find(catch_v) != string::npos)
+			{
+				log << hd_msg << " Hit " << h + 1 << " --  total number of steps this hit: " << aHit->GetPos().size() << endl;
+				log << aHit->GetId();
+				double Etot = 0;
+				for(unsigned int e=0; e<aHit->GetPos().size(); e++) Etot = Etot + aHit->GetEdep()[e];
+				log << "   Total energy deposited: " << Etot/MeV << " MeV" << endl;
+			}
+		}
+	}
+	
+	if(thisDigitization->writeVT)
+	{
+		for(int h=0; h<nhits; h++)
+		{
+			hitOutput thisHitOutput;
+			MHit* aHit = (*MHC)[h];
+			
+			// process each step to produce a charge/time digitized information / step
+			thisHitOutput.setChargeTime(hitProcessRoutine->chargeTime(aHit, h));
+			
+			map<int, int> vSignal = vtSignal(hitProcessRoutine, thisHitOutput.getChargeTime(), tsampling, nsamplings);
+			thisHitOutput.createQuantumS(vSignal);
+			
+			thisDigitization->allVTOutput.push_back(thisHitOutput);
+			
+			string vname = aHit->GetId()[aHit->GetId().size()-1].name;
+			if(VERB > 4 || vname.find(catch_v) != string::npos)
+			{
+				log << hd_msg << " Hit " << h + 1 << " --  total number of steps this hit: " << aHit->GetPos().size() << endl;
+				log << aHit->GetId();
+				double Etot = 0;
+				for(unsigned int e=0; e<aHit->GetPos().size(); e++) Etot = Etot + aHit->GetEdep()[e];
+				log << "   Total energy deposited: " << Etot/MeV << " MeV" << endl;
+			}
+		}
+	}
+	
+	thisDigitization->log = log.str();
+}
+
+
+// runs digitizeDetector on DIGITIZATION_THREADS worker threads
+// each worker owns a random engine, reseeded with the detector seed before each detector
+void MEventAction::digitizeDetectors(vector<detectorDigitization*> digitizations)
+{
+#ifdef G4MULTITHREADED
+	unsigned nworkers = min((unsigned) DIGITIZATION_THREADS, (unsigned) digitizations.size());
+	atomic<unsigned> next(0);
+	
+	vector<thread> workers;
+	for(unsigned w=0; w<nworkers; w++) {
+		workers.push_back(thread([this, &digitizations, &next]() {
+			CLHEP::MTwistEngine workerEngine;
+			G4Random::setTheEngine(&workerEngine);
+			
+			for(unsigned d = next++; d < digitizations.size(); d = next++) {
+				workerEngine.setSeed(digitizations[d]->seed, 0);
+				digitizeDetector(digitizations[d]);
+			}
+		}));
+	}
+	
+	for(auto &worker: workers)
+		worker.join();
+#else
+	for(auto thisDigitization: digitizations)
+		digitizeDetector(thisDigitization);
+#endif
+}
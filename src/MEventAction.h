@@ -23,6 +23,11 @@
 #include "sensitiveDetector.h"
 #include "options.h"
 #include "MPrimaryGeneratorAction.h"
+#include "stepRecord.h"
+#include "eventMixer.h"
+#include "eventFilter.h"
+#include "lumiBunchLibrary.h"
+#include "scoring.h"
 
 
 /// \class BGParts
@@ -92,6 +97,9 @@ vector<G4ThreeVector> vector_mvert(  map<int, TInfos> tinfos, vector<int> tids);
 vector<int>           vector_zint(  int size);  ///< provides a vector of 0
 vector<G4ThreeVector> vector_zthre( int size);  ///< provides a vector of (0,0,0)
 
+/// samples the voltage of a hit from its chargeTime output: crate/slot/channel followed by nsamplings FADC counts
+map<int, int> vtSignal(HitProcess *hitProcessRoutine, map< int, vector <double> > chargeTime, double tsampling, double nsamplings);
+
 /// \class saveEventParams
 /// <b> saveEventParams </b>\n\n
 /// Holds parameters from the SAVE_SELECTED option
@@ -113,6 +121,33 @@ class saveEventParams
 };
 
 
+/// \class detectorDigitization
+/// <b> detectorDigitization </b>\n\n
+/// Digitization of one sensitive detector in one event.\n
+/// The raw information is filled serially in EndOfEventAction,
+/// the digitized and voltage outputs by digitizeDetector, possibly on a
+/// worker thread. The outputs are written in the SeDe_Map order once
+/// all detectors are done.
+class detectorDigitization
+{
+public:
+	string          hitType;
+	MHitCollection *MHC;
+	HitProcess     *hitProcessRoutine;
+	long            seed;                 ///< random seed used by the worker thread
+	bool            writeTrueIntegrated;  ///< INTEGRATEDRAW is active for this detector
+	bool            writeTrueAll;         ///< ALLRAWS is active for this detector
+	bool            writeDgt;             ///< INTEGRATEDDGT is active for this detector
+	bool            writeVT;              ///< SIGNALVT is active for this detector
+
+	vector<hitOutput> allRawOutput;
+	vector<hitOutput> allDgtOutput;
+	vector<hitOutput> allVTOutput;
+
+	string log;   ///< verbosity messages, printed by the main thread with the outputs
+};
+
+
 /// \class MEventAction
 /// <b> MEventAction </b>\n\n
 /// Derived from G4UserEventAction.\n
@@ -176,6 +211,29 @@ public:
 	// SAVE_SELECTED parameters
 	saveEventParams ssp;
 
+	// STEP_RECORD: MHit step arrays saved for DIGITIZE_ONLY
+	stepRecord *stepOutput;
+
+	// MIX_STEP_RECORD: background events overlaid to each event. Set in gemc.cc, needs the detector map
+	eventMixer *mixer;
+
+	// EVENT_FILTER: event selection evaluated before digitization
+	eventFilter *filter;
+
+	// LUMI_BUNCH_RECORD: the bunch of each event is written at the end of the event. Owned by the stepping action, set in gemc.cc
+	lumiBunchRecorder *bunchRecorder;
+
+	// PHASESPACE_RECORD: the particles of each event are written at the end of the event. Owned by the stepping action, set in gemc.cc
+	phaseSpaceRecorder *phaseSpaceOutput;
+
+	// SCORING_MESH, SCORING_VOLUME: the event contributions are added to the scorers at the end of the event. Owned by the stepping action, set in gemc.cc
+	scoringRecorder *scoring;
+
+	// number of threads digitizing the detectors at the end of the event
+	int DIGITIZATION_THREADS;
+	void digitizeDetector(detectorDigitization*);             ///< digitized and voltage outputs of one detector
+	void digitizeDetectors(vector<detectorDigitization*>);    ///< runs digitizeDetector on the worker threads
+
 private:
 	// background hits, key is event number
 	// background hits
@@ -7,9 +7,12 @@
 #include "G4UnitsTable.hh"
 #include "Randomize.hh"
 #include "G4RunManager.hh"
+#include "G4VisExtent.hh"
+#include "G4PrimaryVertex.hh"
 
 // gemc headers
 #include "MPrimaryGeneratorAction.h"
+#include "primaryCopy.h"
 #include "string_utilities.h"
 
 // mlibrary
@@ -40,6 +43,21 @@ MPrimaryGeneratorAction::MPrimaryGeneratorAction(goptions *opts)
 	particleTable = G4ParticleTable::GetParticleTable();
 
 	beamPol  = 0;
+	eventWeight = 1;
+	cosmicTargetArea = 0;
+	primary_reader = nullptr;
+	phaseSpaceResample = false;
+	phaseSpacePhiSymmetry = false;
+
+	bunchLibrary = nullptr;
+	if(gemcOpt->optMap["LUMI_BUNCH_LIBRARY"].args != "no")
+		bunchLibrary = new lumiBunchLibrary(*gemcOpt);
+
+	ngenerated = 0;
+	naccepted  = 0;
+	genFilter  = nullptr;
+	if(gemcOpt->optMap["GENERATOR_FILTER"].args != "no")
+		genFilter = new eventFilter(*gemcOpt, "GENERATOR_FILTER");
 
 	setBeam();
 
@@ -167,6 +185,41 @@ MPrimaryGeneratorAction::MPrimaryGeneratorAction(goptions *opts)
 
 
 void MPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
+{
+	// no selection. Rerun events are selected already
+	if(genFilter == nullptr || rsp.enabled) {
+		generateEvent(anEvent);
+		if(anEvent->GetNumberOfPrimaryVertex() > 0) {
+			ngenerated++;
+			naccepted++;
+		}
+		return;
+	}
+
+	// GENERATOR_FILTER: events are generated until one passes the selection
+	while(true) {
+		G4Event trial(anEvent->GetEventID());
+		generateEvent(&trial);
+
+		// end of the input file: nothing to select
+		if(trial.GetNumberOfPrimaryVertex() == 0) return;
+
+		ngenerated++;
+		if(genFilter->accept(&trial, noHits)) {
+			naccepted++;
+			copyPrimaries(&trial, anEvent);
+			return;
+		}
+
+		if(!isFileOpen()) return;
+
+		if(ngenerated % 1000000 == 0)
+			cout << hd_msg << " Warning: GENERATOR_FILTER accepted " << naccepted << " events out of " << ngenerated
+			     << " generated. Check the selection." << endl;
+	}
+}
+
+void MPrimaryGeneratorAction::generateEvent(G4Event* anEvent)
 {
 	// Check first if event should be seeded
 	if (rsp.enabled) {
@@ -346,70 +399,50 @@ void MPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 			double thisPhi;
 			double akine;
 
-			// first randomly pick a number inside the sphere
-			double cosmicVX = 100000;
-			double cosmicVY = 100000;
-			double cosmicVZ = 100000;
-
-			while( (cosmicVX - cosmicTarget.x() )*(cosmicVX - cosmicTarget.x() ) +
-					(cosmicVY - cosmicTarget.y() )*(cosmicVY - cosmicTarget.y() ) +
-					(cosmicVZ - cosmicTarget.z() )*(cosmicVZ - cosmicTarget.z() ) >= cosmicRadius*cosmicRadius ) {
-
-				// point generated inside spherical or cylindrical volume
-				if(cosmicGeo == "sph" || cosmicGeo == "sphere"){
-					// point inside spherical volume
-					cosmicVX = cosmicTarget.x() - cosmicRadius + 2*cosmicRadius*G4UniformRand();
-					cosmicVY = cosmicTarget.y() - cosmicRadius + 2*cosmicRadius*G4UniformRand();
-					cosmicVZ = cosmicTarget.z() - cosmicRadius + 2*cosmicRadius*G4UniformRand();
-				} else {
-					// point inside a cylinder, height of the cylinder = cosmicRadius/2.
-					double h = cosmicRadius/2.;
-					cosmicVX = -cosmicRadius + 2*cosmicRadius*G4UniformRand();
-					double sig=1.;
-					if((2.*G4UniformRand()-1)<0) sig =-1.;
-					cosmicVY = h*(2.*G4UniformRand()-1)*sig;
-					cosmicVZ = -cosmicRadius + 2*cosmicRadius*G4UniformRand();
-				}
-			}
-
-			if(cosmicNeutrons) {
-				if (cminp<0.1 || cmaxp>10000) cout <<"WARNING !!!! COSMIC NEUTRONS E (MeV) is OUT OF THE VALID RANGE !!!"<<endl;
-				// Model by Ashton (1973)
-				// now generating random momentum, cos(theta)
-				// the maximum of the distribution is the lowest momentum and 0 theta
-				// normalizing by that number
-				double cosmicProb = G4UniformRand()*cosmicNeutBeam(0., cminp/GeV);
-				thisMom = cminp + (cmaxp-cminp)*G4UniformRand(); // momentum in MeV/c
-				thisthe = pi*G4UniformRand()/2.0; // [0,pi/2] zenith angle
-				while(cosmicNeutBeam(thisthe, thisMom/GeV) < cosmicProb){
-					thisMom = cminp + (cmaxp-cminp)*G4UniformRand();
-					thisthe = pi*G4UniformRand()/2.0;
-				}
-			} else {
-				// muons
-				// now generating random momentum, cos(theta)
-				// the maximum of the distribution is the lowest momentum and 0 theta
-				// normalizing by that number
-				double cosmicProb = G4UniformRand()*cosmicMuBeam(0, cminp/GeV);
-				thisMom = (cminp + (cmaxp-cminp)*G4UniformRand());
-				thisthe = pi*G4UniformRand()/2.0;
-				while(cosmicMuBeam(thisthe, thisMom/GeV) < cosmicProb)
-				{
-					thisMom = (cminp + (cmaxp-cminp)*G4UniformRand());
-					thisthe = pi*G4UniformRand()/2.0;
-				}
-			}
+			// momentum and zenith angle from the model table built in setBeam
+			cosmicSampler.sample(thisMom, thisthe);
 
 			// isotropic in phi
 			thisPhi = -pi + 2*pi*G4UniformRand();
 
-			// now finding the vertex. Assuming twice the radius as starting point
+			// when assigning momentum the direction is reversed
 			// attention:
 			// axis transformation, z <> y,  x <> -x
 			// cause the cosmics come from the sky
-			double pvx = cosmicVX - 2*cosmicRadius*sin(thisthe)*cos(thisPhi);
-			double pvy = cosmicVY + 2*cosmicRadius*cos(thisthe);
-			double pvz = cosmicVZ + 2*cosmicRadius*sin(thisthe)*sin(thisPhi);
+			G4ThreeVector beam_dir(cos(thisPhi)*sin(thisthe), -cos(thisthe), -sin(thisPhi)*sin(thisthe));
+
+			double pvx, pvy, pvz;
+			if(cosmicTargetRadii.size()) {
+				// trajectory crossing the COSMIC_TARGETS volumes, weighted
+				G4ThreeVector start = cosmicTargetStart(beam_dir);
+				pvx = start.x();
+				pvy = start.y();
+				pvz = start.z();
+			} else {
+				// vertex inside the sphere or the cylinder (axis along y, height cosmicRadius)
+				double cosmicVX, cosmicVY, cosmicVZ;
+				if(cosmicGeo == "sph" || cosmicGeo == "sphere") {
+					double r    = cosmicRadius*cbrt(G4UniformRand());
+					double cost = 2*G4UniformRand() - 1;
+					double sint = sqrt(1 - cost*cost);
+					double phiv = 2*pi*G4UniformRand();
+					cosmicVX = cosmicTarget.x() + r*sint*cos(phiv);
+					cosmicVY = cosmicTarget.y() + r*sint*sin(phiv);
+					cosmicVZ = cosmicTarget.z() + r*cost;
+				} else {
+					double h    = cosmicRadius/2.;
+					double r    = cosmicRadius*sqrt(G4UniformRand());
+					double phiv = 2*pi*G4UniformRand();
+					cosmicVX = cosmicTarget.x() + r*cos(phiv);
+					cosmicVY = cosmicTarget.y() + h*(2*G4UniformRand() - 1);
+					cosmicVZ = cosmicTarget.z() + r*sin(phiv);
+				}
+
+				// now finding the vertex. Assuming twice the radius as starting point
+				pvx = cosmicVX - 2*cosmicRadius*beam_dir.x();
+				pvy = cosmicVY - 2*cosmicRadius*beam_dir.y();
+				pvz = cosmicVZ - 2*cosmicRadius*beam_dir.z();
+			}
 			particleGun->SetParticlePosition(G4ThreeVector(pvx, pvy, pvz));
 
 			if(cosmicNeutrons) {
@@ -426,9 +459,6 @@ void MPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 
 			particleGun->SetParticleDefinition(Particle);
 
-			// when assigning momentum the direction is reversed
-			G4ThreeVector beam_dir(cos(thisPhi)*sin(thisthe), -cos(thisthe), -sin(thisPhi)*sin(thisthe));
-
 			if(GEN_VERBOSITY > 3) {
 				cout << hd_msg << " Particle id=" <<  Particle->GetParticleName()
 				<< "  Vertex=" << G4ThreeVector(pvx, pvy, pvz)/cm << "cm,  momentum=" << thisMom/GeV << " GeV, theta="
@@ -644,6 +674,131 @@ void MPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 			getline(gif, theWholeLine);
 		}
 
+		else if(gformat == "gprimary" || gformat == "GPRIMARY") {
+			//
+			// gemc binary primary events, converted from LUND, BEAGLE or StdHep with primaryConverter.
+			// The particle columns are the ones of the LUND or BEAGLE files.
+			//
+
+			// rerun event: the file is positioned with the block index
+			if (rsp.enabled && eventIndex < int (rsp.events[rsp.currentevent])) {
+				primary_reader->seek(rsp.events[rsp.currentevent] - 1);
+				eventIndex = rsp.events[rsp.currentevent];
+			}
+
+			if(!primary_reader->readEvent(primary_event)) {
+				return;
+			}
+
+			bool beagle = primary_reader->sourceFormat() == PRIMARY_FORMAT_BEAGLE;
+
+			headerUserDefined = primary_event.header;
+			if(!beagle && headerUserDefined.size() > 4) {
+				beamPol = headerUserDefined[4];
+				if(beamPol>1) {
+					beamPol = 1;
+				}
+			}
+
+			userInfo.clear();
+			for(unsigned p=0; p<primary_event.particles.size(); p++) {
+
+				userInforForParticle thisParticleInfo;
+				thisParticleInfo.infos = primary_event.particles[p];
+				userInfo.push_back(thisParticleInfo);
+
+				const vector<double> &infos = thisParticleInfo.infos;
+				if(infos.size() < (beagle ? 18 : 14)) {
+					cout << hd_msg << " !!! Error: particle " << p+1 << " has " << infos.size() << " columns in " << gfilename << endl;
+					return;
+				}
+
+				if(beagle) {
+					// BEAGLE vertex is in mm
+					int pindex    = infos[0];
+					int type      = infos[1];
+					int pdef      = infos[2];
+					double Vx     = (infos[12]/cm) + svx/cm;
+					double Vy     = (infos[13]/cm) + svy/cm;
+					double Vz     = (infos[14]/cm) + svz/cm;
+
+					setParticleFromPars(p, pindex, type, pdef, infos[7], infos[8], infos[9], Vx, Vy, Vz, anEvent, infos[15], infos[16]);
+				} else {
+					// LUND vertex is in cm
+					int pindex    = infos[0];
+					int type      = infos[2];
+					int pdef      = infos[3];
+					double Vx     = infos[11] + svx/cm;
+					double Vy     = infos[12] + svy/cm;
+					double Vz     = infos[13] + svz/cm;
+
+					if(PROPAGATE_DVERTEXTIME==0) {
+						setParticleFromPars(p, pindex, type, pdef, infos[6], infos[7], infos[8], Vx, Vy, Vz, anEvent);
+					} else {
+						setParticleFromParsPropagateTime(p, userInfo, anEvent);
+					}
+				}
+			}
+
+			if(eventIndex <= ntoskip) {
+				if(GEN_VERBOSITY > 3) {
+					cout << " This event will be skipped." << endl;
+				}
+			}
+			eventIndex++;
+		}
+
+		else if(gformat == "phasespace" || gformat == "PHASESPACE") {
+
+			if(phaseSpaceResample)
+				primary_reader->seek((uint64_t) (G4UniformRand()*primary_reader->numberOfEvents()) % primary_reader->numberOfEvents());
+
+			if(!primary_reader->readEvent(primary_event)) {
+				return;
+			}
+
+			// recorded event weight
+			if(primary_event.header.size() > 1) eventWeight = primary_event.header[1];
+
+			// symmetry of the upstream part: random rotation around z
+			double rotation = phaseSpacePhiSymmetry ? 2*pi*G4UniformRand() : 0;
+
+			for(auto &infos: primary_event.particles) {
+				if(infos.size() < PHASESPACE_COLUMNS) continue;
+
+				int pdef = infos[0];
+				G4ParticleDefinition *psParticle = particleTable->FindParticle(pdef);
+				if(psParticle == nullptr) psParticle = G4IonTable::GetIonTable()->GetIon(pdef);
+				if(psParticle == nullptr) {
+					if(GEN_VERBOSITY > 3) cout << hd_msg << " Particle id " << pdef << " not found in G4 table." << endl;
+					continue;
+				}
+
+				G4ThreeVector pmom(infos[1]*MeV, infos[2]*MeV, infos[3]*MeV);
+				G4ThreeVector pvtx(infos[4]*mm,  infos[5]*mm,  infos[6]*mm);
+				if(rotation != 0) {
+					pmom.rotateZ(rotation);
+					pvtx.rotateZ(rotation);
+				}
+
+				double mass = psParticle->GetPDGMass();
+				particleGun->SetParticleDefinition(psParticle);
+				particleGun->SetParticleEnergy(sqrt(pmom.mag2() + mass*mass) - mass);
+				particleGun->SetParticleMomentumDirection(pmom.unit());
+				particleGun->SetParticlePosition(pvtx);
+				particleGun->SetParticleTime(infos[7]*ns);
+				particleGun->SetNumberOfParticles(1);
+				particleGun->GeneratePrimaryVertex(anEvent);
+
+				// track weight of the recorded particle
+				anEvent->GetPrimaryVertex(anEvent->GetNumberOfPrimaryVertex() - 1)->SetWeight(infos[8]);
+
+				if(GEN_VERBOSITY > 3)
+					cout << hd_msg << " Phase space particle id=" << pdef << " (" << psParticle->GetParticleName() << ")"
+					<< "  Vertex=" << pvtx/cm << "cm,  momentum=" << pmom/GeV << " GeV, weight=" << infos[8] << endl;
+			}
+		}
+
 		else if(gformat == "stdhep" || gformat == "STDHEP" || gformat == "StdHep" || gformat == "StdHEP") {
 			//
 			// StdHep is an (old like LUND) MC generator format in binary form.
@@ -665,7 +820,10 @@ void MPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 
 			for(int p=0;p<NPART;p++)
 			{
-				if( stdhep_reader->daughter1(p)>0)
+				// view of the particle in the reader event arrays
+				lStdParticle sp = stdhep_reader->particle(p);
+
+				if( sp.daughter1>0)
 				{
 					// The particle has daughters, so we do not want to generate this one.
 					continue;
@@ -673,10 +831,10 @@ void MPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 				else
 				{
 
-					Particle = particleTable->FindParticle(stdhep_reader->pid(p));
+					Particle = particleTable->FindParticle(sp.pid);
 					if(!Particle)
 					{
-						cout << hd_msg << " Particle id " << stdhep_reader->pid(p) << " not found in G4 table." << endl << endl;
+						cout << hd_msg << " Particle id " << sp.pid << " not found in G4 table." << endl << endl;
 
 						return;
 					}
@@ -684,7 +842,7 @@ void MPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 					particleGun->SetParticleDefinition(Particle);
 
 					// 4-momenta
-					G4ThreeVector pmom(stdhep_reader->Px(p)*GeV,stdhep_reader->Py(p)*GeV, stdhep_reader->Pz(p)*GeV);
+					G4ThreeVector pmom(sp.p[0]*GeV, sp.p[1]*GeV, sp.p[2]*GeV);
 					double Mom = pmom.mag();
 					double Phi   = pmom.getPhi();
 					double Theta = pmom.getTheta();
@@ -707,9 +865,9 @@ void MPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 					// vertex
 					if(gemcOpt->optMap["STEER_BEAM"].arg == 0)
 					{
-						beam_vrt = G4ThreeVector(stdhep_reader->X(p)*cm,
-														 stdhep_reader->Y(p)*cm,
-														 stdhep_reader->Z(p)*cm);
+						beam_vrt = G4ThreeVector(sp.v[0]*cm,
+														 sp.v[1]*cm,
+														 sp.v[2]*cm);
 					}
 					else
 					{
@@ -717,9 +875,9 @@ void MPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 						double VR  = sqrt(G4UniformRand())*dvr/mm;
 						double PHI = 2.0*pi*G4UniformRand();
 
-						beam_vrt = G4ThreeVector(stdhep_reader->X(p)*cm + vx/mm + VR*cos(PHI),
-														 stdhep_reader->Y(p)*cm + vy/mm + VR*sin(PHI),
-														 stdhep_reader->Z(p)*cm + vz/mm +  (2.0*G4UniformRand()-1.0)*dvz/mm);
+						beam_vrt = G4ThreeVector(sp.v[0]*cm + vx/mm + VR*cos(PHI),
+														 sp.v[1]*cm + vy/mm + VR*sin(PHI),
+														 sp.v[2]*cm + vz/mm +  (2.0*G4UniformRand()-1.0)*dvz/mm);
 
 					}
 					particleGun->SetParticlePosition(beam_vrt);
@@ -736,7 +894,7 @@ void MPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 					particleGun->SetParticleTime(TWINDOW/2);
 					particleGun->GeneratePrimaryVertex(anEvent);
 					if(GEN_VERBOSITY > 3)
-						cout << hd_msg << " Particle Number:  " << p << ", id=" << stdhep_reader->pid(p) << "(" << Particle->GetParticleName() << ")"
+						cout << hd_msg << " Particle Number:  " << p << ", id=" << sp.pid << "(" << Particle->GetParticleName() << ")"
 						<< "  Vertex=" << beam_vrt/cm << "cm,  momentum=" << pmom/GeV << " GeV" << endl;
 				}
 			}
@@ -810,7 +968,29 @@ void MPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 
 	// cout << PBUNCH << " " << NBUNCHES <<  " " << NBUNCHES*PBUNCH << " " << NREMAINING << endl;
 
-	if(PBUNCH > 0)
+	if(bunchLibrary != nullptr)
+	{
+		// each bunch is drawn from the library: the particles start at the boundary
+		for(int b=0; b<NBUNCHES; b++)
+		{
+			for(auto &lp: bunchLibrary->randomBunch())
+			{
+				G4ParticleDefinition *bunchParticle = particleTable->FindParticle(lp.pid);
+				if(bunchParticle == nullptr) bunchParticle = G4IonTable::GetIonTable()->GetIon(lp.pid);
+				if(bunchParticle == nullptr) continue;
+
+				double bmass = bunchParticle->GetPDGMass();
+				particleGun->SetParticleDefinition(bunchParticle);
+				particleGun->SetParticleEnergy(sqrt(lp.p.mag2() + bmass*bmass) - bmass);
+				particleGun->SetParticleMomentumDirection(lp.p.unit());
+				particleGun->SetParticlePosition(lp.v);
+				particleGun->SetParticleTime(TBUNCH*b + lp.time);
+				particleGun->SetNumberOfParticles(1);
+				particleGun->GeneratePrimaryVertex(anEvent);
+			}
+		}
+	}
+	else if(PBUNCH > 0)
 	{
 		particleGun->SetParticleDefinition(L_Particle);
 
@@ -1107,6 +1287,16 @@ void MPrimaryGeneratorAction::setBeam()
 					cosmicParticle = "muon";
 				}
 			}
+
+			// sampling table of the model in the momentum range
+			// paper: A. Dar, Phys.Rev.Lett, 51,3,p.227 (1983)
+			// neutrons: model by Ashton (1973)
+			if(cosmicParticle != "muon") {
+				if (cminp<0.1 || cmaxp>10000) cout <<"WARNING !!!! COSMIC NEUTRONS E (MeV) is OUT OF THE VALID RANGE !!!"<<endl;
+				cosmicSampler.build([this](double t, double p) {return cosmicNeutBeam(t, p/GeV);}, cminp, cmaxp);
+			} else {
+				cosmicSampler.build([this](double t, double p) {return cosmicMuBeam(t, p/GeV);}, cminp, cmaxp);
+			}
 		}
 	} else if( input_gen.compare(0,4,"LUND")==0 || input_gen.compare(0,4,"lund")==0 ) {
 		gformat.assign(  input_gen, 0, input_gen.find(",")) ;
@@ -1130,6 +1320,55 @@ void MPrimaryGeneratorAction::setBeam()
 		beagleHeader = 0;
 	}
 
+	else if( input_gen.compare(0,8,"gprimary")==0 || input_gen.compare(0,8,"GPRIMARY")==0 ) {
+		gformat.assign(  input_gen, 0, input_gen.find(",")) ;
+		gfilename.assign(input_gen,    input_gen.find(",") + 1, input_gen.size()) ;
+		gfilename = trimSpacesFromString(gfilename);
+
+		// file may be already opened cause setBeam is called again in graphic mode
+		if(primary_reader == nullptr) {
+			cout << hd_msg << "gprimary: Opening  " << gformat << " file: " << gfilename << endl;
+			primary_reader = new primaryEventFile(gfilename, "r");
+			if(!primary_reader->isGood()) {
+				cerr << hd_msg << " Can't open gprimary input file " << gfilename << ". Exiting. " << endl;
+				exit(1);
+			}
+			if(primary_reader->sourceFormat() == PRIMARY_FORMAT_BUNCH) {
+				cerr << hd_msg << " " << gfilename << " is a luminosity bunch library: use it with LUMI_BUNCH_LIBRARY. Exiting. " << endl;
+				exit(1);
+			}
+			if(primary_reader->sourceFormat() == PRIMARY_FORMAT_PHASESPACE) {
+				cerr << hd_msg << " " << gfilename << " is a phase space file: use -INPUT_GEN_FILE=\"phasespace, " << gfilename << "\". Exiting. " << endl;
+				exit(1);
+			}
+		}
+	}
+
+	else if( input_gen.compare(0,10,"phasespace")==0 || input_gen.compare(0,10,"PHASESPACE")==0 ) {
+		gformat.assign(  input_gen, 0, input_gen.find(",")) ;
+		gfilename.assign(input_gen,    input_gen.find(",") + 1, input_gen.size()) ;
+		gfilename = trimSpacesFromString(gfilename);
+
+		vector<string> replay = get_info(gemcOpt->optMap["PHASESPACE_REPLAY"].args, string(",\""));
+		phaseSpaceResample = replay.size() > 0 && trimSpacesFromString(replay[0]) == "resample";
+		phaseSpacePhiSymmetry = replay.size() > 1 && trimSpacesFromString(replay[1]) == "phi";
+
+		// file may be already opened cause setBeam is called again in graphic mode
+		if(primary_reader == nullptr) {
+			cout << hd_msg << "phasespace: Opening " << gfilename << (phaseSpaceResample ? ", resampling the events" : ", each event once")
+			     << (phaseSpacePhiSymmetry ? " with random rotations around z" : "") << endl;
+			primary_reader = new primaryEventFile(gfilename, "r");
+			if(!primary_reader->isGood() || primary_reader->sourceFormat() != PRIMARY_FORMAT_PHASESPACE) {
+				cerr << hd_msg << " " << gfilename << " is not a phase space file. Exiting. " << endl;
+				exit(1);
+			}
+			if(phaseSpaceResample && (primary_reader->numberOfEvents() == 0 || primary_reader->numberOfEvents() == UINT64_MAX)) {
+				cerr << hd_msg << " " << gfilename << " has no event index and can't be resampled. Exiting. " << endl;
+				exit(1);
+			}
+		}
+	}
+
 	else if( input_gen.compare(0,6,"stdhep")==0 || input_gen.compare(0,6,"STDHEP")==0 ||
 			  input_gen.compare(0,6,"StdHep")==0 || input_gen.compare(0,6,"StdHEP")==0 )
 	{
@@ -1145,6 +1384,13 @@ void MPrimaryGeneratorAction::setBeam()
 			exit(1);
 		}
 
+		// skipping events using the index of the file event records
+		if(ntoskip > 0) {
+			long nindexed = stdhep_reader->buildEventIndex();
+			cout << hd_msg << "StdHEP: " << nindexed << " events indexed, skipping the first " << ntoskip << endl;
+			stdhep_reader->seekEvent(ntoskip);
+		}
+
 		// For the STEER_BEAM option, we need to have the angles and vertex of the GCARD in BEAM_P and BEAM_V, SPREAD_V
 		// Getting particle name,  momentum from option value
 		values       = get_info(gemcOpt->optMap["BEAM_P"].args);
@@ -1310,6 +1556,12 @@ void MPrimaryGeneratorAction::setBeam()
 MPrimaryGeneratorAction::~MPrimaryGeneratorAction()
 {
 	delete particleGun;
+	delete primary_reader;
+	delete bunchLibrary;
+	if(genFilter != nullptr) {
+		genFilter->printSummary();
+		delete genFilter;
+	}
 	gif.close();
 	bgif.close();
 }
@@ -1331,6 +1583,78 @@ double MPrimaryGeneratorAction::cosmicNeutBeam(double t, double p)
 }
 
 
+// the bounding sphere of each volume is computed from the solid extent,
+// placed in the world with the physical volumes of the mother chain
+void MPrimaryGeneratorAction::setCosmicTargets(map<string, detector> *hallMap)
+{
+	vector<string> targets = get_info(gemcOpt->optMap["COSMIC_TARGETS"].args, string(",\""));
+
+	for(auto &t: targets) {
+		string name = trimSpacesFromString(t);
+		if(hallMap->find(name) == hallMap->end() || (*hallMap)[name].GetSolid() == nullptr) {
+			cout << hd_msg << " !!! Error: COSMIC_TARGETS volume " << name << " not found. Exiting." << endl;
+			exit(1);
+		}
+
+		G4VisExtent extent = (*hallMap)[name].GetSolid()->GetExtent();
+		G4ThreeVector center = extent.GetExtentCentre();
+
+		string dname = name;
+		while(hallMap->find(dname) != hallMap->end() && (*hallMap)[dname].GetPhysical() != nullptr) {
+			G4VPhysicalVolume *pv = (*hallMap)[dname].GetPhysical();
+			center = pv->GetObjectRotationValue()*center + pv->GetObjectTranslation();
+			dname = (*hallMap)[dname].mother;
+		}
+
+		cosmicTargetCenters.push_back(center);
+		cosmicTargetRadii.push_back(extent.GetExtentRadius());
+		cosmicTargetArea += pi*extent.GetExtentRadius()*extent.GetExtentRadius();
+
+		cout << hd_msg << " Cosmic target " << name << ": bounding sphere center " << center/cm
+		     << " cm, radius " << extent.GetExtentRadius()/cm << " cm" << endl;
+	}
+
+	cout << hd_msg << " Cosmic targets projected area: " << cosmicTargetArea/cm2 << " cm2" << endl;
+}
+
+// the trajectory crosses a point uniformly distributed on the projected disk of one of the
+// bounding spheres, chosen with probability proportional to its area. The weight is the
+// total area in cm2 divided by the number of spheres the line crosses, so that overlapping
+// spheres are not counted twice. The cosmic models are shapes, not normalized intensities:
+// the weight is relative, the rates it gives are in arbitrary units
+G4ThreeVector MPrimaryGeneratorAction::cosmicTargetStart(G4ThreeVector dir)
+{
+	double pick = G4UniformRand()*cosmicTargetArea;
+	unsigned k = 0;
+	for(; k<cosmicTargetRadii.size() - 1; k++) {
+		pick -= pi*cosmicTargetRadii[k]*cosmicTargetRadii[k];
+		if(pick < 0) break;
+	}
+
+	G4ThreeVector u = dir.orthogonal().unit();
+	G4ThreeVector v = dir.cross(u);
+
+	double rho   = cosmicTargetRadii[k]*sqrt(G4UniformRand());
+	double alpha = 2*pi*G4UniformRand();
+	G4ThreeVector cross = cosmicTargetCenters[k] + rho*(cos(alpha)*u + sin(alpha)*v);
+
+	// spheres crossed by the line, and distance back to start before all of them
+	int ncrossed = 0;
+	double back = 2*cosmicRadius;
+	for(unsigned j=0; j<cosmicTargetRadii.size(); j++) {
+		G4ThreeVector d = cosmicTargetCenters[j] - cross;
+		double along = d.dot(dir);
+		if((d - along*dir).mag2() <= cosmicTargetRadii[j]*cosmicTargetRadii[j]) ncrossed++;
+		if(cosmicTargetRadii[j] - along + 2*cosmicRadius > back) back = cosmicTargetRadii[j] - along + 2*cosmicRadius;
+	}
+	if(ncrossed == 0) ncrossed = 1;
+
+	eventWeight = (cosmicTargetArea/cm2)/ncrossed;
+
+	return cross - back*dir;
+}
+
+
 void MPrimaryGeneratorAction::setParticleFromPars(int p, int pindex, int type, int pdef, double px, double py, double pz,  double Vx, double Vy, double Vz, G4Event* anEvent, int A, int Z) {
 
 	if(type == 1 && pindex == p+1) {
@@ -13,6 +13,12 @@ using namespace UTIL;
 
 // gemc
 #include "options.h"
+#include "primaryEventFile.h"
+#include "cosmicTable.h"
+#include "detector.h"
+#include "lumiBunchLibrary.h"
+#include "phaseSpace.h"
+#include "eventFilter.h"
 
 // C++
 #include <fstream>
@@ -57,6 +63,28 @@ public:
 		return beamPol;
 	}
 
+	// event weight, written in the header bank. 1 unless the cosmic rays are biased to COSMIC_TARGETS
+	double getEventWeight()
+	{
+		return eventWeight;
+	}
+
+	// events simulated to record the phasespace INPUT_GEN_FILE, written in the header bank. 0 if unknown or for other generators
+	long getSourceEvents()
+	{
+		if(primary_reader != nullptr && primary_reader->sourceFormat() == PRIMARY_FORMAT_PHASESPACE)
+			return (long) primary_reader->sourceEvents();
+		return 0;
+	}
+
+	// events generated and accepted by GENERATOR_FILTER since the start of the run, written in the header bank.
+	// Without filter both are the number of generated events
+	long getGeneratedEvents() {return ngenerated;}
+	long getAcceptedEvents()  {return naccepted;}
+
+	// bounding spheres of the COSMIC_TARGETS volumes. Called once the geometry is built
+	void setCosmicTargets(map<string, detector> *hallMap);
+
 	// user defined info for header
 	vector<double> headerUserDefined;   ///< user defined infos in the  header
 
@@ -71,7 +99,11 @@ public:
 	double getStartTime(){return TWINDOW/2;}
 
 
-	bool isFileOpen() {return !gif.eof();}
+	bool isFileOpen()
+	{
+		if(primary_reader != nullptr) return !primary_reader->eof();
+		return !gif.eof();
+	}
 
 	bool isRerun() { return rsp.enabled; }
 	int rerunEvent() { return rsp.currentevent >=0 ? rsp.events[rsp.currentevent] : 0; }
@@ -111,6 +143,17 @@ private:
 	double cosmicRadius;              ///< radius of area of interest for cosmic rays
 	string cosmicGeo;                 ///< type of surface for cosmic ray generation (sphere || cylinder)
 	string cosmicParticle;            ///< type of cosmic ray particle (muon || neutron)
+	cosmicTable cosmicSampler;        ///< (momentum, zenith angle) sampling table of the cosmic ray model
+	vector<G4ThreeVector> cosmicTargetCenters; ///< COSMIC_TARGETS bounding spheres centers
+	vector<double> cosmicTargetRadii;          ///< COSMIC_TARGETS bounding spheres radii
+	double cosmicTargetArea;                   ///< sum of the bounding spheres projected areas
+	double eventWeight;                        ///< event weight (relative weight for the COSMIC_TARGETS cosmic rays)
+
+	// Generator level selection
+	eventFilter *genFilter;           ///< GENERATOR_FILTER: events failing the selection are generated again
+	long ngenerated;                  ///< events generated since the start of the run
+	long naccepted;                   ///< events accepted since the start of the run
+	map<string, sensitiveDetector*> noHits;  ///< no sensitive detector is needed before tracking
 
 	// Generators Input Files
 	ifstream  gif;                    ///< Generator Input File
@@ -122,6 +165,11 @@ private:
 
 	lStdHep   *stdhep_reader;         /// Handle to the object for reading StdHep files.
 
+	primaryEventFile *primary_reader; ///< gprimary binary events file
+	bool phaseSpaceResample;          ///< PHASESPACE_REPLAY: events drawn at random instead of once each
+	bool phaseSpacePhiSymmetry;       ///< PHASESPACE_REPLAY: random rotation around z of each replayed event
+	primaryEvent      primary_event;  ///< reused for every event
+
 	// Luminosity Beam
 	G4ParticleDefinition *L_Particle;  ///< Luminosity Particle type
 	double L_mom,  L_dmom;             ///< Luminosity beam momentum, delta momentum
@@ -133,6 +181,7 @@ private:
 	double TWINDOW;                    ///< Time Window
 	double TBUNCH;                     ///< Time Between Bunches
 	double lumiFlat;                   ///< if this is set to 1, spread flat in theta, not cos(theta)
+	lumiBunchLibrary *bunchLibrary;    ///< LUMI_BUNCH_LIBRARY: pre-tracked bunches replace the luminosity particles
 
 	// Luminosity Beam2
 	G4ParticleDefinition *L2_Particle;    ///< Luminosity Particle type
@@ -147,9 +196,11 @@ private:
 
 	G4ParticleGun* particleGun;
 	void setBeam();
+	void generateEvent(G4Event* anEvent);
 
 	double cosmicMuBeam(double, double);
 	double cosmicNeutBeam(double, double);
+	G4ThreeVector cosmicTargetStart(G4ThreeVector dir);   ///< starting point of a trajectory crossing the COSMIC_TARGETS
 
 
 	void setParticleFromPars(int, int, int, int, double, double, double,  double, double, double, G4Event* anEvent, int A=0, int Z=0);
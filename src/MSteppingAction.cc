@@ -11,18 +11,52 @@ MSteppingAction::MSteppingAction(goptions Opt)
 	max_x_pos = gemcOpt.optMap["MAX_X_POS"].arg;
 	max_y_pos = gemcOpt.optMap["MAX_Y_POS"].arg;
 	max_z_pos = gemcOpt.optMap["MAX_Z_POS"].arg;
+
+	bunchRecorder = nullptr;
+	if(gemcOpt.optMap["LUMI_BUNCH_RECORD"].args != "no")
+		bunchRecorder = new lumiBunchRecorder(gemcOpt);
+
+	phaseSpaceOutput = nullptr;
+	if(gemcOpt.optMap["PHASESPACE_RECORD"].args != "no")
+		phaseSpaceOutput = new phaseSpaceRecorder(gemcOpt);
+
+	scoring = nullptr;
+	if(gemcOpt.optMap["SCORING_MESH"].args != "no" || gemcOpt.optMap["SCORING_VOLUME"].args != "no")
+		scoring = new scoringRecorder(gemcOpt);
 	
 //	oldpos = G4ThreeVector(0,0,0);
 //	nsame  = 0;
 }
 
-MSteppingAction::~MSteppingAction(){ cout << " > Closing Stepping Action." << endl;}
+MSteppingAction::~MSteppingAction()
+{
+	delete bunchRecorder;
+	delete phaseSpaceOutput;
+	delete scoring;
+	cout << " > Closing Stepping Action." << endl;
+}
 
 
 void MSteppingAction::UserSteppingAction(const G4Step* aStep)
 {
 	G4ThreeVector   pos   = aStep->GetPostStepPoint()->GetPosition();      ///< Global Coordinates of interaction
 	G4Track*        track = aStep->GetTrack();
+
+	// scorers: every step is scored, also if the particle is killed below
+	if(scoring != nullptr)
+		scoring->record(aStep);
+
+	// luminosity bunch library: nothing is tracked beyond the boundary
+	if(bunchRecorder != nullptr && bunchRecorder->record(aStep)) {
+		track->SetTrackStatus(fStopAndKill);
+		return;
+	}
+
+	// phase space record: the simulation is cut at the surface unless the particles are kept
+	if(phaseSpaceOutput != nullptr && phaseSpaceOutput->record(aStep)) {
+		track->SetTrackStatus(fStopAndKill);
+		return;
+	}
 	
 	if(fabs(pos.x()) > max_x_pos ||
 	   fabs(pos.y()) > max_y_pos ||
@@ -12,6 +12,8 @@
 
 // gemc headers
 #include "options.h"
+#include "lumiBunchLibrary.h"
+#include "scoring.h"
 
 class MSteppingAction : public G4UserSteppingAction
 {
@@ -24,6 +26,9 @@ class MSteppingAction : public G4UserSteppingAction
 		double max_x_pos;            ///< Max X Position in millimeters.
 		double max_y_pos;            ///< Max Y Position in millimeters.
 		double max_z_pos;            ///< Max Z Position in millimeters.
+		lumiBunchRecorder *bunchRecorder;  ///< LUMI_BUNCH_RECORD: records and kills the particles entering the boundary volume
+		phaseSpaceRecorder *phaseSpaceOutput; ///< PHASESPACE_RECORD: records the particles entering a volume
+		scoringRecorder *scoring;          ///< SCORING_MESH, SCORING_VOLUME: flux and dose scorers, no hit output
 				
 		// checking if track get stuck.
 		// if after 10 times the oldpos is the same as new pos,
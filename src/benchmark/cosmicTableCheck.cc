@@ -0,0 +1,148 @@
+// Compares the momentum and zenith angle distributions of cosmicTable::sample
+// with a rejection sampler of the same density, p and theta uniform weighted by I(theta, p),
+// for the Dar (muons) and Ashton (neutrons) models used by the internal cosmic ray generator.
+// The chi2/ndf of the two histograms is reported. Exits with 1 if the distributions disagree.
+//
+// Usage: cosmicTableCheck (events per sampler, default 400000)
+
+// gemc headers
+#include "cosmicTable.h"
+
+// G4 headers
+#include "Randomize.hh"
+
+// C++ headers
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+using namespace std;
+
+
+// same models as MPrimaryGeneratorAction, momentum in GeV
+double darMuon(double t, double p)
+{
+	double cosmicA = 55.6;
+	double cosmicB = 1.04;
+	double cosmicC = 64;
+	return pow(cosmicA, cosmicB*cos(t))/(cosmicC*p*p);
+}
+
+double ashtonNeutron(double t, double p)
+{
+	double massNeut = 0.93956542;
+	double En = sqrt(p*p+massNeut*massNeut)-massNeut;
+	double I0 = pow(En, -2.95);
+	return I0*pow(cos(t), 3.5);
+}
+
+
+class histogram
+{
+public:
+	histogram(double min, double max, int n, bool logBins) : lo(min), hi(max), nbins(n), isLog(logBins), counts(n, 0) {;}
+
+	void fill(double x)
+	{
+		double f = isLog ? log(x/lo)/log(hi/lo) : (x - lo)/(hi - lo);
+		int bin = (int) (f*nbins);
+		if(bin >= 0 && bin < nbins) counts[bin]++;
+	}
+
+	double lo, hi;
+	int    nbins;
+	bool   isLog;
+	vector<double> counts;
+};
+
+// two samples with the same number of entries: chi2 = sum (a - b)^2 / (a + b)
+double chi2ndf(const histogram &a, const histogram &b, int &ndf)
+{
+	double chi2 = 0;
+	ndf = -1;
+	for(int i=0; i<a.nbins; i++) {
+		double n = a.counts[i] + b.counts[i];
+		if(n <= 0) continue;
+		chi2 += pow(a.counts[i] - b.counts[i], 2)/n;
+		ndf++;
+	}
+	return ndf > 0 ? chi2/ndf : 0;
+}
+
+
+// textbook rejection sampler: log(p) and theta uniform, accepted with probability
+// proportional to I(theta, p)*p (the jacobian of log p), so that p and theta are uniform weighted by I
+void rejectionSample(function<double(double, double)> intensity, double pmin, double pmax, double wmax, double &p, double &theta)
+{
+	while(true) {
+		p     = pmin*pow(pmax/pmin, G4UniformRand());
+		theta = M_PI/2*G4UniformRand();
+		if(G4UniformRand()*wmax <= intensity(theta, p)*p) return;
+	}
+}
+
+
+// returns true if the table agrees with the rejection sampler
+bool checkModel(string name, function<double(double, double)> intensity, double pmin, double pmax, long nevents)
+{
+	cosmicTable table;
+	table.build(intensity, pmin, pmax);
+
+	// maximum of I*p for the rejection, on a fine grid with a margin
+	double wmax = 0;
+	for(int i=0; i<=2000; i++)
+		for(int j=0; j<=200; j++) {
+			double p = pmin*pow(pmax/pmin, i/2000.0);
+			double w = intensity(M_PI/2*j/200, p)*p;
+			if(w > wmax) wmax = w;
+		}
+	wmax *= 1.05;
+
+	histogram tableP(pmin, pmax, 50, true), tableT(0, M_PI/2, 45, false);
+	histogram rejectP(pmin, pmax, 50, true), rejectT(0, M_PI/2, 45, false);
+
+	for(long e=0; e<nevents; e++) {
+		double p, theta;
+		table.sample(p, theta);
+		tableP.fill(p);
+		tableT.fill(theta);
+
+		rejectionSample(intensity, pmin, pmax, wmax, p, theta);
+		rejectP.fill(p);
+		rejectT.fill(theta);
+	}
+
+	int ndfP, ndfT;
+	double chiP = chi2ndf(tableP, rejectP, ndfP);
+	double chiT = chi2ndf(tableT, rejectT, ndfT);
+
+	// 5 standard deviations of the chi2/ndf distribution
+	bool goodP = chiP < 1 + 5*sqrt(2.0/ndfP);
+	bool goodT = chiT < 1 + 5*sqrt(2.0/ndfT);
+
+	cout << " " << name << ", p in [" << pmin << ", " << pmax << "] GeV: " << endl;
+	cout << "   momentum:     chi2/ndf = " << chiP << " (ndf " << ndfP << ")" << (goodP ? "" : "  FAILED") << endl;
+	cout << "   zenith angle: chi2/ndf = " << chiT << " (ndf " << ndfT << ")" << (goodT ? "" : "  FAILED") << endl;
+
+	return goodP && goodT;
+}
+
+
+int main(int argc, char **argv)
+{
+	long nevents = argc > 1 ? atol(argv[1]) : 400000;
+
+	bool good = true;
+
+	good = checkModel("Dar muons",        darMuon,       1,   1000, nevents) && good;
+	good = checkModel("Dar muons",        darMuon,       2,      5, nevents) && good;
+	good = checkModel("Ashton neutrons",  ashtonNeutron, 0.1,   10, nevents) && good;
+
+	if(!good) {
+		cout << " !!! The cosmic table does not sample the model density." << endl;
+		return 1;
+	}
+
+	cout << " The cosmic table agrees with the rejection sampler." << endl;
+	return 0;
+}
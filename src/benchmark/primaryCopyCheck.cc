@@ -0,0 +1,91 @@
+// Checks that copyPrimaries, used to keep the events accepted by GENERATOR_FILTER,
+// gives the target event exactly the vertices and particles of the trial event:
+// a LUND-like event with one vertex per particle, and a vertex with several particles and daughters.
+// The vertices and particles are counted following their chains, as the G4PrimaryTransformer does.
+// Exits with 1 if the number of vertices, particles or daughters, or the particle momenta, differ.
+//
+// Usage: primaryCopyCheck (number of particles, default 10)
+
+// gemc headers
+#include "primaryCopy.h"
+
+// C++ headers
+#include <iostream>
+#include <cstdlib>
+using namespace std;
+
+
+int countDaughters(const G4Event *anEvent)
+{
+	int n = 0;
+	for(G4PrimaryVertex *pv = anEvent->GetPrimaryVertex(); pv != nullptr; pv = pv->GetNext())
+		for(G4PrimaryParticle *pp = pv->GetPrimary(); pp != nullptr; pp = pp->GetNext())
+			for(G4PrimaryParticle *d = pp->GetDaughter(); d != nullptr; d = d->GetNext())
+				n++;
+	return n;
+}
+
+bool compare(const G4Event *trial, const G4Event *copy, string name)
+{
+	int nv = countPrimaryVertices(trial);
+	int np = countPrimaries(trial);
+	int nd = countDaughters(trial);
+
+	bool good = countPrimaryVertices(copy) == nv && countPrimaries(copy) == np && countDaughters(copy) == nd;
+
+	G4PrimaryVertex *a = trial->GetPrimaryVertex();
+	G4PrimaryVertex *b = copy->GetPrimaryVertex();
+	for(; good && a != nullptr; a = a->GetNext(), b = b->GetNext()) {
+		good = a->GetNumberOfParticle() == b->GetNumberOfParticle() && a->GetPosition() == b->GetPosition() && a->GetT0() == b->GetT0();
+		for(int p=0; good && p<a->GetNumberOfParticle(); p++)
+			good = a->GetPrimary(p)->GetPDGcode() == b->GetPrimary(p)->GetPDGcode() && a->GetPrimary(p)->GetMomentum() == b->GetPrimary(p)->GetMomentum();
+	}
+
+	cout << " " << name << ": trial " << nv << " vertices, " << np << " particles, " << nd << " daughters. Copy "
+	     << countPrimaryVertices(copy) << " vertices, " << countPrimaries(copy) << " particles, "
+	     << countDaughters(copy) << " daughters: " << (good ? "ok" : "FAILED") << endl;
+
+	return good;
+}
+
+int main(int argc, char **argv)
+{
+	int n = 10;
+	if(argc > 1) n = atoi(argv[1]);
+
+	int pids[4] = {11, 2212, 211, 22};
+
+	// LUND: one vertex per particle
+	G4Event lund(1);
+	for(int i=0; i<n; i++) {
+		G4PrimaryVertex *pv = new G4PrimaryVertex(G4ThreeVector(0, 0, i), i);
+		pv->SetPrimary(new G4PrimaryParticle(pids[i%4], i, 2*i, 3*i));
+		lund.AddPrimaryVertex(pv);
+	}
+
+	// one vertex with several particles, each with two daughters
+	G4Event multi(2);
+	G4PrimaryVertex *pv = new G4PrimaryVertex(G4ThreeVector(1, 2, 3), 4);
+	for(int i=0; i<n; i++) {
+		G4PrimaryParticle *pp = new G4PrimaryParticle(pids[i%4], i, -i, 2*i);
+		pp->SetDaughter(new G4PrimaryParticle(22, i, 0, 0));
+		pp->SetDaughter(new G4PrimaryParticle(22, 0, i, 0));
+		pv->SetPrimary(pp);
+	}
+	multi.AddPrimaryVertex(pv);
+
+	G4Event lundCopy(1);
+	copyPrimaries(&lund, &lundCopy);
+
+	G4Event multiCopy(2);
+	copyPrimaries(&multi, &multiCopy);
+
+	bool lundGood  = compare(&lund, &lundCopy, "LUND event");
+	bool multiGood = compare(&multi, &multiCopy, "multi-particle vertex");
+
+	if(!lundGood || !multiGood) {
+		cout << " The copied event does not match the trial event." << endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,120 @@
+// G4 headers
+#include "Randomize.hh"
+
+// gemc headers
+#include "cosmicTable.h"
+
+// C++ headers
+#include <cmath>
+
+
+// samples x in [0, 1] with density linear from a (x=0) to b (x=1)
+static double sampleLinear(double a, double b, double u)
+{
+	if(a + b <= 0) return u;
+
+	double den = a + sqrt(a*a*(1 - u) + b*b*u);
+	if(den <= 0) return 0;
+
+	return u*(a + b)/den;
+}
+
+void cosmicTable::build(function<double(double, double)> intensity, double minp, double maxp, int npbins, int ntbins)
+{
+	pmin = minp;
+	pmax = maxp;
+	np   = npbins;
+	nt   = ntbins;
+
+	// logarithmic momentum spacing for ranges larger than a decade
+	logSpacing = pmin > 0 && pmax > 10*pmin;
+
+	pnodes.resize(np + 1);
+	for(int i=0; i<=np; i++) {
+		if(logSpacing) pnodes[i] = pmin*pow(pmax/pmin, (double) i/np);
+		else           pnodes[i] = pmin + (pmax - pmin)*i/np;
+	}
+	pnodes[np] = pmax;
+
+	tnodes.resize(nt + 1);
+	for(int j=0; j<=nt; j++)
+		tnodes[j] = M_PI/2*j/nt;
+
+	values.resize((np + 1)*(nt + 1));
+	for(int i=0; i<=np; i++)
+		for(int j=0; j<=nt; j++) {
+			double v = intensity(tnodes[j], pnodes[i]);
+			values[i*(nt+1) + j] = (v > 0 && std::isfinite(v)) ? v : 0;
+		}
+
+	// cell weights: integral of the bilinear interpolation
+	int ncells = np*nt;
+	vector<double> weights(ncells);
+	total = 0;
+	for(int i=0; i<np; i++)
+		for(int j=0; j<nt; j++) {
+			double w = (pnodes[i+1] - pnodes[i])*(tnodes[j+1] - tnodes[j])*
+			           (value(i, j) + value(i+1, j) + value(i, j+1) + value(i+1, j+1))/4;
+			weights[i*nt + j] = w;
+			total += w;
+		}
+
+	prob.assign(ncells, 1);
+	alias.resize(ncells);
+	for(int c=0; c<ncells; c++) alias[c] = c;
+
+	if(total <= 0) return;
+
+	// alias table (Vose)
+	vector<int> small, large;
+	vector<double> scaled(ncells);
+	for(int c=0; c<ncells; c++) {
+		scaled[c] = weights[c]*ncells/total;
+		if(scaled[c] < 1) small.push_back(c);
+		else              large.push_back(c);
+	}
+
+	while(!small.empty() && !large.empty()) {
+		int s = small.back(); small.pop_back();
+		int l = large.back(); large.pop_back();
+
+		prob[s]  = scaled[s];
+		alias[s] = l;
+
+		scaled[l] = (scaled[l] + scaled[s]) - 1;
+		if(scaled[l] < 1) small.push_back(l);
+		else              large.push_back(l);
+	}
+
+	// leftovers are 1 within rounding
+	for(auto c: small) prob[c] = 1;
+	for(auto c: large) prob[c] = 1;
+}
+
+void cosmicTable::sample(double &p, double &theta) const
+{
+	int ncells = np*nt;
+
+	// cell: one random number for the cell index and the alias choice
+	double u = G4UniformRand()*ncells;
+	int cell = (int) u;
+	if(cell >= ncells) cell = ncells - 1;
+	if(u - cell >= prob[cell]) cell = alias[cell];
+
+	int i = cell / nt;
+	int j = cell % nt;
+
+	double f00 = value(i,   j);
+	double f10 = value(i+1, j);
+	double f01 = value(i,   j+1);
+	double f11 = value(i+1, j+1);
+
+	// momentum: marginal of the bilinear interpolation is linear
+	double x = sampleLinear(f00 + f01, f10 + f11, G4UniformRand());
+
+	// theta: linear at that momentum
+	double y = sampleLinear((1 - x)*f00 + x*f10, (1 - x)*f01 + x*f11, G4UniformRand());
+
+	p     = pnodes[i] + x*(pnodes[i+1] - pnodes[i]);
+	theta = tnodes[j] + y*(tnodes[j+1] - tnodes[j]);
+}
@@ -0,0 +1,56 @@
+/// \file cosmicTable.h
+/// Defines the sampling table of the internal cosmic ray generator.\n
+/// The cosmic ray intensity I(theta, p) (Dar model for muons, Ashton model for neutrons)
+/// is tabulated once, in setBeam, on a grid of zenith angles in [0, pi/2] and of momenta
+/// in [pmin, pmax], logarithmically spaced so that wide momentum ranges are covered.
+/// Each event picks a grid cell with an alias table, then (p, theta) inside the cell
+/// from the bilinear interpolation of the intensity, with a fixed number of random numbers.\n
+/// The table samples the same density as the former rejection loop: p and theta uniform,
+/// weighted by I(theta, p).
+/// \author \n Maurizio Ungaro
+/// \author mail: ungaro@jlab.org\n\n\n
+#ifndef COSMIC_TABLE_H
+#define COSMIC_TABLE_H 1
+
+// C++ headers
+#include <vector>
+#include <functional>
+using namespace std;
+
+
+/// \class cosmicTable
+/// <b> cosmicTable </b>\n\n
+/// Alias table of the (momentum, zenith angle) grid cells
+class cosmicTable
+{
+public:
+	cosmicTable() : pmin(0), pmax(0), np(0), nt(0), logSpacing(false), total(0) {;}
+
+	// tabulates intensity(theta, p) for p in [minp, maxp]
+	void build(function<double(double, double)> intensity, double minp, double maxp, int npbins = 400, int ntbins = 200);
+
+	bool isBuilt() const {return !prob.empty();}
+
+	// integral of the intensity over the table, in the units of intensity*p
+	double integral() const {return total;}
+
+	// samples momentum and zenith angle
+	void sample(double &p, double &theta) const;
+
+private:
+	double pmin, pmax;
+	int    np, nt;
+	bool   logSpacing;
+	double total;
+
+	vector<double> pnodes;   ///< momentum grid, np + 1 nodes
+	vector<double> tnodes;   ///< theta grid, nt + 1 nodes
+	vector<double> values;   ///< intensity at the nodes, values[i*(nt+1) + j]
+
+	vector<double> prob;     ///< alias table: probability to keep the cell
+	vector<int>    alias;    ///< alias table: other cell
+
+	double value(int i, int j) const {return values[i*(nt+1) + j];}
+};
+
+#endif
@@ -0,0 +1,177 @@
+// gemc headers
+#include "digitizeOnly.h"
+#include "stepRecord.h"
+#include "MEventAction.h"
+#include "string_utilities.h"
+#include "frequencySyncSignal.h"
+
+// C++ headers
+#include <iostream>
+using namespace std;
+
+
+// sensitiveID of a hit collection, built the same way as in MDetectorConstruction
+// from the first volume that has this sensitivity
+static sensitiveID sensitiveIDForSystem(string system, goptions gemcOpt, map<string, detector> *hallMap)
+{
+	for(auto &det: *hallMap) {
+		if(det.second.sensitivity == system)
+			return sensitiveID(system, gemcOpt, det.second.factory, det.second.variation, det.second.system);
+	}
+
+	cout << " !!! Warning: no volume has sensitivity " << system << ". Using empty hit definitions." << endl;
+	sensitiveID empty;
+	empty.name = system;
+	return empty;
+}
+
+
+long int digitizeOnly(goptions gemcOpt,
+					  map<string, detector>           *hallMap,
+					  map<string, HitProcess_Factory> *hitProcessMap,
+					  map<string, double>              gPars,
+					  map<string, gBank>              *banksMap,
+					  outputContainer                 *outContainer,
+					  map<string, outputFactoryInMap> *outputFactoryMap)
+{
+	string hd_msg  = gemcOpt.optMap["LOG_MSG"].args + " Digitize Only: >> ";
+	int    Modulo  = (int) gemcOpt.optMap["PRINT_EVENT"].arg ;
+	long int nmax  = (long int) gemcOpt.optMap["N"].arg;
+
+	string WRITE_ALLRAW = replaceCharInStringWithChars(gemcOpt.optMap["ALLRAWS"].args, ",", "  ");
+	string WRITE_INTRAW = replaceCharInStringWithChars(gemcOpt.optMap["INTEGRATEDRAW"].args, ",", "  ");
+	string WRITE_INTDGT = replaceCharInStringWithChars(gemcOpt.optMap["INTEGRATEDDGT"].args, ",", "  ");
+	string SIGNALVT     = replaceCharInStringWithChars(gemcOpt.optMap["SIGNALVT"].args, ",", "  ");
+
+	double tsampling  = get_number(get_info(gemcOpt.optMap["TSAMPLING"].args).front());
+	double nsamplings = get_number(get_info(gemcOpt.optMap["TSAMPLING"].args).back());
+
+	if(outputFactoryMap->find(outContainer->outType) == outputFactoryMap->end()) {
+		cout << hd_msg << " Error: output type <" << outContainer->outType << "> is not registered. Nothing to digitize into." << endl;
+		return 0;
+	}
+
+	stepRecord record(gemcOpt.optMap["DIGITIZE_ONLY"].args, "r");
+	if(!record.isGood())
+		return 0;
+
+	// hit definitions, built once for each hit collection
+	map<string, sensitiveID> SDIDs;
+
+	stepRecordEvent event;
+	long int nevents = 0;
+
+	while((nmax == 0 || nevents < nmax) && record.readEvent(&event, hallMap)) {
+
+		if(event.evn%Modulo == 0)
+			cout << hd_msg << " Digitizing event " << event.evn << "  Run Number: " << event.runNo << endl;
+
+		outputFactory *processOutputFactory = getOutputFactory(outputFactoryMap, outContainer->outType);
+		outContainer->beginEvent();
+
+		// header, user header and RF as written by the event action
+		processOutputFactory->writeHeader(outContainer, event.header, getBankFromMap("header", banksMap));
+		processOutputFactory->writeUserInfoseHeader(outContainer, event.userHeader);
+
+		if(event.rfsetup != "") {
+			FrequencySyncSignal rfs(event.rfsetup);
+			processOutputFactory->writeRFSignal(outContainer, rfs, getBankFromMap("rf", banksMap));
+		}
+
+		map<int, vector<hitOutput> > hit_outputs_from_AllSD;
+
+		for(auto &system: event.hits) {
+
+			string hitType    = system.first;
+			vector<MHit*> &hits = system.second;
+			int nhits = hits.size();
+
+			if(SDIDs.find(hitType) == SDIDs.end())
+				SDIDs[hitType] = sensitiveIDForSystem(hitType, gemcOpt, hallMap);
+
+			for(auto aHit: hits)
+				aHit->SetSDID(SDIDs[hitType]);
+
+			HitProcess *hitProcessRoutine = getHitProcess(hitProcessMap, hitType);
+			if(!hitProcessRoutine)
+				continue;
+
+			hitProcessRoutine->init(hitType, gemcOpt, gPars);
+
+			bool WRITE_TRUE_INTEGRATED = 0;
+			bool WRITE_TRUE_ALL = 0;
+			if(WRITE_INTRAW.find(hitType) != string::npos) WRITE_TRUE_INTEGRATED = 1;
+			if(WRITE_ALLRAW.find(hitType) != string::npos) WRITE_TRUE_ALL = 1;
+
+			// the raw information is integrated for every hit as in the event action
+			vector<hitOutput> allRawOutput;
+			for(int h=0; h<nhits; h++) {
+				if(hits[h]->isElectronicNoise)
+					continue;
+
+				hitOutput thisHitOutput;
+				thisHitOutput.setRaws(hitProcessRoutine->integrateRaw(hits[h], h+1, WRITE_TRUE_INTEGRATED));
+				if(WRITE_TRUE_ALL)
+					thisHitOutput.setAllRaws(hitProcessRoutine->allRaws(hits[h], h+1));
+				allRawOutput.push_back(thisHitOutput);
+			}
+
+			if(WRITE_TRUE_INTEGRATED)
+				processOutputFactory->writeG4RawIntegrated(outContainer, allRawOutput, hitType, banksMap);
+
+			if(WRITE_TRUE_ALL)
+				processOutputFactory->writeG4RawAll(outContainer, allRawOutput, hitType, banksMap);
+
+			if(WRITE_INTDGT.find(hitType) == string::npos) {
+				hitProcessRoutine->initWithRunNumber(event.runNo);
+
+				vector<hitOutput> allDgtOutput;
+				for(int h=0; h<nhits; h++) {
+					hitOutput thisHitOutput;
+
+					// calling integrateDgt will also set writeHit
+					thisHitOutput.setDgtz(hitProcessRoutine->integrateDgt(hits[h], h+1));
+					if(hitProcessRoutine->writeHit)
+						allDgtOutput.push_back(thisHitOutput);
+				}
+				processOutputFactory->writeG4DgtIntegrated(outContainer, allDgtOutput, hitType, banksMap);
+			}
+
+			if(SIGNALVT.find(hitType) != string::npos) {
+				vector<hitOutput> allVTOutput;
+
+				for(int h=0; h<nhits; h++) {
+					hitOutput thisHitOutput;
+					thisHitOutput.setChargeTime(hitProcessRoutine->chargeTime(hits[h], h));
+
+					map<int, int> vSignal = vtSignal(hitProcessRoutine, thisHitOutput.getChargeTime(), tsampling, nsamplings);
+					thisHitOutput.createQuantumS(vSignal);
+
+					hit_outputs_from_AllSD[vSignal[0]].push_back(thisHitOutput);
+					allVTOutput.push_back(thisHitOutput);
+				}
+				processOutputFactory->writeChargeTime(outContainer, allVTOutput, hitType, banksMap);
+			}
+
+			delete hitProcessRoutine;
+		}
+
+		processOutputFactory->writeFADCMode1(outContainer, hit_outputs_from_AllSD, event.evn);
+
+		// the per detector summaries were saved with the generated particles
+		processOutputFactory->writeGenerated(outContainer, event.primaries, banksMap, event.userInfo);
+
+		if(event.hasAncestors)
+			processOutputFactory->writeAncestors(outContainer, event.ancestors, getBankFromMap("ancestors", banksMap));
+
+		processOutputFactory->writeEvent(outContainer);
+		delete processOutputFactory;
+		outContainer->endEvent(event.evn);
+
+		nevents++;
+	}
+
+	cout << hd_msg << " " << nevents << " events digitized." << endl;
+
+	return nevents;
+}
@@ -0,0 +1,29 @@
+/// \file digitizeOnly.h
+/// Defines the DIGITIZE_ONLY mode.\n
+/// The hits are read from a STEP_RECORD file and only the
+/// HitProcess digitization stages and the output factories are run:
+/// no geometry is built and no particle is tracked.\n
+/// \author \n Maurizio Ungaro
+/// \author mail: ungaro@jlab.org\n\n\n
+#ifndef digitizeOnly_H
+#define digitizeOnly_H 1
+
+// gemc headers
+#include "outputFactory.h"
+#include "gbank.h"
+#include "HitProcess.h"
+#include "detector.h"
+#include "options.h"
+
+
+// digitizes all the events in the DIGITIZE_ONLY step record
+// returns the number of events processed
+long int digitizeOnly(goptions gemcOpt,
+					  map<string, detector>           *hallMap,
+					  map<string, HitProcess_Factory> *hitProcessMap,
+					  map<string, double>              gPars,
+					  map<string, gBank>              *banksMap,
+					  outputContainer                 *outContainer,
+					  map<string, outputFactoryInMap> *outputFactoryMap);
+
+#endif
@@ -0,0 +1,551 @@
+// G4 headers
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
+
+// gemc headers
+#include "eventFilter.h"
+#include "string_utilities.h"
+
+// C++ headers
+#include <iostream>
+#include <cstdlib>
+#include <cctype>
+#include <set>
+#include <cmath>
+using namespace std;
+
+// CLHEP units
+#include "CLHEP/Units/PhysicalConstants.h"
+using namespace CLHEP;
+
+
+// units that can be used in the expression
+static map<string, double> filterUnits()
+{
+	map<string, double> units;
+	units["eV"]  = eV;
+	units["keV"] = keV;
+	units["MeV"] = MeV;
+	units["GeV"] = GeV;
+	units["mm"]  = mm;
+	units["cm"]  = cm;
+	units["m"]   = m;
+	units["ns"]  = ns;
+	units["deg"] = deg;
+	units["rad"] = rad;
+	units["mrad"] = mrad;
+	return units;
+}
+
+// number of arguments of each function
+static map<string, unsigned> filterFunctions()
+{
+	map<string, unsigned> functions;
+	functions["nhits"]    = 1;
+	functions["edep"]     = 1;
+	functions["nids"]     = 2;
+	functions["coinc"]    = 3;
+	functions["ngen"]     = 1;
+	functions["pmax"]     = 1;
+	functions["thetamin"] = 1;
+	functions["thetamax"] = 1;
+	return functions;
+}
+
+// generated particle variables, used in the count() conditions
+enum particleVariable {PV_PID, PV_P, PV_PX, PV_PY, PV_PZ, PV_EKIN, PV_THETA, PV_PHI, PV_VX, PV_VY, PV_VZ, PV_VR, PV_T, PV_N};
+
+static map<string, int> particleVariables()
+{
+	map<string, int> pvars;
+	pvars["pid"]   = PV_PID;
+	pvars["p"]     = PV_P;
+	pvars["px"]    = PV_PX;
+	pvars["py"]    = PV_PY;
+	pvars["pz"]    = PV_PZ;
+	pvars["ekin"]  = PV_EKIN;
+	pvars["theta"] = PV_THETA;
+	pvars["phi"]   = PV_PHI;
+	pvars["vx"]    = PV_VX;
+	pvars["vy"]    = PV_VY;
+	pvars["vz"]    = PV_VZ;
+	pvars["vr"]    = PV_VR;
+	pvars["t"]     = PV_T;
+	return pvars;
+}
+
+// maximum stack depth of a program
+static int programDepth(const vector<eventFilterInstruction> &program)
+{
+	int depth = 0, maxDepth = 0;
+	for(auto &i: program) {
+		if(i.op == eventFilterInstruction::CONSTANT || i.op == eventFilterInstruction::VARIABLE ||
+		   i.op == eventFilterInstruction::PARTICLE || i.op == eventFilterInstruction::COUNT) depth++;
+		else if(i.op != eventFilterInstruction::NEG && i.op != eventFilterInstruction::NOT && i.op != eventFilterInstruction::ABS) depth--;
+		if(depth > maxDepth) maxDepth = depth;
+	}
+	return maxDepth;
+}
+
+
+eventFilter::eventFilter(goptions gemcOpt, string option)
+{
+	optionName     = option;
+	generatorLevel = option == "GENERATOR_FILTER";
+	hd_msg         = gemcOpt.optMap["LOG_MSG"].args + (generatorLevel ? " Generator Filter: >> " : " Event Filter: >> ");
+	verbosity      = gemcOpt.optMap[generatorLevel ? "GEN_VERBOSITY" : "HIT_VERBOSITY"].arg;
+	expression     = gemcOpt.optMap[option].args;
+	nevents        = 0;
+	naccepted      = 0;
+	inCount        = false;
+
+	if(trimSpacesFromString(expression) == "no") return;
+
+	tokenize();
+	pos = 0;
+	parseOr();
+	if(pos != tokens.size()) error("unexpected " + tokens[pos]);
+
+	// stack depth: the count() conditions run above the main program
+	int particleDepth = 0;
+	for(auto &p: particleCode)
+		particleDepth = max(particleDepth, programDepth(p));
+	stack.resize(programDepth(code) + particleDepth);
+
+	cout << hd_msg << " Compiled " << expression << ": " << code.size() << " instructions, "
+	     << variables.size() << " event variables, " << particleCode.size() << " particle conditions." << endl;
+}
+
+void eventFilter::error(string message)
+{
+	cout << hd_msg << " !!! Error in " << optionName << " \"" << expression << "\": " << message << ". Exiting." << endl;
+	exit(1);
+}
+
+void eventFilter::tokenize()
+{
+	string two[] = {"&&", "||", "<=", ">=", "==", "!="};
+
+	unsigned i = 0;
+	while(i < expression.size()) {
+		char c = expression[i];
+
+		if(isspace(c)) {
+			i++;
+		} else if(isdigit(c) || c == '.') {
+			char *end;
+			strtod(expression.c_str() + i, &end);
+			unsigned len = end - (expression.c_str() + i);
+			if(len == 0) error("invalid number");
+			tokens.push_back(expression.substr(i, len));
+			i += len;
+		} else if(isalpha(c) || c == '_') {
+			unsigned j = i;
+			while(j < expression.size() && (isalnum(expression[j]) || expression[j] == '_')) j++;
+			tokens.push_back(expression.substr(i, j - i));
+			i = j;
+		} else {
+			string op(1, c);
+			for(auto &t: two)
+				if(expression.compare(i, 2, t) == 0) op = t;
+			if(op.size() == 1 && string("<>!+-*/(),").find(c) == string::npos)
+				error("unknown character " + op);
+			tokens.push_back(op);
+			i += op.size();
+		}
+	}
+}
+
+bool eventFilter::next(string token)
+{
+	if(pos < tokens.size() && tokens[pos] == token) {
+		pos++;
+		return true;
+	}
+	return false;
+}
+
+void eventFilter::parseOr()
+{
+	parseAnd();
+	while(next("||")) {
+		parseAnd();
+		code.push_back(eventFilterInstruction(eventFilterInstruction::OR));
+	}
+}
+
+void eventFilter::parseAnd()
+{
+	parseNot();
+	while(next("&&")) {
+		parseNot();
+		code.push_back(eventFilterInstruction(eventFilterInstruction::AND));
+	}
+}
+
+void eventFilter::parseNot()
+{
+	if(next("!")) {
+		parseNot();
+		code.push_back(eventFilterInstruction(eventFilterInstruction::NOT));
+	} else {
+		parseComparison();
+	}
+}
+
+void eventFilter::parseComparison()
+{
+	parseSum();
+
+	string ops[] = {"<", "<=", ">", ">=", "==", "!="};
+	eventFilterInstruction::opcode codes[] = {eventFilterInstruction::LT, eventFilterInstruction::LE, eventFilterInstruction::GT,
+	                                          eventFilterInstruction::GE, eventFilterInstruction::EQ, eventFilterInstruction::NE};
+	for(unsigned o=0; o<6; o++) {
+		if(next(ops[o])) {
+			parseSum();
+			code.push_back(eventFilterInstruction(codes[o]));
+			return;
+		}
+	}
+}
+
+void eventFilter::parseSum()
+{
+	parseProduct();
+	while(true) {
+		if(next("+"))      {parseProduct(); code.push_back(eventFilterInstruction(eventFilterInstruction::ADD));}
+		else if(next("-")) {parseProduct(); code.push_back(eventFilterInstruction(eventFilterInstruction::SUB));}
+		else return;
+	}
+}
+
+void eventFilter::parseProduct()
+{
+	parseUnary();
+	while(true) {
+		if(next("*"))      {parseUnary(); code.push_back(eventFilterInstruction(eventFilterInstruction::MUL));}
+		else if(next("/")) {parseUnary(); code.push_back(eventFilterInstruction(eventFilterInstruction::DIV));}
+		else return;
+	}
+}
+
+void eventFilter::parseUnary()
+{
+	if(next("-")) {
+		parseUnary();
+		code.push_back(eventFilterInstruction(eventFilterInstruction::NEG));
+	} else {
+		parsePrimary();
+	}
+}
+
+void eventFilter::parsePrimary()
+{
+	if(pos >= tokens.size()) error("unexpected end of expression");
+
+	string token = tokens[pos++];
+
+	if(token == "(") {
+		parseOr();
+		if(!next(")")) error("missing )");
+		return;
+	}
+
+	if(isdigit(token[0]) || token[0] == '.') {
+		code.push_back(eventFilterInstruction(eventFilterInstruction::CONSTANT, atof(token.c_str())));
+		return;
+	}
+
+	if(isalpha(token[0]) || token[0] == '_') {
+		if(next("(")) {
+			if(token == "count")    parseCount();
+			else if(token == "abs") parseAbs();
+			else                    parseFunction(token);
+			return;
+		}
+		map<string, int> pvars = particleVariables();
+		if(pvars.find(token) != pvars.end()) {
+			if(!inCount) error(token + " is a particle variable: it can only be used inside count()");
+			code.push_back(eventFilterInstruction(eventFilterInstruction::PARTICLE, 0, pvars[token]));
+			return;
+		}
+		map<string, double> units = filterUnits();
+		if(units.find(token) == units.end()) error("unknown unit " + token);
+		code.push_back(eventFilterInstruction(eventFilterInstruction::CONSTANT, units[token]));
+		return;
+	}
+
+	error("unexpected " + token);
+}
+
+// the condition is compiled in its own program, run for each generated particle
+void eventFilter::parseCount()
+{
+	if(inCount) error("count() can not be nested");
+
+	vector<eventFilterInstruction> eventCode;
+	eventCode.swap(code);
+	inCount = true;
+
+	parseOr();
+	if(!next(")")) error("missing ) after the condition of count");
+
+	inCount = false;
+	particleCode.push_back(code);
+	code.swap(eventCode);
+
+	code.push_back(eventFilterInstruction(eventFilterInstruction::COUNT, 0, particleCode.size() - 1));
+}
+
+void eventFilter::parseAbs()
+{
+	parseOr();
+	if(!next(")")) error("missing ) after the argument of abs");
+	code.push_back(eventFilterInstruction(eventFilterInstruction::ABS));
+}
+
+// the arguments are names or numbers, the same call is evaluated once per event
+void eventFilter::parseFunction(string function)
+{
+	map<string, unsigned> functions = filterFunctions();
+	if(functions.find(function) == functions.end()) error("unknown function " + function);
+	if(inCount) error(function + " is an event function: it can not be used inside count()");
+	if(generatorLevel && (function == "nhits" || function == "edep" || function == "nids" || function == "coinc"))
+		error(function + " needs hits: only the generated particles are known before tracking");
+
+	vector<string> args;
+	while(pos < tokens.size() && tokens[pos] != ")") {
+		string arg = tokens[pos++];
+		// negative pids
+		if(arg == "-" && pos < tokens.size()) arg += tokens[pos++];
+		args.push_back(arg);
+		if(!next(",")) break;
+	}
+	if(!next(")")) error("missing ) after the arguments of " + function);
+	if(args.size() != functions[function]) error(function + " needs " + to_string(functions[function]) + " argument(s)");
+
+	for(unsigned v=0; v<variables.size(); v++) {
+		if(variables[v].function == function && variables[v].args == args) {
+			code.push_back(eventFilterInstruction(eventFilterInstruction::VARIABLE, 0, v));
+			return;
+		}
+	}
+
+	variables.push_back(eventFilterVariable(function, args));
+	if(function == "ngen" || function == "pmax" || function == "thetamin" || function == "thetamax")
+		variables.back().pid = atoi(args[0].c_str());
+
+	code.push_back(eventFilterInstruction(eventFilterInstruction::VARIABLE, 0, variables.size() - 1));
+}
+
+
+void eventFilter::bind(eventFilterVariable &v, map<string, sensitiveDetector*> &SeDe_Map)
+{
+	v.bound = true;
+
+	unsigned nsystems = 0;
+	if(v.function == "nhits" || v.function == "edep" || v.function == "nids") nsystems = 1;
+	if(v.function == "coinc") nsystems = 2;
+
+	for(unsigned s=0; s<nsystems; s++) {
+		if(SeDe_Map.find(v.args[s]) != SeDe_Map.end()) {
+			v.sd[s] = SeDe_Map[v.args[s]];
+		} else {
+			cout << hd_msg << " Warning: " << v.args[s] << " is not a sensitive detector: " << v.function << " is always 0." << endl;
+		}
+	}
+}
+
+// position of the identifier in the identity of the hits of this system
+static int identifierIndex(MHitCollection *MHC, string name)
+{
+	if(MHC == nullptr || MHC->GetSize() == 0) return -1;
+
+	vector<identifier> identity = (*MHC)[0]->GetId();
+	for(unsigned i=0; i<identity.size(); i++)
+		if(identity[i].name == name) return i;
+
+	return -1;
+}
+
+// values of an identifier in the hits of a system
+static set<int> identifierValues(MHitCollection *MHC, int index)
+{
+	set<int> values;
+	if(MHC == nullptr || index < 0) return values;
+
+	for(unsigned h=0; h<MHC->GetSize(); h++) {
+		vector<identifier> identity = (*MHC)[h]->GetId();
+		if(index < (int) identity.size())
+			values.insert(identity[index].id);
+	}
+	return values;
+}
+
+void eventFilter::evaluate(eventFilterVariable &v, const G4Event *evt)
+{
+	v.value = 0;
+
+	MHitCollection *MHC[2] = {nullptr, nullptr};
+	for(unsigned s=0; s<2; s++)
+		if(v.sd[s] != nullptr) MHC[s] = v.sd[s]->GetMHitCollection();
+
+	if(v.function == "nhits") {
+		if(MHC[0]) v.value = MHC[0]->GetSize();
+
+	} else if(v.function == "edep") {
+		if(MHC[0] == nullptr) return;
+		for(unsigned h=0; h<MHC[0]->GetSize(); h++) {
+			MHit *aHit = (*MHC[0])[h];
+			if(aHit->isAccumulated()) {
+				v.value += aHit->GetAccumulator().eTot;
+			} else {
+				vector<double> edep = aHit->GetEdep();
+				for(auto e: edep) v.value += e;
+			}
+		}
+
+	} else if(v.function == "nids") {
+		if(v.idIndex[0] < 0) v.idIndex[0] = identifierIndex(MHC[0], v.args[1]);
+		v.value = identifierValues(MHC[0], v.idIndex[0]).size();
+
+	} else if(v.function == "coinc") {
+		for(unsigned s=0; s<2; s++)
+			if(v.idIndex[s] < 0) v.idIndex[s] = identifierIndex(MHC[s], v.args[2]);
+
+		set<int> first  = identifierValues(MHC[0], v.idIndex[0]);
+		set<int> second = identifierValues(MHC[1], v.idIndex[1]);
+		for(auto i: first)
+			if(second.find(i) != second.end()) v.value++;
+
+	} else {
+		// generated particles
+		bool found = false;
+		for(int pv=0; pv<evt->GetNumberOfPrimaryVertex(); pv++) {
+			G4PrimaryVertex *vertex = evt->GetPrimaryVertex(pv);
+			for(int p=0; p<vertex->GetNumberOfParticle(); p++) {
+				G4PrimaryParticle *particle = vertex->GetPrimary(p);
+				if(v.pid != 0 && particle->GetPDGcode() != v.pid) continue;
+
+				G4ThreeVector mom = particle->GetMomentum();
+				double value = 0;
+				if(v.function == "ngen")        value = 1;
+				else if(v.function == "pmax")   value = mom.mag();
+				else                            value = mom.theta();
+
+				if(v.function == "ngen")                                  v.value += value;
+				else if(!found)                                           v.value  = value;
+				else if(v.function == "thetamin" && value < v.value)      v.value  = value;
+				else if(v.function != "thetamin" && value > v.value)      v.value  = value;
+				found = true;
+			}
+		}
+	}
+}
+
+
+// variables of the generated particles, for the count() conditions
+void eventFilter::primaryValues(const G4Event *evt)
+{
+	primaries.clear();
+	for(int pv=0; pv<evt->GetNumberOfPrimaryVertex(); pv++) {
+		G4PrimaryVertex *vertex = evt->GetPrimaryVertex(pv);
+		G4ThreeVector pos = vertex->GetPosition();
+		for(int p=0; p<vertex->GetNumberOfParticle(); p++) {
+			G4PrimaryParticle *particle = vertex->GetPrimary(p);
+			G4ThreeVector mom = particle->GetMomentum();
+
+			vector<double> values(PV_N);
+			values[PV_PID]   = particle->GetPDGcode();
+			values[PV_P]     = mom.mag();
+			values[PV_PX]    = mom.x();
+			values[PV_PY]    = mom.y();
+			values[PV_PZ]    = mom.z();
+			values[PV_EKIN]  = particle->GetKineticEnergy();
+			values[PV_THETA] = mom.theta();
+			values[PV_PHI]   = mom.phi();
+			values[PV_VX]    = pos.x();
+			values[PV_VY]    = pos.y();
+			values[PV_VZ]    = pos.z();
+			values[PV_VR]    = pos.perp();
+			values[PV_T]     = vertex->GetT0();
+			primaries.push_back(values);
+		}
+	}
+}
+
+// runs a program on the stack above base. particle: variables of the generated particle in count()
+double eventFilter::run(const vector<eventFilterInstruction> &program, unsigned base, const double *particle)
+{
+	unsigned sp = base;
+	for(auto &i: program) {
+		switch(i.op) {
+			case eventFilterInstruction::CONSTANT: stack[sp++] = i.value; break;
+			case eventFilterInstruction::VARIABLE: stack[sp++] = variables[i.variable].value; break;
+			case eventFilterInstruction::PARTICLE: stack[sp++] = particle[i.variable]; break;
+			case eventFilterInstruction::COUNT:
+			{
+				double n = 0;
+				for(auto &values: primaries)
+					if(run(particleCode[i.variable], sp, values.data()) != 0) n++;
+				stack[sp++] = n;
+				break;
+			}
+			case eventFilterInstruction::NEG:      stack[sp-1] = -stack[sp-1]; break;
+			case eventFilterInstruction::NOT:      stack[sp-1] = stack[sp-1] == 0; break;
+			case eventFilterInstruction::ABS:      stack[sp-1] = fabs(stack[sp-1]); break;
+			default:
+			{
+				double b  = stack[--sp];
+				double &a = stack[sp-1];
+				switch(i.op) {
+					case eventFilterInstruction::ADD: a = a + b;  break;
+					case eventFilterInstruction::SUB: a = a - b;  break;
+					case eventFilterInstruction::MUL: a = a * b;  break;
+					case eventFilterInstruction::DIV: a = b != 0 ? a / b : 0; break;
+					case eventFilterInstruction::LT:  a = a <  b; break;
+					case eventFilterInstruction::LE:  a = a <= b; break;
+					case eventFilterInstruction::GT:  a = a >  b; break;
+					case eventFilterInstruction::GE:  a = a >= b; break;
+					case eventFilterInstruction::EQ:  a = a == b; break;
+					case eventFilterInstruction::NE:  a = a != b; break;
+					case eventFilterInstruction::AND: a = a != 0 && b != 0; break;
+					case eventFilterInstruction::OR:  a = a != 0 || b != 0; break;
+					default: break;
+				}
+			}
+		}
+	}
+
+	return stack[base];
+}
+
+bool eventFilter::accept(const G4Event *evt, map<string, sensitiveDetector*> &SeDe_Map)
+{
+	nevents++;
+
+	for(auto &v: variables) {
+		if(!v.bound) bind(v, SeDe_Map);
+		evaluate(v, evt);
+	}
+
+	if(!particleCode.empty()) primaryValues(evt);
+
+	bool pass = run(code, 0, nullptr) != 0;
+	if(pass) naccepted++;
+
+	if(verbosity > 3) {
+		cout << hd_msg << (pass ? " accepted" : " rejected") << " event, values:";
+		for(auto &v: variables) cout << " " << v.function << "=" << v.value;
+		cout << endl;
+	}
+
+	return pass;
+}
+
+void eventFilter::printSummary()
+{
+	cout << hd_msg << " " << expression << ": " << naccepted << " events accepted out of " << nevents;
+	if(nevents > 0) cout << " (" << 100.0*naccepted/nevents << "%)";
+	cout << ", " << nevents - naccepted << " rejected before " << (generatorLevel ? "tracking." : "digitization.") << endl;
+}
@@ -0,0 +1,145 @@
+/// \file eventFilter.h
+/// Defines the gemc event filter.\n
+/// The EVENT_FILTER expression is compiled once at startup into
+/// a list of stack instructions. It is evaluated at the end of each event,
+/// after the hits are integrated and before digitization and output:
+/// rejected events are not digitized nor written.\n
+/// Expression syntax: numbers, units (MeV, GeV, deg, ns, cm, ...),
+/// + - * / ( ), comparisons < <= > >= == !=, logical && || !
+/// and the event functions:
+/// - nhits(system): number of hits in a system
+/// - edep(system): total energy deposited in a system
+/// - nids(system, identifier): number of different values of an identifier in the hits of a system
+/// - coinc(system1, system2, identifier): number of identifier values with hits in both systems
+/// - ngen(pid): number of generated particles with pid (0: all particles)
+/// - pmax(pid): largest momentum of the generated particles with pid (0: all particles)
+/// - thetamin(pid), thetamax(pid): smallest, largest polar angle of the generated particles with pid
+/// - count(condition): number of generated particles satisfying the condition. The condition
+///   is an expression of the particle variables pid, p, px, py, pz, ekin, theta, phi, vx, vy, vz, vr, t
+/// - abs(x): absolute value\n
+/// Example: nhits(ec) > 2 && coinc(ftof, ec, sector) >= 1 && pmax(11) > 2*GeV\n
+/// The same expressions, without the hit functions, are used by GENERATOR_FILTER to select
+/// the generated events before tracking, for example:
+/// count(pid == 11 && p > 1*GeV && theta > 2.5*deg && theta < 4.5*deg) >= 1 || count(pid == 2212 && abs(vz) < 5*cm) > 0
+/// \author \n Maurizio Ungaro
+/// \author mail: ungaro@jlab.org\n\n\n
+#ifndef EVENT_FILTER_H
+#define EVENT_FILTER_H 1
+
+// G4 headers
+#include "G4Event.hh"
+
+// gemc headers
+#include "options.h"
+#include "sensitiveDetector.h"
+
+// C++ headers
+#include <string>
+#include <vector>
+#include <map>
+using namespace std;
+
+
+/// \class eventFilterVariable
+/// <b> eventFilterVariable </b>\n\n
+/// One event function call of the expression.
+/// The sensitive detectors and the identifier positions are found at the first event.
+class eventFilterVariable
+{
+public:
+	eventFilterVariable(string f, vector<string> a) : function(f), args(a), pid(0), bound(false), value(0)
+	{
+		sd[0] = sd[1] = nullptr;
+		idIndex[0] = idIndex[1] = -1;
+	}
+
+	string function;
+	vector<string> args;
+
+	sensitiveDetector *sd[2];
+	int idIndex[2];   ///< position of the identifier in the hit identity, -1 until a hit is found
+	int pid;
+	bool bound;
+
+	double value;
+};
+
+
+/// \class eventFilterInstruction
+/// <b> eventFilterInstruction </b>\n\n
+/// Stack machine instruction
+class eventFilterInstruction
+{
+public:
+	enum opcode {CONSTANT, VARIABLE, PARTICLE, COUNT, ABS, ADD, SUB, MUL, DIV, NEG, LT, LE, GT, GE, EQ, NE, AND, OR, NOT};
+
+	eventFilterInstruction(opcode o, double v = 0, int i = -1) : op(o), value(v), variable(i) {;}
+
+	opcode op;
+	double value;
+	int    variable;
+};
+
+
+/// \class eventFilter
+/// <b> eventFilter </b>\n\n
+/// Compiles the EVENT_FILTER (or GENERATOR_FILTER) expression and evaluates it for each event.
+class eventFilter
+{
+public:
+	eventFilter(goptions gemcOpt, string option = "EVENT_FILTER");
+
+	bool isActive() const {return !code.empty();}
+
+	// evaluates the expression, counts accepted and rejected events
+	bool accept(const G4Event *evt, map<string, sensitiveDetector*> &SeDe_Map);
+
+	long nevents;
+	long naccepted;
+
+	// events and acceptance
+	void printSummary();
+
+private:
+	string expression;
+	string optionName;
+	string hd_msg;
+	int verbosity;
+	bool generatorLevel;   ///< GENERATOR_FILTER: no hits are available
+
+	vector<eventFilterInstruction> code;
+	vector<eventFilterVariable> variables;
+	vector<double> stack;
+
+	// count() conditions, evaluated for each generated particle
+	vector<vector<eventFilterInstruction> > particleCode;
+	vector<vector<double> > primaries;
+	bool inCount;
+
+	// parser
+	vector<string> tokens;
+	unsigned pos;
+
+	void tokenize();
+	void parseOr();
+	void parseAnd();
+	void parseNot();
+	void parseComparison();
+	void parseSum();
+	void parseProduct();
+	void parseUnary();
+	void parsePrimary();
+	void parseFunction(string function);
+	void parseCount();
+	void parseAbs();
+	bool next(string token);
+	void error(string message);
+
+	void bind(eventFilterVariable &v, map<string, sensitiveDetector*> &SeDe_Map);
+	void evaluate(eventFilterVariable &v, const G4Event *evt);
+	void primaryValues(const G4Event *evt);
+	double run(const vector<eventFilterInstruction> &program, unsigned base, const double *particle);
+};
+
+
+#endif
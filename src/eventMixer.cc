@@ -0,0 +1,123 @@
+// G4 headers
+#include "Randomize.hh"
+
+// gemc headers
+#include "eventMixer.h"
+#include "string_utilities.h"
+
+// mlibrary
+#include "gstring.h"
+using namespace gstring;
+
+// C++ headers
+#include <iostream>
+#include <cstdlib>
+using namespace std;
+
+// CLHEP units
+#include "CLHEP/Units/PhysicalConstants.h"
+using namespace CLHEP;
+
+
+eventMixer::eventMixer(goptions gemcOpt, map<string, detector> *hMap)
+{
+	string hd_msg = gemcOpt.optMap["LOG_MSG"].args + " Event Mixing: >> ";
+	verbosity = gemcOpt.optMap["HIT_VERBOSITY"].arg;
+
+	record  = nullptr;
+	hallMap = hMap;
+	randomSelection = false;
+	tmin = tmax = 0;
+	nmix = 1;
+	next = 0;
+
+	vector<string> pars = getStringVectorFromStringWithDelimiter(gemcOpt.optMap["MIX_STEP_RECORD"].args, ",");
+	if(pars.size() < 4) {
+		cout << hd_msg << " !!! Error: MIX_STEP_RECORD should be \"filename, sequential|random, tmin, tmax, (events per signal event)\". No mixing." << endl;
+		return;
+	}
+
+	randomSelection = trimSpacesFromString(pars[1]) == "random";
+	tmin = get_number(pars[2]);
+	tmax = get_number(pars[3]);
+	if(pars.size() > 4) nmix = (int) get_number(pars[4]);
+	if(nmix < 1) nmix = 1;
+
+	record = new stepRecord(pars[0], "r");
+	if(!record->isGood())
+		return;
+
+	// only the event offsets are kept in memory, the events are read when selected
+	offsets = record->indexEvents();
+
+	for(int i=0; i<nmix; i++)
+		events.push_back(new stepRecordEvent);
+
+	cout << hd_msg << " " << offsets.size() << " background events indexed in " << trimSpacesFromString(pars[0])
+	     << ", " << nmix << " overlaid to each event with " << (randomSelection ? "random" : "sequential") << " selection, "
+	     << " time shift in [" << tmin/ns << ", " << tmax/ns << "] ns." << endl;
+}
+
+eventMixer::~eventMixer()
+{
+	for(auto ev: events)
+		delete ev;
+
+	if(record != nullptr)
+		delete record;
+}
+
+
+void eventMixer::nextEvent()
+{
+	shifts.clear();
+	if(offsets.empty()) return;
+
+	for(int i=0; i<nmix; i++) {
+		unsigned long index;
+		if(randomSelection) {
+			index = (unsigned long) (G4UniformRand()*offsets.size());
+			if(index >= offsets.size()) index = offsets.size() - 1;
+		} else {
+			// starting again from the first one at the end of the file
+			index = next++ % offsets.size();
+		}
+		double dt = tmin + G4UniformRand()*(tmax - tmin);
+
+		if(!record->readEventAt(offsets[index], events[i], hallMap))
+			cout << " !!! Warning: background event " << index << " could not be read." << endl;
+
+		shifts.push_back(dt);
+
+		if(verbosity > 3)
+			cout << " Mixing background event " << index << " with time shift " << dt/ns << " ns" << endl;
+	}
+}
+
+vector<MHit*> eventMixer::hitsForSystem(string system)
+{
+	vector<MHit*> hits;
+
+	for(unsigned i=0; i<shifts.size(); i++) {
+		auto sys = events[i]->hits.find(system);
+		if(sys == events[i]->hits.end())
+			continue;
+
+		for(auto bgHit: sys->second) {
+			MHit *aHit = new MHit(*bgHit);
+			aHit->shiftTime(shifts[i]);
+
+			vector<int> tids = aHit->GetTIds();
+			for(auto &t: tids) t = -abs(t);
+			aHit->SetTrackIds(tids);
+
+			vector<identifier> identity = aHit->GetId();
+			for(auto &iden: identity) iden.TrackId = -abs(iden.TrackId);
+			aHit->SetId(identity);
+
+			hits.push_back(aHit);
+		}
+	}
+
+	return hits;
+}
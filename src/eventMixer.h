@@ -0,0 +1,59 @@
+/// \file eventMixer.h
+/// Defines the MIX_STEP_RECORD event mixing.\n
+/// The hits of background events, saved in a STEP_RECORD file produced with
+/// a background only beam, are overlaid to each signal event before the
+/// digitization. Each background event is shifted in time inside the readout window.
+/// The luminosity background is simulated once and reused for many signal samples.\n
+/// \author \n Maurizio Ungaro
+/// \author mail: ungaro@jlab.org\n\n\n
+#ifndef eventMixer_H
+#define eventMixer_H 1
+
+// gemc headers
+#include "stepRecord.h"
+#include "detector.h"
+#include "options.h"
+
+// C++ headers
+#include <map>
+#include <vector>
+using namespace std;
+
+
+/// \class eventMixer
+/// <b> eventMixer </b>\n\n
+/// Usage: -MIX_STEP_RECORD="filename, sequential|random, tmin, tmax, (events per signal event)"\n
+/// The offsets of the background events in the file are indexed once. For each signal event
+/// nextEvent selects the background events and their time shifts, the same
+/// for all the detectors, and reads them from the file. hitsForSystem returns shifted copies of the hits.\n
+/// The background track ids are negated so they cannot be confused with the signal tracks.
+class eventMixer
+{
+public:
+	eventMixer(goptions gemcOpt, map<string, detector> *hallMap);
+	~eventMixer();
+
+	bool isGood() { return offsets.size() > 0; }
+
+	// selects the background events for the next signal event
+	void nextEvent();
+
+	// copies of the background hits of a system, to be inserted in its hit collection
+	vector<MHit*> hitsForSystem(string system);
+
+private:
+	stepRecord              *record;
+	map<string, detector>   *hallMap;
+	vector<streampos>        offsets;   ///< file offsets of the background events
+	vector<stepRecordEvent*> events;    ///< background events of this event, read from the file
+
+	bool   randomSelection;   ///< random or sequential selection of the background events
+	double tmin, tmax;        ///< time shift window
+	int    nmix;              ///< number of background events for each signal event
+	int    verbosity;
+
+	unsigned long next;                    ///< next background event in sequential mode
+	vector<double> shifts;                 ///< time shift of each background event of this event
+};
+
+#endif
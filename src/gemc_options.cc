@@ -114,12 +114,40 @@ void goptions::setGoptions()
 	optMap["INPUT_GEN_FILE"].help = "Generator Input. Current availables file formats:\n";
 	optMap["INPUT_GEN_FILE"].help += "      LUND. \n";
 	optMap["INPUT_GEN_FILE"].help += "      example: -INPUT_GEN_FILE=\"LUND, input.dat\" or -INPUT_GEN_FILE=\"StdHEP, darkphoton.stdhep\" \n";
+	optMap["INPUT_GEN_FILE"].help += "      gprimary: binary events converted once from LUND, BEAGLE or StdHep with primaryConverter: \n";
+	optMap["INPUT_GEN_FILE"].help += "      primaryConverter LUND input.dat input.gprimary, then -INPUT_GEN_FILE=\"gprimary, input.gprimary\" \n";
+	optMap["INPUT_GEN_FILE"].help += "      phasespace: particles recorded with PHASESPACE_RECORD, see PHASESPACE_REPLAY. Example: -INPUT_GEN_FILE=\"phasespace, dump.gprimary\" \n";
 	optMap["INPUT_GEN_FILE"].name = "Generator Input File";
 	optMap["INPUT_GEN_FILE"].type = 1;
 	optMap["INPUT_GEN_FILE"].ctgr = "generator";
 	optMap["INPUT_GEN_FILE"].argsJSONDescription  = "type, filename";
 	optMap["INPUT_GEN_FILE"].argsJSONTypes  = "S S";
 
+	optMap["PHASESPACE_REPLAY"].args = "once";
+	optMap["PHASESPACE_REPLAY"].help = "Replay mode of the phasespace INPUT_GEN_FILE.\n";
+	optMap["PHASESPACE_REPLAY"].help += "      once: each recorded event is replayed once, the run stops at the end of the file (default).\n";
+	optMap["PHASESPACE_REPLAY"].help += "      resample: the recorded events are drawn at random.\n";
+	optMap["PHASESPACE_REPLAY"].help += "      \"resample, phi\": drawn at random and rotated by a random angle around the z axis.\n";
+	optMap["PHASESPACE_REPLAY"].help += "      The event weight of the recorded event is written in the header bank, the particle weights are the vertex weights.\n";
+	optMap["PHASESPACE_REPLAY"].help += "      The number of events simulated to record the file is written in the header bank (nsource).\n";
+	optMap["PHASESPACE_REPLAY"].name = "Replay mode of the phasespace input";
+	optMap["PHASESPACE_REPLAY"].type = 1;
+	optMap["PHASESPACE_REPLAY"].ctgr = "generator";
+	optMap["PHASESPACE_REPLAY"].argsJSONDescription  = "mode, symmetry";
+	optMap["PHASESPACE_REPLAY"].argsJSONTypes  = "S S";
+
+	optMap["PHASESPACE_RECORD"].args = "no";
+	optMap["PHASESPACE_RECORD"].help = "Records the particles entering a volume: \"filename, volume, (kill|keep)\".\n";
+	optMap["PHASESPACE_RECORD"].help += "      pid, momentum, position, time and weight of the particles are saved with the event number and weight.\n";
+	optMap["PHASESPACE_RECORD"].help += "      By default the particles are killed at the boundary: the simulation is cut at the surface.\n";
+	optMap["PHASESPACE_RECORD"].help += "      Replay the file with -INPUT_GEN_FILE=\"phasespace, filename\".\n";
+	optMap["PHASESPACE_RECORD"].help += "      Example: -PHASESPACE_RECORD=\"dump.gprimary, shield_exit\"\n";
+	optMap["PHASESPACE_RECORD"].name = "Records the particles entering a volume";
+	optMap["PHASESPACE_RECORD"].type = 1;
+	optMap["PHASESPACE_RECORD"].ctgr = "generator";
+	optMap["PHASESPACE_RECORD"].argsJSONDescription  = "filename, volume, kill";
+	optMap["PHASESPACE_RECORD"].argsJSONTypes  = "S S S";
+
 	optMap["SHIFT_LUND_VERTEX"].args = "(0, 0, 0)cm";
 	optMap["SHIFT_LUND_VERTEX"].help = "Shift Generator File tracks vertices.\n";
 	optMap["SHIFT_LUND_VERTEX"].help += "      example: -SHIFT_LUND_VERTEX=\"(0, 0, -3)cm\" \n";
@@ -148,6 +176,18 @@ void goptions::setGoptions()
 	optMap["MERGE_BGHITS"].argsJSONDescription  = "bgfilename";
 	optMap["MERGE_BGHITS"].argsJSONTypes  = "S";
 
+	optMap["MIX_STEP_RECORD"].args  = "no";
+	optMap["MIX_STEP_RECORD"].help  = "Overlays the hits of background events saved with STEP_RECORD to each event, before the digitization.\n";
+	optMap["MIX_STEP_RECORD"].help += "      The background events are selected sequentially or randomly and shifted in time by a random amount in [tmin, tmax].\n";
+	optMap["MIX_STEP_RECORD"].help += "      The last (optional) argument is the number of background events overlaid to each event (default 1).\n";
+	optMap["MIX_STEP_RECORD"].help += "      Usage: -MIX_STEP_RECORD=\"filename, sequential|random, tmin, tmax, (events per signal event)\"\n";
+	optMap["MIX_STEP_RECORD"].help += "      example: -MIX_STEP_RECORD=\"background_steps.dat, random, -250*ns, 250*ns, 1\" \n";
+	optMap["MIX_STEP_RECORD"].name  = "Overlays background events saved with STEP_RECORD";
+	optMap["MIX_STEP_RECORD"].type  = 1;
+	optMap["MIX_STEP_RECORD"].ctgr  = "generator";
+	optMap["MIX_STEP_RECORD"].argsJSONDescription  = "filename selection tmin tmax nevents";
+	optMap["MIX_STEP_RECORD"].argsJSONTypes  = "S S F F F";
+
 	optMap["NGENP"].arg  = 10;
 	optMap["NGENP"].help = "Max Number of Generated Particles to save in the Output.";
 	optMap["NGENP"].name = "Max Number of Generated Particles to save in the Output";
@@ -217,6 +257,21 @@ void goptions::setGoptions()
 	optMap["COSMICAREA"].ctgr = "generator";
 	optMap["COSMICAREA"].argsJSONDescription  = "x, y, z, radius";
 	optMap["COSMICAREA"].argsJSONTypes  = "F F F F";
+
+	optMap["COSMIC_TARGETS"].args = "no";
+	optMap["COSMIC_TARGETS"].help = "Cosmic rays biased to detector volumes. Comma separated list of volume names.\n";
+	optMap["COSMIC_TARGETS"].help += "      Only trajectories crossing the bounding spheres of the volumes are generated: the crossing point\n";
+	optMap["COSMIC_TARGETS"].help += "      is sampled on their projected area, the direction and momentum from the COSMICRAYS model.\n";
+	optMap["COSMIC_TARGETS"].help += "      Each event has a relative weight in the header bank: the projected area of the spheres in cm2,\n";
+	optMap["COSMIC_TARGETS"].help += "      divided by the number of spheres crossed. The COSMICRAYS models are not normalized:\n";
+	optMap["COSMIC_TARGETS"].help += "      the weights compare rates between volumes or runs, they are not absolute rates.\n";
+	optMap["COSMIC_TARGETS"].help += "      The trajectories start 2 COSMICAREA radii before the first sphere they cross.\n";
+	optMap["COSMIC_TARGETS"].help += "      Example: -COSMIC_TARGETS=\"crystal, veto_top\"\n";
+	optMap["COSMIC_TARGETS"].name = "Cosmic rays biased to detector volumes";
+	optMap["COSMIC_TARGETS"].type = 1;
+	optMap["COSMIC_TARGETS"].ctgr = "generator";
+	optMap["COSMIC_TARGETS"].argsJSONDescription  = "volumes";
+	optMap["COSMIC_TARGETS"].argsJSONTypes  = "S";
 	//
 	//
 	//
@@ -238,6 +293,29 @@ void goptions::setGoptions()
 	optMap["LUMI_EVENT"].argsJSONDescription  = "nparticles, timeWindow, bunchTime";
 	optMap["LUMI_EVENT"].argsJSONTypes  = "S F F";
 
+	optMap["LUMI_BUNCH_RECORD"].args = "no";
+	optMap["LUMI_BUNCH_RECORD"].help = "Records a luminosity bunch library: \"filename, boundary volume\".\n";
+	optMap["LUMI_BUNCH_RECORD"].help += "            Each event is one bunch: use -LUMI_EVENT=\"particles per bunch, TBUNCH, TBUNCH\".\n";
+	optMap["LUMI_BUNCH_RECORD"].help += "            The particles entering the boundary volume are saved (pid, momentum, position, time) and killed.\n";
+	optMap["LUMI_BUNCH_RECORD"].help += "            Example: -LUMI_BUNCH_RECORD=\"bunches.gprimary, target_boundary\"\n";
+	optMap["LUMI_BUNCH_RECORD"].name = "Records a luminosity bunch library";
+	optMap["LUMI_BUNCH_RECORD"].type = 1;
+	optMap["LUMI_BUNCH_RECORD"].ctgr = "luminosity";
+	optMap["LUMI_BUNCH_RECORD"].argsJSONDescription  = "filename, volume";
+	optMap["LUMI_BUNCH_RECORD"].argsJSONTypes  = "S S";
+
+	optMap["LUMI_BUNCH_LIBRARY"].args = "no";
+	optMap["LUMI_BUNCH_LIBRARY"].help = "Luminosity bunch library recorded with LUMI_BUNCH_RECORD.\n";
+	optMap["LUMI_BUNCH_LIBRARY"].help += "            Replaces the LUMI_EVENT particles: each of the LUMI_EVENT TWINDOW/TBUNCH bunches is drawn at random\n";
+	optMap["LUMI_BUNCH_LIBRARY"].help += "            from the library, its particles start at the boundary, delayed by the bunch time.\n";
+	optMap["LUMI_BUNCH_LIBRARY"].help += "            The number of particles of LUMI_EVENT is ignored: the bunches have the particles of the recording run.\n";
+	optMap["LUMI_BUNCH_LIBRARY"].help += "            Example: -LUMI_BUNCH_LIBRARY=\"bunches.gprimary\" -LUMI_EVENT=\"0, 250*ns, 4*ns\"\n";
+	optMap["LUMI_BUNCH_LIBRARY"].name = "Luminosity bunch library";
+	optMap["LUMI_BUNCH_LIBRARY"].type = 1;
+	optMap["LUMI_BUNCH_LIBRARY"].ctgr = "luminosity";
+	optMap["LUMI_BUNCH_LIBRARY"].argsJSONDescription  = "filename";
+	optMap["LUMI_BUNCH_LIBRARY"].argsJSONTypes  = "S";
+
 	optMap["LUMI_P"].args  = "e-, 11*GeV, 0*deg, 0*deg";
 	optMap["LUMI_P"].help  = "Luminosity Particle, momentum, angles (in respect of z-axis). \n";
 	optMap["LUMI_P"].help += "            Example: -LUMI_P=\"proton, 1*GeV, 25*deg, 2*deg\" sets 1 GeV protons, 25 degrees in theta, 2 degrees in phi. \n";
@@ -702,6 +780,30 @@ void goptions::setGoptions()
 	optMap["OUTPUT"].type = 1;
 	optMap["OUTPUT"].ctgr = "output";
 	
+	optMap["OUTPUT_COMPRESSION"].args  = "no";
+	optMap["OUTPUT_COMPRESSION"].help  = "Compresses the output (any type) while writing. The events are grouped in blocks, compressed on worker threads.\n";
+	optMap["OUTPUT_COMPRESSION"].help += "      Each block is a gzip member: the file can be read with gunzip or zcat.\n";
+	optMap["OUTPUT_COMPRESSION"].help += "      The index <output filename>.idx lists the offsets and the events of each block, to read an event range only.\n";
+	optMap["OUTPUT_COMPRESSION"].help += "      Usage: -OUTPUT_COMPRESSION=\"zlib, level (1-9), block size in MB, number of threads\"\n";
+	optMap["OUTPUT_COMPRESSION"].help += "      Example: -OUTPUT_COMPRESSION=\"zlib, 6, 4, 2\" \n";
+	optMap["OUTPUT_COMPRESSION"].name  = "Compresses the output while writing";
+	optMap["OUTPUT_COMPRESSION"].type  = 1;
+	optMap["OUTPUT_COMPRESSION"].ctgr  = "output";
+	optMap["OUTPUT_COMPRESSION"].argsJSONDescription  = "algorithm level blockSize nthreads";
+	optMap["OUTPUT_COMPRESSION"].argsJSONTypes  = "S F F F";
+
+	optMap["OUTPUT_SPLIT"].args  = "no";
+	optMap["OUTPUT_SPLIT"].help  = "Rolls over to a new output file after a number of events or a size in MB (0: no limit).\n";
+	optMap["OUTPUT_SPLIT"].help += "      The files are named <name>.0001.<extension>, <name>.0002.<extension>, ... and each one starts with the simulation conditions.\n";
+	optMap["OUTPUT_SPLIT"].help += "      <output filename>.ranges lists the event range of each file once it is closed.\n";
+	optMap["OUTPUT_SPLIT"].help += "      Usage: -OUTPUT_SPLIT=\"number of events, size in MB\"\n";
+	optMap["OUTPUT_SPLIT"].help += "      Example: -OUTPUT_SPLIT=\"100000, 0\" \n";
+	optMap["OUTPUT_SPLIT"].name  = "Rolls over to a new output file after a number of events or MB";
+	optMap["OUTPUT_SPLIT"].type  = 1;
+	optMap["OUTPUT_SPLIT"].ctgr  = "output";
+	optMap["OUTPUT_SPLIT"].argsJSONDescription  = "nevents sizeMB";
+	optMap["OUTPUT_SPLIT"].argsJSONTypes  = "F F";
+
 	optMap["INTEGRATEDRAW"].args = "no";
 	optMap["INTEGRATEDRAW"].help = "Activates integrated geant4 raw output for system(s). Example: -INTEGRATEDRAW=\"DC, TOF\"";
 	optMap["INTEGRATEDRAW"].name = "Activates integrated geant4 raw output for system(s)";
@@ -732,6 +834,20 @@ void goptions::setGoptions()
 	optMap["ELECTRONICNOISE"].type = 1;
 	optMap["ELECTRONICNOISE"].ctgr = "output";
 
+	optMap["NOISE_ENGINE"].args  = "no";
+	optMap["NOISE_ENGINE"].help  = "Injects random electronic noise hits in a system. The hits are digitized by the system hit process.\n";
+	optMap["NOISE_ENGINE"].help += "      A noise hit in a channel that already has a hit, within the time window, is added to that hit.\n";
+	optMap["NOISE_ENGINE"].help += "      The channels are all the combinations of the identifier ranges. The number of noise hits in each event\n";
+	optMap["NOISE_ENGINE"].help += "      is poisson distributed with mean: number of channels * rate * (tmax - tmin).\n";
+	optMap["NOISE_ENGINE"].help += "      Pedestal noise, dark counts and random hits can be defined as separate sources.\n";
+	optMap["NOISE_ENGINE"].help += "      Usage:\n";
+	optMap["NOISE_ENGINE"].help += "      -NOISE_ENGINE=\"system, rate per channel, tmin, tmax, edep, edep sigma, pid, id1 min max, id2 min max, ...\"\n";
+	optMap["NOISE_ENGINE"].help += "      Example: -NOISE_ENGINE=\"ctof, 2*kHz, -100*ns, 400*ns, 0.5*MeV, 0.2*MeV, 0, paddle 1 48, side 1 2\"\n";
+	optMap["NOISE_ENGINE"].name  = "Injects random electronic noise hits in a system";
+	optMap["NOISE_ENGINE"].type  = 1;
+	optMap["NOISE_ENGINE"].ctgr  = "output";
+	optMap["NOISE_ENGINE"].repe  = 1;
+
 	optMap["VTRESOLUTION"].arg = 0.1;
 	optMap["VTRESOLUTION"].help = "Voltage versus time resolution, in ns";
 	optMap["VTRESOLUTION"].name = "Voltage versus time resolution, in ns.";
@@ -758,6 +874,78 @@ void goptions::setGoptions()
 	optMap["FILTER_HADRONS"].type = 0;
 	optMap["FILTER_HADRONS"].ctgr = "output";
 
+	// compiled event selection
+	optMap["EVENT_FILTER"].args = "no";
+	optMap["EVENT_FILTER"].help = "Selection expression evaluated at the end of each event, before digitization.\n";
+	optMap["EVENT_FILTER"].help += "      Events where the expression is false are not digitized nor written.\n";
+	optMap["EVENT_FILTER"].help += "      Functions: nhits(system), edep(system), nids(system, identifier),\n";
+	optMap["EVENT_FILTER"].help += "      coinc(system1, system2, identifier), ngen(pid), pmax(pid), thetamin(pid), thetamax(pid),\n";
+	optMap["EVENT_FILTER"].help += "      count(condition) (see GENERATOR_FILTER), abs(x).\n";
+	optMap["EVENT_FILTER"].help += "      pid 0 selects all generated particles. Units: eV keV MeV GeV mm cm m ns deg rad mrad.\n";
+	optMap["EVENT_FILTER"].help += "      Operators: + - * / < <= > >= == != && || ! ( )\n";
+	optMap["EVENT_FILTER"].help += "      Example: -EVENT_FILTER=\"nhits(ec) > 2 && coinc(ftof, ec, sector) >= 1 && pmax(11) > 2*GeV\"\n";
+	optMap["EVENT_FILTER"].name = "Event selection expression";
+	optMap["EVENT_FILTER"].type = 1;
+	optMap["EVENT_FILTER"].ctgr = "output";
+
+	optMap["GENERATOR_FILTER"].args = "no";
+	optMap["GENERATOR_FILTER"].help = "Selection expression evaluated on the generated particles, before tracking.\n";
+	optMap["GENERATOR_FILTER"].help += "      Events where the expression is false are not tracked: a new event is generated instead.\n";
+	optMap["GENERATOR_FILTER"].help += "      Same syntax as EVENT_FILTER, without the hit functions. count(condition) is the number of\n";
+	optMap["GENERATOR_FILTER"].help += "      generated particles satisfying the condition, an expression of the particle variables\n";
+	optMap["GENERATOR_FILTER"].help += "      pid, p, px, py, pz, ekin, theta, phi, vx, vy, vz, vr, t. abs(x) is the absolute value.\n";
+	optMap["GENERATOR_FILTER"].help += "      The generated and accepted events are written in the header bank (ngenerated, naccepted)\n";
+	optMap["GENERATOR_FILTER"].help += "      and in the run summary, for the normalization.\n";
+	optMap["GENERATOR_FILTER"].help += "      Example: -GENERATOR_FILTER=\"count(pid == 11 && p > 1*GeV && theta > 2.5*deg && theta < 4.5*deg) >= 1 || count(pid == 2212 && abs(vz) < 5*cm) > 0\"\n";
+	optMap["GENERATOR_FILTER"].name = "Generator level selection expression";
+	optMap["GENERATOR_FILTER"].type = 1;
+	optMap["GENERATOR_FILTER"].ctgr = "generator";
+
+	// scorers: quantities accumulated in memory and written at the end of the run, without hit output
+	optMap["SCORING_MESH"].args = "no";
+	optMap["SCORING_MESH"].help = "Scorer on a 3D mesh in the lab frame: \"name, quantity, nx, ny, nz, xmin, xmax, ymin, ymax, zmin, zmax\".\n";
+	optMap["SCORING_MESH"].help += "      Quantities: flux (track length fluence), edep, dose, neq (1 MeV neutron equivalent fluence, see SCORING_NEQ).\n";
+	optMap["SCORING_MESH"].help += "      The results are binned by particle type and kinetic energy (SCORING_EBINS) and written in SCORING_OUTPUT.\n";
+	optMap["SCORING_MESH"].help += "      Example: -SCORING_MESH=\"hall_neutrons, flux, 50, 50, 100, -5*m, 5*m, -5*m, 5*m, -2*m, 18*m\"\n";
+	optMap["SCORING_MESH"].name = "Scorer on a 3D mesh";
+	optMap["SCORING_MESH"].type = 1;
+	optMap["SCORING_MESH"].ctgr = "output";
+	optMap["SCORING_MESH"].repe = 1;
+
+	optMap["SCORING_VOLUME"].args = "no";
+	optMap["SCORING_VOLUME"].help = "Scorer on physical volumes: \"name, quantity, volume1 volume2 ...\".\n";
+	optMap["SCORING_VOLUME"].help += "      Quantities: flux, edep, dose, neq. Each volume is a bin, including all its copies.\n";
+	optMap["SCORING_VOLUME"].help += "      Example: -SCORING_VOLUME=\"electronics, dose, svt_crate ft_crate\"\n";
+	optMap["SCORING_VOLUME"].name = "Scorer on physical volumes";
+	optMap["SCORING_VOLUME"].type = 1;
+	optMap["SCORING_VOLUME"].ctgr = "output";
+	optMap["SCORING_VOLUME"].repe = 1;
+
+	optMap["SCORING_EBINS"].args = "no";
+	optMap["SCORING_EBINS"].help = "Kinetic energy bins of the scorers, logarithmic: \"nbins, emin, emax\".\n";
+	optMap["SCORING_EBINS"].help += "      Steps of particles outside the energy range are not scored. Default: no energy binning.\n";
+	optMap["SCORING_EBINS"].help += "      Example: -SCORING_EBINS=\"60, 1*eV, 10*GeV\"\n";
+	optMap["SCORING_EBINS"].name = "Kinetic energy bins of the scorers";
+	optMap["SCORING_EBINS"].type = 1;
+	optMap["SCORING_EBINS"].ctgr = "output";
+
+	optMap["SCORING_NEQ"].args = "no";
+	optMap["SCORING_NEQ"].help = "Damage function of a particle type for the neq scorers: \"particle type, filename\".\n";
+	optMap["SCORING_NEQ"].help += "      Particle types: gamma, electron, neutron, proton, pion, muon, other.\n";
+	optMap["SCORING_NEQ"].help += "      The file has two columns: kinetic energy (MeV) and displacement damage relative to 1 MeV neutrons.\n";
+	optMap["SCORING_NEQ"].help += "      Example: -SCORING_NEQ=\"neutron, neutrons_si_damage.txt\"\n";
+	optMap["SCORING_NEQ"].name = "Damage function for the neq scorers";
+	optMap["SCORING_NEQ"].type = 1;
+	optMap["SCORING_NEQ"].ctgr = "output";
+	optMap["SCORING_NEQ"].repe = 1;
+
+	optMap["SCORING_OUTPUT"].args = "scoring.txt, 0";
+	optMap["SCORING_OUTPUT"].help = "Output of the scorers: \"filename, N\". The file is written at the end of the run and,\n";
+	optMap["SCORING_OUTPUT"].help += "      if N > 0, every N events. Each non empty bin has the mean per event and its statistical error.\n";
+	optMap["SCORING_OUTPUT"].name = "Output of the scorers";
+	optMap["SCORING_OUTPUT"].type = 1;
+	optMap["SCORING_OUTPUT"].ctgr = "output";
+
 	// sampling time of electronics (typically FADC), and number of sampling / event
 	// the VT output is sampled every TSAMPLING nanoseconds to produce a ADC
 	// the default number of samples is 500 ADC points, at 4ns intervals (total electronic event time = 2 microseconds)
@@ -767,6 +955,18 @@ void goptions::setGoptions()
 	optMap["TSAMPLING"].type = 1;
 	optMap["TSAMPLING"].ctgr = "output";
 
+	// FADC banks: full waveforms, zero suppressed waveforms or pulses
+	optMap["FADC_MODE"].args = "full";
+	optMap["FADC_MODE"].help = "FADC banks written in the evio output: mode, threshold, NSB, NSA.\n";
+	optMap["FADC_MODE"].help += "      full:  mode 1 waveforms of all channels (default).\n";
+	optMap["FADC_MODE"].help += "      zs:    mode 1 waveforms of the channels with a sample above pedestal + threshold.\n";
+	optMap["FADC_MODE"].help += "      pulse: mode 7 pulses: time, integral from NSB ns before to NSA ns after the threshold crossing, min and max.\n";
+	optMap["FADC_MODE"].help += "      The threshold is in ADC counts above the pedestal. Defaults: 20, 12 ns, 36 ns.\n";
+	optMap["FADC_MODE"].help += "      Example: -FADC_MODE=\"pulse, 20, 12, 36\"\n";
+	optMap["FADC_MODE"].name = "FADC banks mode";
+	optMap["FADC_MODE"].type = 1;
+	optMap["FADC_MODE"].ctgr = "output";
+
 	// Activates RNG saving for selected events
 	optMap["SAVE_SELECTED"].args  = "";
 	optMap["SAVE_SELECTED"].help  = "Save events with selected hit types\n";
@@ -783,7 +983,40 @@ void goptions::setGoptions()
 	optMap["RERUN_SELECTED"].name  = "Rerun saved events";
 	optMap["RERUN_SELECTED"].type  = 1;
 	optMap["RERUN_SELECTED"].ctgr  = "control";
-	
+
+	// Saves the hits step by step so they can be digitized again
+	optMap["STEP_RECORD"].args = "no";
+	optMap["STEP_RECORD"].help = "Saves the hits step arrays, identifiers and volumes to a binary file that can be digitized again with DIGITIZE_ONLY.\n";
+	optMap["STEP_RECORD"].help += "      example: -STEP_RECORD=\"steps.dat\" \n";
+	optMap["STEP_RECORD"].name = "Binary file to save the hits step arrays";
+	optMap["STEP_RECORD"].type = 1;
+	optMap["STEP_RECORD"].ctgr = "output";
+	optMap["STEP_RECORD"].argsJSONDescription  = "stepfilename";
+	optMap["STEP_RECORD"].argsJSONTypes  = "S";
+
+	// Digitization worker threads
+	optMap["DIGITIZATION_THREADS"].arg  = 1;
+	optMap["DIGITIZATION_THREADS"].help = "Number of threads digitizing the sensitive detectors at the end of each event.\n";
+	optMap["DIGITIZATION_THREADS"].help += "      Each detector is digitized by one task with its own random seed; the banks are written in the same order as with one thread.\n";
+	optMap["DIGITIZATION_THREADS"].help += "      Requires a multithreaded geant4 build. Example: -DIGITIZATION_THREADS=8 \n";
+	optMap["DIGITIZATION_THREADS"].name = "Number of threads digitizing the sensitive detectors";
+	optMap["DIGITIZATION_THREADS"].type = 0;
+	optMap["DIGITIZATION_THREADS"].ctgr = "output";
+	optMap["DIGITIZATION_THREADS"].argsJSONDescription  = "nthreads";
+	optMap["DIGITIZATION_THREADS"].argsJSONTypes  = "F";
+
+	// Digitizes a step record, no geometry or tracking
+	optMap["DIGITIZE_ONLY"].args = "no";
+	optMap["DIGITIZE_ONLY"].help = "Reads the hits from a STEP_RECORD file and runs only the digitization and the output.\n";
+	optMap["DIGITIZE_ONLY"].help += "      The geometry is not built and no particle is tracked. The detectors and banks are still loaded to match the hits.\n";
+	optMap["DIGITIZE_ONLY"].help += "      The header, RF, generated particles (with their user infos) and ancestors banks are written from the record.\n";
+	optMap["DIGITIZE_ONLY"].help += "      example: -DIGITIZE_ONLY=\"steps.dat\" \n";
+	optMap["DIGITIZE_ONLY"].name = "Digitizes the hits from a STEP_RECORD file";
+	optMap["DIGITIZE_ONLY"].type = 1;
+	optMap["DIGITIZE_ONLY"].ctgr = "control";
+	optMap["DIGITIZE_ONLY"].argsJSONDescription  = "stepfilename";
+	optMap["DIGITIZE_ONLY"].argsJSONTypes  = "S";
+
 
 
 
@@ -968,7 +1201,9 @@ void goptions::setGoptions()
 	optMap["FIELD_PROPERTIES"].help += "       - G4HelixImplicitEuler: Second order, specialized for helix-like trajectories.\n";
 	optMap["FIELD_PROPERTIES"].help += "       - G4HelixExplicitEuler: First order, specialized for helix-like trajectories.\n";
 	optMap["FIELD_PROPERTIES"].help += "       - G4HelixSimpleRunge: Second order Range Kutta, specialized for helix-like trajectories.\n";
-	optMap["FIELD_PROPERTIES"].help += "       - G4NystromRK4: provides accuracy near that of G4ClassicalRK4 with a significantly reduced cost in field evaluation.\n\n";
+	optMap["FIELD_PROPERTIES"].help += "       - G4NystromRK4: provides accuracy near that of G4ClassicalRK4 with a significantly reduced cost in field evaluation.\n";
+	optMap["FIELD_PROPERTIES"].help += "       - G4DormandPrince745: Fifth order embedded error stepper, fewer field calls than G4ClassicalRK4 for the same accuracy.\n";
+	optMap["FIELD_PROPERTIES"].help += "       - G4BogackiShampine45: Fifth order embedded error stepper.\n\n";
 	optMap["FIELD_PROPERTIES"].help += "       Available Interpolation Methods:\n";
 	optMap["FIELD_PROPERTIES"].help += "       - none: closest grid point.\n";
 	optMap["FIELD_PROPERTIES"].help += "       - linear: linear interpolation.\n\n";
@@ -978,6 +1213,56 @@ void goptions::setGoptions()
 	optMap["FIELD_PROPERTIES"].ctgr  = "fields";
 	optMap["FIELD_PROPERTIES"].repe  = 1;
 
+	optMap["FIELD_INTEGRATION"].args  = "no";
+	optMap["FIELD_INTEGRATION"].help  = "Integration driver and accuracy parameters of a field\n\n";
+	optMap["FIELD_INTEGRATION"].help += "      Usage:\n";
+	optMap["FIELD_INTEGRATION"].help += "      -FIELD_INTEGRATION=\"fieldname, driver, deltaChord, deltaOneStep, deltaIntersection, minEpsilon, maxEpsilon\"\n\n";
+	optMap["FIELD_INTEGRATION"].help += "      Example: -FIELD_INTEGRATION=\"clas12-torus-big, G4InterpolationDriver, 0.25*mm, 0.01*mm, 0.01*mm, 1e-5, 1e-3\"\n\n";
+	optMap["FIELD_INTEGRATION"].help += "      Available drivers:\n";
+	optMap["FIELD_INTEGRATION"].help += "       - default: geant4 default driver with the FIELD_PROPERTIES stepper.\n";
+	optMap["FIELD_INTEGRATION"].help += "       - G4FSALIntegrationDriver: G4DormandPrince745 reusing the last stage of each step (geant4 10.7 or later).\n";
+	optMap["FIELD_INTEGRATION"].help += "       - G4InterpolationDriver: G4DormandPrince745 with dense output interpolation (geant4 10.7 or later).\n\n";
+	optMap["FIELD_INTEGRATION"].help += "      A value of zero keeps the default of the parameter.\n";
+	optMap["FIELD_INTEGRATION"].name  = "Integration driver and accuracy parameters of a field";
+	optMap["FIELD_INTEGRATION"].type  = 1;
+	optMap["FIELD_INTEGRATION"].ctgr  = "fields";
+	optMap["FIELD_INTEGRATION"].repe  = 1;
+
+	optMap["FIELD_ZERO_MASK"].args  = "no";
+	optMap["FIELD_ZERO_MASK"].help  = "Zero field mask of a mapped field. At load time the map is divided in blocks of cells:\n";
+	optMap["FIELD_ZERO_MASK"].help += "      the field is zero, without interpolation, in the blocks where it is below the threshold.\n";
+	optMap["FIELD_ZERO_MASK"].help += "      Usage:\n";
+	optMap["FIELD_ZERO_MASK"].help += "      -FIELD_ZERO_MASK=\"fieldname, threshold, (cells per block, default 4)\"\n";
+	optMap["FIELD_ZERO_MASK"].help += "      Example: -FIELD_ZERO_MASK=\"clas12-torus-big, 0.5*gauss, 4\"\n";
+	optMap["FIELD_ZERO_MASK"].name  = "Zero field mask of a mapped field";
+	optMap["FIELD_ZERO_MASK"].type  = 1;
+	optMap["FIELD_ZERO_MASK"].ctgr  = "fields";
+	optMap["FIELD_ZERO_MASK"].repe  = 1;
+
+	optMap["COMPOSITE_FIELD"].args  = "no";
+	optMap["COMPOSITE_FIELD"].help  = "Defines a field as the sum of other fields. Volumes can use it as any other field.\n";
+	optMap["COMPOSITE_FIELD"].help += "      The components scale factors can be changed at run time with:\n";
+	optMap["COMPOSITE_FIELD"].help += "      /gemc/field/<composite name>/scale \"component factor\"\n";
+	optMap["COMPOSITE_FIELD"].help += "      Usage:\n";
+	optMap["COMPOSITE_FIELD"].help += "      -COMPOSITE_FIELD=\"name, field1, field2, ...\"\n";
+	optMap["COMPOSITE_FIELD"].help += "      Example: -COMPOSITE_FIELD=\"clas12-fields, clas12-torus-big, clas12-solenoid\"\n";
+	optMap["COMPOSITE_FIELD"].name  = "Defines a field as the sum of other fields";
+	optMap["COMPOSITE_FIELD"].type  = 1;
+	optMap["COMPOSITE_FIELD"].ctgr  = "fields";
+	optMap["COMPOSITE_FIELD"].repe  = 1;
+
+	optMap["COMPOSITE_FIELD_BOX"].args  = "no";
+	optMap["COMPOSITE_FIELD_BOX"].help  = "Bounding box and threshold of a composite field component.\n";
+	optMap["COMPOSITE_FIELD_BOX"].help += "      The component is not queried outside the box.\n";
+	optMap["COMPOSITE_FIELD_BOX"].help += "      With the (optional) threshold, the box is shrunk at startup to the region where the component magnitude is above the threshold.\n";
+	optMap["COMPOSITE_FIELD_BOX"].help += "      Usage:\n";
+	optMap["COMPOSITE_FIELD_BOX"].help += "      -COMPOSITE_FIELD_BOX=\"composite, component, xmin, xmax, ymin, ymax, zmin, zmax, (threshold)\"\n";
+	optMap["COMPOSITE_FIELD_BOX"].help += "      Example: -COMPOSITE_FIELD_BOX=\"clas12-fields, clas12-solenoid, -1*m, 1*m, -1*m, 1*m, -1.5*m, 1.5*m, 1*gauss\"\n";
+	optMap["COMPOSITE_FIELD_BOX"].name  = "Bounding box and threshold of a composite field component";
+	optMap["COMPOSITE_FIELD_BOX"].type  = 1;
+	optMap["COMPOSITE_FIELD_BOX"].ctgr  = "fields";
+	optMap["COMPOSITE_FIELD_BOX"].repe  = 1;
+
 	optMap["FIELDS_FILENAMES"].args  = "none";
 	optMap["FIELDS_FILENAMES"].help  = "List of activated fields\n";
 	optMap["FIELDS_FILENAMES"].name  = "List of activated fields";
@@ -0,0 +1,137 @@
+// G4 headers
+#include "G4Track.hh"
+#include "Randomize.hh"
+
+// gemc headers
+#include "lumiBunchLibrary.h"
+#include "string_utilities.h"
+
+// mlibrary
+#include "gstring.h"
+using namespace gstring;
+
+// C++ headers
+#include <iostream>
+#include <cstdlib>
+using namespace std;
+
+// CLHEP units
+#include "CLHEP/Units/PhysicalConstants.h"
+using namespace CLHEP;
+
+#define LUMI_BUNCH_COLUMNS 8
+
+
+lumiBunchRecorder::lumiBunchRecorder(goptions gemcOpt)
+{
+	hd_msg = gemcOpt.optMap["LOG_MSG"].args + " Luminosity Bunch Library: >> ";
+
+	library = nullptr;
+	nbunches = 0;
+	nparticles = 0;
+
+	vector<string> pars = getStringVectorFromStringWithDelimiter(gemcOpt.optMap["LUMI_BUNCH_RECORD"].args, ",");
+	if(pars.size() < 2) {
+		cout << hd_msg << " !!! Error: LUMI_BUNCH_RECORD should be \"filename, boundary volume\". Exiting." << endl;
+		exit(1);
+	}
+	boundary = new volumeBoundary(trimSpacesFromString(pars[1]));
+
+	library = new primaryEventFile(trimSpacesFromString(pars[0]), "w", PRIMARY_FORMAT_BUNCH);
+	if(!library->isGood()) {
+		cout << hd_msg << " !!! Error: can't open " << trimSpacesFromString(pars[0]) << ". Exiting." << endl;
+		exit(1);
+	}
+
+	cout << hd_msg << " Recording the particles entering " << boundary->name << " in " << trimSpacesFromString(pars[0]) << endl;
+}
+
+lumiBunchRecorder::~lumiBunchRecorder()
+{
+	if(library != nullptr) {
+		library->close();
+		delete library;
+		cout << hd_msg << " " << nbunches << " bunches, " << nparticles << " particles recorded." << endl;
+	}
+	delete boundary;
+}
+
+bool lumiBunchRecorder::record(const G4Step *aStep)
+{
+	if(!boundary->entering(aStep)) return false;
+
+	const G4StepPoint *post = aStep->GetPostStepPoint();
+	G4ThreeVector p = post->GetMomentum();
+	G4ThreeVector v = post->GetPosition();
+	double values[LUMI_BUNCH_COLUMNS] = {(double) aStep->GetTrack()->GetDefinition()->GetPDGEncoding(),
+	                                     p.x()/MeV, p.y()/MeV, p.z()/MeV, v.x()/mm, v.y()/mm, v.z()/mm, post->GetGlobalTime()/ns};
+	bunch.particles.push_back(vector<double>(values, values + LUMI_BUNCH_COLUMNS));
+
+	return true;
+}
+
+void lumiBunchRecorder::endBunch()
+{
+	bunch.header.assign(1, bunch.particles.size());
+	library->writeEvent(bunch);
+
+	nbunches++;
+	nparticles += bunch.particles.size();
+
+	bunch.particles.clear();
+}
+
+
+lumiBunchLibrary::lumiBunchLibrary(goptions gemcOpt)
+{
+	string hd_msg = gemcOpt.optMap["LOG_MSG"].args + " Luminosity Bunch Library: >> ";
+	string filename = trimSpacesFromString(gemcOpt.optMap["LUMI_BUNCH_LIBRARY"].args);
+
+	primaryEventFile library(filename, "r");
+	if(!library.isGood() || library.sourceFormat() != PRIMARY_FORMAT_BUNCH) {
+		cout << hd_msg << " !!! Error: " << filename << " is not a luminosity bunch library. Exiting." << endl;
+		exit(1);
+	}
+
+	long nparticles = 0;
+	long nshort = 0;
+	primaryEvent record;
+	while(library.readEvent(record)) {
+		vector<lumiBunchParticle> bunch;
+		bunch.reserve(record.particles.size());
+		for(auto &c: record.particles) {
+			// rows with missing columns are dropped
+			if(c.size() < LUMI_BUNCH_COLUMNS) {
+				nshort++;
+				continue;
+			}
+			lumiBunchParticle particle;
+			particle.pid  = (int) c[0];
+			particle.p    = G4ThreeVector(c[1]*MeV, c[2]*MeV, c[3]*MeV);
+			particle.v    = G4ThreeVector(c[4]*mm,  c[5]*mm,  c[6]*mm);
+			particle.time = c[7]*ns;
+			bunch.push_back(particle);
+		}
+		nparticles += bunch.size();
+		bunches.push_back(bunch);
+	}
+
+	if(nshort > 0)
+		cout << hd_msg << " Warning: " << nshort << " particles of " << filename << " have less than "
+		     << LUMI_BUNCH_COLUMNS << " columns and were dropped." << endl;
+
+	if(bunches.empty()) {
+		cout << hd_msg << " !!! Error: no bunches in " << filename << ". Exiting." << endl;
+		exit(1);
+	}
+
+	cout << hd_msg << " " << bunches.size() << " bunches loaded from " << filename << ", "
+	     << (double) nparticles/bunches.size() << " particles per bunch." << endl;
+}
+
+const vector<lumiBunchParticle>& lumiBunchLibrary::randomBunch() const
+{
+	unsigned long index = (unsigned long) (G4UniformRand()*bunches.size());
+	if(index >= bunches.size()) index = bunches.size() - 1;
+	return bunches[index];
+}
@@ -0,0 +1,94 @@
+/// \file lumiBunchLibrary.h
+/// Defines the luminosity bunch library.\n
+/// Recording (LUMI_BUNCH_RECORD): each event of a luminosity only run is one bunch.
+/// The particles entering the boundary volume are recorded and killed, so that
+/// nothing is tracked beyond the boundary. At the end of the event the bunch,
+/// possibly empty, is written to the library file.\n
+/// Replay (LUMI_BUNCH_LIBRARY): the library is loaded in memory. Each of the
+/// TWINDOW/TBUNCH bunches of an event is drawn at random from the library and
+/// its particles are shot from the boundary, delayed by the bunch time, so the
+/// beam interactions inside the boundary are not tracked again in every event.\n
+/// The library is a gprimary file (see primaryEventFile.h) with one record per bunch
+/// and the columns: pid, px, py, pz, vx, vy, vz, time (MeV, mm, ns).
+/// \author \n Maurizio Ungaro
+/// \author mail: ungaro@jlab.org\n\n\n
+#ifndef LUMI_BUNCH_LIBRARY_H
+#define LUMI_BUNCH_LIBRARY_H 1
+
+// G4 headers
+#include "G4ThreeVector.hh"
+#include "G4Step.hh"
+
+// gemc headers
+#include "options.h"
+#include "primaryEventFile.h"
+#include "phaseSpace.h"
+
+// C++ headers
+#include <string>
+#include <vector>
+using namespace std;
+
+
+/// \class lumiBunchParticle
+/// <b> lumiBunchParticle </b>\n\n
+/// Particle crossing the boundary: time is relative to the bunch
+class lumiBunchParticle
+{
+public:
+	lumiBunchParticle() : pid(0), p(0, 0, 0), v(0, 0, 0), time(0) {;}
+
+	int pid;
+	G4ThreeVector p;
+	G4ThreeVector v;
+	double time;
+};
+
+
+/// \class lumiBunchRecorder
+/// <b> lumiBunchRecorder </b>\n\n
+/// Usage: -LUMI_BUNCH_RECORD="filename, boundary volume"\n
+/// Run with a single bunch per event: -LUMI_EVENT="particles per bunch, TBUNCH, TBUNCH"
+class lumiBunchRecorder
+{
+public:
+	lumiBunchRecorder(goptions gemcOpt);
+	~lumiBunchRecorder();
+
+	// returns true if the step enters the boundary volume. The particle is added to the bunch
+	bool record(const G4Step *aStep);
+
+	// writes the current bunch
+	void endBunch();
+
+private:
+	string hd_msg;
+	volumeBoundary *boundary;
+
+	primaryEventFile *library;
+	primaryEvent bunch;
+	long nbunches;
+	long nparticles;
+};
+
+
+/// \class lumiBunchLibrary
+/// <b> lumiBunchLibrary </b>\n\n
+/// Usage: -LUMI_BUNCH_LIBRARY="filename"\n
+/// TWINDOW and TBUNCH are taken from LUMI_EVENT
+class lumiBunchLibrary
+{
+public:
+	lumiBunchLibrary(goptions gemcOpt);
+
+	unsigned size() const {return bunches.size();}
+
+	// random bunch of the library
+	const vector<lumiBunchParticle>& randomBunch() const;
+
+private:
+	vector<vector<lumiBunchParticle> > bunches;
+};
+
+
+#endif
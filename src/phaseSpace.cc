@@ -0,0 +1,105 @@
+// G4 headers
+#include "G4PhysicalVolumeStore.hh"
+#include "G4Track.hh"
+
+// gemc headers
+#include "phaseSpace.h"
+#include "string_utilities.h"
+
+// mlibrary
+#include "gstring.h"
+using namespace gstring;
+
+// C++ headers
+#include <iostream>
+#include <cstdlib>
+using namespace std;
+
+// CLHEP units
+#include "CLHEP/Units/PhysicalConstants.h"
+using namespace CLHEP;
+
+
+bool volumeBoundary::entering(const G4Step *aStep)
+{
+	if(!lookedUp) {
+		volume = G4PhysicalVolumeStore::GetInstance()->GetVolume(name, false);
+		lookedUp = true;
+		if(volume == nullptr)
+			cout << " !!! Warning: boundary volume " << name << " not found. No particle will be recorded." << endl;
+	}
+
+	const G4StepPoint *post = aStep->GetPostStepPoint();
+
+	return volume != nullptr && post->GetStepStatus() == fGeomBoundary && post->GetPhysicalVolume() == volume;
+}
+
+
+phaseSpaceRecorder::phaseSpaceRecorder(goptions gemcOpt)
+{
+	hd_msg = gemcOpt.optMap["LOG_MSG"].args + " Phase Space: >> ";
+
+	nevents    = 0;
+	nrecorded  = 0;
+	nparticles = 0;
+
+	vector<string> pars = getStringVectorFromStringWithDelimiter(gemcOpt.optMap["PHASESPACE_RECORD"].args, ",");
+	if(pars.size() < 2) {
+		cout << hd_msg << " !!! Error: PHASESPACE_RECORD should be \"filename, volume, (kill|keep)\". Exiting." << endl;
+		exit(1);
+	}
+
+	boundary = new volumeBoundary(trimSpacesFromString(pars[1]));
+	kill = pars.size() < 3 || trimSpacesFromString(pars[2]) != "keep";
+
+	output = new primaryEventFile(trimSpacesFromString(pars[0]), "w", PRIMARY_FORMAT_PHASESPACE);
+	if(!output->isGood()) {
+		cout << hd_msg << " !!! Error: can't open " << trimSpacesFromString(pars[0]) << ". Exiting." << endl;
+		exit(1);
+	}
+
+	cout << hd_msg << " Recording the particles entering " << boundary->name << " in " << trimSpacesFromString(pars[0])
+	     << (kill ? ". The particles are killed at the boundary." : ".") << endl;
+}
+
+phaseSpaceRecorder::~phaseSpaceRecorder()
+{
+	output->setSourceEvents(nevents);
+	output->close();
+	delete output;
+	delete boundary;
+
+	cout << hd_msg << " " << nparticles << " particles recorded in " << nrecorded << " of " << nevents << " events." << endl;
+}
+
+bool phaseSpaceRecorder::record(const G4Step *aStep)
+{
+	if(!boundary->entering(aStep)) return false;
+
+	const G4StepPoint *post = aStep->GetPostStepPoint();
+	G4ThreeVector p = post->GetMomentum();
+	G4ThreeVector v = post->GetPosition();
+
+	double values[PHASESPACE_COLUMNS] = {(double) aStep->GetTrack()->GetDefinition()->GetPDGEncoding(),
+	                                     p.x()/MeV, p.y()/MeV, p.z()/MeV, v.x()/mm, v.y()/mm, v.z()/mm,
+	                                     post->GetGlobalTime()/ns, aStep->GetTrack()->GetWeight()};
+	event.particles.push_back(vector<double>(values, values + PHASESPACE_COLUMNS));
+
+	return kill;
+}
+
+void phaseSpaceRecorder::endEvent(int evn, double eventWeight)
+{
+	nevents++;
+	if(event.particles.empty()) return;
+
+	event.header.resize(2);
+	event.header[0] = evn;
+	event.header[1] = eventWeight;
+	output->writeEvent(event);
+
+	nrecorded++;
+	nparticles += event.particles.size();
+
+	event.particles.clear();
+}
@@ -0,0 +1,80 @@
+/// \file phaseSpace.h
+/// Defines the phase space record of the particles crossing a volume boundary.\n
+/// Record (PHASESPACE_RECORD): every particle entering the named volume is saved with
+/// its pid, momentum, position, time and track weight. By default the particle is
+/// then killed, so the simulation is cut at the surface. The particles of each event
+/// are written at the end of the event, with the event number and the event weight;
+/// events with no crossing particles are not written.\n
+/// Replay (INPUT_GEN_FILE="phasespace, filename"): the recorded particles are the primaries,
+/// see PHASESPACE_REPLAY: each recorded event once, or events resampled at random with an
+/// optional random rotation around the z axis.\n
+/// The file is a gprimary file (see primaryEventFile.h) with one record per event,
+/// header: event number, event weight, and the columns: pid, px, py, pz, vx, vy, vz, time, weight (MeV, mm, ns).
+/// The number of events simulated, with or without crossing particles, is stored in the file header
+/// as the number of source events: it normalizes the replayed events.
+/// \author \n Maurizio Ungaro
+/// \author mail: ungaro@jlab.org\n\n\n
+#ifndef PHASE_SPACE_H
+#define PHASE_SPACE_H 1
+
+// G4 headers
+#include "G4Step.hh"
+#include "G4VPhysicalVolume.hh"
+
+// gemc headers
+#include "options.h"
+#include "primaryEventFile.h"
+
+// C++ headers
+#include <string>
+using namespace std;
+
+#define PHASESPACE_COLUMNS 9
+
+
+/// \class volumeBoundary
+/// <b> volumeBoundary </b>\n\n
+/// Steps entering a physical volume, found by name at the first step once the geometry is built
+class volumeBoundary
+{
+public:
+	volumeBoundary(string volumeName) : name(volumeName), volume(nullptr), lookedUp(false) {;}
+
+	bool entering(const G4Step *aStep);
+
+	string name;
+
+private:
+	G4VPhysicalVolume *volume;
+	bool lookedUp;
+};
+
+
+/// \class phaseSpaceRecorder
+/// <b> phaseSpaceRecorder </b>\n\n
+/// Usage: -PHASESPACE_RECORD="filename, volume, (kill|keep)"
+class phaseSpaceRecorder
+{
+public:
+	phaseSpaceRecorder(goptions gemcOpt);
+	~phaseSpaceRecorder();
+
+	// returns true if the particle entering the volume should be killed
+	bool record(const G4Step *aStep);
+
+	// writes the particles of the event
+	void endEvent(int evn, double eventWeight);
+
+private:
+	string hd_msg;
+	volumeBoundary *boundary;
+	bool kill;
+
+	primaryEventFile *output;
+	primaryEvent event;
+	long nevents;
+	long nrecorded;
+	long nparticles;
+};
+
+#endif
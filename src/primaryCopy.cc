@@ -0,0 +1,57 @@
+// gemc headers
+#include "primaryCopy.h"
+
+G4PrimaryParticle *copyPrimaryParticle(const G4PrimaryParticle *pp)
+{
+	G4PrimaryParticle *copy;
+	if(pp->GetParticleDefinition() != nullptr)
+		copy = new G4PrimaryParticle(pp->GetParticleDefinition(), pp->GetPx(), pp->GetPy(), pp->GetPz());
+	else
+		copy = new G4PrimaryParticle(pp->GetPDGcode(), pp->GetPx(), pp->GetPy(), pp->GetPz());
+
+	copy->SetMass(pp->GetMass());
+	copy->SetCharge(pp->GetCharge());
+	copy->SetPolarization(pp->GetPolarization());
+	copy->SetProperTime(pp->GetProperTime());
+	copy->SetWeight(pp->GetWeight());
+
+	// the daughters are a chain of their own: copying the first one copies all of them
+	if(pp->GetDaughter() != nullptr)
+		copy->SetDaughter(new G4PrimaryParticle(*pp->GetDaughter()));
+
+	return copy;
+}
+
+G4PrimaryVertex *copyPrimaryVertex(const G4PrimaryVertex *pv)
+{
+	G4PrimaryVertex *copy = new G4PrimaryVertex(pv->GetPosition(), pv->GetT0());
+	copy->SetWeight(pv->GetWeight());
+
+	for(int p=0; p<pv->GetNumberOfParticle(); p++)
+		copy->SetPrimary(copyPrimaryParticle(pv->GetPrimary(p)));
+
+	return copy;
+}
+
+void copyPrimaries(const G4Event *from, G4Event *to)
+{
+	for(int v=0; v<from->GetNumberOfPrimaryVertex(); v++)
+		to->AddPrimaryVertex(copyPrimaryVertex(from->GetPrimaryVertex(v)));
+}
+
+int countPrimaryVertices(const G4Event *anEvent)
+{
+	int n = 0;
+	for(G4PrimaryVertex *pv = anEvent->GetPrimaryVertex(); pv != nullptr; pv = pv->GetNext())
+		n++;
+	return n;
+}
+
+int countPrimaries(const G4Event *anEvent)
+{
+	int n = 0;
+	for(G4PrimaryVertex *pv = anEvent->GetPrimaryVertex(); pv != nullptr; pv = pv->GetNext())
+		for(G4PrimaryParticle *pp = pv->GetPrimary(); pp != nullptr; pp = pp->GetNext())
+			n++;
+	return n;
+}
@@ -0,0 +1,31 @@
+/// \file primaryCopy.h
+/// Copies the primary vertices of an event to another event.\n
+/// The G4PrimaryVertex and G4PrimaryParticle copy constructors also copy the vertices
+/// and particles chained after the one copied: copying each vertex of an event
+/// with them gives N(N+1)/2 vertices. Here each vertex and each particle is copied alone,
+/// so the target event gets exactly the vertices and particles of the source event.
+/// \author \n Maurizio Ungaro
+/// \author mail: ungaro@jlab.org\n\n\n
+#ifndef PRIMARY_COPY_H
+#define PRIMARY_COPY_H 1
+
+// G4 headers
+#include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
+
+// copy of one particle, without the particles following it. The daughters are copied
+G4PrimaryParticle *copyPrimaryParticle(const G4PrimaryParticle *pp);
+
+// copy of one vertex and its particles, without the vertices following it
+G4PrimaryVertex *copyPrimaryVertex(const G4PrimaryVertex *pv);
+
+// adds to the event "to" a copy of each vertex of the event "from"
+void copyPrimaries(const G4Event *from, G4Event *to);
+
+// number of vertices and of primary particles of an event, following the vertex and
+// particle chains as the G4PrimaryTransformer does when it makes the tracks
+int countPrimaryVertices(const G4Event *anEvent);
+int countPrimaries(const G4Event *anEvent);
+
+#endif
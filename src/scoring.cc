@@ -0,0 +1,499 @@
+// G4 headers
+#include "G4PhysicalVolumeStore.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4Material.hh"
+#include "G4Track.hh"
+
+// gemc headers
+#include "scoring.h"
+#include "string_utilities.h"
+
+// mlibrary
+#include "gstring.h"
+using namespace gstring;
+
+// C++ headers
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+using namespace std;
+
+// CLHEP units
+#include "CLHEP/Units/PhysicalConstants.h"
+using namespace CLHEP;
+
+
+const char *scoringRecorder::groupNames[SCORING_NGROUPS] = {"gamma", "electron", "neutron", "proton", "pion", "muon", "other"};
+
+
+bool damageFunction::load(string filename)
+{
+	ifstream in(filename.c_str());
+	if(!in) return false;
+
+	string line;
+	while(getline(in, line)) {
+		if(line.empty() || line[0] == '#') continue;
+		vector<string> values = getStringVectorFromString(line);
+		if(values.size() < 2) continue;
+
+		double e = get_number(values[0])*MeV;
+		if(e <= 0) continue;
+		energies.push_back(log(e));
+		factors.push_back(get_number(values[1]));
+	}
+
+	// sorted by energy
+	vector<unsigned> order(energies.size());
+	for(unsigned i=0; i<order.size(); i++) order[i] = i;
+	sort(order.begin(), order.end(), [this](unsigned a, unsigned b) {return energies[a] < energies[b];});
+
+	vector<double> e(energies), f(factors);
+	for(unsigned i=0; i<order.size(); i++) {
+		energies[i] = e[order[i]];
+		factors[i]  = f[order[i]];
+	}
+
+	return !energies.empty();
+}
+
+double damageFunction::factor(double ekin) const
+{
+	if(energies.empty() || ekin <= 0) return 0;
+
+	double le = log(ekin);
+	if(le <= energies.front()) return factors.front();
+	if(le >= energies.back())  return factors.back();
+
+	unsigned i = upper_bound(energies.begin(), energies.end(), le) - energies.begin();
+	double x = (le - energies[i-1])/(energies[i] - energies[i-1]);
+
+	return factors[i-1] + x*(factors[i] - factors[i-1]);
+}
+
+
+size_t scorer::bin(unsigned cell, int group, int ebin) const
+{
+	size_t nebins = nbins/ncells/SCORING_NGROUPS;
+	return ((size_t) cell*SCORING_NGROUPS + group)*nebins + ebin;
+}
+
+int scorer::meshCell(const G4ThreeVector &p) const
+{
+	int idx[3];
+	for(int k=0; k<3; k++) {
+		if(p[k] < lo[k] || p[k] >= hi[k]) return -1;
+		idx[k] = (int) ((p[k] - lo[k])/width[k]);
+		if(idx[k] >= n[k]) idx[k] = n[k] - 1;
+	}
+	return (idx[0]*n[1] + idx[1])*n[2] + idx[2];
+}
+
+// voxel traversal of the segment from a to b, clipped to the mesh
+void scorer::meshSegment(const G4ThreeVector &a, const G4ThreeVector &b, vector<pair<unsigned, double> > &cells) const
+{
+	cells.clear();
+
+	G4ThreeVector d = b - a;
+	double length = d.mag();
+	if(length <= 0) return;
+
+	// parametric range inside the mesh
+	double t0 = 0, t1 = 1;
+	for(int k=0; k<3; k++) {
+		if(d[k] == 0) {
+			if(a[k] < lo[k] || a[k] >= hi[k]) return;
+			continue;
+		}
+		double ta = (lo[k] - a[k])/d[k];
+		double tb = (hi[k] - a[k])/d[k];
+		if(ta > tb) swap(ta, tb);
+		t0 = max(t0, ta);
+		t1 = min(t1, tb);
+	}
+	if(t0 >= t1) return;
+
+	int idx[3], step[3];
+	double tnext[3], tdelta[3];
+	G4ThreeVector start = a + t0*d;
+	for(int k=0; k<3; k++) {
+		idx[k] = (int) floor((start[k] - lo[k])/width[k]);
+		idx[k] = max(0, min(n[k] - 1, idx[k]));
+
+		if(d[k] > 0) {
+			step[k]   = 1;
+			tnext[k]  = (lo[k] + (idx[k] + 1)*width[k] - a[k])/d[k];
+			tdelta[k] = width[k]/d[k];
+		} else if(d[k] < 0) {
+			step[k]   = -1;
+			tnext[k]  = (lo[k] + idx[k]*width[k] - a[k])/d[k];
+			tdelta[k] = -width[k]/d[k];
+		} else {
+			step[k]   = 0;
+			tnext[k]  = numeric_limits<double>::max();
+			tdelta[k] = numeric_limits<double>::max();
+		}
+	}
+
+	double t = t0;
+	while(t < t1) {
+		int k = 0;
+		if(tnext[1] < tnext[k]) k = 1;
+		if(tnext[2] < tnext[k]) k = 2;
+
+		double tend = min(tnext[k], t1);
+		if(tend > t)
+			cells.push_back(make_pair((unsigned) ((idx[0]*n[1] + idx[1])*n[2] + idx[2]), (tend - t)*length));
+		t = tend;
+
+		idx[k] += step[k];
+		if(idx[k] < 0 || idx[k] >= n[k]) break;
+		tnext[k] += tdelta[k];
+	}
+}
+
+// all the physical volumes with the scored names, once the geometry is built
+void scorer::findVolumes()
+{
+	volumesFound = true;
+
+	volumeSizes.assign(volumeNames.size(), 0);
+	volumeMasses.assign(volumeNames.size(), 0);
+
+	G4PhysicalVolumeStore *store = G4PhysicalVolumeStore::GetInstance();
+	for(auto pv: *store) {
+		for(unsigned v=0; v<volumeNames.size(); v++) {
+			if(pv->GetName() != volumeNames[v]) continue;
+
+			G4LogicalVolume *lv = pv->GetLogicalVolume();
+			double size = lv->GetSolid()->GetCubicVolume()*pv->GetMultiplicity();
+			volumeSizes[v]  += size;
+			volumeMasses[v] += size*lv->GetMaterial()->GetDensity();
+			volumeIndex[pv] = v;
+		}
+	}
+
+	for(unsigned v=0; v<volumeNames.size(); v++)
+		if(volumeSizes[v] == 0)
+			cout << " !!! Warning: scorer " << name << ": volume " << volumeNames[v] << " not found. Nothing will be scored in it." << endl;
+}
+
+int scorer::volume(const G4VPhysicalVolume *pv)
+{
+	if(!volumesFound) findVolumes();
+
+	auto v = volumeIndex.find(pv);
+	if(v == volumeIndex.end()) return -1;
+
+	return v->second;
+}
+
+void scorer::endEvent()
+{
+	for(auto &v: eventValues) {
+		sum[v.first]  += v.second;
+		sum2[v.first] += v.second*v.second;
+	}
+	eventValues.clear();
+}
+
+
+static bool scorerQuantity(string q, scorer &s)
+{
+	s.quantityName = q;
+	if(q == "flux")      s.quantity = scorer::FLUX;
+	else if(q == "edep") s.quantity = scorer::EDEP;
+	else if(q == "dose") s.quantity = scorer::DOSE;
+	else if(q == "neq")  s.quantity = scorer::NEQ;
+	else return false;
+	return true;
+}
+
+scoringRecorder::scoringRecorder(goptions gemcOpt)
+{
+	hd_msg  = gemcOpt.optMap["LOG_MSG"].args + " Scoring: >> ";
+	nevents = 0;
+
+	// output file and periodic writing
+	vector<string> pars = getStringVectorFromStringWithDelimiter(gemcOpt.optMap["SCORING_OUTPUT"].args, ",");
+	filename   = pars.size() > 0 ? trimSpacesFromString(pars[0]) : "scoring.txt";
+	writeEvery = pars.size() > 1 ? (long) get_number(pars[1]) : 0;
+
+	// energy bins
+	nebins = 1;
+	emin = emax = 0;
+	logEmin = logEwidth = 0;
+	pars = getStringVectorFromStringWithDelimiter(gemcOpt.optMap["SCORING_EBINS"].args, ",");
+	if(pars.size() == 3) {
+		nebins = (int) get_number(pars[0]);
+		emin   = get_number(pars[1]);
+		emax   = get_number(pars[2]);
+		if(nebins < 1 || emin <= 0 || emax <= emin) {
+			cout << hd_msg << " !!! Error: SCORING_EBINS should be \"nbins, emin, emax\" with 0 < emin < emax. Exiting." << endl;
+			exit(1);
+		}
+		logEmin   = log(emin);
+		logEwidth = (log(emax) - logEmin)/nebins;
+	} else if(pars.size() > 1) {
+		cout << hd_msg << " !!! Error: SCORING_EBINS should be \"nbins, emin, emax\". Exiting." << endl;
+		exit(1);
+	}
+
+	// damage functions
+	vector<aopt> SCORING_NEQ = gemcOpt.getArgs("SCORING_NEQ");
+	for(auto &opt: SCORING_NEQ) {
+		pars = getStringVectorFromStringWithDelimiter(opt.args, ",");
+		if(pars.size() < 2) continue;
+
+		string particle = trimSpacesFromString(pars[0]);
+		string file     = trimSpacesFromString(pars[1]);
+		int g = 0;
+		while(g < SCORING_NGROUPS && particle != groupNames[g]) g++;
+		if(g == SCORING_NGROUPS) {
+			cout << hd_msg << " !!! Error: SCORING_NEQ particle type " << particle << " unknown. Exiting." << endl;
+			exit(1);
+		}
+		if(!damage[g].load(file)) {
+			cout << hd_msg << " !!! Error: can't read the damage function file " << file << ". Exiting." << endl;
+			exit(1);
+		}
+		cout << hd_msg << " Damage function of " << particle << ": " << file << endl;
+	}
+
+	// meshes
+	vector<aopt> SCORING_MESH = gemcOpt.getArgs("SCORING_MESH");
+	for(auto &opt: SCORING_MESH) {
+		pars = getStringVectorFromStringWithDelimiter(opt.args, ",");
+
+		// skipping default option "no"
+		if(pars.size() == 1) continue;
+
+		scorer s;
+		if(pars.size() != 11 || !scorerQuantity(trimSpacesFromString(pars[1]), s)) {
+			cout << hd_msg << " !!! Error: SCORING_MESH should be \"name, (flux|edep|dose|neq), nx, ny, nz, xmin, xmax, ymin, ymax, zmin, zmax\". Exiting." << endl;
+			exit(1);
+		}
+		s.name   = trimSpacesFromString(pars[0]);
+		s.isMesh = true;
+		s.volumesFound = true;
+		s.cellVolume = 1;
+		for(int k=0; k<3; k++) {
+			s.n[k]  = (int) get_number(pars[2+k]);
+			s.lo[k] = get_number(pars[5+2*k]);
+			s.hi[k] = get_number(pars[6+2*k]);
+			if(s.n[k] < 1 || s.hi[k] <= s.lo[k]) {
+				cout << hd_msg << " !!! Error: SCORING_MESH " << s.name << ": wrong number of cells or limits. Exiting." << endl;
+				exit(1);
+			}
+			s.width[k] = (s.hi[k] - s.lo[k])/s.n[k];
+			s.cellVolume *= s.width[k];
+		}
+		s.ncells = s.n[0]*s.n[1]*s.n[2];
+		scorers.push_back(s);
+	}
+
+	// volumes
+	vector<aopt> SCORING_VOLUME = gemcOpt.getArgs("SCORING_VOLUME");
+	for(auto &opt: SCORING_VOLUME) {
+		pars = getStringVectorFromStringWithDelimiter(opt.args, ",");
+
+		// skipping default option "no"
+		if(pars.size() == 1) continue;
+
+		scorer s;
+		if(pars.size() != 3 || !scorerQuantity(trimSpacesFromString(pars[1]), s)) {
+			cout << hd_msg << " !!! Error: SCORING_VOLUME should be \"name, (flux|edep|dose|neq), volume1 volume2 ...\". Exiting." << endl;
+			exit(1);
+		}
+		s.name   = trimSpacesFromString(pars[0]);
+		s.isMesh = false;
+		s.volumesFound = false;
+		s.cellVolume = 0;
+		s.volumeNames = getStringVectorFromString(pars[2]);
+		s.ncells = s.volumeNames.size();
+		scorers.push_back(s);
+	}
+
+	for(auto &s: scorers) {
+		s.nbins = (size_t) s.ncells*SCORING_NGROUPS*nebins;
+		s.sum.assign(s.nbins, 0);
+		s.sum2.assign(s.nbins, 0);
+
+		cout << hd_msg << " " << s.name << ": " << s.quantityName << " in " << s.ncells << (s.isMesh ? " mesh cells, " : " volumes, ")
+		     << s.nbins << " bins (" << 2*s.nbins*sizeof(double)/1048576.0 << " MB)." << endl;
+
+		if(s.quantity == scorer::NEQ) {
+			bool any = false;
+			for(int g=0; g<SCORING_NGROUPS; g++) any = any || damage[g].isLoaded();
+			if(!any) cout << hd_msg << " Warning: " << s.name << " scores the neq fluence but no damage function is given in SCORING_NEQ." << endl;
+		}
+	}
+}
+
+scoringRecorder::~scoringRecorder()
+{
+	if(!isActive()) return;
+
+	write();
+	cout << hd_msg << " " << scorers.size() << " scorers written in " << filename << " for " << nevents << " events." << endl;
+}
+
+int scoringRecorder::particleGroup(int pid) const
+{
+	switch(abs(pid)) {
+		case 22:   return 0;
+		case 11:   return 1;
+		case 2112: return 2;
+		case 2212: return 3;
+		case 211:  return 4;
+		case 13:   return 5;
+		default:   return 6;
+	}
+}
+
+// -1 outside the energy range
+int scoringRecorder::energyBin(double ekin) const
+{
+	if(emax == 0) return 0;
+	if(ekin < emin || ekin >= emax) return -1;
+
+	int b = (int) ((log(ekin) - logEmin)/logEwidth);
+	return min(b, nebins - 1);
+}
+
+void scoringRecorder::record(const G4Step *aStep)
+{
+	const G4StepPoint *pre  = aStep->GetPreStepPoint();
+	const G4StepPoint *post = aStep->GetPostStepPoint();
+	const G4Track *track    = aStep->GetTrack();
+
+	double ekin = pre->GetKineticEnergy();
+	int ebin = energyBin(ekin);
+	if(ebin < 0) return;
+
+	int group     = particleGroup(track->GetDefinition()->GetPDGEncoding());
+	double weight = track->GetWeight();
+	double length = aStep->GetStepLength();
+	double edep   = aStep->GetTotalEnergyDeposit();
+
+	for(auto &s: scorers) {
+
+		if(s.quantity == scorer::FLUX || s.quantity == scorer::NEQ) {
+			if(length <= 0) continue;
+
+			double f = weight;
+			if(s.quantity == scorer::NEQ) {
+				if(!damage[group].isLoaded()) continue;
+				f *= damage[group].factor(ekin);
+			}
+
+			if(s.isMesh) {
+				s.meshSegment(pre->GetPosition(), post->GetPosition(), cells);
+				for(auto &c: cells)
+					s.eventValues[s.bin(c.first, group, ebin)] += f*c.second/s.cellVolume;
+			} else {
+				int v = s.volume(pre->GetPhysicalVolume());
+				if(v >= 0 && s.volumeSizes[v] > 0)
+					s.eventValues[s.bin(v, group, ebin)] += f*length/s.volumeSizes[v];
+			}
+
+		} else {
+			if(edep <= 0) continue;
+
+			double value = weight*edep;
+			int cell = -1;
+			if(s.isMesh) {
+				cell = s.meshCell(0.5*(pre->GetPosition() + post->GetPosition()));
+				if(cell < 0) continue;
+				if(s.quantity == scorer::DOSE) {
+					double density = pre->GetMaterial()->GetDensity();
+					if(density <= 0) continue;
+					value /= density*s.cellVolume;
+				}
+			} else {
+				cell = s.volume(pre->GetPhysicalVolume());
+				if(cell < 0) continue;
+				if(s.quantity == scorer::DOSE) {
+					if(s.volumeMasses[cell] <= 0) continue;
+					value /= s.volumeMasses[cell];
+				}
+			}
+			s.eventValues[s.bin(cell, group, ebin)] += value;
+		}
+	}
+}
+
+void scoringRecorder::endEvent()
+{
+	nevents++;
+	for(auto &s: scorers)
+		s.endEvent();
+
+	if(writeEvery > 0 && nevents % writeEvery == 0)
+		write();
+}
+
+// non-empty bins: mean per event and its error
+void scoringRecorder::write()
+{
+	ofstream out(filename.c_str());
+	if(!out) {
+		cout << hd_msg << " !!! Error: can't open " << filename << ". The scorers are not written." << endl;
+		return;
+	}
+
+	out << "# gemc scorers" << endl;
+	out << "# events: " << nevents << endl;
+	if(emax > 0) out << "# energy bins: " << nebins << ", log spaced from " << emin/MeV << " to " << emax/MeV << " MeV" << endl;
+	else         out << "# energy bins: none" << endl;
+	out << "# particles:";
+	for(int g=0; g<SCORING_NGROUPS; g++) out << " " << groupNames[g];
+	out << endl;
+
+	for(auto &s: scorers) {
+
+		double unit = 1;
+		string unitName;
+		switch(s.quantity) {
+			case scorer::FLUX: unit = 1/cm2;  unitName = "1/cm2"; break;
+			case scorer::NEQ:  unit = 1/cm2;  unitName = "1/cm2 (1 MeV neq)"; break;
+			case scorer::EDEP: unit = MeV;    unitName = "MeV"; break;
+			case scorer::DOSE: unit = gray;   unitName = "Gy"; break;
+		}
+
+		out << "# scorer: " << s.name << ", " << s.quantityName << " per event in " << unitName << endl;
+		if(s.isMesh) {
+			out << "# mesh: " << s.n[0] << " " << s.n[1] << " " << s.n[2] << " cells, x: " << s.lo[0]/mm << " " << s.hi[0]/mm
+			    << ", y: " << s.lo[1]/mm << " " << s.hi[1]/mm << ", z: " << s.lo[2]/mm << " " << s.hi[2]/mm << " mm" << endl;
+			out << "# ix iy iz particle ebin mean error" << endl;
+		} else {
+			out << "# volumes:";
+			for(auto &v: s.volumeNames) out << " " << v;
+			out << endl;
+			out << "# volume particle ebin mean error" << endl;
+		}
+
+		if(nevents == 0) continue;
+
+		size_t nperCell = s.nbins/s.ncells;
+		for(size_t b=0; b<s.nbins; b++) {
+			if(s.sum[b] == 0) continue;
+
+			double mean  = s.sum[b]/nevents;
+			double var   = s.sum2[b]/nevents - mean*mean;
+			double error = nevents > 1 && var > 0 ? sqrt(var/(nevents - 1)) : 0;
+
+			unsigned cell  = b/nperCell;
+			int      group = (b % nperCell)/nebins;
+			int      ebin  = b % nebins;
+
+			if(s.isMesh) out << cell/(s.n[1]*s.n[2]) << " " << (cell/s.n[2]) % s.n[1] << " " << cell % s.n[2];
+			else         out << s.volumeNames[cell];
+			out << " " << groupNames[group] << " " << ebin << " " << mean/unit << " " << error/unit << endl;
+		}
+	}
+}
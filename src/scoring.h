@@ -0,0 +1,157 @@
+/// \file scoring.h
+/// Defines the gemc scorers.\n
+/// Scorers accumulate, in memory, quantities used for radiation and flux studies,
+/// without writing any hit: flux (track length fluence), energy deposition, dose
+/// and 1 MeV neutron equivalent fluence. Each quantity is binned by particle type
+/// (gamma, electron, neutron, proton, pion, muon, other) and, optionally, by kinetic energy.\n
+/// Scorers are defined on a 3D mesh in the lab frame (SCORING_MESH) or on physical
+/// volumes (SCORING_VOLUME). The track length of a step is split along the mesh cells
+/// it crosses; the energy deposited is assigned to the cell of the middle of the step.\n
+/// The sum and sum of squares of the event contributions of each bin are kept,
+/// so the output gives, for each non-empty bin, the mean per event and its statistical error.
+/// The histograms are written in SCORING_OUTPUT at the end of the run and optionally every N events.\n
+/// Units of the results, per event: flux and neq fluence: 1/cm2, edep: MeV, dose: Gy.
+/// The damage functions used for the neq fluence (displacement damage relative to 1 MeV neutrons)
+/// are read from files given in SCORING_NEQ.
+/// \author \n Maurizio Ungaro
+/// \author mail: ungaro@jlab.org\n\n\n
+#ifndef SCORING_H
+#define SCORING_H 1
+
+// G4 headers
+#include "G4Step.hh"
+#include "G4VPhysicalVolume.hh"
+
+// gemc headers
+#include "options.h"
+
+// C++ headers
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+using namespace std;
+
+// particle types of the scorer bins
+#define SCORING_NGROUPS 7
+
+
+/// \class damageFunction
+/// <b> damageFunction </b>\n\n
+/// Displacement damage relative to 1 MeV neutrons as a function of the kinetic energy.
+/// Linear interpolation in log(energy), constant outside the table
+class damageFunction
+{
+public:
+	damageFunction() {;}
+
+	bool load(string filename);
+	bool isLoaded() const {return !energies.empty();}
+
+	double factor(double ekin) const;
+
+private:
+	vector<double> energies;   ///< log of the kinetic energy
+	vector<double> factors;
+};
+
+
+/// \class scorer
+/// <b> scorer </b>\n\n
+/// One SCORING_MESH or SCORING_VOLUME entry
+class scorer
+{
+public:
+	enum quantityType {FLUX, EDEP, DOSE, NEQ};
+
+	string name;
+	string quantityName;
+	quantityType quantity;
+
+	// mesh
+	bool isMesh;
+	int n[3];                ///< number of cells along x, y, z
+	double lo[3], hi[3];     ///< mesh limits
+	double width[3];         ///< cells sizes
+	double cellVolume;
+
+	// volumes
+	vector<string> volumeNames;
+	vector<double> volumeSizes;                           ///< cubic volume of all the copies of each volume
+	vector<double> volumeMasses;                          ///< mass of all the copies of each volume
+	unordered_map<const G4VPhysicalVolume*, int> volumeIndex;   ///< -1 for volumes that are not scored
+	bool volumesFound;
+
+	unsigned ncells;
+	size_t   nbins;
+
+	vector<double> sum;      ///< sum over the events
+	vector<double> sum2;     ///< sum of squares over the events
+	unordered_map<size_t, double> eventValues;   ///< contributions of the current event
+
+	size_t bin(unsigned cell, int group, int ebin) const;
+
+	// track length of the segment inside each cell of the mesh
+	void meshSegment(const G4ThreeVector &a, const G4ThreeVector &b, vector<pair<unsigned, double> > &cells) const;
+
+	// cell of a point of the mesh, -1 if outside
+	int meshCell(const G4ThreeVector &p) const;
+
+	// index of a volume scorer, -1 if the volume is not scored
+	int volume(const G4VPhysicalVolume *pv);
+	void findVolumes();
+
+	void endEvent();
+};
+
+
+/// \class scoringRecorder
+/// <b> scoringRecorder </b>\n\n
+/// Usage:\n
+/// -SCORING_MESH="name, quantity, nx, ny, nz, xmin, xmax, ymin, ymax, zmin, zmax"\n
+/// -SCORING_VOLUME="name, quantity, volume1 volume2 ..."\n
+/// -SCORING_EBINS="nbins, emin, emax"\n
+/// -SCORING_NEQ="particle type, damage function file"\n
+/// -SCORING_OUTPUT="filename, N"
+class scoringRecorder
+{
+public:
+	scoringRecorder(goptions gemcOpt);
+	~scoringRecorder();
+
+	bool isActive() const {return !scorers.empty();}
+
+	// adds the step contributions to the scorers
+	void record(const G4Step *aStep);
+
+	// adds the event contributions to the sums. Writes the histograms every writeEvery events
+	void endEvent();
+
+	// writes the histograms
+	void write();
+
+	static const char *groupNames[SCORING_NGROUPS];
+
+private:
+	string hd_msg;
+	string filename;
+	long   writeEvery;
+	long   nevents;
+
+	vector<scorer> scorers;
+
+	// energy bins, logarithmic. No binning if nebins is 1 and emax is 0
+	int    nebins;
+	double emin, emax;
+	double logEmin, logEwidth;
+
+	damageFunction damage[SCORING_NGROUPS];
+
+	int particleGroup(int pid) const;
+	int energyBin(double ekin) const;
+
+	vector<pair<unsigned, double> > cells;   ///< reused by record
+};
+
+
+#endif
@@ -16,6 +16,19 @@
 
 namespace UTIL{
 
+//
+// A record is an event record, indexed and counted, if one of its
+// blocks is STDHEP or STDHEPEV4. Version 2 headers may have no block ids.
+//
+static bool isStdHepRecord(const char *version, long nBlocks, long dimBlocks, const long *ids, long len)
+{
+   if (*version == '2' && dimBlocks == 0) return(false);
+   for (long j = 0; j < nBlocks && j < len; j++) {
+      if (ids[j] == LSH_STDHEP || ids[j] == LSH_STDHEPEV4) return(true);
+   }
+   return(false);
+}
+
 ////
 //
 // The main lStdHep class.
@@ -31,7 +44,8 @@ namespace UTIL{
 lStdHep::lStdHep(const char *filename, bool open_for_write) : 
   lXDR(filename, open_for_write),
   ntot(0),version(0),title(0),comment(0),date(0),closingDate(0),numevts_expect(0),numevts(0),
-  firstTable(0),dimTable(0),nNTuples(0),nBlocks(0),blockIds(0),blockNames(0)
+  firstTable(0),dimTable(0),nNTuples(0),nBlocks(0),blockIds(0),blockNames(0),
+  indexed(false),nextIndexedEvent(0),recordsRead(0),firstTableLocator(-1)
 {
    if (open_for_write) {
       setError(LSH_NOTSUPPORTED);
@@ -136,10 +150,24 @@ bool lStdHep::more(void)
 
 long lStdHep::readEvent(void)
 {
+   event.isEmpty = 1;
+//
+// Following the event index
+//
+   if (indexed) {
+      while (nextIndexedEvent < (long) eventOffsets.size()) {
+         long pos = eventOffsets[nextIndexedEvent++];
+         if (filePosition(pos) != pos) return(getError());
+         if (event.read(*this) != LSH_SUCCESS) return(getError());
+         if (event.isEmpty) continue;
+         return(getError());
+      }
+      setError(LSH_ENDOFFILE);
+      return(getError());
+   }
 //
 // Look for an event or an event table
 //
-   event.isEmpty = 1;
    while (1) {
       if (eventTable.ievt < eventTable.numEvts) {
          if (filePosition(eventTable.ptrEvents[eventTable.ievt]) !=
@@ -147,6 +175,7 @@ long lStdHep::readEvent(void)
 
          if (event.read(*this) != LSH_SUCCESS) return(getError());
          eventTable.ievt++;
+         if (event.hasStdHep) recordsRead++;
 
          if (event.isEmpty) continue;
          return(getError());
@@ -175,6 +204,85 @@ long lStdHep::readEvent(void)
    return(getError());
 }
 
+long lStdHep::buildEventIndex(void)
+{
+   if (indexed) return((long) eventOffsets.size());
+
+   long position = filePosition();
+   long status   = getError();
+
+   eventOffsets.clear();
+
+   EventTable table;
+   long  len;
+   char *hversion = 0;
+   long  hversionCapacity = 0;
+   long *ids = 0;
+   long  idsCapacity = 0;
+
+   long locator = firstTableLocator;
+   while (locator >= 0) {
+      if (filePosition(locator) != locator) break;
+      if (table.read(*this) != LSH_SUCCESS) break;
+      locator = table.nextlocator;
+//
+// Only the event header of each record is read
+//
+      for (long i = 0; i < table.numEvts; i++) {
+         long pos = table.ptrEvents[i];
+         if (filePosition(pos) != pos) break;
+
+         long blockid = readLong();
+         readLong();
+         hversion = (char *) readString(len, hversion, hversionCapacity);
+         if (getError() != LSH_SUCCESS || blockid != LSH_EVENTHEADER) continue;
+
+         for (int k = 0; k < 4; k++) readLong();   // evtnum, storenum, runnum, trigMask
+         long nb   = readLong();
+         long dimb = readLong();
+         len = 0;
+         if (*hversion == '2') {
+            readLong();
+            readLong();
+         }
+         if (*hversion != '2' || dimb != 0) {
+            ids = readLongArray(len, ids, idsCapacity);
+            if (getError() != LSH_SUCCESS) continue;
+         }
+
+         if (isStdHepRecord(hversion, nb, dimb, ids, len)) eventOffsets.push_back(pos);
+      }
+   }
+
+   delete [] hversion;
+   delete [] ids;
+//
+// Back to where we were: the events already read are not read again
+//
+   filePosition(position);
+   setError(status);
+
+   indexed          = true;
+   nextIndexedEvent = recordsRead < (long) eventOffsets.size() ? recordsRead : (long) eventOffsets.size();
+
+   return((long) eventOffsets.size());
+}
+
+long lStdHep::seekEvent(long n)
+{
+   if (!indexed) buildEventIndex();
+
+   if (n < 0 || n >= (long) eventOffsets.size()) {
+      nextIndexedEvent = (long) eventOffsets.size();
+      setError(LSH_ENDOFFILE);
+      return(getError());
+   }
+
+   nextIndexedEvent = n;
+   setError(LSH_SUCCESS);
+   return(getError());
+}
+
 long lStdHep::getEvent(lStdEvent &lse) const
 {
    if (long status = getError() != LSH_SUCCESS) return(status);
@@ -253,6 +361,7 @@ long lStdHep::readFileHeader(void)
 //
 // Read the first event table
 //
+   firstTableLocator = filePosition();
    eventTable.read(*this);
    return(getError());
 }
@@ -363,7 +472,11 @@ long lStdHep::EventTable::print(FILE *fp)
 }
 
 lStdHep::Event::Event() :
-   isEmpty(0), blockid(0),ntot(0),version(0),evtnum(0),storenum(0),runnum(0),
+   isEmpty(0), blockid(0),ntot(0),version(0),
+   versionCapacity(0),blockIdsCapacity(0),ptrBlocksCapacity(0),
+   isthepCapacity(0),idhepCapacity(0),jmohepCapacity(0),jdahepCapacity(0),
+   phepCapacity(0),vhepCapacity(0),scaleCapacity(0),spinCapacity(0),colorflowCapacity(0),isEv4(0),hasStdHep(0),
+   evtnum(0),storenum(0),runnum(0),
    trigMask(0),nBlocks(0),dimBlocks(0),nNTuples(0),dimNTuples(0),blockIds(0),
    ptrBlocks(0),nevhep(0),nhep(0),isthep(0),idhep(0),jmohep(0),jdahep(0),phep(0),
    vhep(0),eventweight(0),alphaqed(0),alphaqcd(0),scale(0),spin(0),colorflow(0),idrup(0),
@@ -393,7 +506,10 @@ void lStdHep::Event::cleanup(void)
    delete [] scale;       scale     = 0;
    delete [] spin;        spin      = 0;
    delete [] colorflow;   colorflow = 0;
-   blockid = ntot = nevhep = nhep = 0;
+   versionCapacity = blockIdsCapacity = ptrBlocksCapacity = 0;
+   isthepCapacity = idhepCapacity = jmohepCapacity = jdahepCapacity = 0;
+   phepCapacity = vhepCapacity = scaleCapacity = spinCapacity = colorflowCapacity = 0;
+   blockid = ntot = nevhep = nhep = isEv4 = hasStdHep = 0;
    isEmpty = 1;
    return;
 }
@@ -404,12 +520,15 @@ long lStdHep::Event::read(lStdHep &ls)
 // Read event header
 //
    long len;
-
-   cleanup();
+//
+// The arrays of the previous event are reused
+//
+   blockid = ntot = nevhep = nhep = isEv4 = hasStdHep = 0;
+   isEmpty = 1;
 
    blockid = ls.readLong();
    ntot    = ls.readLong();
-   version = ls.readString(len);
+   version = (char *) ls.readString(len, version, versionCapacity);
    if (blockid != LSH_EVENTHEADER) ls.setError(LSH_NOEVENT);
 
    evtnum    = ls.readLong();
@@ -423,8 +542,9 @@ long lStdHep::Event::read(lStdHep &ls)
       nNTuples = ls.readLong();
       dimNTuples = ls.readLong();
       if (dimBlocks) {
-         blockIds  = ls.readLongArray(len);
-         ptrBlocks = ls.readLongArray(len);
+         blockIds  = ls.readLongArray(len, blockIds, blockIdsCapacity);
+         hasStdHep = isStdHepRecord(version, nBlocks, dimBlocks, blockIds, len);
+         ptrBlocks = ls.readLongArray(len, ptrBlocks, ptrBlocksCapacity);
       }
       if (dimNTuples) {
          ls.setError(LSH_NOTSUPPORTED);
@@ -434,8 +554,9 @@ long lStdHep::Event::read(lStdHep &ls)
    else {
       nNTuples   = 0;
       dimNTuples = 0;
-      blockIds   = ls.readLongArray(len);
-      ptrBlocks  = ls.readLongArray(len);
+      blockIds   = ls.readLongArray(len, blockIds, blockIdsCapacity);
+      hasStdHep  = isStdHepRecord(version, nBlocks, dimBlocks, blockIds, len);
+      ptrBlocks  = ls.readLongArray(len, ptrBlocks, ptrBlocksCapacity);
    }
 //
 // Read event
@@ -443,54 +564,39 @@ long lStdHep::Event::read(lStdHep &ls)
    for (int i = 0; i < nBlocks; i++) {
       blockid = ls.readLong();
       ntot    = ls.readLong();
-      if (version) delete [] version;
-      version = ls.readString(len);
+      version = (char *) ls.readString(len, version, versionCapacity);
 
       isEmpty = 0;
       switch (blockIds[i]) {
          case LSH_STDHEP          : // 101
             nevhep = ls.readLong();
             nhep   = ls.readLong();
-            if (isthep) delete [] isthep;
-            isthep = ls.readLongArray(len);
-            if (idhep)  delete [] idhep;
-            idhep  = ls.readLongArray(len);
-            if (jmohep) delete [] jmohep;
-            jmohep = ls.readLongArray(len);
-            if (jdahep) delete [] jdahep;
-            jdahep = ls.readLongArray(len);
-            if (phep)   delete [] phep;
-            phep   = ls.readDoubleArray(len);
-            if (vhep)   delete [] vhep;
-            vhep   = ls.readDoubleArray(len);
+            isthep = ls.readLongArray(len, isthep, isthepCapacity);
+            idhep  = ls.readLongArray(len, idhep, idhepCapacity);
+            jmohep = ls.readLongArray(len, jmohep, jmohepCapacity);
+            jdahep = ls.readLongArray(len, jdahep, jdahepCapacity);
+            phep   = ls.readDoubleArray(len, phep, phepCapacity);
+            vhep   = ls.readDoubleArray(len, vhep, vhepCapacity);
             break;
          case LSH_STDHEPEV4       : // 201
             nevhep = ls.readLong();
             nhep   = ls.readLong();
-            if (isthep) delete [] isthep;
-            isthep = ls.readLongArray(len);
-            if (idhep)  delete [] idhep;
-            idhep  = ls.readLongArray(len);
-            if (jmohep) delete [] jmohep;
-            jmohep = ls.readLongArray(len);
-            if (jdahep) delete [] jdahep;
-            jdahep = ls.readLongArray(len);
-            if (phep)   delete [] phep;
-            phep   = ls.readDoubleArray(len);
-            if (vhep)   delete [] vhep;
-            vhep   = ls.readDoubleArray(len);
+            isthep = ls.readLongArray(len, isthep, isthepCapacity);
+            idhep  = ls.readLongArray(len, idhep, idhepCapacity);
+            jmohep = ls.readLongArray(len, jmohep, jmohepCapacity);
+            jdahep = ls.readLongArray(len, jdahep, jdahepCapacity);
+            phep   = ls.readDoubleArray(len, phep, phepCapacity);
+            vhep   = ls.readDoubleArray(len, vhep, vhepCapacity);
 //
 // New stuff for STDHEPEV4:
 //
+            isEv4       = 1;
             eventweight = ls.readDouble();
             alphaqed    = ls.readDouble();
             alphaqcd    = ls.readDouble();
-            if (scale) delete [] scale;
-            scale       = ls.readDoubleArray(len);
-            if (spin)  delete [] spin;
-            spin        = ls.readDoubleArray(len);
-            if (colorflow) delete [] colorflow;
-            colorflow   = ls.readLongArray(len);
+            scale       = ls.readDoubleArray(len, scale, scaleCapacity);
+            spin        = ls.readDoubleArray(len, spin, spinCapacity);
+            colorflow   = ls.readLongArray(len, colorflow, colorflowCapacity);
             idrup       = ls.readLong();
             break;
          case LSH_OFFTRACKARRAYS  : // 102
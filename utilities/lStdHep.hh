@@ -31,6 +31,11 @@
 //   o Fixed memory leak
 // - Version 1.5 (10-Aug-2004, WGL):
 //   o Added numEvents() method by request.
+// - gemc (10/19/2026):
+//   o The event arrays are reused from event to event.
+//   o lStdParticle: view of a particle in the event arrays.
+//   o buildEventIndex() / seekEvent(): index of the event records
+//     built from the event tables, to start reading at any event.
 //
 ////
 #ifndef LSTDHEP__HH
@@ -110,6 +115,21 @@ struct lStdEvent : public std::vector<lStdTrack>  {
    long nTracks(void) { return(size()); };
 };
 
+////
+//
+// View of a particle of the current event: pointers into the
+// event arrays, valid until the next event is read.
+//
+////
+struct lStdParticle {
+   const double  *p;     // px, py, pz, E, M
+   const double  *v;     // x, y, z, t
+   long           pid;
+   long           status;
+   long           mother1;
+   long           daughter1;
+};
+
 ////
 //
 // The lStdHep class is the "handle" for the StdHep file, and
@@ -213,10 +233,30 @@ public:
    double         spinZ(int i)      const { return(event.spin[i * 3 + 2] );   };
    long           colorflow(int i, int j)  const { return(event.colorflow[i * 2 + j] ); };
    long           idrup(void)       const { return(event.idrup);              };
+
+   lStdParticle   particle(int i)   const {
+      lStdParticle lp = { event.phep + i * 5, event.vhep + i * 4, event.idhep[i], event.isthep[i],
+                          event.jmohep[i + i + 0], event.jdahep[i + i + 0] };
+      return(lp);
+   };
 //
 // Call this to make sure you can call things like scale, spin and colorflow:
 //
-   bool           isStdHepEv4(void) const { return(event.scale != 0);         };
+   bool           isStdHepEv4(void) const { return(event.isEv4 != 0);         };
+//
+// Event index
+// -----------
+// Reads the headers of all the event records listed in the event tables and
+// keeps the file offset of the records containing an event (begin and end of
+// run records are not indexed). Returns the number of events.
+// After the index is built, readEvent() follows the index.
+//
+   long           buildEventIndex(void);
+//
+// The next readEvent() reads event n (0 is the first event of the file).
+// The index is built if needed.
+//
+   long           seekEvent(long n);
 //
 // Event writing functions. They return the last error encountered,
 // or LSH_SUCCESS.
@@ -284,6 +324,14 @@ private:
    long          *blockIds;
    const char   **blockNames;
 //
+// Event index
+//
+   std::vector<long> eventOffsets;
+   bool           indexed;
+   long           nextIndexedEvent;
+   long           recordsRead;       // events read following the event tables
+   long           firstTableLocator;
+//
 // Event table
 //
    class EventTable {
@@ -342,7 +390,18 @@ private:
 //
       long blockid;
       long ntot;
-      const char *version;
+      char *version;
+//
+// ...Array sizes: the arrays are reallocated only when they are too small
+//
+      long versionCapacity, blockIdsCapacity, ptrBlocksCapacity;
+      long isthepCapacity, idhepCapacity, jmohepCapacity, jdahepCapacity;
+      long phepCapacity, vhepCapacity, scaleCapacity, spinCapacity, colorflowCapacity;
+      long isEv4;
+//
+// ...1 if the record has a STDHEP or STDHEPEV4 block: the records in the event index
+//
+      long hasStdHep;
 //
 // ...Event header:
 //
@@ -12,6 +12,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 
 #if defined(__APPLE_CC__)
 #include <sys/types.h>
@@ -42,10 +43,12 @@ lXDR::~lXDR()
       delete [] _fileName;
       _fileName = 0;
    }
+   delete [] _buffer;
    return;
 }
 
-lXDR::lXDR(const char *filename, bool open_for_write) : _fileName(0), _fp(0) 
+lXDR::lXDR(const char *filename, bool open_for_write) : _fileName(0), _fp(0),
+   _buffer(new char[BUFFERSIZE]), _bufferStart(0), _bufferLength(0), _bufferPos(0)
 {
    setFileName(filename, open_for_write);
    if (htonl(1L) == 1L) _hasNetworkOrder = true;
@@ -87,6 +90,10 @@ void lXDR::setFileName(const char *filename, bool open_for_write)
 
    _openForWrite = open_for_write;
 
+   _bufferStart  = 0;
+   _bufferLength = 0;
+   _bufferPos    = 0;
+
    _error = LXDR_SUCCESS;
    return;
 }
@@ -114,6 +121,104 @@ double lXDR::ntohd(double d) const
    return(d);
 }
 
+//
+// Returns a pointer to the next n bytes of the file and advances the position.
+// The unread bytes are moved to the start of the buffer and the rest of the
+// buffer is filled with one fread. Returns 0 if n is larger than the buffer
+// or if the file ends before n bytes.
+//
+const char *lXDR::bufferBytes(long n)
+{
+   if (_bufferLength - _bufferPos < n) {
+      if (n > BUFFERSIZE) return(0);
+      long left = _bufferLength - _bufferPos;
+      memmove(_buffer, _buffer + _bufferPos, left);
+      _bufferStart  += _bufferPos;
+      _bufferPos     = 0;
+      _bufferLength  = left + fread(_buffer + left, 1, BUFFERSIZE - left, _fp);
+      if (_bufferLength < n) return(0);
+   }
+   const char *b = _buffer + _bufferPos;
+   _bufferPos += n;
+   return(b);
+}
+
+long lXDR::readBytes(void *data, long n)
+{
+   if (n <= BUFFERSIZE) {
+      const char *b = bufferBytes(n);
+      if (b == 0) return(_error = LXDR_READERROR);
+      memcpy(data, b, n);
+      return(LXDR_SUCCESS);
+   }
+//
+// Larger than the buffer: what is left in the buffer, then directly from the file
+//
+   long left = _bufferLength - _bufferPos;
+   memcpy(data, _buffer + _bufferPos, left);
+   _bufferStart  += _bufferLength;
+   _bufferLength  = 0;
+   _bufferPos     = 0;
+   long nr = fread((char *) data + left, 1, n - left, _fp);
+   _bufferStart  += nr;
+   if (nr != n - left) return(_error = LXDR_READERROR);
+   return(LXDR_SUCCESS);
+}
+
+//
+// Bulk decoding of arrays, one buffer at a time
+//
+long lXDR::decodeLongs(long *data, long n)
+{
+   while (n > 0) {
+      long chunk = n < BUFFERSIZE / 4 ? n : BUFFERSIZE / 4;
+      const char *b = bufferBytes(4 * chunk);
+      if (b == 0) return(_error = LXDR_READERROR);
+      for (long i = 0; i < chunk; i++) {
+         uint32_t w;
+         memcpy(&w, b + 4 * i, 4);
+         data[i] = (int32_t) ntohl(w);
+      }
+      data += chunk;
+      n    -= chunk;
+   }
+   return(LXDR_SUCCESS);
+}
+
+long lXDR::decodeDoubles(double *data, long n)
+{
+   while (n > 0) {
+      long chunk = n < BUFFERSIZE / 8 ? n : BUFFERSIZE / 8;
+      const char *b = bufferBytes(8 * chunk);
+      if (b == 0) return(_error = LXDR_READERROR);
+      memcpy(data, b, 8 * chunk);
+      if (_hasNetworkOrder == false) for (long i = 0; i < chunk; i++) data[i] = ntohd(data[i]);
+      data += chunk;
+      n    -= chunk;
+   }
+   return(LXDR_SUCCESS);
+}
+
+long lXDR::decodeFloats(double *data, long n)
+{
+   while (n > 0) {
+      long chunk = n < BUFFERSIZE / 4 ? n : BUFFERSIZE / 4;
+      const char *b = bufferBytes(4 * chunk);
+      if (b == 0) return(_error = LXDR_READERROR);
+      for (long i = 0; i < chunk; i++) {
+         uint32_t w;
+         float    f;
+         memcpy(&w, b + 4 * i, 4);
+         w = ntohl(w);
+         memcpy(&f, &w, 4);
+         data[i] = (double) f;
+      }
+      data += chunk;
+      n    -= chunk;
+   }
+   return(LXDR_SUCCESS);
+}
+
 long lXDR::checkRead(long *l)
 {
    if (_openForWrite) return(_error = LXDR_READONLY);
@@ -125,7 +230,7 @@ long lXDR::checkRead(long *l)
       //*l = ntohl(*l);
 
       int32_t buf;
-      if (fread(&buf, 4, 1, _fp) != 1) return(_error = LXDR_READERROR);
+      if (readBytes(&buf, 4) != LXDR_SUCCESS) return(_error);
       *l = ((int32_t)ntohl(buf));
    }
    return(LXDR_SUCCESS);
@@ -136,7 +241,7 @@ long lXDR::checkRead(double *d)
    if (_openForWrite) return(_error = LXDR_READONLY);
    if (_fp == 0)      return(_error = LXDR_NOFILE);
    if (d) {
-      if (fread(d, 8, 1, _fp) != 1) return(_error = LXDR_READERROR);
+      if (readBytes(d, 8) != LXDR_SUCCESS) return(_error);
       *d = ntohd(*d);
    }
    return(LXDR_SUCCESS);
@@ -147,7 +252,7 @@ long lXDR::checkRead(float *f)
    if (_openForWrite) return(_error = LXDR_READONLY);
    if (_fp == 0)      return(_error = LXDR_NOFILE);
    if (f) {
-      if (fread(f, 4, 1, _fp) != 1) return(_error = LXDR_READERROR);
+      if (readBytes(f, 4) != LXDR_SUCCESS) return(_error);
       // je: in architectures where long isn't 4 byte long this code crashes
       //*((long *) f) = ntohl(*((long *) f));
 
@@ -179,85 +284,108 @@ double lXDR::readFloat(void)
 
 const char *lXDR::readString(long &length)
 {
-   if (checkRead(&length)) return(0);
-   long rl = (length + 3) & 0xFFFFFFFC;
-   char *s = new char[rl + 1];
-   if (fread(s, 1, rl, _fp) != (unsigned long) rl) {
-      _error = LXDR_READERROR;
+   long capacity = 0;
+   char *s = (char *) readString(length, 0, capacity);
+   if (_error != LXDR_SUCCESS) {
       delete [] s;
       return(0);
    }
-   s[rl] = '\0';
-   _error = LXDR_SUCCESS;
    return(s);
 }
 
-long *lXDR::readLongArray(long &length)
+const char *lXDR::readString(long &length, char *data, long &capacity)
 {
-   if (checkRead(&length)) return(0);
-   long *s = new long[length];
-   // je: in architectures where long isn't 4 byte long this code crashes
-   //if (fread(s, 4, length, _fp) != (unsigned long) length) {
-   //   _error = LXDR_READERROR;
-   //   delete [] s;
-   //   return(0);
-   //}
-   //if (_hasNetworkOrder == false) for (long i = 0; i < length; i++) s[i] = ntohl(s[i]);
-
-   int32_t *buf = new int32_t[length];
-   if (fread(buf, 4, length, _fp) != (unsigned long) length) {
-       _error = LXDR_READERROR;
-       delete [] buf;
-       delete [] s;
-       return(0);
-   }
-   for (long i = 0; i < length; i++){
-       if (_hasNetworkOrder == false){
-           s[i] = ((int32_t)ntohl(buf[i]));
-       }
-       else{
-            s[i] = (long)buf[i];
-       }
-   }
-   delete [] buf;
+   if (checkRead(&length)) return(data);
+   if (length < 0) {
+      _error = LXDR_READERROR;
+      return(data);
+   }
+   long rl = (length + 3) & 0xFFFFFFFC;
+   if (rl + 1 > capacity) {
+      delete [] data;
+      data     = new char[rl + 1];
+      capacity = rl + 1;
+   }
+   if (readBytes(data, rl) != LXDR_SUCCESS) {
+      data[0] = '\0';
+      return(data);
+   }
+   data[rl] = '\0';
    _error = LXDR_SUCCESS;
+   return(data);
+}
+
+long *lXDR::readLongArray(long &length)
+{
+   long capacity = 0;
+   long *s = readLongArray(length, 0, capacity);
+   if (_error != LXDR_SUCCESS) {
+      delete [] s;
+      return(0);
+   }
+   if (s == 0) s = new long[1];
    return(s);
 }
 
-double *lXDR::readDoubleArray(long &length)
+long *lXDR::readLongArray(long &length, long *data, long &capacity)
 {
-   if (checkRead(&length)) return(0);
-   double *s = new double[length];
-   if (fread(s, 8, length, _fp) != (unsigned long) length) {
+   if (checkRead(&length)) return(data);
+   if (length < 0) {
       _error = LXDR_READERROR;
+      return(data);
+   }
+   if (length > capacity) {
+      delete [] data;
+      data     = new long[length];
+      capacity = length;
+   }
+   if (decodeLongs(data, length) != LXDR_SUCCESS) return(data);
+   _error = LXDR_SUCCESS;
+   return(data);
+}
+
+double *lXDR::readDoubleArray(long &length)
+{
+   long capacity = 0;
+   double *s = readDoubleArray(length, 0, capacity);
+   if (_error != LXDR_SUCCESS) {
       delete [] s;
       return(0);
    }
-   if (_hasNetworkOrder == false) for (long i = 0; i < length; i++) s[i] = ntohd(s[i]);
-   _error = LXDR_SUCCESS;
+   if (s == 0) s = new double[1];
    return(s);
 }
 
+double *lXDR::readDoubleArray(long &length, double *data, long &capacity)
+{
+   if (checkRead(&length)) return(data);
+   if (length < 0) {
+      _error = LXDR_READERROR;
+      return(data);
+   }
+   if (length > capacity) {
+      delete [] data;
+      data     = new double[length];
+      capacity = length;
+   }
+   if (decodeDoubles(data, length) != LXDR_SUCCESS) return(data);
+   _error = LXDR_SUCCESS;
+   return(data);
+}
+
 double *lXDR::readFloatArray(long &length)
 {
    if (checkRead(&length)) return(0);
-   long *st = new long[length];
-   // je: FIXME this will cause problems in architectures where long isn't 4 byte long
-   if (fread(st, 4, length, _fp) != (unsigned long) length) {
+   if (length < 0) {
       _error = LXDR_READERROR;
-      delete [] st;
       return(0);
    }
-   double *s = new double[length];
-   // je: FIXME what happens if _hasNetworkOrder == true?!
-   if (_hasNetworkOrder == false) {
-      for (long i = 0; i < length; i++) {
-         long l = ntohl(st[i]);
-         s[i] = (double) (*((float *) &l));
-      }
+   double *s = new double[length > 0 ? length : 1];
+   if (decodeFloats(s, length) != LXDR_SUCCESS) {
+      delete [] s;
+      return(0);
    }
    _error = LXDR_SUCCESS;
-   delete [] st;
    return(s);
 }
 
@@ -344,11 +472,29 @@ long lXDR::filePosition(long pos)
       _error = LXDR_NOFILE;
       return(-1);
    }
-   if (pos == -1) return(ftell(_fp));
+   if (_openForWrite) {
+      if (pos == -1) return(ftell(_fp));
+      if (fseek(_fp, pos, SEEK_SET)) {
+         _error = LXDR_SEEKERROR;
+         return(-1);
+      }
+      return(pos);
+   }
+//
+// Reading: positions inside the buffer don't need a seek
+//
+   if (pos == -1) return(_bufferStart + _bufferPos);
+   if (pos >= _bufferStart && pos <= _bufferStart + _bufferLength) {
+      _bufferPos = pos - _bufferStart;
+      return(pos);
+   }
    if (fseek(_fp, pos, SEEK_SET)) {
       _error = LXDR_SEEKERROR;
       return(-1);
    }
+   _bufferStart  = pos;
+   _bufferLength = 0;
+   _bufferPos    = 0;
    return(pos);
 }
 
@@ -11,7 +11,12 @@
 //
 // Release notes:
 // - Version 1.0 (23-Oct-2003)
-//
+// - gemc (10/19/2026):
+//   o Reading goes through a 1 MB buffer refilled with large
+//     fread calls instead of one fread per value.
+//   o Arrays are byte swapped in bulk from the buffer.
+//   o Array reads can reuse the caller arrays (no allocation
+//     once the arrays are large enough).
 //
 // Copied from the LCIO library, 2012.
 //
@@ -93,6 +98,14 @@ public:
    double     *readFloatArray(long &length); // Note that this returns an array of doubles!!
    double     *readDoubleArray(long &length);
 //
+// Same as above, but the data is read into the provided array, which is
+// reallocated only if capacity is smaller than length. The array is returned
+// also in case of errors, so the caller keeps ownership.
+//
+   const char *readString(long &length, char *data, long &capacity);
+   long       *readLongArray(long &length, long *data, long &capacity);
+   double     *readDoubleArray(long &length, double *data, long &capacity);
+//
 // Write data
 // ----------
 // The following routines write single longs or doubles.
@@ -121,6 +134,20 @@ private:
    FILE      *_fp;
    long       _error;
    bool       _openForWrite;
+//
+// Read buffer: _buffer[0] is at file offset _bufferStart
+//
+   enum { BUFFERSIZE = 1 << 20 };
+   char      *_buffer;
+   long       _bufferStart;
+   long       _bufferLength;
+   long       _bufferPos;
+
+   const char *bufferBytes(long n);
+   long       readBytes(void *data, long n);
+   long       decodeLongs(long *data, long n);
+   long       decodeDoubles(double *data, long n);
+   long       decodeFloats(double *data, long n);
 
    bool       _hasNetworkOrder;
    double     ntohd(double d) const;
@@ -0,0 +1,293 @@
+// gemc headers
+#include "primaryEventFile.h"
+
+// C++ headers
+#include <iostream>
+#include <cstring>
+#include <cmath>
+
+#define PRIMARY_FILE_MAGIC       "GPRIMARY"
+#define PRIMARY_FILE_BYTEORDER   0x01020304
+#define PRIMARY_FILE_HEADER_SIZE 64
+
+#define PRIMARY_COLUMN_INT    1
+#define PRIMARY_COLUMN_DOUBLE 2
+
+template <class T> static void putValue(vector<char> &buffer, T value)
+{
+	const char *p = (const char*) &value;
+	buffer.insert(buffer.end(), p, p + sizeof(T));
+}
+
+template <class T> static T getValue(const char *&p)
+{
+	T value;
+	memcpy(&value, p, sizeof(T));
+	p += sizeof(T);
+	return value;
+}
+
+
+primaryEventFile::primaryEventFile(string filename, string mode, int sourceFormat, unsigned eventsPerBlock)
+{
+	writing      = mode == "w";
+	atEnd        = false;
+	closed       = false;
+	format       = sourceFormat;
+	blockSize    = eventsPerBlock > 0 ? eventsPerBlock : 1000;
+	nevents      = 0;
+	indexOffset  = 0;
+	currentEvent = 0;
+	nsource      = 0;
+
+	if(writing) {
+		file.open(filename.c_str(), ios::out | ios::binary | ios::trunc);
+		good = file.good();
+		if(good) writeFileHeader();
+	} else {
+		file.open(filename.c_str(), ios::in | ios::binary);
+		good = file.good() && readFileHeader();
+		if(good) readIndex();
+	}
+
+	if(!good) atEnd = true;
+}
+
+primaryEventFile::~primaryEventFile()
+{
+	close();
+}
+
+void primaryEventFile::writeFileHeader()
+{
+	char header[PRIMARY_FILE_HEADER_SIZE];
+	memset(header, 0, PRIMARY_FILE_HEADER_SIZE);
+
+	uint32_t version   = PRIMARY_FILE_VERSION;
+	uint32_t byteOrder = PRIMARY_FILE_BYTEORDER;
+	uint32_t fmt       = format;
+
+	memcpy(header,      PRIMARY_FILE_MAGIC, 8);
+	memcpy(header + 8,  &version,     4);
+	memcpy(header + 12, &byteOrder,   4);
+	memcpy(header + 16, &fmt,         4);
+	memcpy(header + 20, &blockSize,   4);
+	memcpy(header + 24, &nevents,     8);
+	memcpy(header + 32, &indexOffset, 8);
+	memcpy(header + 40, &nsource,     8);
+
+	file.seekp(0);
+	file.write(header, PRIMARY_FILE_HEADER_SIZE);
+}
+
+bool primaryEventFile::readFileHeader()
+{
+	char header[PRIMARY_FILE_HEADER_SIZE];
+	file.read(header, PRIMARY_FILE_HEADER_SIZE);
+	if(!file.good() || memcmp(header, PRIMARY_FILE_MAGIC, 8) != 0) {
+		cout << " !!! Error: this is not a gemc primary events file." << endl;
+		return false;
+	}
+
+	const char *p = header + 8;
+	uint32_t version   = getValue<uint32_t>(p);
+	uint32_t byteOrder = getValue<uint32_t>(p);
+	format             = getValue<uint32_t>(p);
+	blockSize          = getValue<uint32_t>(p);
+	nevents            = getValue<uint64_t>(p);
+	indexOffset        = getValue<uint64_t>(p);
+	nsource            = getValue<uint64_t>(p);
+
+	if(byteOrder != PRIMARY_FILE_BYTEORDER) {
+		cout << " !!! Error: the primary events file was written with a different byte order." << endl;
+		return false;
+	}
+	if(version > PRIMARY_FILE_VERSION) {
+		cout << " !!! Error: primary events file version " << version << " is not supported. Latest version: " << PRIMARY_FILE_VERSION << endl;
+		return false;
+	}
+
+	return true;
+}
+
+// files that were not closed have no index: they are read sequentially
+void primaryEventFile::readIndex()
+{
+	if(indexOffset == 0) {
+		nevents = UINT64_MAX;
+		return;
+	}
+
+	file.seekg(indexOffset);
+	uint64_t nblocks = 0;
+	file.read((char*) &nblocks, 8);
+	for(uint64_t b=0; b<nblocks && file.good(); b++) {
+		uint64_t firstEvent, offset;
+		file.read((char*) &firstEvent, 8);
+		file.read((char*) &offset, 8);
+		blockOffsets.push_back(offset);
+	}
+
+	file.clear();
+	file.seekg(PRIMARY_FILE_HEADER_SIZE);
+}
+
+
+bool primaryEventFile::readEvent(primaryEvent &event)
+{
+	if(writing || atEnd || currentEvent >= nevents) {
+		atEnd = true;
+		return false;
+	}
+
+	uint32_t size = 0;
+	file.read((char*) &size, 4);
+	if(!file.good()) {
+		atEnd = true;
+		return false;
+	}
+
+	if(record.size() < size) record.resize(size);
+	file.read(record.data(), size);
+	if(!file.good()) {
+		cout << " !!! Error: primary events file truncated at event " << currentEvent << endl;
+		atEnd = true;
+		return false;
+	}
+
+	const char *p = record.data();
+	uint32_t nparticles = getValue<uint32_t>(p);
+	uint32_t nheader    = getValue<uint32_t>(p);
+	uint32_t ncolumns   = getValue<uint32_t>(p);
+
+	event.header.resize(nheader);
+	if(nheader) memcpy(event.header.data(), p, nheader*sizeof(double));
+	p += nheader*sizeof(double);
+
+	const char *types = p;
+	p += ncolumns;
+
+	event.particles.resize(nparticles);
+	for(auto &particle: event.particles)
+		particle.resize(ncolumns);
+
+	for(uint32_t c=0; c<ncolumns; c++) {
+		if(types[c] == PRIMARY_COLUMN_INT) {
+			for(uint32_t i=0; i<nparticles; i++)
+				event.particles[i][c] = getValue<int32_t>(p);
+		} else {
+			for(uint32_t i=0; i<nparticles; i++)
+				event.particles[i][c] = getValue<double>(p);
+		}
+	}
+
+	currentEvent++;
+	return true;
+}
+
+bool primaryEventFile::seek(uint64_t event)
+{
+	if(writing) return false;
+
+	if(event >= nevents) {
+		atEnd = true;
+		return false;
+	}
+
+	uint64_t first = 0;
+	uint64_t block = event/blockSize;
+	file.clear();
+	if(block < blockOffsets.size()) {
+		first = block*blockSize;
+		file.seekg(blockOffsets[block]);
+	} else {
+		file.seekg(PRIMARY_FILE_HEADER_SIZE);
+	}
+
+	// skipping the records before the event in the block
+	for(uint64_t e=first; e<event; e++) {
+		uint32_t size = 0;
+		file.read((char*) &size, 4);
+		if(!file.good()) {
+			atEnd = true;
+			return false;
+		}
+		file.seekg(size, ios::cur);
+	}
+
+	currentEvent = event;
+	atEnd = false;
+	return true;
+}
+
+
+void primaryEventFile::writeEvent(const primaryEvent &event)
+{
+	if(!writing || closed) return;
+
+	if(nevents % blockSize == 0)
+		blockOffsets.push_back(file.tellp());
+
+	uint32_t nparticles = event.particles.size();
+	uint32_t nheader    = event.header.size();
+	uint32_t ncolumns   = 0;
+	for(auto &particle: event.particles)
+		if(particle.size() > ncolumns) ncolumns = particle.size();
+
+	// a column is int32 if all its values are integers
+	vector<char> types(ncolumns, PRIMARY_COLUMN_INT);
+	for(auto &particle: event.particles) {
+		for(uint32_t c=0; c<ncolumns; c++) {
+			double value = c < particle.size() ? particle[c] : 0;
+			if(value != floor(value) || fabs(value) > 2147483647.0)
+				types[c] = PRIMARY_COLUMN_DOUBLE;
+		}
+	}
+
+	record.clear();
+	putValue<uint32_t>(record, 0);   // record size, set below
+	putValue<uint32_t>(record, nparticles);
+	putValue<uint32_t>(record, nheader);
+	putValue<uint32_t>(record, ncolumns);
+	for(auto h: event.header)
+		putValue<double>(record, h);
+	record.insert(record.end(), types.begin(), types.end());
+
+	for(uint32_t c=0; c<ncolumns; c++) {
+		for(auto &particle: event.particles) {
+			double value = c < particle.size() ? particle[c] : 0;
+			if(types[c] == PRIMARY_COLUMN_INT)
+				putValue<int32_t>(record, (int32_t) value);
+			else
+				putValue<double>(record, value);
+		}
+	}
+
+	uint32_t size = record.size() - 4;
+	memcpy(record.data(), &size, 4);
+
+	file.write(record.data(), record.size());
+	nevents++;
+}
+
+void primaryEventFile::close()
+{
+	if(closed) return;
+	closed = true;
+
+	if(writing && good) {
+		indexOffset = file.tellp();
+
+		uint64_t nblocks = blockOffsets.size();
+		file.write((const char*) &nblocks, 8);
+		for(uint64_t b=0; b<nblocks; b++) {
+			uint64_t firstEvent = b*blockSize;
+			file.write((const char*) &firstEvent, 8);
+			file.write((const char*) &blockOffsets[b], 8);
+		}
+
+		writeFileHeader();
+	}
+
+	file.close();
+}
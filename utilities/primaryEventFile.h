@@ -0,0 +1,101 @@
+/// \file primaryEventFile.h
+/// Defines the gemc binary primary events file (gprimary).\n
+/// Generator files (LUND, BEAGLE, StdHep) are converted once with
+/// primaryConverter and read by the generator action without text parsing.\n
+/// Layout (native byte order, checked with the byte order word):
+/// - file header, 64 bytes: magic "GPRIMARY", version, byte order word,
+///   source format, number of events, index offset, events per block,
+///   number of source events (0 if unknown)
+/// - events: record size in bytes, number of particles, number of header
+///   values, number of particle columns, header values (double),
+///   column types (1 byte each: int32 or double) then the particle table,
+///   column by column
+/// - block index at the index offset: number of blocks, then
+///   first event and file offset of each block
+///
+/// The columns are the ones of the source format (LUND: 14, BEAGLE: 18),
+/// so that the generator action maps them as for the text files.
+/// Columns with only integer values are written as int32.
+/// \author \n Maurizio Ungaro
+/// \author mail: ungaro@jlab.org\n\n\n
+#ifndef PRIMARY_EVENT_FILE_H
+#define PRIMARY_EVENT_FILE_H 1
+
+// C++ headers
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+using namespace std;
+
+#define PRIMARY_FILE_VERSION   1
+#define PRIMARY_FORMAT_LUND    1
+#define PRIMARY_FORMAT_BEAGLE  2
+#define PRIMARY_FORMAT_BUNCH   3   ///< luminosity bunch library, see lumiBunchLibrary.h
+#define PRIMARY_FORMAT_PHASESPACE 4   ///< particles crossing a volume boundary, see phaseSpace.h
+
+/// \class primaryEvent
+/// <b> primaryEvent </b>\n\n
+/// Header values and particle table of one event, with the columns of the source format
+class primaryEvent
+{
+public:
+	vector<double> header;
+	vector<vector<double> > particles;   ///< particles[p][column]
+};
+
+
+/// \class primaryEventFile
+/// <b> primaryEventFile </b>\n\n
+/// Reads or writes a gprimary file. mode is "r" or "w".
+class primaryEventFile
+{
+public:
+	primaryEventFile(string filename, string mode, int sourceFormat = PRIMARY_FORMAT_LUND, unsigned eventsPerBlock = 1000);
+	~primaryEventFile();
+
+	bool isGood() const {return good;}
+	bool eof()    const {return atEnd;}
+
+	int      sourceFormat()   const {return format;}
+	uint64_t numberOfEvents() const {return nevents;}
+
+	// events of the source simulation the file was written from, for example the events
+	// simulated to record a phase space. Set before close, 0 if unknown
+	uint64_t sourceEvents()   const {return nsource;}
+	void     setSourceEvents(uint64_t n) {nsource = n;}
+
+	// reads the next event. Returns false at the end of the file
+	bool readEvent(primaryEvent &event);
+
+	// positions the file at the event (0 is the first event) using the block index
+	bool seek(uint64_t event);
+
+	void writeEvent(const primaryEvent &event);
+
+	// writes the index and the number of events
+	void close();
+
+private:
+	fstream  file;
+	bool     writing;
+	bool     good;
+	bool     atEnd;
+	bool     closed;
+
+	int      format;
+	uint32_t blockSize;
+	uint64_t nevents;
+	uint64_t indexOffset;
+	uint64_t currentEvent;
+	uint64_t nsource;
+
+	vector<uint64_t> blockOffsets;      ///< offset of the first event of each block
+	vector<char>     record;            ///< event record buffer
+
+	void writeFileHeader();
+	bool readFileHeader();
+	void readIndex();
+};
+
+#endif